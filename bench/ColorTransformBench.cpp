@@ -0,0 +1,127 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorTransform.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkString.h"
+#include "include/encode/SkICC.h"
+
+#include <utility>
+
+// Converts a Display P3 image to sRGB with a transform looked up per call or made once up front,
+// against readPixels() as the baseline.
+class ColorTransformBench : public Benchmark {
+public:
+    enum class Mode { kReadPixels, kTransform, kCachedTransform };
+
+    ColorTransformBench(Mode mode, SkISize size) : fMode(mode), fSize(size) {
+        static const char* kNames[] = {"readpixels", "transform", "cached_transform"};
+        fName.printf("color_transform_%s_%dx%d", kNames[(int)mode], size.width(), size.height());
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return Backend::kNonRendering == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                                       SkNamedGamut::kDisplayP3);
+        fSrc.allocPixels(SkImageInfo::MakeN32Premul(fSize, p3));
+        for (int y = 0; y < fSrc.height(); ++y) {
+            for (int x = 0; x < fSrc.width(); ++x) {
+                *fSrc.getAddr32(x, y) = 0xFF000000 | (x * 0x010203 + y * 0x030201);
+            }
+        }
+        fDst.allocPixels(fSrc.info().makeColorSpace(SkColorSpace::MakeSRGB()));
+        fTransform = SkColorTransform::Make(std::move(p3), nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            switch (fMode) {
+                case Mode::kReadPixels:
+                    SkAssertResult(fSrc.readPixels(fDst.pixmap()));
+                    break;
+                case Mode::kTransform:
+                    SkAssertResult(SkColorTransform::Make(fSrc.refColorSpace(),
+                                                          fDst.refColorSpace())
+                                           ->apply(fDst.pixmap(), fSrc.pixmap()));
+                    break;
+                case Mode::kCachedTransform:
+                    SkAssertResult(fTransform->apply(fDst.pixmap(), fSrc.pixmap()));
+                    break;
+            }
+        }
+    }
+
+private:
+    Mode                    fMode;
+    SkISize                 fSize;
+    SkString                fName;
+    SkBitmap                fSrc, fDst;
+    sk_sp<SkColorTransform> fTransform;
+};
+
+DEF_BENCH( return new ColorTransformBench(ColorTransformBench::Mode::kReadPixels,
+                                          {4000, 3000}); )
+DEF_BENCH( return new ColorTransformBench(ColorTransformBench::Mode::kTransform,
+                                          {4000, 3000}); )
+DEF_BENCH( return new ColorTransformBench(ColorTransformBench::Mode::kCachedTransform,
+                                          {4000, 3000}); )
+DEF_BENCH( return new ColorTransformBench(ColorTransformBench::Mode::kTransform,
+                                          {64, 64}); )
+
+// Converts an opaque image, as decoded, with an A2B (CLUT-based) HLG profile to sRGB, exactly or
+// through a baked LUT.
+class ColorTransformA2BBench : public Benchmark {
+public:
+    ColorTransformA2BBench(SkColorTransform::Mode mode) : fMode(mode) {
+        fName.printf("color_transform_a2b_%s",
+                     mode == SkColorTransform::Mode::kBaked ? "baked" : "exact");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return Backend::kNonRendering == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSrc.allocPixels(SkImageInfo::MakeN32(2000, 1500, kOpaque_SkAlphaType));
+        for (int y = 0; y < fSrc.height(); ++y) {
+            for (int x = 0; x < fSrc.width(); ++x) {
+                *fSrc.getAddr32(x, y) = 0xFF000000 | (x * 0x010203 + y * 0x030201);
+            }
+        }
+        fDst.allocPixels(fSrc.info());
+        fTransform = SkColorTransform::MakeFromICC(
+                SkWriteICCProfile(SkNamedTransferFn::kHLG, SkNamedGamut::kRec2020), nullptr, fMode);
+        SkASSERT_RELEASE(fTransform->isBaked() == (fMode == SkColorTransform::Mode::kBaked));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkAssertResult(fTransform->apply(fDst.pixmap(), fSrc.pixmap()));
+        }
+    }
+
+private:
+    SkColorTransform::Mode  fMode;
+    SkString                fName;
+    SkBitmap                fSrc, fDst;
+    sk_sp<SkColorTransform> fTransform;
+};
+
+DEF_BENCH( return new ColorTransformA2BBench(SkColorTransform::Mode::kExact); )
+DEF_BENCH( return new ColorTransformA2BBench(SkColorTransform::Mode::kBaked); )
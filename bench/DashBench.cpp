@@ -435,6 +435,53 @@ private:
     using INHERITED = Benchmark;
 };
 
+// A long, curvy route (e.g. on a map) drawn at high zoom, so only a small part of it is visible.
+class DashRouteBench : public Benchmark {
+    SkString            fName;
+    SkPath              fPath;
+    SkScalar            fZoom;
+    sk_sp<SkPathEffect> fPathEffect;
+
+public:
+    DashRouteBench(SkScalar zoom) : fZoom(zoom) {
+        fName.printf("dash_route_zoom_%g", zoom);
+
+        SkRandom rand;
+        fPath.moveTo(0, 240);
+        for (int i = 0; i < 1000; ++i) {
+            SkScalar x = i * 20.0f;
+            fPath.quadTo(x + 10, rand.nextRangeF(200, 280), x + 20, rand.nextRangeF(230, 250));
+        }
+
+        const SkScalar intervals[] = { 6, 4 };
+        fPathEffect = SkDashPathEffect::Make(intervals, std::size(intervals), 0);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint p;
+        this->setupPaint(&p);
+        p.setStyle(SkPaint::kStroke_Style);
+        p.setStrokeWidth(2);
+        p.setPathEffect(fPathEffect);
+
+        // Zoom in on the middle of the route.
+        canvas->translate(320, 240);
+        canvas->scale(fZoom, fZoom);
+        canvas->translate(-10000, -240);
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPath, p);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const SkScalar gDots[] = { SK_Scalar1, SK_Scalar1 };
@@ -448,6 +495,8 @@ DEF_BENCH( return new DashBench(PARAM(gDots), 4); )
 DEF_BENCH( return new MakeDashBench(make_poly, "poly"); )
 DEF_BENCH( return new MakeDashBench(make_quad, "quad"); )
 DEF_BENCH( return new MakeDashBench(make_cubic, "cubic"); )
+DEF_BENCH( return new DashRouteBench(1); )
+DEF_BENCH( return new DashRouteBench(16); )
 DEF_BENCH( return new DashLineBench(0, false); )
 DEF_BENCH( return new DashLineBench(SK_Scalar1, false); )
 DEF_BENCH( return new DashLineBench(2 * SK_Scalar1, false); )
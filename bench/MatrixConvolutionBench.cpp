@@ -14,14 +14,45 @@
 
 #include "tools/ToolUtils.h"
 
+#include <cmath>
+
+enum class KernelType {
+    kSmall,
+    kBig,
+    kGaussian,  // 15x15, separable
+};
+
+static const char* kernel_type_name(KernelType type) {
+    switch (type) {
+        case KernelType::kSmall:    return "";
+        case KernelType::kBig:      return "bigKernel_";
+        case KernelType::kGaussian: return "gaussianKernel_";
+    }
+    SkUNREACHABLE;
+}
+
 class MatrixConvolutionBench : public Benchmark {
 public:
-    MatrixConvolutionBench(bool bigKernel, SkTileMode tileMode, bool convolveAlpha)
+    MatrixConvolutionBench(KernelType kernelType, SkTileMode tileMode, bool convolveAlpha)
         : fName(SkStringPrintf("matrixconvolution_%s%s%s",
-                               bigKernel ? "bigKernel_" : "",
+                               kernel_type_name(kernelType),
                                ToolUtils::tilemode_name(tileMode),
                                convolveAlpha ? "" : "_noConvolveAlpha")) {
-        if (bigKernel) {
+        if (kernelType == KernelType::kGaussian) {
+            SkISize kernelSize = SkISize::Make(15, 15);
+            SkScalar kernel[225];
+            for (int y = 0; y < 15; y++) {
+                for (int x = 0; x < 15; x++) {
+                    kernel[y * 15 + x] = std::exp(-((x - 7) * (x - 7) + (y - 7) * (y - 7)) / 18.f) /
+                                         (2 * SK_ScalarPI * 9);
+                }
+            }
+            SkScalar gain = SK_Scalar1, bias = 0;
+            SkIPoint kernelOffset = SkIPoint::Make(7, 7);
+            fFilter = SkImageFilters::MatrixConvolution(kernelSize, kernel, gain, bias,
+                                                        kernelOffset, tileMode, convolveAlpha,
+                                                        nullptr);
+        } else if (kernelType == KernelType::kBig) {
             SkISize kernelSize = SkISize::Make(9, 9);
             SkScalar kernel[81];
             for (int i = 0; i < 81; i++) {
@@ -74,14 +105,18 @@ private:
     using INHERITED = Benchmark;
 };
 
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kSmall, SkTileMode::kDecal, false); )
+
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kBig, SkTileMode::kDecal, false); )
 
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kGaussian, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kGaussian, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::kGaussian, SkTileMode::kDecal, false); )
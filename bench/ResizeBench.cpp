@@ -0,0 +1,62 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkString.h"
+#include "src/core/SkResizePixels.h"
+
+class ResizeBench : public Benchmark {
+public:
+    ResizeBench(const char* filterName, SkResizeFilter filter, SkISize srcSize, SkISize dstSize)
+            : fFilter(filter), fSrcSize(srcSize), fDstSize(dstSize) {
+        fName.printf("resize_%s_%dx%d_to_%dx%d", filterName, srcSize.width(), srcSize.height(),
+                     dstSize.width(), dstSize.height());
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return Backend::kNonRendering == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkImageInfo info = SkImageInfo::MakeN32Premul(fSrcSize, SkColorSpace::MakeSRGB());
+        fSrc.allocPixels(info);
+        for (int y = 0; y < fSrc.height(); ++y) {
+            for (int x = 0; x < fSrc.width(); ++x) {
+                *fSrc.getAddr32(x, y) = 0xFF000000 | (x * 0x010203 + y * 0x030201);
+            }
+        }
+        fDst.allocPixels(info.makeDimensions(fDstSize));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkAssertResult(SkResizePixels(fDst.pixmap(), fSrc.pixmap(), fFilter));
+        }
+    }
+
+private:
+    SkString       fName;
+    SkResizeFilter fFilter;
+    SkISize        fSrcSize, fDstSize;
+    SkBitmap       fSrc, fDst;
+};
+
+// A typical thumbnail, a modest downscale, and an upscale.
+DEF_BENCH( return new ResizeBench("lanczos3", SkResizeFilter::Lanczos3(),
+                                  {4000, 3000}, {400, 300}); )
+DEF_BENCH( return new ResizeBench("mitchell", SkResizeFilter::Mitchell(),
+                                  {4000, 3000}, {400, 300}); )
+DEF_BENCH( return new ResizeBench("lanczos3", SkResizeFilter::Lanczos3(),
+                                  {1024, 1024}, {700, 700}); )
+DEF_BENCH( return new ResizeBench("catmullrom", SkResizeFilter::CatmullRom(),
+                                  {512, 512}, {1024, 1024}); )
@@ -10,6 +10,7 @@
 #include "include/core/SkPath.h"
 #include "include/core/SkRRect.h"
 #include "include/utils/SkShadowUtils.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkDrawShadowInfo.h"
 
 class ShadowBench : public Benchmark {
@@ -104,3 +105,57 @@ DEF_BENCH(return new ShadowBench(false, true);)
 DEF_BENCH(return new ShadowBench(true, false);)
 DEF_BENCH(return new ShadowBench(true, true);)
 
+
+// Draws a scrolling, zooming list of material design cards. Every card is its own SkPath at its
+// own position, and the list's matrix changes slightly every frame, as it would during a fling
+// or a zoom animation.
+class ShadowCardsBench : public Benchmark {
+public:
+    ShadowCardsBench(bool zooming) : fZooming(zooming) {
+        fName.printf("shadows_cards_%s", zooming ? "zooming" : "scrolling");
+    }
+
+protected:
+    enum {
+        kWidth = 640,
+        kHeight = 480,
+        kNumCards = 200,
+    };
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < kNumCards; ++i) {
+            SkRect rect = SkRect::MakeXYWH(rand.nextRangeF(0, kWidth - 120),
+                                           rand.nextRangeF(0, kHeight - 80),
+                                           120, 80);
+            fCards[i] = SkPath::RRect(SkRRect::MakeRectXY(rect, 8, 8));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            canvas->save();
+            // Sub-pixel scroll offsets, and scales that vary by less than a percent.
+            canvas->translate(0, -0.37f * (i % 50));
+            if (fZooming) {
+                SkScalar scale = 1 + 0.0002f * (i % 32);
+                canvas->scale(scale, scale);
+            }
+            const SkPath& card = fCards[i % kNumCards];
+            SkShadowUtils::DrawShadow(canvas, card, SkPoint3::Make(0, 0, 8),
+                                      SkPoint3::Make(kWidth / 2, -200, 600), 800,
+                                      0x19000000, 0x40000000, kNone_ShadowFlag);
+            canvas->restore();
+        }
+    }
+
+private:
+    SkString fName;
+    SkPath   fCards[kNumCards];
+    bool     fZooming;
+};
+
+DEF_BENCH(return new ShadowCardsBench(false);)
+DEF_BENCH(return new ShadowCardsBench(true);)
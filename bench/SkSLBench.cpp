@@ -8,12 +8,14 @@
 #include "bench/ResultsWriter.h"
 #include "bench/SkSLBench.h"
 #include "include/core/SkCanvas.h"
+#include "include/effects/SkRuntimeEffect.h"
 #include "src/base/SkArenaAlloc.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/gpu/ganesh/GrCaps.h"
 #include "src/gpu/ganesh/GrRecordingContextPriv.h"
 #include "src/gpu/ganesh/mock/GrMockCaps.h"
 #include "src/sksl/SkSLCompiler.h"
+#include "src/sksl/SkSLLexer.h"
 #include "src/sksl/SkSLModuleLoader.h"
 #include "src/sksl/SkSLParser.h"
 #include "src/sksl/codegen/SkSLGLSLCodeGenerator.h"
@@ -787,3 +789,230 @@ DEF_BENCH(return new SkSLModuleLoaderBench("sksl_module_loader_graphite",
                                                    SkSL::ProgramKind::kGraphiteVertex,
                                                    SkSL::ProgramKind::kGraphiteFragment,
                                            });)
+
+// Measures the latency a client sees on its first runtime effect: loading the shared and
+// runtime-shader modules from source, then compiling a small shader against them.
+class SkSLFirstRuntimeEffectBench : public Benchmark {
+public:
+    const char* onGetName() override {
+        return "sksl_first_runtime_effect";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    bool shouldLoop() const override {
+        return false;
+    }
+
+    void onPreDraw(SkCanvas*) override {
+        SkSL::ModuleLoader::Get().unloadModules();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkASSERT(loops == 1);
+        sk_sp<SkRuntimeEffect> effect = SkRuntimeEffect::MakeForShader(SkString(R"(
+            uniform half4 color;
+            half4 main(float2 xy) {
+                return mix(color, half4(fract(xy * 0.125), 0, 1), 0.5);
+            }
+        )")).effect;
+        SkASSERT(effect);
+    }
+};
+
+DEF_BENCH(return new SkSLFirstRuntimeEffectBench();)
+
+// Measures the lexer alone, over a large hand-written effect and over the module sources (which
+// are minified, so they are mostly identifiers and punctuation).
+class SkSLLexerBench : public Benchmark {
+public:
+    SkSLLexerBench(const char* name, const char* src)
+            : fName(SkStringPrintf("sksl_lexer_%s", name)), fSrc(src) {}
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkSL::Lexer lexer;
+            lexer.start(fSrc);
+            fNumTokens = 0;
+            while (lexer.next().fKind != SkSL::Token::Kind::TK_END_OF_FILE) {
+                ++fNumTokens;
+            }
+        }
+    }
+
+private:
+    SkString fName;
+    std::string_view fSrc;
+    int fNumTokens = 0;
+};
+
+DEF_BENCH(return new SkSLLexerBench("large", large_SRC);)
+DEF_BENCH(return new SkSLLexerBench("shared_module", SKSL_MINIFIED_sksl_shared);)
+DEF_BENCH(return new SkSLLexerBench("gpu_module", SKSL_MINIFIED_sksl_gpu);)
+DEF_BENCH(return new SkSLLexerBench("graphite_frag_module", SKSL_MINIFIED_sksl_graphite_frag);)
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Runtime shaders which are typical of real effects: complex-number iteration, a gradient with a
+// smoothstep, and a loop of float3 arithmetic.
+static constexpr const char* kFusionEffects[][2] = {
+    {"fractal", R"(
+        uniform float t;
+        half4 main(float2 p) {
+            float2 z = p / 128 - 1;
+            float v = 0;
+            for (int i = 0; i < 12; i++) {
+                z = float2(z.x*z.x - z.y*z.y, 2*z.x*z.y) + float2(0.3*sin(t), 0.5);
+                v += exp(-length(z));
+            }
+            return half4(half3(fract(v), fract(v*2), fract(v*3)), 1);
+        }
+    )"},
+    {"radial_gradient", R"(
+        uniform float2 c;
+        uniform float r;
+        half4 main(float2 p) {
+            float d = distance(p, c) / r;
+            half3 a = half3(0.2, 0.4, 0.9), b = half3(0.9, 0.5, 0.1);
+            half3 col = mix(a, b, half(smoothstep(0, 1, d)));
+            col = col * col * (3 - 2 * col);
+            return half4(col * (d < 1 ? 1 : 0.5), 1);
+        }
+    )"},
+    {"float3_arithmetic", R"(
+        uniform float3 k;
+        half4 main(float2 p) {
+            float3 c = float3(p / 256, 0.5), a = c, q = k / 256;
+            for (int i = 0; i < 16; i++) {
+                a = a * c + q;
+                a = a / (a + c);
+                c = c - a * q;
+            }
+            return half4(half3(a), 1);
+        }
+    )"},
+};
+
+static std::unique_ptr<SkSL::RP::Program> compile_runtime_shader_to_rp(SkSL::Compiler* compiler,
+                                                                       const char* src,
+                                                                       bool fuse) {
+    SkSL::ProgramSettings settings;
+    settings.fFuseRasterPipelineOps = fuse;
+    std::unique_ptr<SkSL::Program> program = compiler->convertProgram(
+            SkSL::ProgramKind::kRuntimeShader, std::string(src), settings);
+    if (!program) {
+        return nullptr;
+    }
+    const SkSL::FunctionDeclaration* main = program->getFunction("main");
+    if (!main) {
+        return nullptr;
+    }
+    return SkSL::MakeRasterPipelineProgram(*program, *main->definition(), /*debugTrace=*/nullptr,
+                                           /*writeTraceOps=*/false);
+}
+
+// Times raster-pipeline execution of a runtime shader, with and without superinstruction fusion.
+class SkSLRasterPipelineFusionBench : public Benchmark {
+public:
+    SkSLRasterPipelineFusionBench(const char* name, const char* src, bool fuse)
+            : fName(std::string("sksl_rp_") + name + (fuse ? "_fused" : "_unfused"))
+            , fSrc(src)
+            , fFuse(fuse) {}
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    void onDelayedSetup() override {
+        fProgram = compile_runtime_shader_to_rp(&fCompiler, fSrc, fFuse);
+        SkASSERT_RELEASE(fProgram);
+
+        // Every uniform in these effects is a float; give them values in a plausible range.
+        fUniforms.resize(fProgram->numUniforms());
+        std::fill(fUniforms.begin(), fUniforms.end(), 100.0f);
+
+        fDstCtx = SkRasterPipeline_MemoryCtx{fDstPixels, kWidth};
+        fPipeline.append(SkRasterPipelineOp::seed_shader);
+        fProgram->appendStages(&fPipeline, &fAlloc, /*callbacks=*/nullptr, SkSpan(fUniforms));
+        fPipeline.append(SkRasterPipelineOp::store_8888, &fDstCtx);
+        fCompiledPipeline = fPipeline.compile();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            fCompiledPipeline(0, 0, kWidth, kHeight);
+        }
+    }
+
+private:
+    std::string fName;
+    const char* fSrc;
+    bool fFuse;
+    SkSL::Compiler fCompiler;
+    std::unique_ptr<SkSL::RP::Program> fProgram;
+    std::vector<float> fUniforms;
+    SkSTArenaAlloc<4096> fAlloc;
+    SkRasterPipeline fPipeline{&fAlloc};
+    std::function<void(size_t, size_t, size_t, size_t)> fCompiledPipeline;
+    SkRasterPipeline_MemoryCtx fDstCtx;
+
+    static constexpr int kWidth = 256;
+    static constexpr int kHeight = 256;
+    uint32_t fDstPixels[kWidth * kHeight];
+
+    using INHERITED = Benchmark;
+};
+
+#define RP_FUSION_BENCH(index)                                                                  \
+    DEF_BENCH(return new SkSLRasterPipelineFusionBench(kFusionEffects[index][0],                \
+                                                       kFusionEffects[index][1],                \
+                                                       /*fuse=*/false);)                        \
+    DEF_BENCH(return new SkSLRasterPipelineFusionBench(kFusionEffects[index][0],                \
+                                                       kFusionEffects[index][1],                \
+                                                       /*fuse=*/true);)
+
+RP_FUSION_BENCH(0)
+RP_FUSION_BENCH(1)
+RP_FUSION_BENCH(2)
+
+// These benchmarks aren't timed; they report how many raster-pipeline stages each effect needs,
+// with and without superinstruction fusion.
+void RunSkSLRasterPipelineFusionBenchmarks(NanoJSONResultsWriter* log) {
+    SkSL::Compiler compiler;
+    for (const auto& [name, src] : kFusionEffects) {
+        for (bool fuse : {false, true}) {
+            std::unique_ptr<SkSL::RP::Program> program =
+                    compile_runtime_shader_to_rp(&compiler, src, fuse);
+            if (!program) {
+                continue;
+            }
+            std::vector<float> uniforms(program->numUniforms(), 0.0f);
+            SkSTArenaAlloc<4096> alloc;
+            SkRasterPipeline pipeline(&alloc);
+            program->appendStages(&pipeline, &alloc, /*callbacks=*/nullptr, SkSpan(uniforms));
+
+            std::string statName = std::string("sksl_rp_stages_") + name +
+                                   (fuse ? "_fused" : "_unfused");
+            log->beginObject(statName.c_str());                  // test
+            log->beginObject("meta");                            //   config
+            log->appendS32("stages", pipeline.getNumStages());   //     sub_result
+            log->endObject();                                    //   config
+            log->endObject();                                    // test
+        }
+    }
+}
@@ -12,5 +12,6 @@
 class NanoJSONResultsWriter;
 
 void RunSkSLModuleBenchmarks(NanoJSONResultsWriter*);
+void RunSkSLRasterPipelineFusionBenchmarks(NanoJSONResultsWriter*);
 
 #endif
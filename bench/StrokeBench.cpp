@@ -10,7 +10,10 @@
 #include "include/core/SkPath.h"
 #include "include/core/SkPathUtils.h"
 #include "include/core/SkString.h"
+#include "include/core/SkVertices.h"
+#include "include/private/base/SkTPin.h"
 #include "src/base/SkRandom.h"
+#include "src/core/SkPolylineStroker.h"
 
 class StrokeBench : public Benchmark {
 public:
@@ -67,6 +70,18 @@ static SkPath line_path_maker() {
     }
     return path;
 }
+// A long time series, which SkStroke hands to SkPolylineStroker.
+static SkPath polyline_path_maker() {
+    SkPath path;
+    SkRandom rand;
+    SkScalar y = 0;
+    path.moveTo(0, y);
+    for (int i = 1; i < 100 * N; ++i) {
+        y = SkTPin(y + rand.nextSScalar1() * Y / 10, -Y, Y);
+        path.lineTo(i * X / N, y);
+    }
+    return path;
+}
 static SkPath quad_path_maker() {
     SkPath path;
     SkRandom rand;
@@ -118,3 +133,35 @@ DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_.25", .
 DEF_BENCH(return new StrokeBench(quad_path_maker(), paint_maker(), "quad_.25", .25f);)
 DEF_BENCH(return new StrokeBench(conic_path_maker(), paint_maker(), "conic_.25", .25f);)
 DEF_BENCH(return new StrokeBench(cubic_path_maker(), paint_maker(), "cubic_.25", .25f);)
+
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), paint_maker(), "polyline_1", 1);)
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), paint_maker(), "polyline_4", 4);)
+
+class PolylineVerticesBench : public Benchmark {
+public:
+    PolylineVerticesBench(SkPaint::Join join) : fPath(polyline_path_maker()), fJoin(join) {
+        fName.printf("build_stroke_polyline_vertices_%d", join);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == Backend::kNonRendering;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPolylineStroker stroker(X / 10, SkPaint::kButt_Cap, fJoin, 4);
+        for (int i = 0; i < loops; ++i) {
+            sk_sp<SkVertices> vertices = stroker.strokeVertices(fPath);
+        }
+    }
+
+private:
+    SkPath        fPath;
+    SkPaint::Join fJoin;
+    SkString      fName;
+};
+
+DEF_BENCH(return new PolylineVerticesBench(SkPaint::kMiter_Join);)
+DEF_BENCH(return new PolylineVerticesBench(SkPaint::kRound_Join);)
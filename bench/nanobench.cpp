@@ -1454,6 +1454,7 @@ int main(int argc, char** argv) {
     // loaded, so we won't be able to capture a delta for them.
     log.beginObject("results");
     RunSkSLModuleBenchmarks(&log);
+    RunSkSLRasterPipelineFusionBenchmarks(&log);
 
     int runs = 0;
     BenchmarkStream benchStream;
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkColorTransform_DEFINED
+#define SkColorTransform_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkTArray.h"
+#include "modules/skcms/skcms.h"
+
+#include <cstddef>
+#include <utility>
+
+class SkColorSpace;
+class SkPixmap;
+
+/**
+ *  A color transform between two profiles, for converting many images (e.g. every decoded image
+ *  from a camera's CMYK or Display P3 profile to sRGB). The source profile is parsed once, and
+ *  transforms are cached by profile, so making the same transform again is a lookup.
+ *
+ *  apply() converts one pixmap, in bands of rows on SkTaskGroup's default executor.
+ */
+class SK_API SkColorTransform : public SkNVRefCnt<SkColorTransform> {
+public:
+    enum class Mode {
+        // Evaluates every curve, matrix and CLUT of both profiles for each pixel.
+        kExact,
+        // For A2B (CLUT-based) profiles, samples the transform once into a dense grid (33^3 to
+        // 41^3 points for RGB sources, 17^4 for CMYK), lined up with the profile's own CLUT, and
+        // interpolates it tetrahedrally. As in an ICC A2B transform, the source's "A" curves shape
+        // each input before the lookup, and the grid holds linear values that the destination's
+        // TRC encodes afterwards; 8-bit sources that aren't premultiplied skip straight to the
+        // lookup. The grid is checked against the exact transform when it is made, and if it is
+        // ever more than three 8-bit steps off, the transform stays exact (isBaked() is false).
+        // Source values are clamped to [0, 1]. Matrix/TRC profiles, which are cheaper to convert
+        // exactly, and sources that are neither RGB nor CMYK are always converted exactly.
+        kBaked,
+    };
+
+    /**
+     *  Returns a transform from the ICC profile to dst (sRGB if null), or null if the profile
+     *  can't be parsed. The profile may have more than three channels (e.g. CMYK).
+     */
+    static sk_sp<SkColorTransform> MakeFromICC(sk_sp<SkData> srcICC, sk_sp<SkColorSpace> dst,
+                                               Mode = Mode::kExact);
+
+    /** Returns a transform from src to dst; either may be null, meaning sRGB. */
+    static sk_sp<SkColorTransform> Make(sk_sp<SkColorSpace> src, sk_sp<SkColorSpace> dst,
+                                        Mode = Mode::kExact);
+
+    bool isBaked() const { return !fLUT.empty(); }
+
+    /**
+     *  Converts src, whose pixels are in this transform's source profile, into dst, whose pixels
+     *  are in its destination profile, regardless of the pixmaps' own color spaces. Color types
+     *  may differ, and alpha is converted according to each pixmap's alpha type.
+     *
+     *  Returns false if the pixmaps differ in size or either color type is not supported.
+     */
+    bool apply(const SkPixmap& dst, const SkPixmap& src) const;
+
+    // Drops every cached transform; for tests.
+    static void PurgeCache();
+
+private:
+    SkColorTransform(sk_sp<SkData> srcICC, const skcms_ICCProfile& src,
+                     const skcms_ICCProfile& dst)
+            : fSrcICC(std::move(srcICC)), fSrcProfile(src), fDstProfile(dst) {}
+
+    // Fills in fLUT, fShapers and fByteCoords, if the source is an RGB or CMYK A2B profile and
+    // the result is close enough to the exact transform.
+    void bake();
+
+    // Converts count pixels through fLUT.
+    bool transformBaked(const void* src, skcms_PixelFormat srcFormat, skcms_AlphaFormat srcAlpha,
+                        size_t srcBpp, void* dst, skcms_PixelFormat dstFormat,
+                        skcms_AlphaFormat dstAlpha, size_t dstBpp, size_t count) const;
+
+    // fSrcProfile may point into fSrcICC.
+    sk_sp<SkData>    fSrcICC;
+    skcms_ICCProfile fSrcProfile;
+    skcms_ICCProfile fDstProfile;
+    // fDstProfile with a linear TRC, which baked transforms convert to.
+    skcms_ICCProfile fLinearDstProfile;
+
+    // When baked, fLUT holds the transform sampled at fGridPoints^fLUTInputs points, as unclamped
+    // linear RGBx floats in the destination gamut, with the first input varying slowest.
+    // fShapers holds each input's "A" curve tabulated as grid coordinates, applied before the
+    // lookup.
+    skia_private::TArray<float> fLUT;
+    skia_private::TArray<float> fShapers;
+    // The grid coordinate of each byte value along each input, for 8-bit sources.
+    skia_private::TArray<float> fByteCoords;
+    int                         fLUTInputs = 0;
+    int                         fGridPoints = 0;
+};
+
+#endif
@@ -88,6 +88,10 @@ private:
     ~SkContourMeasure() override {}
 
     const Segment* distanceToSegment(SkScalar distance, SkScalar* t) const;
+    // index must be that of the first segment that ends at or after distance.
+    const Segment* indexToSegment(int index, SkScalar distance, SkScalar* t) const;
+    void segmentTo(const Segment* seg, SkScalar startT, const Segment* stopSeg, SkScalar stopT,
+                   SkPath* dst, bool startWithMoveTo) const;
 
     friend class SkContourMeasureIter;
     friend class SkPathMeasurePriv;
@@ -126,6 +126,14 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  These functions get/set the memory usage limit for the cache of stroked paths, which lets
+     *  non-volatile paths that are stroked the same way repeatedly (e.g. every frame) skip the
+     *  stroker. Zero is the default value, meaning strokes are never cached.
+     */
+    static size_t GetStrokeCacheByteLimit();
+    static size_t SetStrokeCacheByteLimit(size_t newLimit);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -134,7 +142,7 @@ public:
 
     /**
      *  Free as much globally cached memory as possible. This will purge all private caches in Skia,
-     *  including font and image caches.
+     *  including font, image and stroke caches.
      *
      *  If there are caches associated with GPU context, those will not be affected by this call.
      */
@@ -24,6 +24,7 @@
 #include "include/private/base/SkTo.h"
 #include "include/private/base/SkTypeTraits.h"
 #include "include/sksl/SkSLDebugTrace.h"
+#include "include/sksl/SkSLProfile.h"
 #include "include/sksl/SkSLVersion.h"
 
 #include <cstddef>
@@ -36,6 +37,8 @@
 #include <utility>
 #include <vector>
 
+class SkArenaAlloc;
+class SkExecutor;
 struct SkIPoint;
 
 namespace SkSL {
@@ -127,6 +130,13 @@ public:
         // painted.)
         bool forceUnoptimized = false;
 
+        // On the CPU backend, compiles variants of the effect with its uniform values folded in as
+        // constants, so that expressions and branches that depend on them become static. A set of
+        // uniform values is specialized once it has been drawn a few times, and variants are kept
+        // for a few of the most recently drawn sets. This helps effects that are drawn many times
+        // with few distinct uniform values, and costs a compile per set.
+        bool specializeUniforms = false;
+
     private:
         friend class SkRuntimeEffect;
         friend class SkRuntimeEffectPriv;
@@ -181,6 +191,16 @@ public:
         return MakeForBlender(std::move(sksl), Options{});
     }
 
+    // Compiles every string in `sksl` with `make` (MakeForColorFilter, MakeForShader or
+    // MakeForBlender), spreading the work across `executor`. If `executor` is null, the default
+    // SkExecutor is used. The results are returned in the same order as `sksl`. This is intended
+    // for warming up many effects at once; built-in SkSL modules are shared between the worker
+    // threads, and each compile otherwise runs independently.
+    static std::vector<Result> MakeBatch(Result (*make)(SkString sksl, const Options&),
+                                         SkSpan<const SkString> sksl,
+                                         const Options& options,
+                                         SkExecutor* executor = nullptr);
+
     // Object that allows passing a SkShader, SkColorFilter or SkBlender as a child
     class SK_API ChildPtr {
     public:
@@ -243,6 +263,46 @@ public:
     };
     static TracedShader MakeTraced(sk_sp<SkShader> shader, const SkIPoint& traceCoord);
 
+    /**
+     * Creates a new Runtime Effect patterned after an already-existing one. The new shader behaves
+     * like the original, but counts how often each raster pipeline stage of its program runs, and
+     * samples how long each stage takes. Stages are mapped back to the SkSL lines that generated
+     * them. Call `dump` on the profile for a histogram of the hottest lines and stages, or export
+     * it with `writeJSON` or `writePerfettoTrace`.
+     *
+     * Profiling adds overhead to every stage, so absolute times are inflated; compare the relative
+     * cost of lines within a profile. Times are sampled on one of every `sampleInterval` runs of
+     * the program (a run covers a handful of pixels); invocation counts are always exact.
+     *
+     * Profiles are only supported on shaders drawn to a raster (non-GPU) canvas, from one thread
+     * at a time. The profiled program skips uniform specialization.
+     */
+    struct ProfiledShader {
+        sk_sp<SkShader> shader;
+        sk_sp<SkSL::Profile> profile;
+    };
+    static ProfiledShader MakeProfiled(sk_sp<SkShader> shader, int sampleInterval = 1);
+
+    /**
+     * Abstract interface to a cache of programs compiled for the raster (non-GPU) backend. With a
+     * cache installed, an effect seen by an earlier process can skip the SkSL inliner and code
+     * generator when it is first drawn. Like GrContextOptions::PersistentCache, keys and data are
+     * opaque blobs, and loaded data is trusted: `load` must only return what `store` was given.
+     */
+    class SK_API PersistentCache {
+    public:
+        virtual ~PersistentCache() = default;
+
+        // Returns the data stored for `key`, or null if there is none.
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
+    // Installs a process-wide cache, or removes it when passed null. The cache may be called from
+    // any thread, and must remain valid until it has been replaced.
+    static void SetPersistentCache(PersistentCache* cache);
+
     // Returns the SkSL source of the runtime effect shader.
     const std::string& source() const;
 
@@ -278,6 +338,7 @@ private:
         kAlwaysOpaque_Flag        = 0x040,
         kAlphaUnchanged_Flag      = 0x080,
         kDisableOptimization_Flag = 0x100,
+        kSpecializeUniforms_Flag  = 0x200,
     };
 
     SkRuntimeEffect(std::unique_ptr<SkSL::Program> baseProgram,
@@ -290,6 +351,10 @@ private:
 
     sk_sp<SkRuntimeEffect> makeUnoptimizedClone();
 
+    // Returns the effect's RP program with every uniform replaced by its value in 'uniformData' and
+    // folded into the IR, or null if that isn't possible.
+    std::unique_ptr<SkSL::RP::Program> makeSpecializedRPProgram(const float* uniformData) const;
+
     static Result MakeFromSource(SkString sksl, const Options& options, SkSL::ProgramKind kind);
 
     static Result MakeInternal(std::unique_ptr<SkSL::Program> program,
@@ -307,6 +372,13 @@ private:
 
     const SkSL::RP::Program* getRPProgram(SkSL::DebugTracePriv* debugTrace) const;
 
+    // Returns a variant of 'program' (from getRPProgram) with '*uniforms' folded in, and clears
+    // '*uniforms', if the effect specializes uniforms, has drawn with these values often enough,
+    // and that variant compiles; 'alloc' keeps it alive. Otherwise returns 'program'.
+    const SkSL::RP::Program* specializeRPProgram(const SkSL::RP::Program* program,
+                                                 SkSpan<const float>* uniforms,
+                                                 SkArenaAlloc* alloc) const;
+
     friend class GrSkSLFP;              // usesColorTransform
     friend class SkRuntimeShader;       // fBaseProgram, fMain, fSampleUsages, getRPProgram()
     friend class SkRuntimeBlender;      //
@@ -325,6 +397,10 @@ private:
     std::vector<Child> fChildren;
     std::vector<SkSL::SampleUsage> fSampleUsages;
 
+    // Only allocated when the effect specializes uniforms.
+    struct SpecializationCache;
+    std::unique_ptr<SpecializationCache> fSpecializations;
+
     uint32_t fFlags;  // Flags
 };
 
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2024 Google LLC.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_PROFILE
+#define SKSL_PROFILE
+
+#include "include/core/SkRefCnt.h"
+
+class SkWStream;
+
+namespace SkSL {
+
+class Profile : public SkRefCnt {
+public:
+    /**
+     * Serializes the profile to JSON: the SkSL source, and the invocation count and sampled time
+     * of every raster pipeline stage, along with the source line that generated it.
+     */
+    virtual void writeJSON(SkWStream* w) const = 0;
+
+    /**
+     * Writes the profile as a trace in the Chrome JSON trace-event format, which can be opened
+     * in the Perfetto UI. Each source line becomes a slice, subdivided into the stages it ran.
+     */
+    virtual void writePerfettoTrace(SkWStream* w) const = 0;
+
+    /** Generates a human-readable histogram of the hottest source lines and stages. */
+    virtual void dump(SkWStream* o) const = 0;
+};
+
+} // namespace SkSL
+
+#endif
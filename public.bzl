@@ -41,6 +41,7 @@ SKIA_PUBLIC_HDRS = [
     "include/core/SkColorPriv.h",
     "include/core/SkColorSpace.h",
     "include/core/SkColorTable.h",
+    "include/core/SkColorTransform.h",
     "include/core/SkColorType.h",
     "include/core/SkContourMeasure.h",
     "include/core/SkCoverageMode.h",
@@ -210,6 +211,7 @@ SKIA_PUBLIC_HDRS = [
     "include/ports/SkTypeface_win.h",
     # We do not want clients to directly include our private headers, so we exclude include/private
     "include/sksl/SkSLDebugTrace.h",
+    "include/sksl/SkSLProfile.h",
     "include/sksl/SkSLVersion.h",
     "include/utils/SkCanvasStateUtils.h",
     "include/utils/SkCustomTypeface.h",
@@ -407,6 +409,7 @@ BASE_SRCS_ALL = [
     "src/core/SkBlitter_A8.h",
     "src/core/SkBlitter_ARGB32.cpp",
     "src/core/SkBlitter_Sprite.cpp",
+    "src/core/SkBlurEngine.cpp",
     "src/core/SkBlurEngine.h",
     "src/core/SkBlurMask.cpp",
     "src/core/SkBlurMask.h",
@@ -433,6 +436,9 @@ BASE_SRCS_ALL = [
     "src/core/SkColorSpaceXformSteps.cpp",
     "src/core/SkColorSpaceXformSteps.h",
     "src/core/SkColorTable.cpp",
+    "src/core/SkColorTransform.cpp",
+    "src/core/SkCompactPath.cpp",
+    "src/core/SkCompactPath.h",
     "src/core/SkCompressedDataUtils.cpp",
     "src/core/SkCompressedDataUtils.h",
     "src/core/SkContourMeasure.cpp",
@@ -474,6 +480,7 @@ BASE_SRCS_ALL = [
     "src/core/SkEffectPriv.h",
     "src/core/SkEnumerate.h",
     "src/core/SkExecutor.cpp",
+    "src/core/SkExecutorPriv.h",
     "src/core/SkFDot6.h",
     "src/core/SkFlattenable.cpp",
     "src/core/SkFont.cpp",
@@ -594,6 +601,8 @@ BASE_SRCS_ALL = [
     "src/core/SkPoint.cpp",
     "src/core/SkPoint3.cpp",
     "src/core/SkPointPriv.h",
+    "src/core/SkPolylineStroker.cpp",
+    "src/core/SkPolylineStroker.h",
     "src/core/SkPtrRecorder.cpp",
     "src/core/SkPtrRecorder.h",
     "src/core/SkQuadClipper.cpp",
@@ -634,6 +643,8 @@ BASE_SRCS_ALL = [
     "src/core/SkRegion.cpp",
     "src/core/SkRegionPriv.h",
     "src/core/SkRegion_path.cpp",
+    "src/core/SkResizePixels.cpp",
+    "src/core/SkResizePixels.h",
     "src/core/SkResourceCache.cpp",
     "src/core/SkResourceCache.h",
     "src/core/SkRuntimeBlender.cpp",
@@ -673,6 +684,8 @@ BASE_SRCS_ALL = [
     "src/core/SkStringUtils.h",
     "src/core/SkStroke.cpp",
     "src/core/SkStroke.h",
+    "src/core/SkStrokeCache.cpp",
+    "src/core/SkStrokeCache.h",
     "src/core/SkStrokeRec.cpp",
     "src/core/SkStrokerPriv.cpp",
     "src/core/SkStrokerPriv.h",
@@ -1672,6 +1685,8 @@ BASE_SRCS_ALL = [
     "src/sksl/tracing/SkSLDebugTracePlayer.h",
     "src/sksl/tracing/SkSLDebugTracePriv.cpp",
     "src/sksl/tracing/SkSLDebugTracePriv.h",
+    "src/sksl/tracing/SkSLProfilePriv.cpp",
+    "src/sksl/tracing/SkSLProfilePriv.h",
     "src/sksl/tracing/SkSLTraceHook.cpp",
     "src/sksl/tracing/SkSLTraceHook.h",
     "src/sksl/transform/SkSLAddConstToVarModifiers.cpp",
@@ -1688,6 +1703,7 @@ BASE_SRCS_ALL = [
     "src/sksl/transform/SkSLProgramWriter.h",
     "src/sksl/transform/SkSLRenamePrivateSymbols.cpp",
     "src/sksl/transform/SkSLReplaceConstVarsWithLiterals.cpp",
+    "src/sksl/transform/SkSLReplaceVariablesWithConstants.cpp",
     "src/sksl/transform/SkSLRewriteIndexedSwizzle.cpp",
     "src/sksl/transform/SkSLTransform.h",
     "src/text/GlyphRun.cpp",
@@ -1762,6 +1778,7 @@ BASE_SRCS_ALL = [
     "src/utils/SkShadowTessellator.cpp",
     "src/utils/SkShadowTessellator.h",
     "src/utils/SkShadowUtils.cpp",
+    "src/utils/SkShadowUtilsPriv.h",
     "src/utils/SkTextUtils.cpp",
     "src/xps/SkXPSDevice.cpp",
     "src/xps/SkXPSDevice.h",
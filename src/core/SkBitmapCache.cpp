@@ -301,7 +301,10 @@ const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCa
         return nullptr;
     }
 
-    SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache));
+    // Raster images already own their pixels, so holding on to them until the sampler reaches
+    // the smaller levels costs nothing.
+    SkMipmap* mipmap = image->isRasterBacked() ? SkMipmap::BuildLazy(src, get_fact(localCache))
+                                               : SkMipmap::Build(src, get_fact(localCache));
     if (mipmap) {
         MipMapRec* rec = new MipMapRec(SkBitmapCacheDesc::Make(image), mipmap);
         CHECK_LOCAL(localCache, add, Add, rec);
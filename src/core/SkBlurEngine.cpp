@@ -0,0 +1,797 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkBlurEngine.h"
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkTileMode.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/base/SkNoDestructor.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE1
+    #include <xmmintrin.h>
+    #define SK_PREFETCH(ptr) _mm_prefetch(reinterpret_cast<const char*>(ptr), _MM_HINT_T0)
+#elif defined(__GNUC__)
+    #define SK_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+    #define SK_PREFETCH(ptr)
+#endif
+
+namespace {
+
+// TODO(b/294575803): Provide a more accurate CPU implementation at s<2, at which point the notion
+// of an identity sigma can be consolidated between the different functions.
+// This is defined by the SVG spec:
+// https://drafts.fxtf.org/filter-effects/#feGaussianBlurElement
+int calculate_window(double sigma) {
+    auto possibleWindow = static_cast<int>(floor(sigma * 3 * sqrt(2 * SK_DoublePI) / 4 + 0.5));
+    return std::max(1, possibleWindow);
+}
+
+// Above this sigma, images are blurred at a lower resolution and then upscaled. This keeps the
+// window of the box filters small, and cuts the number of pixels that go through them.
+static constexpr float kMaxUnscaledSigma = 32.f;
+
+class Pass {
+public:
+    explicit Pass(int border) : fBorder(border) {}
+    virtual ~Pass() = default;
+
+    void blur(int srcLeft, int srcRight, int dstRight,
+              const uint32_t* src, int srcStride,
+              uint32_t* dst, int dstStride) {
+        this->startBlur();
+
+        auto srcStart = srcLeft - fBorder,
+                srcEnd   = srcRight - fBorder,
+                dstEnd   = dstRight,
+                srcIdx   = srcStart,
+                dstIdx   = 0;
+
+        const uint32_t* srcCursor = src;
+        uint32_t* dstCursor = dst;
+
+        if (dstIdx < srcIdx) {
+            // The destination pixels are not effected by the src pixels,
+            // change to zero as per the spec.
+            // https://drafts.fxtf.org/filter-effects/#FilterPrimitivesOverviewIntro
+            int commonEnd = std::min(srcIdx, dstEnd);
+            while (dstIdx < commonEnd) {
+                *dstCursor = 0;
+                dstCursor += dstStride;
+                SK_PREFETCH(dstCursor);
+                dstIdx++;
+            }
+        } else if (srcIdx < dstIdx) {
+            // The edge of the source is before the edge of the destination. Calculate the sums for
+            // the pixels before the start of the destination.
+            if (int commonEnd = std::min(dstIdx, srcEnd); srcIdx < commonEnd) {
+                // Preload the blur with values from src before dst is entered.
+                int n = commonEnd - srcIdx;
+                this->blurSegment(n, srcCursor, srcStride, nullptr, 0);
+                srcIdx += n;
+                srcCursor += n * srcStride;
+            }
+            if (srcIdx < dstIdx) {
+                // The weird case where src is out of pixels before dst is even started.
+                int n = dstIdx - srcIdx;
+                this->blurSegment(n, nullptr, 0, nullptr, 0);
+                srcIdx += n;
+            }
+        }
+
+        if (int commonEnd = std::min(dstEnd, srcEnd); dstIdx < commonEnd) {
+            // Both srcIdx and dstIdx are in sync now, and can run in a 1:1 fashion. This is the
+            // normal mode of operation.
+            SkASSERT(srcIdx == dstIdx);
+
+            int n = commonEnd - dstIdx;
+            this->blurSegment(n, srcCursor, srcStride, dstCursor, dstStride);
+            srcCursor += n * srcStride;
+            dstCursor += n * dstStride;
+            dstIdx += n;
+            srcIdx += n;
+        }
+
+        // Drain the remaining blur values into dst assuming 0's for the leading edge.
+        if (dstIdx < dstEnd) {
+            int n = dstEnd - dstIdx;
+            this->blurSegment(n, nullptr, 0, dstCursor, dstStride);
+        }
+    }
+
+protected:
+    virtual void startBlur() = 0;
+    virtual void blurSegment(
+            int n, const uint32_t* src, int srcStride, uint32_t* dst, int dstStride) = 0;
+
+private:
+    const int fBorder;
+};
+
+class PassMaker {
+public:
+    explicit PassMaker(int window) : fWindow{window} {}
+    virtual ~PassMaker() = default;
+    virtual Pass* makePass(void* buffer, SkArenaAlloc* alloc) const = 0;
+    virtual size_t bufferSizeBytes() const = 0;
+    int window() const {return fWindow;}
+
+private:
+    const int fWindow;
+};
+
+// Implement a scanline processor that uses a three-box filter to approximate a Gaussian blur.
+// The GaussPass is limit to processing sigmas < 135.
+class GaussPass final : public Pass {
+public:
+    // NB 136 is the largest sigma that will not cause a buffer full of 255 mask values to overflow
+    // using the Gauss filter. It also limits the size of buffers used hold intermediate values.
+    // Explanation of maximums:
+    //   sum0 = window * 255
+    //   sum1 = window * sum0 -> window * window * 255
+    //   sum2 = window * sum1 -> window * window * window * 255 -> window^3 * 255
+    //
+    //   The value window^3 * 255 must fit in a uint32_t. So,
+    //      window^3 < 2^32. window = 255.
+    //
+    //   window = floor(sigma * 3 * sqrt(2 * kPi) / 4 + 0.5)
+    //   For window <= 255, the largest value for sigma is 136.
+    static PassMaker* MakeMaker(double sigma, SkArenaAlloc* alloc) {
+        SkASSERT(0 <= sigma);
+        int window = calculate_window(sigma);
+        if (255 <= window) {
+            return nullptr;
+        }
+
+        class Maker : public PassMaker {
+        public:
+            explicit Maker(int window) : PassMaker{window} {}
+            Pass* makePass(void* buffer, SkArenaAlloc* alloc) const override {
+                return GaussPass::Make(this->window(), buffer, alloc);
+            }
+
+            size_t bufferSizeBytes() const override {
+                int window = this->window();
+                size_t onePassSize = window - 1;
+                // If the window is odd, then there is an obvious middle element. For even sizes
+                // 2 passes are shifted, and the last pass has an extra element. Like this:
+                //       S
+                //    aaaAaa
+                //     bbBbbb
+                //    cccCccc
+                //       D
+                size_t bufferCount = (window & 1) == 1 ? 3 * onePassSize : 3 * onePassSize + 1;
+                return bufferCount * sizeof(skvx::Vec<4, uint32_t>);
+            }
+        };
+
+        return alloc->make<Maker>(window);
+    }
+
+    static GaussPass* Make(int window, void* buffers, SkArenaAlloc* alloc) {
+        // We don't need to store the trailing edge pixel in the buffer;
+        int passSize = window - 1;
+        skvx::Vec<4, uint32_t>* buffer0 = static_cast<skvx::Vec<4, uint32_t>*>(buffers);
+        skvx::Vec<4, uint32_t>* buffer1 = buffer0 + passSize;
+        skvx::Vec<4, uint32_t>* buffer2 = buffer1 + passSize;
+        // If the window is odd just one buffer is needed, but if it's even, then there is one
+        // more element on that pass.
+        skvx::Vec<4, uint32_t>* buffersEnd = buffer2 + ((window & 1) ? passSize : passSize + 1);
+
+        // Calculating the border is tricky. The border is the distance in pixels between the first
+        // dst pixel and the first src pixel (or the last src pixel and the last dst pixel).
+        // I will go through the odd case which is simpler, and then through the even case. Given a
+        // stack of filters seven wide for the odd case of three passes.
+        //
+        //        S
+        //     aaaAaaa
+        //     bbbBbbb
+        //     cccCccc
+        //        D
+        //
+        // The furthest changed pixel is when the filters are in the following configuration.
+        //
+        //                 S
+        //           aaaAaaa
+        //        bbbBbbb
+        //     cccCccc
+        //        D
+        //
+        // The A pixel is calculated using the value S, the B uses A, and the C uses B, and
+        // finally D is C. So, with a window size of seven the border is nine. In the odd case, the
+        // border is 3*((window - 1)/2).
+        //
+        // For even cases the filter stack is more complicated. The spec specifies two passes
+        // of even filters and a final pass of odd filters. A stack for a width of six looks like
+        // this.
+        //
+        //       S
+        //    aaaAaa
+        //     bbBbbb
+        //    cccCccc
+        //       D
+        //
+        // The furthest pixel looks like this.
+        //
+        //               S
+        //          aaaAaa
+        //        bbBbbb
+        //    cccCccc
+        //       D
+        //
+        // For a window of six, the border value is eight. In the even case the border is 3 *
+        // (window/2) - 1.
+        int border = (window & 1) == 1 ? 3 * ((window - 1) / 2) : 3 * (window / 2) - 1;
+
+        // If the window is odd then the divisor is just window ^ 3 otherwise,
+        // it is window * window * (window + 1) = window ^ 3 + window ^ 2;
+        int window2 = window * window;
+        int window3 = window2 * window;
+        int divisor = (window & 1) == 1 ? window3 : window3 + window2;
+        return alloc->make<GaussPass>(buffer0, buffer1, buffer2, buffersEnd, border, divisor);
+    }
+
+    GaussPass(skvx::Vec<4, uint32_t>* buffer0,
+              skvx::Vec<4, uint32_t>* buffer1,
+              skvx::Vec<4, uint32_t>* buffer2,
+              skvx::Vec<4, uint32_t>* buffersEnd,
+              int border,
+              int divisor)
+        : Pass{border}
+        , fBuffer0{buffer0}
+        , fBuffer1{buffer1}
+        , fBuffer2{buffer2}
+        , fBuffersEnd{buffersEnd}
+        , fDivider(divisor) {}
+
+private:
+    void startBlur() override {
+        skvx::Vec<4, uint32_t> zero = {0u, 0u, 0u, 0u};
+        zero.store(fSum0);
+        zero.store(fSum1);
+        auto half = fDivider.half();
+        skvx::Vec<4, uint32_t>{half, half, half, half}.store(fSum2);
+        sk_bzero(fBuffer0, (fBuffersEnd - fBuffer0) * sizeof(skvx::Vec<4, uint32_t>));
+
+        fBuffer0Cursor = fBuffer0;
+        fBuffer1Cursor = fBuffer1;
+        fBuffer2Cursor = fBuffer2;
+    }
+
+    // GaussPass implements the common three pass box filter approximation of Gaussian blur,
+    // but combines all three passes into a single pass. This approach is facilitated by three
+    // circular buffers the width of the window which track values for trailing edges of each of
+    // the three passes. This allows the algorithm to use more precision in the calculation
+    // because the values are not rounded each pass. And this implementation also avoids a trap
+    // that's easy to fall into resulting in blending in too many zeroes near the edge.
+    //
+    // In general, a window sum has the form:
+    //     sum_n+1 = sum_n + leading_edge - trailing_edge.
+    // If instead we do the subtraction at the end of the previous iteration, we can just
+    // calculate the sums instead of having to do the subtractions too.
+    //
+    //      In previous iteration:
+    //      sum_n+1 = sum_n - trailing_edge.
+    //
+    //      In this iteration:
+    //      sum_n+1 = sum_n + leading_edge.
+    //
+    // Now we can stack all three sums and do them at once. Sum0 gets its leading edge from the
+    // actual data. Sum1's leading edge is just Sum0, and Sum2's leading edge is Sum1. So, doing the
+    // three passes at the same time has the form:
+    //
+    //    sum0_n+1 = sum0_n + leading edge
+    //    sum1_n+1 = sum1_n + sum0_n+1
+    //    sum2_n+1 = sum2_n + sum1_n+1
+    //
+    //    sum2_n+1 / window^3 is the new value of the destination pixel.
+    //
+    // Reduce the sums by the trailing edges which were stored in the circular buffers for the
+    // next go around. This is the case for odd sized windows, even windows the the third
+    // circular buffer is one larger then the first two circular buffers.
+    //
+    //    sum2_n+2 = sum2_n+1 - buffer2[i];
+    //    buffer2[i] = sum1;
+    //    sum1_n+2 = sum1_n+1 - buffer1[i];
+    //    buffer1[i] = sum0;
+    //    sum0_n+2 = sum0_n+1 - buffer0[i];
+    //    buffer0[i] = leading edge
+    void blurSegment(
+            int n, const uint32_t* src, int srcStride, uint32_t* dst, int dstStride) override {
+        skvx::Vec<4, uint32_t>* buffer0Cursor = fBuffer0Cursor;
+        skvx::Vec<4, uint32_t>* buffer1Cursor = fBuffer1Cursor;
+        skvx::Vec<4, uint32_t>* buffer2Cursor = fBuffer2Cursor;
+        skvx::Vec<4, uint32_t> sum0 = skvx::Vec<4, uint32_t>::Load(fSum0);
+        skvx::Vec<4, uint32_t> sum1 = skvx::Vec<4, uint32_t>::Load(fSum1);
+        skvx::Vec<4, uint32_t> sum2 = skvx::Vec<4, uint32_t>::Load(fSum2);
+
+        // Given an expanded input pixel, move the window ahead using the leadingEdge value.
+        auto processValue = [&](const skvx::Vec<4, uint32_t>& leadingEdge) {
+            sum0 += leadingEdge;
+            sum1 += sum0;
+            sum2 += sum1;
+
+            skvx::Vec<4, uint32_t> blurred = fDivider.divide(sum2);
+
+            sum2 -= *buffer2Cursor;
+            *buffer2Cursor = sum1;
+            buffer2Cursor = (buffer2Cursor + 1) < fBuffersEnd ? buffer2Cursor + 1 : fBuffer2;
+            sum1 -= *buffer1Cursor;
+            *buffer1Cursor = sum0;
+            buffer1Cursor = (buffer1Cursor + 1) < fBuffer2 ? buffer1Cursor + 1 : fBuffer1;
+            sum0 -= *buffer0Cursor;
+            *buffer0Cursor = leadingEdge;
+            buffer0Cursor = (buffer0Cursor + 1) < fBuffer1 ? buffer0Cursor + 1 : fBuffer0;
+
+            return skvx::cast<uint8_t>(blurred);
+        };
+
+        auto loadEdge = [&](const uint32_t* srcCursor) {
+            return skvx::cast<uint32_t>(skvx::Vec<4, uint8_t>::Load(srcCursor));
+        };
+
+        if (!src && !dst) {
+            while (n --> 0) {
+                (void)processValue(0);
+            }
+        } else if (src && !dst) {
+            while (n --> 0) {
+                (void)processValue(loadEdge(src));
+                src += srcStride;
+            }
+        } else if (!src && dst) {
+            while (n --> 0) {
+                processValue(0u).store(dst);
+                dst += dstStride;
+            }
+        } else if (src && dst) {
+            while (n --> 0) {
+                processValue(loadEdge(src)).store(dst);
+                src += srcStride;
+                dst += dstStride;
+            }
+        }
+
+        // Store the state
+        fBuffer0Cursor = buffer0Cursor;
+        fBuffer1Cursor = buffer1Cursor;
+        fBuffer2Cursor = buffer2Cursor;
+
+        sum0.store(fSum0);
+        sum1.store(fSum1);
+        sum2.store(fSum2);
+    }
+
+    skvx::Vec<4, uint32_t>* const fBuffer0;
+    skvx::Vec<4, uint32_t>* const fBuffer1;
+    skvx::Vec<4, uint32_t>* const fBuffer2;
+    skvx::Vec<4, uint32_t>* const fBuffersEnd;
+    const skvx::ScaledDividerU32 fDivider;
+
+    // blur state
+    char fSum0[sizeof(skvx::Vec<4, uint32_t>)];
+    char fSum1[sizeof(skvx::Vec<4, uint32_t>)];
+    char fSum2[sizeof(skvx::Vec<4, uint32_t>)];
+    skvx::Vec<4, uint32_t>* fBuffer0Cursor;
+    skvx::Vec<4, uint32_t>* fBuffer1Cursor;
+    skvx::Vec<4, uint32_t>* fBuffer2Cursor;
+};
+
+// Runs the same three box filters as GaussPass over F16 pixels. The sums are kept in float, so
+// each box is run over the whole line in turn, in a scratch buffer that is reused between lines.
+class HalfGaussPass {
+public:
+    explicit HalfGaussPass(int window) {
+        if (window & 1) {
+            int r = (window - 1) / 2;
+            fBoxes[0] = fBoxes[1] = fBoxes[2] = {r, r};
+            fInvDivisor = 1.f / ((float)window * window * window);
+        } else {
+            // Two boxes of the even window, shifted in opposite directions, and a third box one
+            // pixel wider; see GaussPass::Make().
+            int r = window / 2;
+            fBoxes[0] = {r, r - 1};
+            fBoxes[1] = {r - 1, r};
+            fBoxes[2] = {r, r};
+            fInvDivisor = 1.f / ((float)window * window * (window + 1));
+        }
+        fBorder = fBoxes[0].fLeft + fBoxes[1].fLeft + fBoxes[2].fLeft;
+    }
+
+    // Same arguments as Pass::blur().
+    void blur(int srcLeft, int srcRight, int dstRight,
+              const uint64_t* src, int srcStride,
+              uint64_t* dst, int dstStride) {
+        // fLine[i] holds the value at position i - fBorder, so it covers every position that
+        // affects [0, dstRight).
+        const int length = dstRight + 2 * fBorder;
+        fLine.resize(2 * length);
+        skvx::float4* line = fLine.data();
+        skvx::float4* tmp = line + length;
+
+        std::fill(line, line + length, skvx::float4(0.f));
+        const int start = std::max(srcLeft, -fBorder);
+        const int end = std::min(srcRight, dstRight + fBorder);
+        for (int pos = start; pos < end; ++pos) {
+            line[pos + fBorder] = skvx::from_half(
+                    skvx::Vec<4, uint16_t>::Load(src + (ptrdiff_t)(pos - srcLeft) * srcStride));
+        }
+
+        box(line, tmp, length, fBoxes[0]);
+        box(tmp, line, length, fBoxes[1]);
+        box(line, tmp, length, fBoxes[2]);
+
+        for (int i = 0; i < dstRight; ++i) {
+            skvx::to_half(tmp[i + fBorder] * fInvDivisor).store(dst + (ptrdiff_t)i * dstStride);
+        }
+    }
+
+private:
+    struct Box {
+        int fLeft;
+        int fRight;
+    };
+
+    // dst[i] = src[i - box.fLeft] + ... + src[i + box.fRight], with zeros beyond the ends.
+    static void box(const skvx::float4* src, skvx::float4* dst, int length, Box box) {
+        skvx::float4 sum = 0.f;
+        for (int i = 0; i < std::min(box.fRight, length); ++i) {
+            sum += src[i];
+        }
+        for (int i = 0; i < length; ++i) {
+            if (i + box.fRight < length) {
+                sum += src[i + box.fRight];
+            }
+            dst[i] = sum;
+            if (i - box.fLeft >= 0) {
+                sum -= src[i - box.fLeft];
+            }
+        }
+    }
+
+    Box fBoxes[3];
+    int fBorder;
+    float fInvDivisor;
+    skia_private::TArray<skvx::float4> fLine;
+};
+
+// Blurs the pixels of src, which sit at srcBounds, into a new bitmap covering dstBounds; both are
+// in the same coordinate space, and src is treated as transparent outside of srcBounds. The X pass
+// blurs from src into dst, and the Y pass then blurs dst in place. Each band of lines gets its own
+// pass, made by makePassX(alloc) or makePassY(alloc).
+template <typename Pixel, typename MakePassX, typename MakePassY>
+SkBitmap blur_unscaled(SkSize sigma, const SkPixmap& src, SkIRect srcBounds, SkIRect dstBounds,
+                       MakePassX&& makePassX, MakePassY&& makePassY) {
+    SkASSERT(src.width() == srcBounds.width() && src.height() == srcBounds.height());
+    SkASSERT(src.info().bytesPerPixel() == sizeof(Pixel));
+
+    const bool blurX = calculate_window(sigma.width()) > 1;
+    const bool blurY = calculate_window(sigma.height()) > 1;
+
+    auto originalDstBounds = dstBounds;
+    if (blurX && blurY) {
+        // Inflate the dst by the window required for the Y pass so that the X pass can prepare it.
+        // The Y pass will be offset to only write to the original rows in dstBounds, but its window
+        // will access these extra rows calculated by the X pass. We make one slightly larger image
+        // to hold this extra data instead of two separate images sized exactly to each pass
+        // because the blur can write in place.
+        dstBounds.outset(0, SkScalarCeilToInt(3 * sigma.height()));
+    }
+
+    SkBitmap dst;
+    const SkIPoint dstOrigin = dstBounds.topLeft();
+    if (!dst.tryAllocPixels(src.info().makeWH(dstBounds.width(), dstBounds.height()))) {
+        return {};
+    }
+    dst.eraseColor(SK_ColorTRANSPARENT);
+
+    auto pixelsAt = [](const SkPixmap& pm, int x, int y) {
+        return static_cast<Pixel*>(pm.writable_addr(x, y));
+    };
+    auto stride = [](const SkPixmap& pm) { return SkToInt(pm.rowBytes() / sizeof(Pixel)); };
+
+    if (!blurX && !blurY) {
+        // Both sigmas are too small to blur, so just copy the overlapping pixels.
+        SkIRect overlap;
+        if (overlap.intersect(srcBounds, dstBounds)) {
+            SkPixmap srcSubset;
+            SkAssertResult(src.extractSubset(&srcSubset,
+                                             overlap.makeOffset(-srcBounds.topLeft())));
+            dst.writePixels(srcSubset, overlap.left() - dstOrigin.x(), overlap.top() - dstOrigin.y());
+        }
+        return dst;
+    }
+
+    SkPixmap srcPixels = src;
+    SkPixmap dstPixels = dst.pixmap();
+
+    // Initialize these assuming the Y-only case
+    int loopStart  = std::max(srcBounds.left(),  dstBounds.left());
+    int loopEnd    = std::min(srcBounds.right(), dstBounds.right());
+    int dstYOffset = 0;
+
+    if (blurX) {
+        // First an X-only blur from src into dst, including the extra rows that will become input
+        // for the second Y pass, which will then be performed in place.
+        loopStart = std::max(srcBounds.top(),    dstBounds.top());
+        loopEnd   = std::min(srcBounds.bottom(), dstBounds.bottom());
+
+        SkTaskGroup::ForEachBand(loopEnd - loopStart, dstBounds.width(), [&](int first, int end) {
+            SkSTArenaAlloc<1024> alloc;
+            auto pass = makePassX(&alloc);
+            for (int y = loopStart + first; y < loopStart + end; ++y) {
+                pass->blur(srcBounds.left()  - dstBounds.left(),
+                           srcBounds.right() - dstBounds.left(),
+                           dstBounds.width(),
+                           pixelsAt(srcPixels, 0, y - srcBounds.top()), 1,
+                           pixelsAt(dstPixels, 0, y - dstBounds.top()), 1);
+            }
+        });
+
+        // Set up the Y pass to blur from the full dst into the non-outset portion of dst
+        srcPixels = dstPixels;
+        srcBounds = dstBounds;
+        loopStart = originalDstBounds.left();
+        loopEnd   = originalDstBounds.right();
+        dstYOffset = originalDstBounds.top() - dstBounds.top();
+        dstBounds = originalDstBounds;
+    }
+
+    // Iterate over each column to calculate 1D blur along Y. This is either blurring from src into
+    // dst for a 1D blur; or it's blurring from dst into dst for the second pass of a 2D blur.
+    if (blurY) {
+        SkTaskGroup::ForEachBand(loopEnd - loopStart, dstBounds.height(), [&](int first, int end) {
+            SkSTArenaAlloc<1024> alloc;
+            auto pass = makePassY(&alloc);
+            for (int x = loopStart + first; x < loopStart + end; ++x) {
+                pass->blur(srcBounds.top()    - dstBounds.top(),
+                           srcBounds.bottom() - dstBounds.top(),
+                           dstBounds.height(),
+                           pixelsAt(srcPixels, x - srcBounds.left(), 0), stride(srcPixels),
+                           pixelsAt(dstPixels, x - dstBounds.left(), dstYOffset), stride(dstPixels));
+            }
+        });
+    }
+
+    originalDstBounds.offset(-dstOrigin); // Make relative to dst's pixels
+    SkBitmap result;
+    SkAssertResult(dst.extractSubset(&result, originalDstBounds));
+    return result;
+}
+
+SkBitmap blur_unscaled(SkSize sigma, const SkPixmap& src, SkIRect srcBounds, SkIRect dstBounds) {
+    SkASSERT(sigma.width() <= kMaxUnscaledSigma && sigma.height() <= kMaxUnscaledSigma);
+
+    if (src.colorType() == kRGBA_F16_SkColorType || src.colorType() == kRGBA_F16Norm_SkColorType) {
+        auto makePass = [](float sigma) {
+            return [window = calculate_window(sigma)](SkArenaAlloc* alloc) {
+                return alloc->make<HalfGaussPass>(window);
+            };
+        };
+        return blur_unscaled<uint64_t>(sigma, src, srcBounds, dstBounds,
+                                       makePass(sigma.width()), makePass(sigma.height()));
+    }
+
+    SkASSERT(src.colorType() == kRGBA_8888_SkColorType ||
+             src.colorType() == kBGRA_8888_SkColorType);
+    SkSTArenaAlloc<256> makerAlloc;
+    auto makePass = [&makerAlloc](float sigma) {
+        // kMaxUnscaledSigma is well within the range of GaussPass.
+        PassMaker* maker = GaussPass::MakeMaker(sigma, &makerAlloc);
+        SkASSERT(maker);
+        return [maker](SkArenaAlloc* alloc) {
+            void* buffer = alloc->makeBytesAlignedTo(maker->bufferSizeBytes(),
+                                                     alignof(skvx::Vec<4, uint32_t>));
+            return maker->makePass(buffer, alloc);
+        };
+    };
+    return blur_unscaled<uint32_t>(sigma, src, srcBounds, dstBounds,
+                                   makePass(sigma.width()), makePass(sigma.height()));
+}
+
+// Loads and stores premultiplied pixels of either supported color type as floats.
+skvx::float4 load_pixel(SkColorType ct, const void* addr) {
+    if (ct == kRGBA_F16_SkColorType || ct == kRGBA_F16Norm_SkColorType) {
+        return skvx::from_half(skvx::Vec<4, uint16_t>::Load(addr));
+    }
+    return skvx::cast<float>(skvx::Vec<4, uint8_t>::Load(addr)) * (1 / 255.f);
+}
+
+void store_pixel(SkColorType ct, const skvx::float4& px, void* addr) {
+    if (ct == kRGBA_F16_SkColorType || ct == kRGBA_F16Norm_SkColorType) {
+        skvx::to_half(px).store(addr);
+    } else {
+        skvx::cast<uint8_t>(skvx::pin(px * 255.f + 0.5f, skvx::float4(0.f), skvx::float4(255.f)))
+                .store(addr);
+    }
+}
+
+int floor_div(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+int ceil_div(int a, int b) { return -floor_div(-a, b); }
+
+// Blurs like blur_unscaled(), but first averages blocks of scale.width() x scale.height() pixels
+// of src, blurs that with a correspondingly smaller sigma, and then upscales the result with
+// bilinear filtering.
+SkBitmap blur_downscaled(SkSize sigma, SkISize scale,
+                         const SkPixmap& src, SkIRect srcBounds, SkIRect dstBounds) {
+    const SkColorType ct = src.colorType();
+    const int sx = scale.width();
+    const int sy = scale.height();
+
+    // The low resolution source covers every block that touches srcBounds.
+    SkIRect lowSrcBounds = SkIRect::MakeLTRB(floor_div(srcBounds.left(), sx),
+                                             floor_div(srcBounds.top(), sy),
+                                             ceil_div(srcBounds.right(), sx),
+                                             ceil_div(srcBounds.bottom(), sy));
+    SkBitmap lowSrc;
+    if (!lowSrc.tryAllocPixels(src.info().makeDimensions(lowSrcBounds.size()))) {
+        return {};
+    }
+    const float invArea = 1.f / (sx * sy);
+    const int lowSrcRowPixels = lowSrcBounds.width() * sx * sy;
+    SkTaskGroup::ForEachBand(lowSrcBounds.height(), lowSrcRowPixels, [&](int first, int end) {
+        for (int y = first; y < end; ++y) {
+            // The rows and columns of src in this block, clipped to srcBounds.
+            const int top = std::max((lowSrcBounds.top() + y) * sy, srcBounds.top());
+            const int bottom = std::min((lowSrcBounds.top() + y + 1) * sy, srcBounds.bottom());
+            for (int x = 0; x < lowSrcBounds.width(); ++x) {
+                const int left = std::max((lowSrcBounds.left() + x) * sx, srcBounds.left());
+                const int right = std::min((lowSrcBounds.left() + x + 1) * sx, srcBounds.right());
+                skvx::float4 sum = 0.f;
+                for (int srcY = top; srcY < bottom; ++srcY) {
+                    for (int srcX = left; srcX < right; ++srcX) {
+                        sum += load_pixel(ct, src.addr(srcX - srcBounds.left(),
+                                                       srcY - srcBounds.top()));
+                    }
+                }
+                store_pixel(ct, sum * invArea, lowSrc.getAddr(x, y));
+            }
+        }
+    });
+
+    // One more low resolution pixel on each side gives the bilinear filter its neighbors.
+    SkIRect lowDstBounds = SkIRect::MakeLTRB(floor_div(dstBounds.left(), sx) - 1,
+                                             floor_div(dstBounds.top(), sy) - 1,
+                                             ceil_div(dstBounds.right(), sx) + 1,
+                                             ceil_div(dstBounds.bottom(), sy) + 1);
+    SkBitmap lowDst = blur_unscaled({sigma.width() / sx, sigma.height() / sy},
+                                    lowSrc.pixmap(), lowSrcBounds, lowDstBounds);
+    if (lowDst.drawsNothing()) {
+        return {};
+    }
+
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(src.info().makeDimensions(dstBounds.size()))) {
+        return {};
+    }
+    const SkPixmap low = lowDst.pixmap();
+    auto lowPixel = [&](int x, int y) {
+        return load_pixel(ct, low.addr(std::clamp(x, 0, low.width() - 1),
+                                       std::clamp(y, 0, low.height() - 1)));
+    };
+    SkTaskGroup::ForEachBand(dstBounds.height(), dstBounds.width(), [&](int first, int end) {
+        for (int y = first; y < end; ++y) {
+            // The center of this pixel, in lowDst's pixel space.
+            const float lowY = (dstBounds.top() + y + 0.5f) / sy - 0.5f - lowDstBounds.top();
+            const int y0 = sk_float_floor2int(lowY);
+            const float fy = lowY - y0;
+            for (int x = 0; x < dstBounds.width(); ++x) {
+                const float lowX = (dstBounds.left() + x + 0.5f) / sx - 0.5f - lowDstBounds.left();
+                const int x0 = sk_float_floor2int(lowX);
+                const float fx = lowX - x0;
+                skvx::float4 top = lowPixel(x0, y0) * (1 - fx) + lowPixel(x0 + 1, y0) * fx;
+                skvx::float4 bottom = lowPixel(x0, y0 + 1) * (1 - fx) +
+                                      lowPixel(x0 + 1, y0 + 1) * fx;
+                store_pixel(ct, top * (1 - fy) + bottom * fy, dst.getAddr(x, y));
+            }
+        }
+    });
+    return dst;
+}
+
+// Returns the power of two that brings sigma down to kMaxUnscaledSigma.
+int downscale_factor(float sigma) {
+    int scale = 1;
+    while (sigma / scale > kMaxUnscaledSigma) {
+        scale *= 2;
+    }
+    return scale;
+}
+
+bool is_supported(SkColorType colorType) {
+    switch (colorType) {
+        // The passes treat each channel the same way, so channel order doesn't matter.
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kRGBA_F16_SkColorType:
+        case kRGBA_F16Norm_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+class RasterBlurAlgorithm : public SkBlurEngine::Algorithm {
+public:
+    // Large sigmas are handled by blurring at a lower resolution.
+    float maxSigma() const override { return SK_FloatInfinity; }
+
+    bool supportsOnlyDecalTiling() const override { return true; }
+
+    sk_sp<SkSpecialImage> blur(SkSize sigma,
+                               sk_sp<SkSpecialImage> src,
+                               const SkIRect& srcRect,
+                               SkTileMode tileMode,
+                               const SkIRect& dstRect) const override {
+        SkASSERT(tileMode == SkTileMode::kDecal);
+        SkASSERT(SkIRect::MakeSize(src->dimensions()).contains(srcRect));
+
+        SkBitmap srcBM;
+        SkPixmap srcPixels;
+        if (!SkSpecialImages::AsBitmap(src.get(), &srcBM) ||
+            !is_supported(srcBM.colorType()) ||
+            !srcBM.pixmap().extractSubset(&srcPixels, srcRect)) {
+            return nullptr;
+        }
+
+        const SkISize scale = {downscale_factor(sigma.width()), downscale_factor(sigma.height())};
+        SkBitmap dst = scale == SkISize{1, 1}
+                ? blur_unscaled(sigma, srcPixels, srcRect, dstRect)
+                : blur_downscaled(sigma, scale, srcPixels, srcRect, dstRect);
+        if (dst.drawsNothing()) {
+            return nullptr;
+        }
+        return SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()), dst,
+                                               src->props());
+    }
+};
+
+class RasterBlurEngine : public SkBlurEngine {
+public:
+    const Algorithm* findAlgorithm(SkSize sigma, SkColorType colorType) const override {
+        return is_supported(colorType) ? &fAlgorithm : nullptr;
+    }
+
+private:
+    RasterBlurAlgorithm fAlgorithm;
+};
+
+}  // anonymous namespace
+
+const SkBlurEngine* SkBlurEngine::GetRasterBlurEngine() {
+    static const SkNoDestructor<RasterBlurEngine> gEngine;
+    return gEngine.get();
+}
+
+bool SkBlurEngine::IsRasterBlurEffectivelyIdentity(float sigma) {
+    return calculate_window(sigma) <= 1;
+}
+
+bool SkBlurEngine::IsRasterBlurDownscaled(float sigma) {
+    return downscale_factor(sigma) > 1;
+}
@@ -37,6 +37,17 @@ public:
 
     virtual ~SkBlurEngine() = default;
 
+    // Returns the engine used by the raster backend, which blurs 8888 and F16 images on the CPU
+    // with separable three-box approximations of a Gaussian.
+    static const SkBlurEngine* GetRasterBlurEngine();
+
+    // The raster engine's box filters are the identity for sigmas below about 0.8.
+    static bool IsRasterBlurEffectivelyIdentity(float sigma);
+
+    // Returns true if the raster engine blurs with 'sigma' at a lower resolution. The downscaled
+    // pixel grid is anchored to the source image, so the result depends on where that image starts.
+    static bool IsRasterBlurDownscaled(float sigma);
+
     // Returns an Algorithm ideal for the requested 'sigma' that will support sampling an image of
     // the given 'colorType'. If the engine does not support the requested configuration, it returns
     // null. The engine maintains the lifetime of its algorithms, so the returned non-null
@@ -24,6 +24,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkStrokeRec.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/private/base/SkAlign.h"
 #include "include/private/base/SkAssert.h"
@@ -239,6 +240,20 @@ static SkCachedData* add_cached_rects(SkMaskBuilder* mask, SkScalar sigma, SkBlu
     return cache;
 }
 
+static SkCachedData* find_cached_convex_path(SkTLazy<SkMask>* mask, SkScalar sigma,
+                                             SkBlurStyle style, const SkPath& path) {
+    return SkMaskCache::FindAndRef(sigma, style, path, mask);
+}
+
+static SkCachedData* add_cached_convex_path(SkMaskBuilder* mask, SkScalar sigma,
+                                            SkBlurStyle style, const SkPath& path) {
+    SkCachedData* cache = copy_mask_to_cacheddata(mask);
+    if (cache) {
+        SkMaskCache::Add(sigma, style, path, *mask, cache);
+    }
+    return cache;
+}
+
 static const bool c_analyticBlurRRect{true};
 
 SkMaskFilterBase::FilterReturn
@@ -503,6 +518,56 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
     return kTrue_FilterReturn;
 }
 
+SkMaskFilterBase::FilterReturn
+SkBlurMaskFilterImpl::filterConvexPath(const SkPath& devPath, const SkMatrix& matrix,
+                                       const SkIRect& clipBounds,
+                                       SkTLazy<CachedMask>* result) const {
+    SkASSERT(result != nullptr);
+    if (!SkMaskCache::CanCacheConvexPath(devPath) ||
+        rect_exceeds(devPath.getBounds(), SkIntToScalar(32767))) {
+        return kUnimplemented_FilterReturn;
+    }
+
+    // The cached mask is the whole blur, which is only what filterPath() would have made if the
+    // path is within the clip; otherwise take the old code path, which clips the mask. Large
+    // paths are left to it as well, to keep their masks out of the cache.
+    static constexpr int kMaxCachedSize = 512;
+    const SkIRect pathBounds = devPath.getBounds().roundOut();
+    if (pathBounds.isEmpty() || !clipBounds.contains(pathBounds) ||
+        pathBounds.width() > kMaxCachedSize || pathBounds.height() > kMaxCachedSize) {
+        return kUnimplemented_FilterReturn;
+    }
+
+    // The cache holds the mask relative to the top-left of the path's bounds.
+    const SkScalar sigma = this->computeXformedSigma(matrix);
+    SkTLazy<SkMask> cachedMask;
+    SkCachedData* cache = find_cached_convex_path(&cachedMask, sigma, fBlurStyle, devPath);
+    if (!cache) {
+        // Draw the path the way filterPath() would, so cached and uncached draws match.
+        SkMaskBuilder srcM, filterM;
+        if (!SkDrawBase::DrawToMask(devPath, clipBounds, this, &matrix, &srcM,
+                                    SkMaskBuilder::kComputeBoundsAndRenderImage_CreateMode,
+                                    SkStrokeRec::kFill_InitStyle)) {
+            return kFalse_FilterReturn;
+        }
+        SkAutoMaskFreeImage amf(srcM.image());
+
+        SkIPoint margin;
+        if (!this->filterMask(&filterM, srcM, matrix, &margin)) {
+            return kFalse_FilterReturn;
+        }
+        filterM.bounds().offset(-pathBounds.fLeft, -pathBounds.fTop);
+        cache = add_cached_convex_path(&filterM, sigma, fBlurStyle, devPath);
+        cachedMask.init(filterM);
+    }
+
+    result->init(SkMask{cachedMask->fImage,
+                        cachedMask->fBounds.makeOffset(pathBounds.fLeft, pathBounds.fTop),
+                        cachedMask->fRowBytes, cachedMask->fFormat},
+                 cache); // transfer ownership to result
+    return kTrue_FilterReturn;
+}
+
 void SkBlurMaskFilterImpl::computeFastBounds(const SkRect& src,
                                              SkRect* dst) const {
     // TODO: if we're doing kInner blur, should we return a different outset?
@@ -16,6 +16,7 @@
 
 class SkImageFilter;
 class SkMatrix;
+class SkPath;
 class SkRRect;
 class SkReadBuffer;
 class SkWriteBuffer;
@@ -54,6 +55,10 @@ private:
                                    const SkIRect& clipBounds,
                                    SkTLazy<NinePatch>*) const override;
 
+    FilterReturn filterConvexPath(const SkPath&, const SkMatrix&,
+                                  const SkIRect& clipBounds,
+                                  SkTLazy<CachedMask>*) const override;
+
     bool filterRectMask(SkMaskBuilder* dstM, const SkRect& r, const SkMatrix& matrix,
                         SkIPoint* margin, SkMaskBuilder::CreateMode createMode) const;
     bool filterRRectMask(SkMaskBuilder* dstM, const SkRRect& r, const SkMatrix& matrix,
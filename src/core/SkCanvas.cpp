@@ -870,7 +870,7 @@ void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
     FilterSpan filtersOrNull = filters.empty() ? FilterSpan{&nullFilter, 1} : filters;
 
     for (const sk_sp<SkImageFilter>& filter : filtersOrNull) {
-        auto result = filter ? as_IFB(filter)->filterImage(ctx) : source;
+        auto result = filter ? skif::FilterResult::FilterInTiles(ctx, filter.get()) : source;
 
         if (srcIsCoverageLayer) {
             SkASSERT(dst->useDrawCoverageMaskForMaskFilters());
@@ -2695,7 +2695,7 @@ void SkCanvas::onDrawImageRect2(const SkImage* image, const SkRect& src, const S
         // and a desired output matching the device clip bounds.
         ctx = ctx.withNewDesiredOutput(mapping.deviceToLayer(outputBounds))
                  .withNewSource(source);
-        auto result = as_IFB(realPaint.getImageFilter())->filterImage(ctx);
+        auto result = skif::FilterResult::FilterInTiles(ctx, realPaint.getImageFilter());
         result.draw(ctx, device, realPaint.getBlender());
         stats.reportStats();
         return;
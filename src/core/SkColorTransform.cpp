@@ -0,0 +1,580 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkColorTransform.h"
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkPixmap.h"
+#include "include/private/base/SkAttributes.h"
+#include "include/private/base/SkMutex.h"
+#include "src/base/SkNoDestructor.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkLRUCache.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+// Baked transforms sample RGB sources at 33^3 to 41^3 points and CMYK sources at 17^4, as
+// chosen by grid_points().
+static constexpr int kGridPoints3D = 33;
+static constexpr int kMaxGridPoints3D = 41;
+static constexpr int kGridPoints4D = 17;
+static constexpr int kMaxGridPoints4D = 17;
+
+// Baked transforms convert pixels to and from floats this many at a time.
+static constexpr int kPixelsPerChunk = 256;
+
+// Baked transforms tabulate the curve that shapes each input at this many points.
+static constexpr int kShaperEntries = 4096;
+
+// A baked transform is checked against the exact one at this many points along each input (a grid
+// offset from the baked one), and discarded if it is ever further off than kMaxBakedError. That is
+// a few 8-bit steps: A2B profiles' CLUTs are interpolated multilinearly rather than tetrahedrally,
+// and nonlinear steps can follow them. HLG, PQ and CMYK profiles bake to within 2.3 steps.
+static constexpr int kCheckPoints3D = 64;
+static constexpr int kCheckPoints4D = 24;
+static constexpr float kMaxBakedError = 3 / 255.f;
+
+// Whether a and b convert identically. SkColorSpace::Equals() only compares hashes in release
+// builds.
+bool same_color_space(const SkColorSpace* a, const SkColorSpace* b) {
+    if (a == b) {
+        return true;
+    }
+    if (!a || !b) {
+        return false;
+    }
+    skcms_TransferFunction aTF, bTF;
+    skcms_Matrix3x3 aXYZ, bXYZ;
+    a->transferFn(&aTF);
+    b->transferFn(&bTF);
+    a->toXYZD50(&aXYZ);
+    b->toXYZD50(&bXYZ);
+    return 0 == memcmp(&aTF, &bTF, sizeof(aTF)) && 0 == memcmp(&aXYZ, &bXYZ, sizeof(aXYZ));
+}
+
+// Transforms are looked up by hash, but matched on their full source and destination, so two
+// profiles that happen to hash alike never share a transform.
+struct TransformKey {
+    TransformKey(sk_sp<SkData> srcICC, sk_sp<SkColorSpace> src, sk_sp<SkColorSpace> dst,
+                 SkColorTransform::Mode mode)
+            : fSrcICC(std::move(srcICC))
+            , fSrc(std::move(src))
+            , fDst(std::move(dst))
+            , fMode(mode) {
+        fHash = fSrcICC ? SkChecksum::Hash32(fSrcICC->data(), fSrcICC->size())
+                        : SkChecksum::Mix((uint32_t)fSrc->hash());
+        fHash = SkChecksum::Mix(fHash ^ (uint32_t)fDst->hash() ^ (uint32_t)fMode);
+    }
+
+    // Exactly one of fSrcICC and fSrc is set.
+    sk_sp<SkData>          fSrcICC;
+    sk_sp<SkColorSpace>    fSrc;
+    sk_sp<SkColorSpace>    fDst;
+    SkColorTransform::Mode fMode;
+    uint32_t               fHash;
+
+    bool operator==(const TransformKey& that) const {
+        return fHash == that.fHash && fMode == that.fMode &&
+               (fSrcICC ? that.fSrcICC && fSrcICC->equals(that.fSrcICC.get()) : !that.fSrcICC) &&
+               same_color_space(fSrc.get(), that.fSrc.get()) &&
+               same_color_space(fDst.get(), that.fDst.get());
+    }
+
+    struct Hash {
+        uint32_t operator()(const TransformKey& key) const { return key.fHash; }
+    };
+};
+
+using TransformCache = SkLRUCache<TransformKey, sk_sp<SkColorTransform>, TransformKey::Hash>;
+
+SkMutex& cache_mutex() {
+    static SkNoDestructor<SkMutex> mutex;
+    return *mutex;
+}
+
+TransformCache& cache() {
+    cache_mutex().assertHeld();
+    static SkNoDestructor<TransformCache> cache(16 /*arbitrary*/);
+    return *cache;
+}
+
+template <typename MakeFn>
+sk_sp<SkColorTransform> find_or_make(const TransformKey& key, MakeFn&& make) {
+    {
+        SkAutoMutexExclusive lock(cache_mutex());
+        if (sk_sp<SkColorTransform>* found = cache().find(key)) {
+            return *found;
+        }
+    }
+    sk_sp<SkColorTransform> transform = make();
+    if (transform) {
+        SkAutoMutexExclusive lock(cache_mutex());
+        cache().insert_or_update(key, transform);
+    }
+    return transform;
+}
+
+bool pixel_format(SkColorType ct, skcms_PixelFormat* format) {
+    switch (ct) {
+        case kRGBA_8888_SkColorType:
+        case kRGB_888x_SkColorType:
+            *format = skcms_PixelFormat_RGBA_8888;
+            return true;
+        case kBGRA_8888_SkColorType:
+            *format = skcms_PixelFormat_BGRA_8888;
+            return true;
+        case kRGB_565_SkColorType:
+            *format = skcms_PixelFormat_BGR_565;
+            return true;
+        case kRGBA_1010102_SkColorType:
+        case kRGB_101010x_SkColorType:
+            *format = skcms_PixelFormat_RGBA_1010102;
+            return true;
+        case kBGRA_1010102_SkColorType:
+        case kBGR_101010x_SkColorType:
+            *format = skcms_PixelFormat_BGRA_1010102;
+            return true;
+        case kGray_8_SkColorType:
+            *format = skcms_PixelFormat_G_8;
+            return true;
+        case kR16G16B16A16_unorm_SkColorType:
+            *format = skcms_PixelFormat_RGBA_16161616LE;
+            return true;
+        case kRGBA_F16Norm_SkColorType:
+            *format = skcms_PixelFormat_RGBA_hhhh_Norm;
+            return true;
+        case kRGBA_F16_SkColorType:
+            *format = skcms_PixelFormat_RGBA_hhhh;
+            return true;
+        case kRGBA_F32_SkColorType:
+            *format = skcms_PixelFormat_RGBA_ffff;
+            return true;
+        default:
+            return false;
+    }
+}
+
+skcms_AlphaFormat alpha_format(const SkPixmap& pm) {
+    switch (pm.alphaType()) {
+        case kUnpremul_SkAlphaType: return skcms_AlphaFormat_Unpremul;
+        case kPremul_SkAlphaType:   return skcms_AlphaFormat_PremulAsEncoded;
+        default:                    return skcms_AlphaFormat_Opaque;
+    }
+}
+
+// Clamps to [0, 1], mapping NaN to 0.
+float pin_unit(float x) {
+    return x > 0 ? std::min(x, 1.f) : 0.f;
+}
+
+// Evaluates a profile's curve as skcms does for A2B curves, with the input and output clamped to
+// [0, 1].
+float eval_curve(const skcms_Curve& curve, float x) {
+    x = pin_unit(x);
+    if (curve.table_entries == 0) {
+        return pin_unit(skcms_TransferFunction_eval(&curve.parametric, x));
+    }
+    auto entry = [&](int i) {
+        return curve.table_8 ? curve.table_8[i] * (1 / 255.f)
+                             : (curve.table_16[2 * i] << 8 | curve.table_16[2 * i + 1]) *
+                                       (1 / 65535.f);
+    };
+    const float ix = x * (curve.table_entries - 1);
+    const int lo = (int)ix,
+              hi = std::min(lo + 1, (int)curve.table_entries - 1);
+    return pin_unit(entry(lo) + (ix - lo) * (entry(hi) - entry(lo)));
+}
+
+// Fills pixels with opaque RGBA_ffff colors at each point of a points^inputs grid, with the last
+// input varying fastest. The points are i / (points - 1) along each input, or the centers of
+// points equal steps when centered is true.
+void fill_grid(skia_private::TArray<float>* pixels, int inputs, int points, bool centered) {
+    int count = 1;
+    for (int i = 0; i < inputs; ++i) {
+        count *= points;
+    }
+    pixels->clear();
+    pixels->push_back_n(4 * count, 1.f);
+    for (int p = 0; p < count; ++p) {
+        for (int i = inputs - 1, index = p; i >= 0; --i, index /= points) {
+            (*pixels)[4 * p + i] = centered ? (index % points + 0.5f) / points
+                                            : (float)(index % points) / (points - 1);
+        }
+    }
+}
+
+// Returns the number of points along each input of a baked LUT for a2b. When a2b's CLUT has the
+// same number of points along each input, the LUT's intervals are a multiple of the CLUT's, so
+// that it samples the CLUT at each of its points, where its multilinear interpolation bends.
+int grid_points(const skcms_A2B& a2b, int inputs, int minPoints, int maxPoints) {
+    if ((int)a2b.input_channels != inputs) {
+        return minPoints;
+    }
+    const int intervals = a2b.grid_points[0] - 1;
+    for (int i = 1; i < inputs; ++i) {
+        if (a2b.grid_points[i] - 1 != intervals) {
+            return minPoints;
+        }
+    }
+    if (intervals < 1) {
+        return minPoints;
+    }
+    const int points = intervals * ((minPoints - 2) / intervals + 1) + 1;
+    return points <= maxPoints ? points : minPoints;
+}
+
+// A tetrahedron of a LUT cell: a walk from the cell's origin to its far corner along the axes in
+// order of decreasing fraction, with s0 and s1 the strides of the first two steps, s the stride to
+// the far corner, and f0 >= f1 >= f2 the fractions along each step's axis.
+struct Tetrahedron {
+    int s0, s1, s;
+    float f0, f1, f2;
+};
+
+// Picks the tetrahedron containing (fr, fg, fb) in a cell whose corners along the three axes are
+// sr, sg and sb floats apart. This is done with selects rather than branches, since neighboring
+// pixels of noisy images fall in different tetrahedra.
+SK_ALWAYS_INLINE Tetrahedron find_tetrahedron(int sr, int sg, int sb,
+                                               float fr, float fg, float fb) {
+    const int rg = fr > fg,
+              gb = fg > fb,
+              rb = fr > fb;
+    const int first = (rg & rb) * sr + (!rg & gb) * sg + (!(rg & rb) & !(!rg & gb)) * sb,
+              last = (!rg & !rb) * sr + (rg & !gb) * sg + ((rg & gb) | (!rg & rb)) * sb;
+    const float f0 = std::max(fr, std::max(fg, fb)),
+                f2 = std::min(fr, std::min(fg, fb));
+    return {first, sr + sg + sb - first - last, sr + sg + sb, f0, fr + fg + fb - f0 - f2, f2};
+}
+
+// Interpolates the LUT cell starting at c within tetrahedron t.
+SK_ALWAYS_INLINE skvx::float4 tetrahedral(const float* c, const Tetrahedron& t) {
+    const skvx::float4 c0 = skvx::float4::Load(c),
+                       c1 = skvx::float4::Load(c + t.s0),
+                       c2 = skvx::float4::Load(c + t.s0 + t.s1),
+                       c3 = skvx::float4::Load(c + t.s);
+    return c0 + t.f0 * (c1 - c0) + t.f1 * (c2 - c1) + t.f2 * (c3 - c2);
+}
+
+// Maps an unpacked input to its grid coordinate through its tabulated shaper.
+SK_ALWAYS_INLINE float shape(const float* shaper, float x) {
+    const float ix = pin_unit(x) * (kShaperEntries - 1);
+    const int lo = std::min((int)ix, kShaperEntries - 2);
+    return shaper[lo] + (ix - lo) * (shaper[lo + 1] - shaper[lo]);
+}
+
+// Converts n pixels in place through a LUT with kInputs inputs and G points along each, laid out
+// with the last input varying fastest. Each pixel holds its grid coordinate along each input,
+// followed by its alpha if it has three inputs. A fourth input (K) is interpolated linearly
+// between two tetrahedral lookups over the first three.
+template <int kInputs>
+void interpolate(float* pixels, size_t n, const float* lut, int G) {
+    const int sk = 4,
+              sb = kInputs == 4 ? sk * G : 4,
+              sg = sb * G,
+              sr = sg * G;
+    const int strides[4] = {sr, sg, sb, sk};
+    for (size_t p = 0; p < n; ++p) {
+        float* px = pixels + 4 * p;
+        int offset = 0;
+        float frac[4];
+        for (int i = 0; i < kInputs; ++i) {
+            const float x = px[i];
+            const int cell = std::min((int)x, G - 2);
+            frac[i] = x - cell;
+            offset += cell * strides[i];
+        }
+
+        // CMYK has no alpha.
+        const float alpha = kInputs == 4 ? 1.f : px[3];
+        const float* cell = lut + offset;
+        const Tetrahedron t = find_tetrahedron(sr, sg, sb, frac[0], frac[1], frac[2]);
+        skvx::float4 color = tetrahedral(cell, t);
+        if constexpr (kInputs == 4) {
+            color += frac[3] * (tetrahedral(cell + sk, t) - color);
+        }
+        color.store(px);
+        px[3] = alpha;
+    }
+}
+
+}  // namespace
+
+sk_sp<SkColorTransform> SkColorTransform::MakeFromICC(sk_sp<SkData> srcICC,
+                                                      sk_sp<SkColorSpace> dst,
+                                                      Mode mode) {
+    if (!srcICC) {
+        return nullptr;
+    }
+    if (!dst) {
+        dst = SkColorSpace::MakeSRGB();
+    }
+    const TransformKey key(srcICC, nullptr, dst, mode);
+    return find_or_make(key, [&]() -> sk_sp<SkColorTransform> {
+        skcms_ICCProfile src, dstProfile;
+        if (!skcms_Parse(srcICC->data(), srcICC->size(), &src)) {
+            return nullptr;
+        }
+        dst->toProfile(&dstProfile);
+        sk_sp<SkColorTransform> transform(new SkColorTransform(std::move(srcICC), src, dstProfile));
+        if (mode == Mode::kBaked) {
+            transform->bake();
+        }
+        return transform;
+    });
+}
+
+sk_sp<SkColorTransform> SkColorTransform::Make(sk_sp<SkColorSpace> src, sk_sp<SkColorSpace> dst,
+                                               Mode mode) {
+    if (!src) {
+        src = SkColorSpace::MakeSRGB();
+    }
+    if (!dst) {
+        dst = SkColorSpace::MakeSRGB();
+    }
+    const TransformKey key(nullptr, src, dst, mode);
+    return find_or_make(key, [&]() {
+        skcms_ICCProfile srcProfile, dstProfile;
+        src->toProfile(&srcProfile);
+        dst->toProfile(&dstProfile);
+        sk_sp<SkColorTransform> transform(new SkColorTransform(nullptr, srcProfile, dstProfile));
+        if (mode == Mode::kBaked) {
+            transform->bake();
+        }
+        return transform;
+    });
+}
+
+void SkColorTransform::PurgeCache() {
+    SkAutoMutexExclusive lock(cache_mutex());
+    cache().reset();
+}
+
+void SkColorTransform::bake() {
+    // Matrix/TRC profiles are cheaper to convert exactly, with or without a LUT.
+    if (!fSrcProfile.has_A2B) {
+        return;
+    }
+    int checkPoints;
+    if (fSrcProfile.data_color_space == skcms_Signature_RGB) {
+        fLUTInputs = 3;
+        fGridPoints = grid_points(fSrcProfile.A2B, 3, kGridPoints3D, kMaxGridPoints3D);
+        checkPoints = kCheckPoints3D;
+    } else if (fSrcProfile.data_color_space == skcms_Signature_CMYK) {
+        fLUTInputs = 4;
+        fGridPoints = grid_points(fSrcProfile.A2B, 4, kGridPoints4D, kMaxGridPoints4D);
+        checkPoints = kCheckPoints4D;
+    } else {
+        return;
+    }
+
+    // As in an ICC A2B transform, each input is shaped by a 1D curve before the grid, and each
+    // output after it, so that the grid only has to capture what is left: the source's "A"
+    // curves are tabulated (as grid coordinates) and applied before the lookup, and the grid
+    // holds linear destination values, encoded by the destination's TRC when the pixels are
+    // packed. (Photoshop's inverted CMYK is inverted again before the "A" curves.)
+    const bool inverted = fSrcProfile.data_color_space == skcms_Signature_CMYK;
+    skcms_ICCProfile shapedSrc = fSrcProfile;
+    skcms_Curve* inputCurves = (int)shapedSrc.A2B.input_channels == fLUTInputs
+                                       ? shapedSrc.A2B.input_curves
+                                       : nullptr;
+    fShapers.push_back_n(fLUTInputs * kShaperEntries);
+    for (int i = 0; i < fLUTInputs; ++i) {
+        for (int e = 0; e < kShaperEntries; ++e) {
+            const float x = (float)e / (kShaperEntries - 1);
+            fShapers[i * kShaperEntries + e] =
+                    (inputCurves ? eval_curve(inputCurves[i], inverted ? 1 - x : x) : x) *
+                    (fGridPoints - 1);
+        }
+        if (inputCurves) {
+            inputCurves[i] = {};
+            inputCurves[i].parametric = *skcms_Identity_TransferFunction();
+        }
+    }
+    fLinearDstProfile = fDstProfile;
+    skcms_SetTransferFunction(&fLinearDstProfile, skcms_Identity_TransferFunction());
+
+    // 8-bit sources skip unpacking and shaping: the grid coordinate of each byte along each input
+    // is tabulated, unpacked just as transformBaked() would.
+    uint8_t bytes[4 * 256];
+    float unpacked[4 * 256];
+    for (int b = 0; b < 4 * 256; ++b) {
+        bytes[b] = (uint8_t)(b / 4);
+    }
+    bool ok = skcms_Transform(bytes, skcms_PixelFormat_RGBA_8888, skcms_AlphaFormat_Unpremul,
+                              &fSrcProfile,
+                              unpacked, skcms_PixelFormat_RGBA_ffff, skcms_AlphaFormat_Unpremul,
+                              &fSrcProfile, 256);
+    fByteCoords.push_back_n(fLUTInputs * 256);
+    for (int i = 0; i < fLUTInputs; ++i) {
+        for (int b = 0; b < 256; ++b) {
+            fByteCoords[i * 256 + b] = shape(&fShapers[i * kShaperEntries], unpacked[4 * b + i]);
+        }
+    }
+
+    skia_private::TArray<float> grid;
+    fill_grid(&grid, fLUTInputs, fGridPoints, /*centered=*/false);
+    if (inputCurves && inverted) {
+        for (int e = 0; e < grid.size(); ++e) {
+            if (e % 4 < fLUTInputs) {
+                grid[e] = 1 - grid[e];
+            }
+        }
+    }
+    const int entries = grid.size() / 4;
+    fLUT.push_back_n(4 * entries);
+    ok = ok && skcms_Transform(grid.data(), skcms_PixelFormat_RGBA_ffff,
+                               skcms_AlphaFormat_Unpremul, &shapedSrc,
+                               fLUT.data(), skcms_PixelFormat_RGBA_ffff,
+                               skcms_AlphaFormat_Unpremul, &fLinearDstProfile, entries);
+
+    // Some profiles don't interpolate well even so, and are left exact. The baked transform is
+    // compared to the exact one at the centers of a grid offset from the baked one.
+    if (ok) {
+        skia_private::TArray<float> check, exact, baked;
+        fill_grid(&check, fLUTInputs, checkPoints, /*centered=*/true);
+        const int count = check.size() / 4;
+        exact.push_back_n(4 * count);
+        baked.push_back_n(4 * count);
+        ok = skcms_Transform(check.data(), skcms_PixelFormat_RGBA_ffff,
+                             skcms_AlphaFormat_Unpremul, &fSrcProfile,
+                             exact.data(), skcms_PixelFormat_RGBA_ffff,
+                             skcms_AlphaFormat_Unpremul, &fDstProfile, count) &&
+             this->transformBaked(check.data(), skcms_PixelFormat_RGBA_ffff,
+                                  skcms_AlphaFormat_Unpremul, 4 * sizeof(float),
+                                  baked.data(), skcms_PixelFormat_RGBA_ffff,
+                                  skcms_AlphaFormat_Unpremul, 4 * sizeof(float), count);
+        for (int i = 0; ok && i < 4 * count; ++i) {
+            ok = std::abs(pin_unit(exact[i]) - pin_unit(baked[i])) <= kMaxBakedError;
+        }
+    }
+    if (!ok) {
+        fLUT.clear();
+        fShapers.clear();
+        fByteCoords.clear();
+        fLUTInputs = fGridPoints = 0;
+    }
+}
+
+bool SkColorTransform::transformBaked(const void* src, skcms_PixelFormat srcFormat,
+                                      skcms_AlphaFormat srcAlpha, size_t srcBpp,
+                                      void* dst, skcms_PixelFormat dstFormat,
+                                      skcms_AlphaFormat dstAlpha, size_t dstBpp,
+                                      size_t count) const {
+    // RGBA and BGRA bytes are looked up directly, unless premultiplied. (CMYK has no alpha; the
+    // fourth byte is K.)
+    const bool bytes = (srcFormat == skcms_PixelFormat_RGBA_8888 ||
+                        srcFormat == skcms_PixelFormat_BGRA_8888) &&
+                       srcAlpha != skcms_AlphaFormat_PremulAsEncoded;
+    const bool swapRB = srcFormat == skcms_PixelFormat_BGRA_8888;
+    const bool opaque = srcAlpha == skcms_AlphaFormat_Opaque;
+
+    const float* byteCoords = fByteCoords.data();
+    const float* shapers = fShapers.data();
+
+    float pixels[4 * kPixelsPerChunk];
+    auto srcBytes = static_cast<const char*>(src);
+    auto dstBytes = static_cast<char*>(dst);
+    for (size_t done = 0; done < count; done += kPixelsPerChunk) {
+        const size_t n = std::min<size_t>(kPixelsPerChunk, count - done);
+
+        if (bytes) {
+            const uint8_t* in = reinterpret_cast<const uint8_t*>(srcBytes + done * srcBpp);
+            for (size_t p = 0; p < n; ++p, in += 4) {
+                float* px = pixels + 4 * p;
+                for (int i = 0; i < fLUTInputs; ++i) {
+                    const int c = swapRB && i != 1 && i != 3 ? 2 - i : i;
+                    px[i] = byteCoords[i * 256 + in[c]];
+                }
+                if (fLUTInputs == 3) {
+                    px[3] = opaque ? 1.f : in[3] * (1 / 255.f);
+                }
+            }
+        } else {
+            // Converting to the source profile itself only unpacks and unpremultiplies, leaving
+            // encoded values (or raw CMYK) in floats.
+            if (!skcms_Transform(srcBytes + done * srcBpp, srcFormat, srcAlpha, &fSrcProfile,
+                                 pixels, skcms_PixelFormat_RGBA_ffff, skcms_AlphaFormat_Unpremul,
+                                 &fSrcProfile, n)) {
+                return false;
+            }
+            for (size_t p = 0; p < n; ++p) {
+                for (int i = 0; i < fLUTInputs; ++i) {
+                    pixels[4 * p + i] = shape(shapers + i * kShaperEntries, pixels[4 * p + i]);
+                }
+            }
+        }
+
+        if (fLUTInputs == 4) {
+            interpolate<4>(pixels, n, fLUT.data(), fGridPoints);
+        } else {
+            interpolate<3>(pixels, n, fLUT.data(), fGridPoints);
+        }
+
+        // Converting from the linear destination profile applies the destination's TRC, then
+        // clamps, premultiplies and packs.
+        if (!skcms_Transform(pixels, skcms_PixelFormat_RGBA_ffff, skcms_AlphaFormat_Unpremul,
+                             &fLinearDstProfile, dstBytes + done * dstBpp, dstFormat, dstAlpha,
+                             &fDstProfile, n)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkColorTransform::apply(const SkPixmap& dst, const SkPixmap& src) const {
+    skcms_PixelFormat srcFormat, dstFormat;
+    if (src.dimensions() != dst.dimensions() || src.info().isEmpty() ||
+        !src.addr() || !dst.addr() ||
+        !pixel_format(src.colorType(), &srcFormat) || !pixel_format(dst.colorType(), &dstFormat)) {
+        return false;
+    }
+    const skcms_AlphaFormat srcAlpha = alpha_format(src),
+                            dstAlpha = alpha_format(dst);
+    const int width = src.width(),
+              height = src.height();
+    const size_t srcBpp = src.info().bytesPerPixel(),
+                 dstBpp = dst.info().bytesPerPixel();
+
+    // Contiguous rows are converted with one call per band.
+    const bool contiguous = src.rowBytes() == src.info().minRowBytes() &&
+                            dst.rowBytes() == dst.info().minRowBytes();
+    std::atomic<bool> ok{true};
+    auto convertRows = [&](int first, int end) {
+        const int calls = contiguous ? 1 : end - first;
+        const size_t pixelsPerCall = contiguous ? (size_t)width * (end - first) : width;
+        for (int i = 0; i < calls; ++i) {
+            const void* srcRow = src.addr(0, first + i);
+            void* dstRow = dst.writable_addr(0, first + i);
+            const bool converted =
+                    this->isBaked()
+                            ? this->transformBaked(srcRow, srcFormat, srcAlpha, srcBpp,
+                                                   dstRow, dstFormat, dstAlpha, dstBpp,
+                                                   pixelsPerCall)
+                            : skcms_Transform(srcRow, srcFormat, srcAlpha, &fSrcProfile,
+                                              dstRow, dstFormat, dstAlpha, &fDstProfile,
+                                              pixelsPerCall);
+            if (!converted) {
+                ok.store(false, std::memory_order_relaxed);
+                return;
+            }
+        }
+    };
+
+    SkTaskGroup::ForEachBand(height, width, convertRows);
+    return ok.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkCompactPath.h"
+
+#include "include/core/SkPathTypes.h"
+#include "include/private/SkPathRef.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/core/SkPathPriv.h"
+
+#include <cstring>
+
+SkCompactPath::SkCompactPath() : SkCompactPath(*Make(SkPath())) {}
+
+const SkCompactPath::Header& SkCompactPath::header() const {
+    return *static_cast<const Header*>(fData->data());
+}
+
+int SkCompactPath::countVerbs() const { return this->header().fVerbCount; }
+
+int SkCompactPath::countPoints() const { return this->header().fPointCount; }
+
+SkScalar SkCompactPath::quantum() const { return this->header().fQuantum; }
+
+SkRect SkCompactPath::getBounds() const { return this->header().fBounds; }
+
+size_t SkCompactPath::writeToMemory(void* buffer) const {
+    if (buffer) {
+        memcpy(buffer, fData->data(), fData->size());
+    }
+    return fData->size();
+}
+
+SkPath SkCompactPath::toPath() const {
+    const Header& header = this->header();
+    if (header.fVerbCount == 0) {
+        SkPath path;
+        path.setFillType(this->getFillType());
+        return path;
+    }
+
+    skia_private::AutoSTMalloc<64, SkPoint> points(header.fPointCount);
+    RawIter iter(*this);
+    SkPoint pts[4];
+    int count = 0;
+    for (SkPath::Verb verb; (verb = iter.next(pts)) != SkPath::kDone_Verb;) {
+        switch (verb) {
+            case SkPath::kMove_Verb:  points[count++] = pts[0]; break;
+            case SkPath::kLine_Verb:  points[count++] = pts[1]; break;
+            case SkPath::kQuad_Verb:
+            case SkPath::kConic_Verb:
+                points[count++] = pts[1];
+                points[count++] = pts[2];
+                break;
+            case SkPath::kCubic_Verb:
+                points[count++] = pts[1];
+                points[count++] = pts[2];
+                points[count++] = pts[3];
+                break;
+            default:
+                break;
+        }
+    }
+    SkASSERT(count == header.fPointCount);
+
+    const auto* weights = SkTAddOffset<const SkScalar>(fData->data(), sizeof(Header));
+    const auto* verbs = reinterpret_cast<const uint8_t*>(weights + header.fWeightCount);
+    SkPathVerbAnalysis analysis = sk_path_analyze_verbs(verbs, header.fVerbCount);
+    SkASSERT(analysis.valid);
+    return SkPathPriv::MakePath(analysis, points.get(), verbs, header.fVerbCount, weights,
+                                this->getFillType(), false);
+}
+
+void SkCompactPath::WriteVarint(uint32_t value, uint8_t* dst, size_t* offset) {
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if (dst) {
+            dst[*offset] = byte | (value ? 0x80 : 0);
+        }
+        *offset += 1;
+    } while (value);
+}
+
+bool SkCompactPath::ReadVarint(const uint8_t** src, const uint8_t* end, uint32_t* value) {
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*src >= end) {
+            return false;
+        }
+        uint8_t byte = *(*src)++;
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkCompactPath::RawIter::RawIter(const SkCompactPath& path) {
+    const Header& header = path.header();
+    fConicWeights = SkTAddOffset<const SkScalar>(path.fData->data(), sizeof(Header));
+    fVerbs = reinterpret_cast<const uint8_t*>(fConicWeights + header.fWeightCount);
+    fVerbsEnd = fVerbs + header.fVerbCount;
+    fPointBytes = fVerbsEnd;
+    fPointBytesEnd = fPointBytes + header.fPointByteCount;
+    fOrigin = {header.fBounds.fLeft, header.fBounds.fTop};
+    fQuantum = header.fQuantum;
+}
+
+SkPoint SkCompactPath::RawIter::nextPoint() {
+    uint32_t dx = 0, dy = 0;
+    SkAssertResult(ReadVarint(&fPointBytes, fPointBytesEnd, &dx));
+    SkAssertResult(ReadVarint(&fPointBytes, fPointBytesEnd, &dy));
+    fX += UnZigZag(dx);
+    fY += UnZigZag(dy);
+    return {GridToCoord(fOrigin.fX, fX, fQuantum), GridToCoord(fOrigin.fY, fY, fQuantum)};
+}
+
+SkPath::Verb SkCompactPath::RawIter::next(SkPoint pts[4]) {
+    if (fVerbs == fVerbsEnd) {
+        return SkPath::kDone_Verb;
+    }
+    SkPathVerb verb = static_cast<SkPathVerb>(*fVerbs++);
+    switch (verb) {
+        case SkPathVerb::kMove:
+            pts[0] = fLastPt = this->nextPoint();
+            break;
+        case SkPathVerb::kLine:
+            pts[0] = fLastPt;
+            pts[1] = fLastPt = this->nextPoint();
+            break;
+        case SkPathVerb::kConic:
+            fConicWeight = *fConicWeights++;
+            [[fallthrough]];
+        case SkPathVerb::kQuad:
+            pts[0] = fLastPt;
+            pts[1] = this->nextPoint();
+            pts[2] = fLastPt = this->nextPoint();
+            break;
+        case SkPathVerb::kCubic:
+            pts[0] = fLastPt;
+            pts[1] = this->nextPoint();
+            pts[2] = this->nextPoint();
+            pts[3] = fLastPt = this->nextPoint();
+            break;
+        case SkPathVerb::kClose:
+            break;
+    }
+    return static_cast<SkPath::Verb>(verb);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCompactPath_DEFINED
+#define SkCompactPath_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkScalar.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+/**
+ *  A lossy, immutable and much smaller encoding of an SkPath, for holding large sets of static
+ *  geometry (e.g. map tiles). Points are snapped to a grid of the given quantum, relative to the
+ *  top-left of the path's bounds, and each point is stored as a variable-length delta from the
+ *  previous one, so typical points take 2 to 4 bytes instead of 8. Verbs and conic weights are
+ *  stored as is.
+ *
+ *  The encoded bytes are also the serialized form: writeToMemory() just copies them, and
+ *  SkPath::readFromMemory() accepts them, decoding to a regular path.
+ */
+class SkCompactPath {
+public:
+    // Points move by at most half of this; 1/16 is below what AA rasterization can resolve.
+    static constexpr SkScalar kDefaultQuantum = 1.0f / 16;
+
+    /** An empty path. */
+    SkCompactPath();
+
+    /**
+     *  Encodes the path on a grid of quantum-sized cells. Returns nullopt if the path is not
+     *  finite, the quantum is not positive, or the path is too large for that quantum.
+     */
+    static std::optional<SkCompactPath> Make(const SkPath&, SkScalar quantum = kDefaultQuantum);
+
+    /**
+     *  Reads data written by writeToMemory(), returning nullopt if it is not valid. If bytesRead
+     *  is not null, it is set to the number of bytes consumed.
+     */
+    static std::optional<SkCompactPath> MakeFromMemory(const void* buffer, size_t length,
+                                                       size_t* bytesRead = nullptr);
+
+    bool isEmpty() const { return this->countVerbs() == 0; }
+    int countVerbs() const;
+    int countPoints() const;
+    SkPathFillType getFillType() const;
+    SkScalar quantum() const;
+
+    /** The bounds of the decoded points. */
+    SkRect getBounds() const;
+
+    /** Decodes into a regular path. */
+    SkPath toPath() const;
+
+    /** Returns the number of bytes written, or needed if buffer is null. */
+    size_t writeToMemory(void* buffer) const;
+    sk_sp<SkData> serialize() const { return fData; }
+
+    size_t approximateBytesUsed() const { return sizeof(*this) + fData->size(); }
+
+    /**
+     *  Walks the verbs like SkPath::RawIter, decoding points as it goes.
+     */
+    class RawIter {
+    public:
+        explicit RawIter(const SkCompactPath&);
+
+        /**
+         *  Returns the next verb, or kDone_Verb. Fills pts like SkPath::RawIter does: the
+         *  previous point followed by the new ones for segments, a single point for kMove.
+         */
+        SkPath::Verb next(SkPoint pts[4]);
+
+        /** Returns the weight of the conic most recently returned by next(). */
+        SkScalar conicWeight() const { return fConicWeight; }
+
+    private:
+        SkPoint nextPoint();
+
+        const uint8_t*  fVerbs;
+        const uint8_t*  fVerbsEnd;
+        const uint8_t*  fPointBytes;
+        const uint8_t*  fPointBytesEnd;
+        const SkScalar* fConicWeights;
+        SkPoint         fOrigin;
+        SkScalar        fQuantum;
+        int32_t         fX = 0;
+        int32_t         fY = 0;
+        SkPoint         fLastPt = {0, 0};
+        SkScalar        fConicWeight = 0;
+    };
+
+private:
+    // The data starts with this, followed by the conic weights, the verbs, the encoded points,
+    // and padding to a multiple of four bytes.
+    struct Header {
+        uint32_t fPacked;  // fill type, serialization type and version, as in SkPath_serial.cpp
+        SkScalar fQuantum;
+        SkRect   fBounds;  // of the decoded points; the grid's origin is the top-left corner
+        int32_t  fVerbCount;
+        int32_t  fPointCount;
+        int32_t  fWeightCount;
+        int32_t  fPointByteCount;
+    };
+
+    explicit SkCompactPath(sk_sp<SkData> data) : fData(std::move(data)) {}
+
+    const Header& header() const;
+
+    static void WriteVarint(uint32_t, uint8_t* dst, size_t* offset);
+    // Returns false if the varint runs past end.
+    static bool ReadVarint(const uint8_t** src, const uint8_t* end, uint32_t* value);
+
+    static uint32_t ZigZag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+    static int32_t UnZigZag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+    // Encoding and decoding must map grid coordinates back to exactly the same values.
+    static SkScalar GridToCoord(SkScalar origin, int32_t grid, SkScalar quantum) {
+        return origin + (SkScalar)grid * quantum;
+    }
+
+    // Grid coordinates must stay well inside int32, so that deltas never overflow.
+    static constexpr int32_t kMaxGridCoord = 1 << 30;
+
+    sk_sp<SkData> fData;
+};
+
+#endif
@@ -10,6 +10,7 @@
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathTypes.h"
+#include "include/core/SkRect.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkFloatingPoint.h"
@@ -583,7 +584,13 @@ const SkContourMeasure::Segment* SkContourMeasure::distanceToSegment( SkScalar d
     int index = SkTKSearch<Segment, SkScalar>(seg, count, distance);
     // don't care if we hit an exact match or not, so we xor index if it is negative
     index ^= (index >> 31);
-    seg = &seg[index];
+    return this->indexToSegment(index, distance, t);
+}
+
+const SkContourMeasure::Segment* SkContourMeasure::indexToSegment(int index, SkScalar distance,
+                                                                  SkScalar* t) const {
+    SkASSERT(index >= 0 && index < fSegments.size());
+    const Segment* seg = &fSegments[index];
 
     // now interpolate t-values with the prev segment (if possible)
     SkScalar    startT = 0, startD = 0;
@@ -669,7 +676,6 @@ bool SkContourMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
         return false;
     }
 
-    SkPoint  p;
     SkScalar startT, stopT;
     const Segment* seg = this->distanceToSegment(startD, &startT);
     if (!SkIsFinite(startT)) {
@@ -679,6 +685,14 @@ bool SkContourMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
     if (!SkIsFinite(stopT)) {
         return false;
     }
+    this->segmentTo(seg, startT, stopSeg, stopT, dst, startWithMoveTo);
+    return true;
+}
+
+void SkContourMeasure::segmentTo(const Segment* seg, SkScalar startT,
+                                 const Segment* stopSeg, SkScalar stopT,
+                                 SkPath* dst, bool startWithMoveTo) const {
+    SkPoint  p;
     SkASSERT(seg <= stopSeg);
     if (startWithMoveTo) {
         compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, startT, &p, nullptr);
@@ -695,6 +709,127 @@ bool SkContourMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
         } while (seg->fPtIndex < stopSeg->fPtIndex);
         SkContourMeasure_segTo(&fPts[seg->fPtIndex], seg->fType, 0, stopT, dst);
     }
+}
 
-    return true;
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void SkPathMeasurePriv::VisibleSpans(const SkContourMeasure& contour, const SkRect& bounds,
+                                     skia_private::TArray<Span>* spans) {
+    const SkTDArray<SkContourMeasure::Segment>& segs = contour.fSegments;
+    const int firstSpan = spans->size();
+
+    // Horizontal and vertical lines have empty bounds, so SkRect::Intersects() won't do.
+    auto touches = [&bounds](const SkRect& r) {
+        return r.fLeft <= bounds.fRight && bounds.fLeft <= r.fRight &&
+               r.fTop <= bounds.fBottom && bounds.fTop <= r.fBottom;
+    };
+    auto addSpan = [&](SkScalar startD, SkScalar stopD) {
+        if (spans->size() > firstSpan && spans->back().fStop == startD) {
+            spans->back().fStop = stopD;
+        } else {
+            spans->push_back({startD, stopD});
+        }
+    };
+
+    SkPath piece;
+    SkScalar startD = 0;
+    for (int i = 0; i < segs.size();) {
+        // Find the last segment of this line or curve.
+        const unsigned ptIndex = segs[i].fPtIndex;
+        const unsigned segType = segs[i].fType;
+        int last = i;
+        while (last + 1 < segs.size() && segs[last + 1].fPtIndex == ptIndex) {
+            ++last;
+        }
+        const SkScalar stopD = segs[last].fDistance;
+
+        // Lines and curves lie within the bounds of their points.
+        const SkPoint* pts = &contour.fPts[ptIndex];
+        SkRect curveBounds;
+        switch (segType) {
+            case kLine_SegType:
+                curveBounds.setBounds(pts, 2);
+                break;
+            case kQuad_SegType:
+                curveBounds.setBounds(pts, 3);
+                break;
+            case kCubic_SegType:
+                curveBounds.setBounds(pts, 4);
+                break;
+            case kConic_SegType: {
+                // pts[1] holds the conic's weight.
+                const SkPoint conicPts[3] = {pts[0], pts[2], pts[3]};
+                curveBounds.setBounds(conicPts, 3);
+            } break;
+            default:
+                SkDEBUGFAIL("unknown segType");
+                curveBounds = bounds;
+        }
+
+        if (touches(curveBounds)) {
+            if (last == i) {
+                addSpan(startD, stopD);
+            } else {
+                // A long curve may only pass through bounds briefly, so check each of the pieces
+                // it was measured with.
+                SkScalar pieceStartD = startD;
+                SkScalar pieceStartT = 0;
+                for (int j = i; j <= last; ++j) {
+                    SkPoint start;
+                    compute_pos_tan(pts, segType, pieceStartT, &start, nullptr);
+                    piece.rewind();
+                    piece.moveTo(start);
+                    SkContourMeasure_segTo(pts, segType, pieceStartT, segs[j].getScalarT(), &piece);
+                    if (touches(piece.getBounds())) {
+                        addSpan(pieceStartD, segs[j].fDistance);
+                    }
+                    pieceStartD = segs[j].fDistance;
+                    pieceStartT = segs[j].getScalarT();
+                }
+            }
+        }
+        startD = stopD;
+        i = last + 1;
+    }
+}
+
+void SkPathMeasurePriv::GetSegments(const SkContourMeasure& contour, SkSpan<const Span> spans,
+                                    SkPath* dst) {
+    SkASSERT(dst);
+    using Segment = SkContourMeasure::Segment;
+
+    const SkTDArray<Segment>& segs = contour.fSegments;
+    if (segs.empty()) {
+        return;
+    }
+    const SkScalar length = contour.length();
+
+    // Like distanceToSegment(), but carries on from the previous distance.
+    int index = 0;
+    auto seek = [&](SkScalar distance, SkScalar* t) {
+        while (index + 1 < segs.size() && segs[index].fDistance < distance) {
+            ++index;
+        }
+        return contour.indexToSegment(index, distance, t);
+    };
+
+    for (const Span& span : spans) {
+        // Pin the distances as getSegment() does.
+        SkScalar startD = std::max(span.fStart, 0.0f);
+        SkScalar stopD = std::min(span.fStop, length);
+        if (!(startD <= stopD)) {   // catch NaN values as well
+            continue;
+        }
+
+        SkScalar startT, stopT;
+        const Segment* seg = seek(startD, &startT);
+        if (!SkIsFinite(startT)) {
+            continue;
+        }
+        const Segment* stopSeg = seek(stopD, &stopT);
+        if (!SkIsFinite(stopT)) {
+            continue;
+        }
+        contour.segmentTo(seg, startT, stopSeg, stopT, dst, true);
+    }
 }
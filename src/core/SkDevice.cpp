@@ -373,7 +373,8 @@ void SkDevice::drawFilteredImage(const skif::Mapping& mapping,
                       &stats};
 
     SkIPoint offset;
-    sk_sp<SkSpecialImage> result = as_IFB(filter)->filterImage(ctx).imageAndOffset(ctx, &offset);
+    sk_sp<SkSpecialImage> result =
+            skif::FilterResult::FilterInTiles(ctx, filter).imageAndOffset(ctx, &offset);
     stats.reportStats();
     if (result) {
         SkMatrix deviceMatrixWithOffset = mapping.layerToDevice();
@@ -10,6 +10,7 @@
 #include "include/private/base/SkSemaphore.h"
 #include "include/private/base/SkTArray.h"
 #include "src/base/SkNoDestructor.h"
+#include "src/core/SkExecutorPriv.h"
 
 #include <deque>
 #include <thread>
@@ -58,6 +59,10 @@ void SkExecutor::SetDefault(SkExecutor* executor) {
     gDefaultExecutor = executor;
 }
 
+bool SkExecutorHasDefault() {
+    return gDefaultExecutor != nullptr;
+}
+
 // We'll always push_back() new work, but pop from the front of deques or the back of SkTArray.
 static inline std::function<void(void)> pop(std::deque<std::function<void(void)>>* list) {
     std::function<void(void)> fn = std::move(list->front());
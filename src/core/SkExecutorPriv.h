@@ -0,0 +1,15 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkExecutorPriv_DEFINED
+#define SkExecutorPriv_DEFINED
+
+// Returns true if an executor has been installed with SkExecutor::SetDefault(). Otherwise
+// SkExecutor::GetDefault() returns a trivial executor that runs work inline as it's added.
+bool SkExecutorHasDefault();
+
+#endif  // SkExecutorPriv_DEFINED
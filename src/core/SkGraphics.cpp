@@ -16,6 +16,7 @@
 #include "src/core/SkOpts.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkStrikeCache.h"
+#include "src/core/SkStrokeCache.h"
 #include "src/core/SkSwizzlePriv.h"
 #include "src/core/SkTypefaceCache.h"
 
@@ -35,12 +36,22 @@ void SkGraphics::Init() {
 void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
   SkResourceCache::DumpMemoryStatistics(dump);
   SkStrikeCache::DumpMemoryStatistics(dump);
+  SkImageFilter_Base::DumpCacheMemoryStatistics(dump);
+}
+
+size_t SkGraphics::GetStrokeCacheByteLimit() {
+    return SkStrokeCache::GetByteLimit();
+}
+
+size_t SkGraphics::SetStrokeCacheByteLimit(size_t newLimit) {
+    return SkStrokeCache::SetByteLimit(newLimit);
 }
 
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter_Base::PurgeCache();
+    SkStrokeCache::PurgeAll();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -16,6 +16,7 @@
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/base/SkTime.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -253,10 +254,14 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
         return result;
     }
 
+    const double start = SkTime::GetNSecs();
     result = this->onFilterImage(context);
 
     if (context.backend()->cache()) {
-        context.backend()->cache()->set(key, this, result);
+        // The time includes evaluating any inputs that weren't cached, since those would have to
+        // be recomputed as well.
+        const uint64_t recomputeNanos = (uint64_t) std::max(SkTime::GetNSecs() - start, 0.0);
+        context.backend()->cache()->set(key, this, result, recomputeNanos);
     }
 
     return result;
@@ -345,6 +350,20 @@ SkImageFilter_Base::MatrixCapability SkImageFilter_Base::getCTMCapability() cons
     return result;
 }
 
+bool SkImageFilter_Base::canFilterInTiles(const skif::Mapping& mapping) const {
+    if (!this->onCanFilterInTiles(mapping)) {
+        return false;
+    }
+    const int count = this->countInputs();
+    for (int i = 0; i < count; ++i) {
+        const SkImageFilter_Base* input = as_IFB(this->getInput(i));
+        if (input && !input->canFilterInTiles(mapping)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 skif::LayerSpace<SkIRect> SkImageFilter_Base::getChildInputLayerBounds(
         int index,
         const skif::Mapping& mapping,
@@ -391,3 +410,10 @@ void SkImageFilter_Base::PurgeCache() {
         cache->purge();
     }
 }
+
+void SkImageFilter_Base::DumpCacheMemoryStatistics(SkTraceMemoryDump* dump) {
+    auto cache = SkImageFilterCache::Get(SkImageFilterCache::CreateIfNecessary::kNo);
+    if (cache) {
+        cache->dumpMemoryStatistics(dump);
+    }
+}
@@ -7,15 +7,21 @@
 
 #include "src/core/SkImageFilterCache.h"
 
+#include "include/core/SkString.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/private/base/SkMutex.h"
 #include "include/private/base/SkOnce.h"
-#include "src/base/SkTInternalLList.h"
+#include "src/base/SkTDPQueue.h"
 #include "src/core/SkChecksum.h"
 #include "src/core/SkImageFilterTypes.h"
+#include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkTDynamicHash.h"
 #include "src/core/SkTHash.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <vector>
 
 using namespace skia_private;
@@ -28,103 +34,239 @@ using namespace skia_private;
 
 namespace {
 
+// Entries are spread across shards by key hash, each with its own lock, so that concurrent filter
+// evaluations (e.g. tiles on different threads) rarely contend. The byte budget is shared.
+static constexpr int kShardCount = 16;
+
+static constexpr char kDumpName[] = "skia/sk_image_filter_cache";
+
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0), fInflation(0) { }
     ~CacheImpl() override {
-        fLookup.foreach([&](Value* v) { delete v; });
+        for (Shard& shard : fShards) {
+            shard.fLookup.foreach([&](Value* v) { delete v; });
+        }
     }
     struct Value {
         Value(const Key& key, const skif::FilterResult& image,
-              const SkImageFilter* filter)
-            : fKey(key), fImage(image), fFilter(filter) {}
+              const SkImageFilter* filter, uint64_t recomputeNanos)
+            : fKey(key), fImage(image), fFilter(filter)
+            , fBytes(image.image() ? image.image()->getSize() : 0)
+            , fCostPerByte((double) recomputeNanos / std::max<size_t>(fBytes, 1)) {}
 
         Key fKey;
         skif::FilterResult fImage;
         const SkImageFilter* fFilter;
+        size_t fBytes;
+        double fCostPerByte;
+        // GreedyDual-Size priority: the cache's inflation when last used, plus fCostPerByte.
+        double fPriority = 0;
+        int fQueueIndex = -1;
+
         static const Key& GetKey(const Value& v) {
             return v.fKey;
         }
         static uint32_t Hash(const Key& key) {
             return SkChecksum::Hash32(&key, sizeof(Key));
         }
-        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Value);
+        static bool Less(Value* const& a, Value* const& b) {
+            return a->fPriority < b->fPriority;
+        }
+        static int* QueueIndex(Value* const& v) {
+            return &v->fQueueIndex;
+        }
     };
 
     bool get(const Key& key, skif::FilterResult* result) const override {
         SkASSERT(result);
 
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            if (v != fLRU.head()) {
-                fLRU.remove(v);
-                fLRU.addToHead(v);
-            }
+        Shard& shard = this->shardFor(key);
+        SkAutoMutexExclusive mutex(shard.fMutex);
+        FilterStats& stats = shard.fStats[key.fUniqueID];
+        if (Value* v = shard.fLookup.find(key)) {
+            v->fPriority = fInflation.load(std::memory_order_relaxed) + v->fCostPerByte;
+            shard.fQueue.priorityDidChange(v);
+            stats.fHits++;
 
             *result = v->fImage;
             return true;
         }
+        stats.fMisses++;
         return false;
     }
 
     void set(const Key& key, const SkImageFilter* filter,
-             const skif::FilterResult& result) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
-            this->removeInternal(v);
-        }
-        Value* v = new Value(key, result, filter);
-        fLookup.add(v);
-        fLRU.addToHead(v);
-        fCurrentBytes += result.image() ? result.image()->getSize() : 0;
-        if (auto* values = fImageFilterValues.find(filter)) {
+             const skif::FilterResult& result, uint64_t recomputeNanos) override {
+        Value* v = new Value(key, result, filter, recomputeNanos);
+
+        Shard& shard = this->shardFor(key);
+        {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            if (Value* old = shard.fLookup.find(key)) {
+                this->removeInternal(&shard, old);
+            }
+        }
+
+        // Make room for the new entry, but always keep it, even if it's over budget on its own.
+        while (fCurrentBytes.load(std::memory_order_relaxed) + v->fBytes > fMaxBytes &&
+               this->evictCheapest()) {}
+
+        SkAutoMutexExclusive mutex(shard.fMutex);
+        if (Value* old = shard.fLookup.find(key)) {
+            // Another thread added the same key while the lock was released.
+            this->removeInternal(&shard, old);
+        }
+        v->fPriority = fInflation.load(std::memory_order_relaxed) + v->fCostPerByte;
+        shard.fLookup.add(v);
+        shard.fQueue.insert(v);
+        fCurrentBytes.fetch_add(v->fBytes, std::memory_order_relaxed);
+        if (auto* values = shard.fImageFilterValues.find(filter)) {
             values->push_back(v);
         } else {
-            fImageFilterValues.set(filter, {v});
+            shard.fImageFilterValues.set(filter, {v});
         }
+        FilterStats& stats = shard.fStats[key.fUniqueID];
+        stats.fBytes += v->fBytes;
+        stats.fRecomputeNanos += recomputeNanos;
+    }
 
-        while (fCurrentBytes > fMaxBytes) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            if (tail == v) {
-                break;
+    void purge() override {
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            while (shard.fQueue.count() > 0) {
+                this->removeInternal(&shard, shard.fQueue.peek());
             }
-            this->removeInternal(tail);
         }
     }
 
-    void purge() override {
-        SkAutoMutexExclusive mutex(fMutex);
-        while (fCurrentBytes > 0) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            this->removeInternal(tail);
+    void purgeByImageFilter(const SkImageFilter* filter) override {
+        const uint32_t filterID = as_IFB(filter)->uniqueID();
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            // The filter is being destroyed, so its stats can't be looked up anymore.
+            shard.fStats.remove(filterID);
+            auto* values = shard.fImageFilterValues.find(filter);
+            if (!values) {
+                continue;
+            }
+            for (Value* v : *values) {
+                // We set the filter to be null so that removeInternal() won't delete from values
+                // while we're iterating over it.
+                v->fFilter = nullptr;
+                this->removeInternal(&shard, v);
+            }
+            shard.fImageFilterValues.remove(filter);
         }
     }
 
-    void purgeByImageFilter(const SkImageFilter* filter) override {
-        SkAutoMutexExclusive mutex(fMutex);
-        auto* values = fImageFilterValues.find(filter);
-        if (!values) {
+    SkDEBUGCODE(int count() const override {
+        int count = 0;
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            count += shard.fLookup.count();
+        }
+        return count;
+    })
+
+    FilterStats getFilterStats(uint32_t filterID) const override {
+        FilterStats total;
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            if (const FilterStats* stats = shard.fStats.find(filterID)) {
+                add_stats(&total, *stats);
+            }
+        }
+        return total;
+    }
+
+    void dumpMemoryStatistics(SkTraceMemoryDump* dump) const override {
+        dump->dumpNumericValue(kDumpName, "size", "bytes",
+                               fCurrentBytes.load(std::memory_order_relaxed));
+        dump->dumpNumericValue(kDumpName, "budget_size", "bytes", fMaxBytes);
+        dump->setMemoryBacking(kDumpName, "malloc", nullptr);
+        if (dump->getRequestedDetails() == SkTraceMemoryDump::kLight_LevelOfDetail) {
             return;
         }
-        for (Value* v : *values) {
-            // We set the filter to be null so that removeInternal() won't delete from values while
-            // we're iterating over it.
-            v->fFilter = nullptr;
-            this->removeInternal(v);
+
+        THashMap<uint32_t, FilterStats> allStats;
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            shard.fStats.foreach([&](uint32_t filterID, const FilterStats& stats) {
+                add_stats(&allStats[filterID], stats);
+            });
         }
-        fImageFilterValues.remove(filter);
+        allStats.foreach([&](uint32_t filterID, const FilterStats& stats) {
+            SkString dumpName = SkStringPrintf("%s/filter_%u", kDumpName, filterID);
+            dump->dumpNumericValue(dumpName.c_str(), "hits", "objects", stats.fHits);
+            dump->dumpNumericValue(dumpName.c_str(), "misses", "objects", stats.fMisses);
+            dump->dumpNumericValue(dumpName.c_str(), "recompute_time", "nanoseconds",
+                                   stats.fRecomputeNanos);
+            // Results are accounted for in the cache's total size, so this isn't "size".
+            dump->dumpNumericValue(dumpName.c_str(), "cached_size", "bytes", stats.fBytes);
+        });
     }
 
-    SkDEBUGCODE(int count() const override { return fLookup.count(); })
 private:
-    void removeInternal(Value* v) {
+    struct Shard {
+        SkTDynamicHash<Value, Key>                          fLookup;
+        SkTDPQueue<Value*, Value::Less, Value::QueueIndex>  fQueue;
+        // Value* always points to an item in fLookup.
+        THashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
+        THashMap<uint32_t, FilterStats>                     fStats;
+        SkMutex                                             fMutex;
+    };
+
+    static void add_stats(FilterStats* dst, const FilterStats& src) {
+        dst->fHits += src.fHits;
+        dst->fMisses += src.fMisses;
+        dst->fBytes += src.fBytes;
+        dst->fRecomputeNanos += src.fRecomputeNanos;
+    }
+
+    Shard& shardFor(const Key& key) const {
+        // Use the high bits, since the low bits pick the bucket within the shard's hash table.
+        return fShards[(Value::Hash(key) >> 24) % kShardCount];
+    }
+
+    // Evicts the entry with the lowest priority across all shards. Returns false if the cache is
+    // empty.
+    bool evictCheapest() {
+        Shard* cheapest = nullptr;
+        double lowestPriority = std::numeric_limits<double>::infinity();
+        for (Shard& shard : fShards) {
+            SkAutoMutexExclusive mutex(shard.fMutex);
+            if (shard.fQueue.count() > 0 && shard.fQueue.peek()->fPriority <= lowestPriority) {
+                lowestPriority = shard.fQueue.peek()->fPriority;
+                cheapest = &shard;
+            }
+        }
+        if (!cheapest) {
+            return false;
+        }
+
+        // The shard may have changed since it was peeked, but its lowest entry is still a good
+        // enough candidate.
+        SkAutoMutexExclusive mutex(cheapest->fMutex);
+        if (cheapest->fQueue.count() == 0) {
+            return true; // Try again
+        }
+        Value* v = cheapest->fQueue.peek();
+        // Age the cache, so entries that aren't used again eventually fall below new ones.
+        double inflation = fInflation.load(std::memory_order_relaxed);
+        while (inflation < v->fPriority &&
+               !fInflation.compare_exchange_weak(inflation, v->fPriority,
+                                                 std::memory_order_relaxed)) {}
+        this->removeInternal(cheapest, v);
+        return true;
+    }
+
+    void removeInternal(Shard* shard, Value* v) {
         if (v->fFilter) {
-            if (auto* values = fImageFilterValues.find(v->fFilter)) {
+            if (auto* values = shard->fImageFilterValues.find(v->fFilter)) {
                 if (values->size() == 1 && (*values)[0] == v) {
-                    fImageFilterValues.remove(v->fFilter);
+                    shard->fImageFilterValues.remove(v->fFilter);
                 } else {
                     for (auto it = values->begin(); it != values->end(); ++it) {
                         if (*it == v) {
@@ -135,19 +277,20 @@ private:
                 }
             }
         }
-        fCurrentBytes -= v->fImage.image() ? v->fImage.image()->getSize() : 0;
-        fLRU.remove(v);
-        fLookup.remove(v->fKey);
+        if (FilterStats* stats = shard->fStats.find(v->fKey.fUniqueID)) {
+            stats->fBytes -= v->fBytes;
+        }
+        fCurrentBytes.fetch_sub(v->fBytes, std::memory_order_relaxed);
+        shard->fQueue.remove(v);
+        shard->fLookup.remove(v->fKey);
         delete v;
     }
 private:
-    SkTDynamicHash<Value, Key>                          fLookup;
-    mutable SkTInternalLList<Value>                     fLRU;
-    // Value* always points to an item in fLookup.
-    THashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
+    mutable Shard                                       fShards[kShardCount];
     size_t                                              fMaxBytes;
-    size_t                                              fCurrentBytes;
-    mutable SkMutex                                     fMutex;
+    std::atomic<size_t>                                 fCurrentBytes;
+    // The priority of the last evicted entry, which new and reused entries' priorities start from.
+    std::atomic<double>                                 fInflation;
 };
 
 } // namespace
@@ -18,6 +18,7 @@
 #include <cstdint>
 
 class SkImageFilter;
+class SkTraceMemoryDump;
 namespace skif { class FilterResult; }
 
 struct SkImageFilterCacheKey {
@@ -54,6 +55,10 @@ struct SkImageFilterCacheKey {
 // This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID) to result
 // NOTE: this is the _specific_ unique ID of the image filter, so refiltering the same image with a
 // copy of the image filter (with exactly the same parameters) will not yield a cache hit.
+//
+// When over budget, the cache evicts the entries that are cheapest to recompute per byte first,
+// aged so that entries which haven't been used in a while eventually go regardless of their cost
+// (the GreedyDual-Size policy). With equal costs this degrades to LRU.
 class SkImageFilterCache : public SkRefCnt {
 public:
     static constexpr size_t kDefaultTransientSize = 32 * 1024 * 1024;
@@ -70,12 +75,30 @@ public:
     virtual bool get(const SkImageFilterCacheKey& key,
                      skif::FilterResult* result) const = 0;
     // 'filter' is included in the caching to allow the purging of all of an image filter's cached
-    // results when it is destroyed.
+    // results when it is destroyed. 'recomputeNanos' is how long 'result' took to compute, which
+    // decides how long it stays in the cache relative to other entries of the same size.
     virtual void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
-                     const skif::FilterResult& result) = 0;
+                     const skif::FilterResult& result, uint64_t recomputeNanos) = 0;
+    void set(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
+             const skif::FilterResult& result) {
+        this->set(key, filter, result, /*recomputeNanos=*/0);
+    }
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
+
+    // Cache activity for the results of one image filter, identified by its unique ID.
+    struct FilterStats {
+        int64_t  fHits = 0;
+        int64_t  fMisses = 0;
+        size_t   fBytes = 0;           // currently held in the cache
+        uint64_t fRecomputeNanos = 0;  // total time spent computing results that were added
+    };
+    virtual FilterStats getFilterStats(uint32_t filterID) const = 0;
+
+    // Dumps the cache's total size and budget, and with kObjectsBreakdowns_LevelOfDetail, the
+    // FilterStats of each filter with cached results.
+    virtual void dumpMemoryStatistics(SkTraceMemoryDump*) const = 0;
 };
 
 #endif
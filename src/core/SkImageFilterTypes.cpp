@@ -23,6 +23,7 @@
 #include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkTArray.h"
 #include "src/base/SkMathPriv.h"
 #include "src/base/SkVx.h"
 #include "src/core/SkBitmapDevice.h"
@@ -35,6 +36,7 @@
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 
@@ -199,7 +201,14 @@ public:
         return SkImages::RasterFromBitmap(data);
     }
 
-    const SkBlurEngine* getBlurEngine() const override { return nullptr; }
+    const SkBlurEngine* getBlurEngine() const override {
+        return SkBlurEngine::GetRasterBlurEngine();
+    }
+
+    // The smallest tile; FilterInTiles() grows the tiles of DAGs that need large input margins.
+    int tileSize() const override { return 512; }
+
+    bool hasCPUPixels() const override { return true; }
 };
 
 } // anonymous namespace
@@ -224,6 +233,14 @@ sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType
     return sk_make_sp<RasterBackend>(surfaceProps, colorType);
 }
 
+void Stats::add(const Stats& other) {
+    fNumVisitedImageFilters += other.fNumVisitedImageFilters;
+    fNumCacheHits += other.fNumCacheHits;
+    fNumOffscreenSurfaces += other.fNumOffscreenSurfaces;
+    fNumShaderClampedDraws += other.fNumShaderClampedDraws;
+    fNumShaderBasedTilingDraws += other.fNumShaderBasedTilingDraws;
+}
+
 void Stats::dumpStats() const {
     SkDebugf("ImageFilter Stats:\n"
              "      # visited filters: %d\n"
@@ -1757,6 +1774,107 @@ FilterResult FilterResult::MakeFromImage(const Context& ctx,
     return surface.snap();
 }
 
+FilterResult FilterResult::FilterInTiles(const Context& ctx, const SkImageFilter* filter) {
+    SkASSERT(filter);
+    const SkImageFilter_Base* filterBase = as_IFB(filter);
+
+    // Tiling only pays off when the tiles are filtered in parallel: each one re-reads the margin
+    // of input around it that the DAG requires, and the tiles are copied into one surface after.
+    const LayerSpace<SkIRect>& desiredOutput = ctx.desiredOutput();
+    int64_t tileSize = ctx.backend()->tileSize();
+    if (tileSize <= 0 || desiredOutput.isEmpty() ||
+        !SkTaskGroup::DefaultExecutorIsMultiThreaded() ||
+        !filterBase->canFilterInTiles(ctx.mapping())) {
+        return filterBase->filterImage(ctx);
+    }
+
+    // Grow the tiles until the input each one requires is at most kMaxTileInputRatio times its
+    // own area, and there are no more than kMaxTileCount of them. Large kernels (e.g. a blur with
+    // a big sigma) therefore get big tiles, or are filtered in a single pass.
+    static constexpr int64_t kMaxTileInputRatio = 2;
+    static constexpr int64_t kMaxTileCount = 256;
+    int64_t tilesX, tilesY;
+    for (;;) {
+        if (desiredOutput.width() <= tileSize && desiredOutput.height() <= tileSize) {
+            return filterBase->filterImage(ctx);
+        }
+        tilesX = (desiredOutput.width() + tileSize - 1) / tileSize;
+        tilesY = (desiredOutput.height() + tileSize - 1) / tileSize;
+
+        const SkIRect tile = SkIRect::MakeXYWH(desiredOutput.left(),
+                                               desiredOutput.top(),
+                                               SkToInt(std::min<int64_t>(tileSize,
+                                                                         desiredOutput.width())),
+                                               SkToInt(std::min<int64_t>(tileSize,
+                                                                         desiredOutput.height())));
+        const SkIRect tileInput = SkIRect(filterBase->getInputLayerBounds(
+                ctx.mapping(), LayerSpace<SkIRect>(tile)));
+        const int64_t tileArea = tile.width64() * tile.height64();
+        const int64_t inputArea = tileInput.isEmpty64() ? 0
+                                                        : tileInput.width64() * tileInput.height64();
+        if (tilesX * tilesY <= kMaxTileCount && inputArea <= kMaxTileInputRatio * tileArea) {
+            break;
+        }
+        tileSize *= 2;
+    }
+    const int tileCount = SkToInt(tilesX * tilesY);
+
+    skia_private::TArray<LayerSpace<SkIRect>> tileBounds;
+    tileBounds.reserve(tileCount);
+    for (int64_t y = 0; y < tilesY; ++y) {
+        for (int64_t x = 0; x < tilesX; ++x) {
+            // Computed in 64 bits since the last tile may end past INT_MAX before clipping.
+            const int64_t left = desiredOutput.left() + x * tileSize;
+            const int64_t top = desiredOutput.top() + y * tileSize;
+            tileBounds.push_back(LayerSpace<SkIRect>(SkIRect::MakeLTRB(
+                    SkToInt(left),
+                    SkToInt(top),
+                    SkToInt(std::min<int64_t>(left + tileSize, desiredOutput.right())),
+                    SkToInt(std::min<int64_t>(top + tileSize, desiredOutput.bottom())))));
+        }
+    }
+
+    // Each tile gets its own Stats since they are not thread-safe.
+    skia_private::TArray<FilterResult> tiles;
+    tiles.push_back_n(tileCount);
+    skia_private::TArray<Stats> tileStats;
+    tileStats.push_back_n(tileCount);
+    {
+        SkTaskGroup tasks;
+        tasks.batch(tileCount, [&](int i) {
+            tiles[i] = filterBase->filterImage(ctx.withNewDesiredOutput(tileBounds[i])
+                                                  .withNewStats(&tileStats[i]));
+        });
+        tasks.wait();
+    }
+    for (const Stats& stats : tileStats) {
+        ctx.addStats(stats);
+    }
+
+    // A tile's result is only valid within its own bounds, so anything it covers outside of them
+    // is clipped away when the tiles are drawn together.
+    const auto outputBounds = LayerSpace<SkIRect>::Union(tileCount, [&](int i) {
+        LayerSpace<SkIRect> bounds = tiles[i].layerBounds();
+        return bounds.intersect(tileBounds[i]) ? bounds : LayerSpace<SkIRect>::Empty();
+    });
+
+    AutoSurface surface{ctx, outputBounds, PixelBoundary::kTransparent,
+                        /*renderInParameterSpace=*/false};
+    if (surface) {
+        for (int i = 0; i < tileCount; ++i) {
+            if (!tiles[i]) {
+                continue;
+            }
+            surface.device()->pushClipStack();
+            surface.device()->clipRect(SkRect::Make(SkIRect(tileBounds[i])),
+                                       SkClipOp::kIntersect, /*aa=*/false);
+            tiles[i].draw(ctx, surface.device(), /*preserveDeviceState=*/true);
+            surface.device()->popClipStack();
+        }
+    }
+    return surface.snap();
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // FilterResult::Builder
 
@@ -1861,8 +1979,6 @@ FilterResult FilterResult::Builder::merge() {
 FilterResult FilterResult::Builder::blur(const LayerSpace<SkSize>& sigma) {
     SkASSERT(fInputs.size() == 1);
 
-    // TODO: The blur functor is only supported for GPU contexts; SkBlurImageFilter should have
-    // detected this.
     const SkBlurEngine* blurEngine = fContext.backend()->getBlurEngine();
     SkASSERT(blurEngine);
 
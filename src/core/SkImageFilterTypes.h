@@ -726,6 +726,15 @@ public:
                                       ParameterSpace<SkRect> dstRect,
                                       const SkSamplingOptions& sampling);
 
+    // Evaluates 'filter' for the context's desired output. When the backend has a tile size, the
+    // default executor is multi-threaded, and the desired output is larger than one tile, the
+    // output is split into tiles that are filtered in parallel on SkTaskGroup's default executor.
+    // Each tile only requires the input regions mapped from its own bounds, and the tiles grow
+    // until that input is within a small multiple of their area. Intermediate results are cached
+    // per tile in the backend's SkImageFilterCache, and the tiles are then drawn into one surface.
+    // 'filter' must not be null.
+    static FilterResult FilterInTiles(const Context& ctx, const SkImageFilter* filter);
+
     // Bilinear is used as the default because it can be downgraded to nearest-neighbor when the
     // final transform is pixel-aligned, and chaining multiple bilinear samples and transforms is
     // assumed to be visually close enough to sampling once at highest quality and final transform.
@@ -1102,6 +1111,14 @@ public:
     // TODO: Once all Backends provide a blur engine, maybe just have Backend extend it.
     virtual const SkBlurEngine* getBlurEngine() const = 0;
 
+    // The size of the square tiles that FilterResult::FilterInTiles() splits a filter DAG's
+    // output into, or 0 if the backend evaluates the whole output at once.
+    virtual int tileSize() const { return 0; }
+
+    // True if the backend's images and devices hold CPU-addressable pixels, which filters may then
+    // read and write directly instead of rendering through shaders.
+    virtual bool hasCPUPixels() const { return false; }
+
     // Properties controlling the pixel data for offscreen surfaces rendered to during filtering.
     const SkSurfaceProps& surfaceProps() const { return fSurfaceProps; }
     SkColorType colorType() const { return fColorType; }
@@ -1129,6 +1146,8 @@ struct Stats {
     int fNumShaderClampedDraws = 0; // shader-emulated clamp is fairly cheap but HW tiling is best
     int fNumShaderBasedTilingDraws = 0; // shader-emulated decal, mirror, repeat are expensive
 
+    void add(const Stats& other);
+
     void dumpStats() const;   // log to std out
     void reportStats() const; // trace event counters
 };
@@ -1210,8 +1229,21 @@ public:
         return c;
     }
 
+    // Create a new context that matches this context, but records its stats into 'stats', so that
+    // it can be evaluated on another thread. Use addStats() to fold them back into this context.
+    Context withNewStats(Stats* stats) const {
+        Context c = *this;
+        c.fStats = stats;
+        return c;
+    }
+
 
     // Stats tracking
+    void addStats(const Stats& stats) const {
+        if (fStats) {
+            fStats->add(stats);
+        }
+    }
     void markVisitedImageFilter() const {
         if (fStats) {
             fStats->fNumVisitedImageFilters++;
@@ -18,6 +18,8 @@
 
 #include <optional>
 
+class SkTraceMemoryDump;
+
 // True base class that all SkImageFilter implementations need to extend from. This provides the
 // actual API surface that Skia will use to compute the filtered images.
 class SkImageFilter_Base : public SkImageFilter {
@@ -82,6 +84,16 @@ public:
             const skif::DeviceSpace<SkIRect>& desiredOutput,
             std::optional<skif::ParameterSpace<SkRect>> knownContentBounds) const;
 
+    /**
+     *  Like getInputBounds(), but for a 'desiredOutput' that is already in layer space, and
+     *  assuming unbounded content.
+     */
+    skif::LayerSpace<SkIRect> getInputLayerBounds(
+            const skif::Mapping& mapping,
+            const skif::LayerSpace<SkIRect>& desiredOutput) const {
+        return this->onGetInputLayerBounds(mapping, desiredOutput, /*contentBounds=*/{});
+    }
+
     /**
      *  Calculate the device-space bounds of the output of this filter DAG, if it were to process
      *  an image layer covering the 'contentBounds'. The 'mapping' defines how the content will be
@@ -127,6 +139,10 @@ public:
     using MatrixCapability = skif::MatrixCapability;
     MatrixCapability getCTMCapability() const;
 
+    // Returns true if this image filter graph produces the same pixels when each tile of the
+    // desired output is filtered on its own with 'mapping' as when it is filtered all at once.
+    bool canFilterInTiles(const skif::Mapping& mapping) const;
+
     uint32_t uniqueID() const { return fUniqueID; }
 
     static SkFlattenable::Type GetFlattenableType() {
@@ -201,10 +217,11 @@ protected:
 
 private:
     friend class SkImageFilter;
-    // For PurgeCache()
+    // For PurgeCache() and DumpCacheMemoryStatistics()
     friend class SkGraphics;
 
     static void PurgeCache();
+    static void DumpCacheMemoryStatistics(SkTraceMemoryDump*);
 
     // Configuration points for the filter implementation, marked private since they should not
     // need to be invoked by the subclasses. These refer to the node's specific behavior and are
@@ -233,6 +250,14 @@ private:
      */
     virtual bool onAffectsTransparentBlack() const { return false; }
 
+    /**
+     *  Return false if this filter's output depends on the bounds of the output it is asked for,
+     *  beyond the input those bounds require (e.g. it resamples on a grid anchored to them). The
+     *  graph is then never split into tiles by skif::FilterResult::FilterInTiles(). Only raster
+     *  backends filter in tiles.
+     */
+    virtual bool onCanFilterInTiles(const skif::Mapping&) const { return true; }
+
     /**
      * Return true if `affectsTransparentBlack()` should only be based on
      * `onAffectsTransparentBlack()` and ignore the transparency behavior of child input filters.
@@ -8,20 +8,66 @@
 #include "src/core/SkMaskBlurFilter.h"
 
 #include "include/core/SkColorPriv.h"
+#include "include/private/base/SkAlign.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTPin.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkArenaAlloc.h"
+#include "src/base/SkMathPriv.h"
 #include "src/base/SkVx.h"
 #include "src/core/SkGaussFilter.h"
 
 #include <cmath>
 #include <climits>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 namespace {
 static const double kPi = 3.14159265358979323846264338327950288;
 
+// Both passes blur this many rows at once.
+static constexpr int kRows = 8;
+using RowSums = skvx::Vec<kRows, uint32_t>;
+
+// Iterates along kRows rows of A8 that have been interleaved by interleave_rows(), yielding the
+// alphas of all of them at each step.
+class InterleavedIter {
+public:
+    explicit InterleavedIter(const uint32_t* ptr) : fPtr{ptr} {}
+    InterleavedIter& operator++() { fPtr += kRows; return *this; }
+    InterleavedIter& operator--() { fPtr -= kRows; return *this; }
+    RowSums operator*() const { return RowSums::Load(fPtr); }
+    bool operator<(const InterleavedIter& that) const { return fPtr < that.fPtr; }
+
+private:
+    const uint32_t* fPtr;
+};
+
+// Copies rowCount (up to kRows) rows of width alphas, starting at row and rowBytes apart, into
+// dst so that the alphas of each column are consecutive. Missing rows are zero.
+template <typename AlphaIter>
+void interleave_rows(AlphaIter row, uint32_t rowBytes, int width, int rowCount, uint32_t* dst) {
+    SkASSERT(0 < rowCount && rowCount <= kRows);
+    for (int r = 0; r < kRows; ++r) {
+        if (r < rowCount) {
+            AlphaIter src = row;
+            for (int x = 0; x < width; ++x, ++src) {
+                dst[kRows * x + r] = *src;
+            }
+            if (r + 1 < rowCount) {
+                row >>= rowBytes;
+            }
+        } else {
+            for (int x = 0; x < width; ++x) {
+                dst[kRows * x + r] = 0;
+            }
+        }
+    }
+}
+
 class PlanGauss final {
 public:
     explicit PlanGauss(double sigma) {
@@ -91,13 +137,17 @@ public:
     int    border()     const { return fBorder; }
 
 public:
+    // A Scan blurs one row of Sum values at a time: Sum is uint32_t to blur a single row of
+    // alpha, or RowSums to blur kRows rows at once, in which case the source yields kRows alphas
+    // per step and each result is stored as kRows consecutive bytes.
+    template <typename Sum>
     class Scan {
     public:
         Scan(uint64_t weight, int noChangeCount,
-             uint32_t* buffer0, uint32_t* buffer0End,
-             uint32_t* buffer1, uint32_t* buffer1End,
-             uint32_t* buffer2, uint32_t* buffer2End)
-            : fWeight{weight}
+             Sum* buffer0, Sum* buffer0End,
+             Sum* buffer1, Sum* buffer1End,
+             Sum* buffer2, Sum* buffer2End)
+            : fScale24{static_cast<uint32_t>((weight + (1 << 7)) >> 8)}
             , fNoChangeCount{noChangeCount}
             , fBuffer0{buffer0}
             , fBuffer0End{buffer0End}
@@ -105,7 +155,9 @@ public:
             , fBuffer1End{buffer1End}
             , fBuffer2{buffer2}
             , fBuffer2End{buffer2End}
-        { }
+        {
+            SkASSERT(fScale24 >= 256);
+        }
 
         template <typename AlphaIter> void blur(const AlphaIter srcBegin, const AlphaIter srcEnd,
                     uint8_t* dst, int dstStride, uint8_t* dstEnd) const {
@@ -115,18 +167,18 @@ public:
 
             std::memset(fBuffer0, 0x00, (fBuffer2End - fBuffer0) * sizeof(*fBuffer0));
 
-            uint32_t sum0 = 0;
-            uint32_t sum1 = 0;
-            uint32_t sum2 = 0;
+            Sum sum0 = 0;
+            Sum sum1 = 0;
+            Sum sum2 = 0;
 
             // Consume the source generating pixels.
             for (AlphaIter src = srcBegin; src < srcEnd; ++src, dst += dstStride) {
-                uint32_t leadingEdge = *src;
+                Sum leadingEdge = *src;
                 sum0 += leadingEdge;
                 sum1 += sum0;
                 sum2 += sum1;
 
-                *dst = this->finalScale(sum2);
+                this->store(dst, sum2);
 
                 sum2 -= *buffer2Cursor;
                 *buffer2Cursor = sum1;
@@ -143,12 +195,12 @@ public:
 
             // The leading edge is off the right side of the mask.
             for (int i = 0; i < fNoChangeCount; i++) {
-                uint32_t leadingEdge = 0;
+                Sum leadingEdge = 0;
                 sum0 += leadingEdge;
                 sum1 += sum0;
                 sum2 += sum1;
 
-                *dst = this->finalScale(sum2);
+                this->store(dst, sum2);
 
                 sum2 -= *buffer2Cursor;
                 *buffer2Cursor = sum1;
@@ -174,12 +226,12 @@ public:
             AlphaIter src = srcEnd;
             while (dstCursor > dst) {
                 dstCursor -= dstStride;
-                uint32_t leadingEdge = *(--src);
+                Sum leadingEdge = *(--src);
                 sum0 += leadingEdge;
                 sum1 += sum0;
                 sum2 += sum1;
 
-                *dstCursor = this->finalScale(sum2);
+                this->store(dstCursor, sum2);
 
                 sum2 -= *buffer2Cursor;
                 *buffer2Cursor = sum1;
@@ -196,31 +248,36 @@ public:
         }
 
     private:
-        inline static constexpr uint64_t kHalf = static_cast<uint64_t>(1) << 31;
-
-        uint8_t finalScale(uint32_t sum) const {
-            return SkTo<uint8_t>((fWeight * sum + kHalf) >> 32);
+        // Lanes only multiply 32 bits at a time, so the weight is rounded to 24 bits of fraction.
+        // Single rows round the same way, so a pixel doesn't depend on which rows were grouped.
+        SK_ALWAYS_INLINE void store(uint8_t* dst, Sum sum) const {
+            if constexpr (std::is_same_v<Sum, uint32_t>) {
+                *dst = SkTo<uint8_t>((sum * fScale24 + (1 << 23)) >> 24);
+            } else {
+                skvx::cast<uint8_t>((sum * fScale24 + (1 << 23)) >> 24).store(dst);
+            }
         }
 
-        uint64_t  fWeight;
-        int       fNoChangeCount;
-        uint32_t* fBuffer0;
-        uint32_t* fBuffer0End;
-        uint32_t* fBuffer1;
-        uint32_t* fBuffer1End;
-        uint32_t* fBuffer2;
-        uint32_t* fBuffer2End;
+        uint32_t fScale24;
+        int      fNoChangeCount;
+        Sum*     fBuffer0;
+        Sum*     fBuffer0End;
+        Sum*     fBuffer1;
+        Sum*     fBuffer1End;
+        Sum*     fBuffer2;
+        Sum*     fBuffer2End;
     };
 
-    Scan makeBlurScan(int width, uint32_t* buffer) const {
-        uint32_t* buffer0, *buffer0End, *buffer1, *buffer1End, *buffer2, *buffer2End;
+    template <typename Sum>
+    Scan<Sum> makeBlurScan(int width, Sum* buffer) const {
+        Sum* buffer0, *buffer0End, *buffer1, *buffer1End, *buffer2, *buffer2End;
         buffer0 = buffer;
         buffer0End = buffer1 = buffer0 + fPass0Size;
         buffer1End = buffer2 = buffer1 + fPass1Size;
         buffer2End = buffer2 + fPass2Size;
         int noChangeCount = fSlidingWindow > width ? fSlidingWindow - width : 0;
 
-        return Scan(
+        return Scan<Sum>(
             fWeight, noChangeCount,
             buffer0, buffer0End,
             buffer1, buffer1End,
@@ -950,6 +1007,173 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
     return {radiusX, radiusY};
 }
 
+// Blurs with a sigma at least this large are computed at a lower resolution.
+static constexpr double kMinDownsampleSigma = 16;
+
+// Adds the box filtered, fx by fy downsampled src to small, which is smallW wide. Pixels past the
+// edges of src count as zero.
+template <typename AlphaIter>
+static void box_downsample(AlphaIter row, uint32_t rowBytes, int srcW, int srcH, int fx, int fy,
+                           uint8_t* small, int smallW) {
+    skia_private::AutoTMalloc<uint32_t> sums(smallW);
+    const int shift = SkPrevLog2(fx * fy);
+    for (int y = 0; y < srcH; y += fy, small += smallW) {
+        std::fill_n(sums.get(), smallW, 0);
+        for (int r = y; r < std::min(y + fy, srcH); ++r) {
+            AlphaIter src = row;
+            for (int x = 0; x < srcW; ++x, ++src) {
+                sums[x / fx] += *src;
+            }
+            if (r + 1 < srcH) {
+                row >>= rowBytes;
+            }
+        }
+        for (int x = 0; x < smallW; ++x) {
+            small[x] = SkTo<uint8_t>((sums[x] + (fx * fy / 2)) >> shift);
+        }
+    }
+}
+
+// For each pixel along one axis of the destination, the two pixels of the blurred small mask
+// that bracket its center, and the weight of the second of them out of 256.
+struct UpsampleTap {
+    int fIndex;
+    int fWeight;
+};
+
+static void make_upsample_taps(int dstSize, int border, int factor, int smallBorder,
+                               UpsampleTap* taps) {
+    for (int d = 0; d < dstSize; ++d) {
+        // Small pixel j is centered over src pixels [(j - smallBorder) * factor, ... + factor).
+        double u = (d - border + 0.5) / factor - 0.5 + smallBorder;
+        int j = sk_double_floor2int(u);
+        int w = sk_double_round2int((u - j) * 256);
+        if (w == 256) {
+            j += 1;
+            w = 0;
+        }
+        taps[d] = {j, w};
+    }
+}
+
+// For sigmas of kMinDownsampleSigma and more, src is box filtered down by a power of two along
+// each axis, blurred with the correspondingly smaller sigma, and interpolated back up bilinearly
+// into the same destination the full resolution blur would fill. The box filter and the
+// interpolation blur a little themselves, so the smaller sigma makes up only the rest.
+static SkIPoint downsampled_blur(double sigmaW, double sigmaH,
+                                 const SkMask& src, SkMaskBuilder* dst) {
+    PlanGauss planW(sigmaW);
+    PlanGauss planH(sigmaH);
+
+    int borderW = planW.border(),
+        borderH = planH.border();
+
+    *dst = SkMaskBuilder::PrepareDestination(borderW, borderH, src);
+    if (src.fImage == nullptr) {
+        return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
+    }
+    if (dst->fImage == nullptr) {
+        dst->bounds().setEmpty();
+        return {0, 0};
+    }
+
+    // Leave at least kMinDownsampleSigma / 2 to blur at the lower resolution.
+    auto factorFor = [](double sigma) {
+        int factor = 1;
+        while (sigma / (2 * factor) >= kMinDownsampleSigma / 2) {
+            factor *= 2;
+        }
+        return factor;
+    };
+    auto smallSigma = [](double sigma, int factor) {
+        return std::sqrt(std::max(0.0, (sigma * sigma - (factor * factor - 1) / 4.0)) /
+                         (factor * factor));
+    };
+    const int fx = factorFor(sigmaW),
+              fy = factorFor(sigmaH);
+
+    int srcW = src.fBounds.width(),
+        srcH = src.fBounds.height(),
+        dstW = dst->fBounds.width(),
+        dstH = dst->fBounds.height(),
+        smallW = (srcW + fx - 1) / fx,
+        smallH = (srcH + fy - 1) / fy;
+
+    SkMaskBuilder small(SkMaskBuilder::AllocImage(SkToSizeT(smallW) * smallH),
+                        SkIRect::MakeWH(smallW, smallH), SkToU32(smallW), SkMask::kA8_Format);
+    SkAutoMaskFreeImage smallImage(small.image());
+    switch (src.fFormat) {
+        case SkMask::kBW_Format:
+            box_downsample(SkMask::AlphaIter<SkMask::kBW_Format>(src.fImage, 0),
+                           src.fRowBytes, srcW, srcH, fx, fy, small.image(), smallW);
+            break;
+        case SkMask::kA8_Format:
+            box_downsample(SkMask::AlphaIter<SkMask::kA8_Format>(src.fImage),
+                           src.fRowBytes, srcW, srcH, fx, fy, small.image(), smallW);
+            break;
+        case SkMask::kARGB32_Format:
+            box_downsample(SkMask::AlphaIter<SkMask::kARGB32_Format>(
+                                   reinterpret_cast<const uint32_t*>(src.fImage)),
+                           src.fRowBytes, srcW, srcH, fx, fy, small.image(), smallW);
+            break;
+        case SkMask::kLCD16_Format:
+            box_downsample(SkMask::AlphaIter<SkMask::kLCD16_Format>(
+                                   reinterpret_cast<const uint16_t*>(src.fImage)),
+                           src.fRowBytes, srcW, srcH, fx, fy, small.image(), smallW);
+            break;
+        default:
+            SK_ABORT("Unhandled format.");
+    }
+
+    SkMaskBuilder blurred;
+    SkIPoint smallBorder = SkMaskBlurFilter(smallSigma(sigmaW, fx), smallSigma(sigmaH, fy))
+                                   .blur(small, &blurred);
+    SkAutoMaskFreeImage blurredImage(blurred.image());
+    if (blurred.fImage == nullptr) {
+        std::memset(dst->image(), 0, dst->computeImageSize());
+        return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
+    }
+    const int blurredW = blurred.fBounds.width(),
+              blurredH = blurred.fBounds.height();
+
+    skia_private::AutoTMalloc<UpsampleTap> tapsX(dstW), tapsY(dstH);
+    make_upsample_taps(dstW, borderW, fx, smallBorder.x(), tapsX.get());
+    make_upsample_taps(dstH, borderH, fy, smallBorder.y(), tapsY.get());
+
+    // Interpolate each row of the blurred mask horizontally, in 8.8 fixed point. Pixels past the
+    // edges of the blurred mask are zero.
+    skia_private::AutoTMalloc<uint16_t> rows(SkToSizeT(dstW) * blurredH);
+    for (int y = 0; y < blurredH; ++y) {
+        const uint8_t* in = blurred.fImage + y * blurred.fRowBytes;
+        uint16_t* out = rows.get() + SkToSizeT(y) * dstW;
+        for (int x = 0; x < dstW; ++x) {
+            const int j = tapsX[x].fIndex,
+                      w = tapsX[x].fWeight;
+            const uint32_t a = 0 <= j     && j     < blurredW ? in[j]     : 0,
+                           b = 0 <= j + 1 && j + 1 < blurredW ? in[j + 1] : 0;
+            out[x] = SkTo<uint16_t>(a * (256 - w) + b * w);
+        }
+    }
+
+    // Then interpolate those rows vertically into dst.
+    skia_private::AutoTMalloc<uint16_t> zeros(dstW);
+    std::fill_n(zeros.get(), dstW, 0);
+    auto row = [&](int j) {
+        return 0 <= j && j < blurredH ? rows.get() + SkToSizeT(j) * dstW : zeros.get();
+    };
+    for (int y = 0; y < dstH; ++y) {
+        const uint16_t* a = row(tapsY[y].fIndex);
+        const uint16_t* b = row(tapsY[y].fIndex + 1);
+        const uint32_t w = tapsY[y].fWeight;
+        uint8_t* out = dst->image() + SkToSizeT(y) * dst->fRowBytes;
+        for (int x = 0; x < dstW; ++x) {
+            out[x] = SkTo<uint8_t>((a[x] * (256 - w) + b[x] * w + (1 << 15)) >> 16);
+        }
+    }
+
+    return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
+}
+
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
 SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMaskBuilder* dst) const {
@@ -958,6 +1182,10 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMaskBuilder* dst) const {
         return small_blur(fSigmaW, fSigmaH, src, dst);
     }
 
+    if (std::max(fSigmaW, fSigmaH) >= kMinDownsampleSigma) {
+        return downsampled_blur(fSigmaW, fSigmaH, src, dst);
+    }
+
     // 1024 is a place holder guess until more analysis can be done.
     SkSTArenaAlloc<1024> alloc;
 
@@ -985,65 +1213,68 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMaskBuilder* dst) const {
 
     auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
     auto buffer = alloc.makeArrayDefault<uint32_t>(bufferSize);
+    auto rowsBuffer = alloc.makeArrayDefault<RowSums>(bufferSize);
 
-    // Blur both directions.
+    // Blur both directions. Both passes blur kRows rows at a time, so the rows of tmp are padded
+    // to a multiple of kRows.
     int tmpW = srcH,
-        tmpH = dstW;
+        tmpH = dstW,
+        tmpStride = SkAlignTo(tmpW, kRows);
 
     // Make sure not to overflow the multiply for the tmp buffer size.
-    if (tmpH > std::numeric_limits<int>::max() / tmpW) {
+    if (tmpH > std::numeric_limits<int>::max() / tmpStride) {
         return {0, 0};
     }
-    auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
+    auto tmp = alloc.makeArrayDefault<uint8_t>(tmpStride * tmpH);
+    auto interleaved = alloc.makeArrayDefault<uint32_t>(kRows * std::max(srcW, tmpW));
 
     // Blur horizontally, and transpose.
-    const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
-    switch (src.fFormat) {
-        case SkMask::kBW_Format: {
-            const uint8_t* bwStart = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
-            auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kA8_Format: {
-            const uint8_t* a8Start = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
-            auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kARGB32_Format: {
-            const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
-            auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+    auto scanW = planW.makeBlurScan(srcW, rowsBuffer);
+    auto blurRows = [&](auto start) {
+        for (int y = 0; y < srcH; y += kRows) {
+            interleave_rows(start, src.fRowBytes, srcW, std::min(kRows, srcH - y), interleaved);
+            auto tmpStart = &tmp[y];
+            scanW.blur(InterleavedIter(interleaved), InterleavedIter(interleaved + kRows * srcW),
+                       tmpStart, tmpStride, tmpStart + tmpStride * tmpH);
+            if (y + kRows < srcH) {
+                start >>= kRows * src.fRowBytes;
             }
-        } break;
-        case SkMask::kLCD16_Format: {
-            const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
-            auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
+        }
+    };
+    switch (src.fFormat) {
+        case SkMask::kBW_Format:
+            blurRows(SkMask::AlphaIter<SkMask::kBW_Format>(src.fImage, 0));
+            break;
+        case SkMask::kA8_Format:
+            blurRows(SkMask::AlphaIter<SkMask::kA8_Format>(src.fImage));
+            break;
+        case SkMask::kARGB32_Format:
+            blurRows(SkMask::AlphaIter<SkMask::kARGB32_Format>(
+                    reinterpret_cast<const uint32_t*>(src.fImage)));
+            break;
+        case SkMask::kLCD16_Format:
+            blurRows(SkMask::AlphaIter<SkMask::kLCD16_Format>(
+                    reinterpret_cast<const uint16_t*>(src.fImage)));
+            break;
         default:
             SK_ABORT("Unhandled format.");
     }
 
     // Blur vertically (scan in memory order because of the transposition),
-    // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
+    // and transpose back to the original orientation. Each group of kRows rows of tmp fills
+    // as many consecutive columns of dst; the leftover rows are blurred one at a time.
+    auto rowsScanH = planH.makeBlurScan(tmpW, rowsBuffer);
+    int y = 0;
+    for (; y + kRows <= tmpH; y += kRows) {
+        interleave_rows(SkMask::AlphaIter<SkMask::kA8_Format>(&tmp[y * tmpStride]), tmpStride,
+                        tmpW, kRows, interleaved);
+        auto dstStart = &dst->image()[y];
+        rowsScanH.blur(InterleavedIter(interleaved), InterleavedIter(interleaved + kRows * tmpW),
+                       dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
+    }
+    auto scanH = planH.makeBlurScan(tmpW, buffer);
+    for (; y < tmpH; y++) {
+        auto tmpStart = &tmp[y * tmpStride];
         auto dstStart = &dst->image()[y];
 
         scanH.blur(tmpStart, tmpStart + tmpW,
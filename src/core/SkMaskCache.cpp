@@ -7,17 +7,22 @@
 
 #include "src/core/SkMaskCache.h"
 
+#include "include/core/SkPath.h"
+#include "include/core/SkPoint.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSize.h"
 #include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTemplates.h"
 #include "src/base/SkTLazy.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkResourceCache.h"
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 class SkDiscardableMemory;
 enum SkBlurStyle : int;
@@ -195,3 +200,115 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style,
     RectsBlurKey key(sigma, style, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gConvexPathBlurKeyNamespaceLabel;
+
+struct ConvexPathBlurKey : public SkResourceCache::Key {
+public:
+    static constexpr int kMaxPoints = SkMaskCache::kMaxConvexPathPoints;
+    static constexpr int kMaxVerbs = kMaxPoints + 2;
+
+    ConvexPathBlurKey(SkScalar sigma, SkBlurStyle style, const SkPath& path)
+        : fSigma(sigma)
+        , fStyle(style)
+        , fPointCount(path.countPoints())
+        , fVerbCount(path.countVerbs())
+    {
+        SkASSERT(SkMaskCache::CanCacheConvexPath(path));
+        const SkIRect ir = path.getBounds().roundOut();
+        const SkPoint* points = SkPathPriv::PointData(path);
+        const SkScalar* weights = SkPathPriv::ConicWeightData(path);
+        const int weightCount = SkPathPriv::ConicWeightCnt(path);
+
+        // Only the used part of fData is hashed and compared, but a key is copied whole.
+        sk_bzero(fData, sizeof(fData));
+        int n = 0;
+        for (int i = 0; i < fPointCount; ++i) {
+            fData[n++] = points[i].fX - ir.fLeft;
+            fData[n++] = points[i].fY - ir.fTop;
+        }
+        for (int i = 0; i < weightCount; ++i) {
+            fData[n++] = weights[i];
+        }
+        // The verbs are packed at the end, four to a float.
+        std::memcpy(&fData[n], SkPathPriv::VerbData(path), fVerbCount);
+        n += (fVerbCount + 3) / 4;
+
+        this->init(&gConvexPathBlurKeyNamespaceLabel, 0,
+                   sizeof(fSigma) + sizeof(fStyle) + sizeof(fPointCount) + sizeof(fVerbCount) +
+                   n * sizeof(fData[0]));
+    }
+
+    SkScalar    fSigma;
+    int32_t     fStyle;
+    int32_t     fPointCount;
+    int32_t     fVerbCount;
+    // Points, then conic weights (at most one per two points), then verbs.
+    SkScalar    fData[2 * kMaxPoints + kMaxPoints / 2 + kMaxVerbs / 4 + 1];
+};
+
+struct ConvexPathBlurRec : public SkResourceCache::Rec {
+    ConvexPathBlurRec(const ConvexPathBlurKey& key, const SkMask& mask, SkCachedData* data)
+        : fKey(key), fValue({{nullptr, mask.fBounds, mask.fRowBytes, mask.fFormat}, data})
+    {
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~ConvexPathBlurRec() override {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    ConvexPathBlurKey fKey;
+    MaskValue         fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "convex-path-blur"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const ConvexPathBlurRec& rec = static_cast<const ConvexPathBlurRec&>(baseRec);
+        SkTLazy<MaskValue>* result = static_cast<SkTLazy<MaskValue>*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        result->init(rec.fValue);
+        return true;
+    }
+};
+} // namespace
+
+bool SkMaskCache::CanCacheConvexPath(const SkPath& path) {
+    return path.countPoints() <= ConvexPathBlurKey::kMaxPoints &&
+           path.countVerbs() <= ConvexPathBlurKey::kMaxVerbs &&
+           !path.isInverseFillType() && path.isConvex();
+}
+
+SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma, SkBlurStyle style,
+                                      const SkPath& convexPath, SkTLazy<SkMask>* mask,
+                                      SkResourceCache* localCache) {
+    SkTLazy<MaskValue> result;
+    ConvexPathBlurKey key(sigma, style, convexPath);
+    if (!CHECK_LOCAL(localCache, find, Find, key, ConvexPathBlurRec::Visitor, &result)) {
+        return nullptr;
+    }
+
+    mask->init(static_cast<const uint8_t*>(result->fData->data()),
+               result->fMask.fBounds, result->fMask.fRowBytes, result->fMask.fFormat);
+    return result->fData;
+}
+
+void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style,
+                      const SkPath& convexPath, const SkMask& mask, SkCachedData* data,
+                      SkResourceCache* localCache) {
+    ConvexPathBlurKey key(sigma, style, convexPath);
+    return CHECK_LOCAL(localCache, add, Add, new ConvexPathBlurRec(key, mask, data));
+}
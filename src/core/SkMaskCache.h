@@ -11,6 +11,7 @@
 #include "include/core/SkScalar.h"
 
 class SkCachedData;
+class SkPath;
 class SkRRect;
 class SkResourceCache;
 enum SkBlurStyle : int;
@@ -20,6 +21,12 @@ template <typename T> class SkTLazy;
 
 class SkMaskCache {
 public:
+    // Convex paths are cached only when they have at most this many points (and at most two more
+    // verbs), which covers ovals and simple polygons.
+    static constexpr int kMaxConvexPathPoints = 32;
+
+    static bool CanCacheConvexPath(const SkPath&);
+
     /**
      * On success, return a ref to the SkCachedData that holds the pixels, and have mask
      * already point to that memory.
@@ -32,6 +39,14 @@ public:
     static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style,
                                     const SkRect rects[], int count, SkTLazy<SkMask>* mask,
                                     SkResourceCache* localCache = nullptr);
+    /**
+     * Convex paths are keyed by their shape relative to the top-left of their rounded-out
+     * bounds, so the same path at any integer translation shares the entry. The mask's bounds are
+     * relative to that corner too.
+     */
+    static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style,
+                                    const SkPath& convexPath, SkTLazy<SkMask>* mask,
+                                    SkResourceCache* localCache = nullptr);
 
     /**
      * Add a mask and its pixel-data to the cache.
@@ -42,6 +57,9 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+    static void Add(SkScalar sigma, SkBlurStyle style,
+                    const SkPath& convexPath, const SkMask& mask, SkCachedData* data,
+                    SkResourceCache* localCache = nullptr);
 };
 
 #endif
@@ -33,16 +33,24 @@
 class SkRRect;
 struct SkDeserialProcs;
 
-SkMaskFilterBase::NinePatch::~NinePatch() {
-    if (fCache) {
-        SkASSERT((const void*)fMask.fImage == fCache->data());
-        fCache->unref();
+static void unref_cache_or_free_image(const SkMask& mask, SkCachedData* cache) {
+    if (cache) {
+        SkASSERT((const void*)mask.fImage == cache->data());
+        cache->unref();
     } else {
-        // fMask is about to be destroyed and "owns" its fImage.
-        SkMaskBuilder::FreeImage(const_cast<uint8_t*>(fMask.fImage));
+        // mask is about to be destroyed and "owns" its fImage.
+        SkMaskBuilder::FreeImage(const_cast<uint8_t*>(mask.fImage));
     }
 }
 
+SkMaskFilterBase::NinePatch::~NinePatch() {
+    unref_cache_or_free_image(fMask, fCache);
+}
+
+SkMaskFilterBase::CachedMask::~CachedMask() {
+    unref_cache_or_free_image(fMask, fCache);
+}
+
 bool SkMaskFilterBase::asABlur(BlurRec*) const {
     return false;
 }
@@ -203,6 +211,22 @@ static void draw_nine(const SkMask& mask, const SkIRect& outerR, const SkIPoint&
     }
 }
 
+static void draw_mask(const SkMask& mask, const SkRasterClip& clip, SkBlitter* blitter) {
+    // if we get here, we need to (possibly) resolve the clip and blitter
+    SkAAClipBlitterWrapper wrapper(clip, blitter);
+    blitter = wrapper.getBlitter();
+
+    SkRegion::Cliperator clipper(wrapper.getRgn(), mask.fBounds);
+
+    if (!clipper.done()) {
+        const SkIRect& cr = clipper.rect();
+        do {
+            blitter->blitMask(mask, cr);
+            clipper.next();
+        } while (!clipper.done());
+    }
+}
+
 static int countNestedRects(const SkPath& path, SkRect rects[2]) {
     if (SkPathPriv::IsNestedFillRects(path, rects)) {
         return 2;
@@ -252,6 +276,23 @@ bool SkMaskFilterBase::filterPath(const SkPath& devPath, const SkMatrix& matrix,
                 // fall out
                 break;
         }
+    } else if (SkStrokeRec::kFill_InitStyle == style && devPath.isConvex()) {
+        SkTLazy<CachedMask> cached;
+
+        switch (this->filterConvexPath(devPath, matrix, clip.getBounds(), &cached)) {
+            case kFalse_FilterReturn:
+                SkASSERT(!cached.isValid());
+                return false;
+
+            case kTrue_FilterReturn:
+                draw_mask(cached->fMask, clip, blitter);
+                return true;
+
+            case kUnimplemented_FilterReturn:
+                SkASSERT(!cached.isValid());
+                // fall out
+                break;
+        }
     }
 
     SkMaskBuilder srcM, dstM;
@@ -273,20 +314,7 @@ bool SkMaskFilterBase::filterPath(const SkPath& devPath, const SkMatrix& matrix,
     }
     SkAutoMaskFreeImage autoDst(dstM.image());
 
-    // if we get here, we need to (possibly) resolve the clip and blitter
-    SkAAClipBlitterWrapper wrapper(clip, blitter);
-    blitter = wrapper.getBlitter();
-
-    SkRegion::Cliperator clipper(wrapper.getRgn(), dstM.fBounds);
-
-    if (!clipper.done()) {
-        const SkIRect& cr = clipper.rect();
-        do {
-            blitter->blitMask(dstM, cr);
-            clipper.next();
-        } while (!clipper.done());
-    }
-
+    draw_mask(dstM, clip, blitter);
     return true;
 }
 
@@ -302,6 +330,12 @@ SkMaskFilterBase::filterRectsToNine(const SkRect[], int count, const SkMatrix&,
     return kUnimplemented_FilterReturn;
 }
 
+SkMaskFilterBase::FilterReturn
+SkMaskFilterBase::filterConvexPath(const SkPath&, const SkMatrix&,
+                                   const SkIRect& clipBounds, SkTLazy<CachedMask>*) const {
+    return kUnimplemented_FilterReturn;
+}
+
 void SkMaskFilterBase::computeFastBounds(const SkRect& src, SkRect* dst) const {
     SkMask srcM(nullptr, src.roundOut(), 0, SkMask::kA8_Format);
     SkMaskBuilder dstM;
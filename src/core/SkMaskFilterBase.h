@@ -160,6 +160,25 @@ protected:
                                            const SkIRect& clipBounds,
                                            SkTLazy<NinePatch>*) const;
 
+    class CachedMask : ::SkNoncopyable {
+    public:
+        CachedMask(const SkMask& mask, SkCachedData* cache) : fMask(mask), fCache(cache) {}
+        ~CachedMask();
+
+        SkMask        fMask;    // in device space
+        SkCachedData* fCache = nullptr;
+    };
+
+    /**
+     *  Override if your subclass can filter a filled convex path (in device space) and reuse the
+     *  result when the same shape is drawn again, e.g. by caching it in SkMaskCache. On success
+     *  return kTrue_FilterReturn with the whole filtered mask; the caller clips it. Return values
+     *  are otherwise as for filterRectsToNine.
+     */
+    virtual FilterReturn filterConvexPath(const SkPath& devPath, const SkMatrix&,
+                                          const SkIRect& clipBounds,
+                                          SkTLazy<CachedMask>*) const;
+
 private:
     friend class SkDraw;
     friend class SkDrawBase;
@@ -15,7 +15,10 @@
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkMipmapBuilder.h"
 
+#include <atomic>
+#include <memory>
 #include <new>
+#include <utility>
 
 //
 // ColorTypeFilter is the "Type" we pass to some downsample template functions.
@@ -83,6 +86,7 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
     // init
     mipmap->fCS = sk_ref_sp(src.info().colorSpace());
     mipmap->fCount = countLevels;
+    mipmap->fBuiltCount.store(countLevels, std::memory_order_relaxed);
     mipmap->fLevels = (Level*)mipmap->writable_data();
     SkASSERT(mipmap->fLevels);
 
@@ -232,6 +236,7 @@ bool SkMipmap::extractLevel(SkSize scaleSize, Level* levelPtr) const {
         level = fCount;
     }
     if (levelPtr) {
+        this->buildLevels(level);
         *levelPtr = fLevels[level - 1];
         // need to augment with our colorspace
         levelPtr->fPixmap.setColorSpace(fCS);
@@ -273,6 +278,48 @@ SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
     return Build(srcPixmap, fact);
 }
 
+SkMipmap* SkMipmap::BuildLazy(const SkBitmap& src, SkDiscardableFactoryProc fact) {
+    SkPixmap srcPixmap;
+    if (!src.peekPixels(&srcPixmap)) {
+        return nullptr;
+    }
+    std::unique_ptr<SkMipmapDownSampler> downsampler = MakeDownSampler(srcPixmap);
+    if (!downsampler) {
+        return nullptr;
+    }
+    SkMipmap* mipmap = Build(srcPixmap, fact, /*computeContents=*/false);
+    if (mipmap) {
+        mipmap->fBuiltCount.store(0, std::memory_order_relaxed);
+        mipmap->fLazySrc = src;
+        mipmap->fLazyDownSampler = std::move(downsampler);
+    }
+    return mipmap;
+}
+
+void SkMipmap::buildLevels(int count) const {
+    SkASSERT(count <= fCount);
+    if (fBuiltCount.load(std::memory_order_acquire) >= count) {
+        return;
+    }
+
+    SkAutoMutexExclusive lock(fLazyMutex);
+    int built = fBuiltCount.load(std::memory_order_relaxed);
+    if (built >= count) {
+        return;  // another thread got here first
+    }
+    SkPixmap srcPM = built > 0 ? fLevels[built - 1].fPixmap : fLazySrc.pixmap();
+    for (; built < count; ++built) {
+        fLazyDownSampler->buildLevel(fLevels[built].fPixmap, srcPM);
+        srcPM = fLevels[built].fPixmap;
+    }
+    fBuiltCount.store(built, std::memory_order_release);
+
+    if (built == fCount) {
+        fLazySrc.reset();
+        fLazyDownSampler.reset();
+    }
+}
+
 int SkMipmap::countLevels() const {
     return fCount;
 }
@@ -288,6 +335,7 @@ bool SkMipmap::getLevel(int index, Level* levelPtr) const {
         return false;
     }
     if (levelPtr) {
+        this->buildLevels(index + 1);
         *levelPtr = fLevels[index];
         // need to augment with our colorspace
         levelPtr->fPixmap.setColorSpace(fCS);
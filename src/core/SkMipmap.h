@@ -8,15 +8,18 @@
 #ifndef SkMipmap_DEFINED
 #define SkMipmap_DEFINED
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSize.h"
+#include "include/private/base/SkMutex.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/shaders/SkShaderBase.h"
+
+#include <atomic>
 #include <memory>
 
-class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
 class SkMipmapBuilder;
@@ -46,6 +49,12 @@ public:
 
     static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
 
+    // Like Build(), but each level's pixels are only computed the first time that level (or a
+    // smaller one) is asked for by getLevel() or extractLevel(), so sampling that only reaches the
+    // first few levels doesn't pay for the rest. Holds a ref on src's pixels until the last level
+    // is built.
+    static SkMipmap* BuildLazy(const SkBitmap& src, SkDiscardableFactoryProc);
+
     // Determines how many levels a SkMipmap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
     // creating the SkMipmap.
@@ -96,10 +105,20 @@ private:
     Level*              fLevels;    // managed by the baseclass, may be null due to onDataChanged.
     int                 fCount;
 
+    // The number of levels whose pixels have been computed; less than fCount only when lazy.
+    mutable std::atomic<int> fBuiltCount{0};
+    // The base level and downsampler for the levels not built yet, guarded by fLazyMutex.
+    mutable SkMutex                              fLazyMutex;
+    mutable SkBitmap                             fLazySrc;
+    mutable std::unique_ptr<SkMipmapDownSampler> fLazyDownSampler;
+
     SkMipmap(void* malloc, size_t size);
     SkMipmap(size_t size, SkDiscardableMemory* dm);
 
     static size_t AllocLevelsSize(int levelCount, size_t pixelSize);
+
+    // Computes the pixels of the first 'count' levels, if they aren't already.
+    void buildLevels(int count) const;
 };
 
 #endif
@@ -13,6 +13,7 @@
 #include "src/base/SkHalf.h"
 #include "src/base/SkVx.h"
 #include "src/core/SkMipmap.h"
+#include "src/core/SkTaskGroup.h"
 
 namespace {
 
@@ -374,6 +375,46 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
+// The 2x2 box is by far the most common filter (every level of a power-of-two image), so formats
+// with 8-bit channels get a wide version of it. Each lane of a Pair holds two adjacent src pixels.
+// Splitting their bytes into even and odd ones leaves every byte in a 16-bit field, with room for
+// the sum of four pixels, so the results match downsample_2_2<F> exactly.
+template <typename Pair, typename F>
+void downsample_2_2_bytes(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    constexpr int N = 8;
+    using V = skvx::Vec<N, Pair>;
+    constexpr int kPixelBytes = sizeof(Pair) / 2;
+    constexpr Pair kBytes = static_cast<Pair>(~Pair(0)) / 0xFFFF * 0x00FF;  // 0x00FF00FF...
+
+    auto p0 = static_cast<const char*>(src);
+    auto p1 = p0 + srcRB;
+    auto d = static_cast<char*>(dst);
+
+    int i = 0;
+    for (; i + N <= count; i += N) {
+        const V r0 = V::Load(p0 + i * sizeof(Pair)),
+                r1 = V::Load(p1 + i * sizeof(Pair));
+        V even = (r0 & kBytes) + (r1 & kBytes),
+          odd  = ((r0 >> 8) & kBytes) + ((r1 >> 8) & kBytes);
+        V out;
+        if constexpr (kPixelBytes == 1) {
+            // The even and odd bytes are the two pixels.
+            out = (even + odd) >> 2;
+        } else {
+            // Fold the high pixel of each lane onto the low one.
+            even = even + (even >> (8 * kPixelBytes));
+            odd  = odd  + (odd  >> (8 * kPixelBytes));
+            out = ((even >> 2) & kBytes) | (((odd >> 2) & kBytes) << 8);
+        }
+        using Pixel = typename F::Type;
+        static_assert(sizeof(Pixel) == kPixelBytes);
+        skvx::cast<Pixel>(out).store(d + i * kPixelBytes);
+    }
+    if (i < count) {
+        downsample_2_2<F>(d + i * kPixelBytes, p0 + i * sizeof(Pair), srcRB, count - i);
+    }
+}
 
 typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
 
@@ -425,15 +466,21 @@ void HQDownSampler::buildLevel(const SkPixmap& dst, const SkPixmap& src) {
         }
     }
 
-    const void* srcBasePtr = src.addr();
     const size_t srcRB = src.rowBytes();
-    void* dstBasePtr = dst.writable_addr();
+    auto filterRows = [&](int firstRow, int endRow) {
+        const void* srcBasePtr = (const char*)src.addr() + srcRB * 2 * firstRow;
+        void* dstBasePtr = (char*)dst.writable_addr() + dst.rowBytes() * firstRow;
+
+        for (int y = firstRow; y < endRow; y++) {
+            proc(dstBasePtr, srcBasePtr, srcRB, dst.width());
+            srcBasePtr = (const char*)srcBasePtr + srcRB * 2; // jump two rows
+            dstBasePtr = (      char*)dstBasePtr + dst.rowBytes();
+        }
+    };
 
-    for (int y = 0; y < dst.height(); y++) {
-        proc(dstBasePtr, srcBasePtr, srcRB, dst.width());
-        srcBasePtr = (const char*)srcBasePtr + srcRB * 2; // jump two rows
-        dstBasePtr = (      char*)dstBasePtr + dst.rowBytes();
-    }
+    // Large levels are filtered in bands of rows, in parallel. Each dst row only reads its own
+    // two or three src rows, so the bands are independent.
+    SkTaskGroup::ForEachBand(dst.height(), dst.width(), filterRows);
 }
 
 } // namespace
@@ -454,7 +501,7 @@ std::unique_ptr<SkMipmapDownSampler> SkMipmap::MakeDownSampler(const SkPixmap& r
             proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
+            proc_2_2 = downsample_2_2_bytes<uint64_t, ColorTypeFilter_8888>;
             proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
@@ -486,7 +533,7 @@ std::unique_ptr<SkMipmapDownSampler> SkMipmap::MakeDownSampler(const SkPixmap& r
             proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
+            proc_2_2 = downsample_2_2_bytes<uint16_t, ColorTypeFilter_8>;
             proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
@@ -507,7 +554,7 @@ std::unique_ptr<SkMipmapDownSampler> SkMipmap::MakeDownSampler(const SkPixmap& r
             proc_1_2 = downsample_1_2<ColorTypeFilter_88>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_88>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_88>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_88>;
+            proc_2_2 = downsample_2_2_bytes<uint32_t, ColorTypeFilter_88>;
             proc_2_3 = downsample_2_3<ColorTypeFilter_88>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_88>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_88>;
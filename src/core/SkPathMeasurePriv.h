@@ -10,8 +10,13 @@
 
 #include "include/core/SkPath.h"
 #include "include/core/SkPoint.h"
+#include "include/core/SkScalar.h"
+#include "include/core/SkSpan.h"
+#include "include/private/base/SkTArray.h"
 #include "src/core/SkGeometry.h"
 
+struct SkRect;
+
 // Used in the Segment struct defined in SkPathMeasure.h
 // It is used as a 2-bit field so if you add to this
 // you must increase the size of the bitfield there.
@@ -26,13 +31,34 @@ enum SkSegType {
 void SkPathMeasure_segTo(const SkPoint pts[], unsigned segType,
                    SkScalar startT, SkScalar stopT, SkPath* dst);
 
-// for testing
-
+class SkContourMeasure;
 class SkPathMeasure;
 
 class SkPathMeasurePriv {
 public:
+    // for testing
     static size_t CountSegments(const SkPathMeasure&);
+
+    // A range of distances along a contour.
+    struct Span {
+        SkScalar fStart;
+        SkScalar fStop;
+    };
+
+    /**
+     *  Appends to spans the ranges of the contour that may touch bounds, in increasing order.
+     *  Each line or curve is kept if the bounds of its points touch bounds; curves that do are
+     *  then narrowed down to the pieces they were measured with. Adjacent ranges are merged.
+     */
+    static void VisibleSpans(const SkContourMeasure&, const SkRect& bounds,
+                             skia_private::TArray<Span>* spans);
+
+    /**
+     *  Appends each span to dst, as getSegment(start, stop, dst, true) would. The spans must be
+     *  in increasing order, so the contour's segments are found with a single forward walk
+     *  instead of a search per span.
+     */
+    static void GetSegments(const SkContourMeasure&, SkSpan<const Span> spans, SkPath* dst);
 };
 
 #endif  // SkPathMeasurePriv_DEFINED
@@ -15,18 +15,25 @@
 #include "include/private/SkPathRef.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkPoint_impl.h"
 #include "include/private/base/SkTPin.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkAutoMalloc.h"
 #include "src/base/SkBuffer.h"
 #include "src/base/SkSafeMath.h"
+#include "src/core/SkCompactPath.h"
 #include "src/core/SkPathEnums.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkRRectPriv.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <optional>
+#include <utility>
 
 enum SerializationOffsets {
     kType_SerializationShift = 28,       // requires 4 bits
@@ -49,7 +56,8 @@ enum SerializationVersions {
 
 enum SerializationType {
     kGeneral = 0,
-    kRRect = 1
+    kRRect = 1,
+    kCompact = 2,  // written by SkCompactPath
 };
 
 static unsigned extract_version(uint32_t packed) {
@@ -224,6 +232,16 @@ size_t SkPath::readFromMemory_EQ4Or5(const void* storage, size_t length) {
             return this->readAsRRect(storage, length);
         case SerializationType::kGeneral:
             break;  // fall out
+        case SerializationType::kCompact: {
+            size_t size;
+            std::optional<SkCompactPath> compact = SkCompactPath::MakeFromMemory(storage, length,
+                                                                                &size);
+            if (!compact) {
+                return 0;
+            }
+            *this = compact->toPath();
+            return size;
+        }
         default:
             return 0;
     }
@@ -269,3 +287,157 @@ size_t SkPath::readFromMemory_EQ4Or5(const void* storage, size_t length) {
                                  extract_filltype(packed), false);
     return buffer.pos();
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// SkCompactPath
+
+SkPathFillType SkCompactPath::getFillType() const {
+    return extract_filltype(this->header().fPacked);
+}
+
+std::optional<SkCompactPath> SkCompactPath::Make(const SkPath& path, SkScalar quantum) {
+    if (!path.isFinite() || !(quantum > 0) || !SkIsFinite(quantum)) {
+        return std::nullopt;
+    }
+
+    const SkRect& bounds = path.getBounds();
+    if (bounds.width() / quantum >= kMaxGridCoord || bounds.height() / quantum >= kMaxGridCoord) {
+        return std::nullopt;
+    }
+    const SkPoint origin = {bounds.fLeft, bounds.fTop};
+
+    const int pts = path.countPoints();
+    const int cnx = SkPathPriv::ConicWeightCnt(path);
+    const int vbs = path.countVerbs();
+    const SkPoint* points = SkPathPriv::PointData(path);
+
+    // Returns the size of the encoded points, writing them if dst is not null.
+    int32_t maxX = 0, maxY = 0;
+    auto encode_points = [&](uint8_t* dst) {
+        size_t offset = 0;
+        int32_t prevX = 0, prevY = 0;
+        for (int i = 0; i < pts; ++i) {
+            int32_t x = (int32_t)std::lround((points[i].fX - origin.fX) / quantum),
+                    y = (int32_t)std::lround((points[i].fY - origin.fY) / quantum);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+            WriteVarint(ZigZag(x - prevX), dst, &offset);
+            WriteVarint(ZigZag(y - prevY), dst, &offset);
+            prevX = x;
+            prevY = y;
+        }
+        return offset;
+    };
+    const size_t pointBytes = encode_points(nullptr);
+
+    SkSafeMath safe;
+    size_t size = sizeof(Header);
+    size = safe.add(size, safe.mul(cnx, sizeof(SkScalar)));
+    size = safe.add(size, vbs);
+    size = safe.add(size, pointBytes);
+    size = safe.alignUp(size, 4);
+    if (!safe || pointBytes > SK_MaxS32) {
+        return std::nullopt;
+    }
+
+    Header header;
+    header.fPacked = ((int)path.getFillType() << kFillType_SerializationShift) |
+                     (SerializationType::kCompact << kType_SerializationShift) |
+                     kCurrent_Version;
+    header.fQuantum = quantum;
+    header.fBounds = pts ? SkRect::MakeLTRB(origin.fX,
+                                            origin.fY,
+                                            GridToCoord(origin.fX, maxX, quantum),
+                                            GridToCoord(origin.fY, maxY, quantum))
+                         : SkRect::MakeEmpty();
+    header.fVerbCount = vbs;
+    header.fPointCount = pts;
+    header.fWeightCount = cnx;
+    header.fPointByteCount = SkToS32(pointBytes);
+
+    sk_sp<SkData> data = SkData::MakeZeroInitialized(size);
+    SkWBuffer buffer(data->writable_data(), size);
+    buffer.write(&header, sizeof(Header));
+    buffer.write(SkPathPriv::ConicWeightData(path), cnx * sizeof(SkScalar));
+    buffer.write(SkPathPriv::VerbData(path), vbs);
+    encode_points(static_cast<uint8_t*>(data->writable_data()) + buffer.pos());
+    return SkCompactPath(std::move(data));
+}
+
+std::optional<SkCompactPath> SkCompactPath::MakeFromMemory(const void* storage, size_t length,
+                                                           size_t* bytesRead) {
+    SkRBuffer buffer(storage, length);
+    Header header;
+    if (!buffer.read(&header, sizeof(Header))) {
+        return std::nullopt;
+    }
+    if (extract_version(header.fPacked) != kCurrent_Version ||
+        extract_serializationtype(header.fPacked) != SerializationType::kCompact ||
+        !(header.fQuantum > 0) || !SkIsFinite(header.fQuantum) ||
+        !header.fBounds.isFinite() || !header.fBounds.isSorted() ||
+        header.fVerbCount < 0 || header.fPointCount < 0 || header.fWeightCount < 0 ||
+        header.fPointByteCount < 0) {
+        return std::nullopt;
+    }
+
+    const SkScalar* weights = buffer.skipCount<SkScalar>(header.fWeightCount);
+    const uint8_t* verbs = buffer.skipCount<uint8_t>(header.fVerbCount);
+    const uint8_t* pointBytes = buffer.skipCount<uint8_t>(header.fPointByteCount);
+    buffer.skipToAlign4();
+    if (!buffer.isValid()) {
+        return std::nullopt;
+    }
+
+    if (header.fVerbCount == 0) {
+        if (header.fPointCount != 0 || header.fWeightCount != 0) {
+            return std::nullopt;
+        }
+    } else {
+        SkPathVerbAnalysis analysis = sk_path_analyze_verbs(verbs, header.fVerbCount);
+        if (!analysis.valid || analysis.points != header.fPointCount ||
+            analysis.weights != header.fWeightCount) {
+            return std::nullopt;
+        }
+    }
+
+    for (int i = 0; i < header.fWeightCount; ++i) {
+        SkScalar weight;
+        memcpy(&weight, weights + i, sizeof(SkScalar));
+        if (!(weight > 0) || !SkIsFinite(weight)) {
+            return std::nullopt;
+        }
+    }
+
+    // The iterator trusts the points, so decode them all once, and check that they land exactly
+    // on the recorded bounds. The deltas are untrusted, so sum them in 64 bits and check each
+    // step, which keeps the iterator's 32-bit sums from overflowing.
+    const uint8_t* end = pointBytes + header.fPointByteCount;
+    int64_t x = 0, y = 0, maxX = 0, maxY = 0;
+    for (int i = 0; i < header.fPointCount; ++i) {
+        uint32_t dx, dy;
+        if (!ReadVarint(&pointBytes, end, &dx) || !ReadVarint(&pointBytes, end, &dy)) {
+            return std::nullopt;
+        }
+        x += UnZigZag(dx);
+        y += UnZigZag(dy);
+        if (x < 0 || y < 0 || x > kMaxGridCoord || y > kMaxGridCoord) {
+            return std::nullopt;
+        }
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+    if (pointBytes != end) {
+        return std::nullopt;
+    }
+    const SkRect& bounds = header.fBounds;
+    if (header.fPointCount > 0 &&
+        (GridToCoord(bounds.fLeft, (int32_t)maxX, header.fQuantum) != bounds.fRight ||
+         GridToCoord(bounds.fTop, (int32_t)maxY, header.fQuantum) != bounds.fBottom)) {
+        return std::nullopt;
+    }
+
+    if (bytesRead) {
+        *bytesRead = buffer.pos();
+    }
+    return SkCompactPath(SkData::MakeWithCopy(storage, buffer.pos()));
+}
@@ -17,15 +17,15 @@
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTileMode.h"
+#include "src/core/SkResizePixels.h"
 #include "src/shaders/SkImageShader.h"
 
 #include <utility>
 
-struct SkSamplingOptions;
-
 bool SkPixmap::scalePixels(const SkPixmap& actualDst, const SkSamplingOptions& sampling) const {
     // We may need to tweak how we interpret these just a little below, so we make copies.
     SkPixmap src = *this,
@@ -42,6 +42,12 @@ bool SkPixmap::scalePixels(const SkPixmap& actualDst, const SkSamplingOptions& s
         return src.readPixels(dst);
     }
 
+    // Cubic filters are separable, so they can run as two passes over precomputed weights, which
+    // also lets them cover every src pixel when downscaling.
+    if (sampling.useCubic) {
+        return SkResizePixels(dst, src, SkResizeFilter::Cubic(sampling.cubic));
+    }
+
     // If src and dst are both unpremul, we'll fake the source out to appear as if premul,
     // and mark the destination as opaque.  This odd combination allows us to scale unpremul
     // pixels without ever premultiplying them (perhaps losing information in the color channels).
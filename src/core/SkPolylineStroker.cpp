@@ -0,0 +1,443 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkPolylineStroker.h"
+
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPathBuilder.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkVertices.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkTDArray.h"
+#include "include/private/base/SkTPin.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkPointPriv.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Round joins and caps emitted as triangle fans deviate from the true arc by at most this much
+// (in device space, before dividing by the resolution scale).
+static constexpr SkScalar kFanTolerance = 0.25f;
+
+// Computes the normal of each segment pts[i] -> pts[i+1], scaled to the stroke radius and
+// rotated the same way as SkStroke's (CCW), so that the outer side of a clockwise turn is +normal.
+void compute_normals(const SkPoint pts[], int segCount, SkScalar radius, SkVector normals[]) {
+    int i = 0;
+    // Four segments at a time: pts[i..i+4) and pts[i+1..i+5) are loaded as interleaved x/y.
+    for (; i + 4 <= segCount; i += 4) {
+        skvx::float8 d = skvx::float8::Load(pts + i + 1) - skvx::float8::Load(pts + i);
+        skvx::float8 dd = d * d;
+        skvx::float4 lenSq = skvx::shuffle<0,2,4,6>(dd) + skvx::shuffle<1,3,5,7>(dd);
+        skvx::float4 scale = radius / skvx::sqrt(lenSq);
+        if (!skvx::all(scale * 0 == 0)) {
+            break;  // Overflow or underflow; let the scalar loop handle the rest.
+        }
+        skvx::float8 n = skvx::shuffle<1,0,3,2,5,4,7,6>(d) *
+                         skvx::float8{1, -1, 1, -1, 1, -1, 1, -1} *
+                         skvx::shuffle<0,0,1,1,2,2,3,3>(scale);
+        n.store(normals + i);
+    }
+    for (; i < segCount; ++i) {
+        SkVector n = pts[i + 1] - pts[i];
+        if (!n.setLength(radius)) {
+            n.set(radius, 0);
+        }
+        SkPointPriv::RotateCCW(&n);
+        normals[i] = n;
+    }
+}
+
+bool is_clockwise(const SkVector& before, const SkVector& after) {
+    return before.fX * after.fY > before.fY * after.fX;
+}
+
+// The points and normals of one side of a contour, walked forwards or backwards. Walking the
+// contour backwards negates every normal, so emitting the +normal side of the reversed contour
+// produces the other side of the stroke, with the same join rules.
+struct Side {
+    const SkPoint*  fPts;       // fSegCount + 1 points; closed contours repeat the first point
+    const SkVector* fNormals;   // fSegCount normals
+    int             fSegCount;
+    bool            fReversed;
+
+    SkPoint pt(int k) const { return fPts[fReversed ? fSegCount - k : k]; }
+    SkVector normal(int k) const {
+        return fReversed ? -fNormals[fSegCount - 1 - k] : fNormals[k];
+    }
+};
+
+class PathEmitter {
+public:
+    PathEmitter(SkScalar radius, SkPaint::Cap cap, SkPaint::Join join, SkScalar invMiterLimit,
+                SkPathBuilder* builder)
+        : fRadius(radius)
+        , fInvMiterLimit(invMiterLimit)
+        , fCap(cap)
+        , fJoin(join)
+        , fBuilder(builder) {}
+
+    void contour(const SkPoint pts[], const SkVector normals[], int segCount, bool closed) {
+        const Side fwd{pts, normals, segCount, false};
+        const Side rev{pts, normals, segCount, true};
+
+        fBuilder->incReserve(4 * segCount + 8);
+        fBuilder->moveTo(fwd.pt(0) + fwd.normal(0));
+        this->side(fwd, closed);
+        if (closed) {
+            fBuilder->close();
+            fBuilder->moveTo(rev.pt(0) + rev.normal(0));
+        } else {
+            this->cap(fwd.pt(segCount), fwd.normal(segCount - 1));
+        }
+        this->side(rev, closed);
+        if (!closed) {
+            this->cap(rev.pt(segCount), rev.normal(segCount - 1));
+        }
+        fBuilder->close();
+    }
+
+private:
+    void side(const Side& s, bool closed) {
+        for (int k = 0; k < s.fSegCount; ++k) {
+            const SkPoint pivot = s.pt(k + 1);
+            const SkVector before = s.normal(k);
+            if (closed || k + 1 < s.fSegCount) {
+                this->join(pivot, before, s.normal(k + 1 == s.fSegCount ? 0 : k + 1));
+            } else {
+                fBuilder->lineTo(pivot + before);
+            }
+        }
+    }
+
+    // Finishes the segment ending at pivot + before, and joins it to the one starting at
+    // pivot + after. Mirrors the joiners in SkStrokerPriv, for the +normal side only.
+    void join(SkPoint pivot, SkVector before, SkVector after) {
+        const SkScalar dot = SkPoint::DotProduct(before, after) / (fRadius * fRadius);
+        if (dot >= 0 && SkScalarNearlyZero(1 - dot)) {
+            fBuilder->lineTo(pivot + before);   // nearly a straight line
+            return;
+        }
+        if (!is_clockwise(before, after)) {
+            // This is the inside of the turn. Go through the pivot, as SkStroke does, so that a
+            // radius larger than the segments can't show a diagonal through the stroke.
+            fBuilder->lineTo(pivot + before);
+            fBuilder->lineTo(pivot);
+            fBuilder->lineTo(pivot + after);
+            return;
+        }
+
+        switch (fJoin) {
+            case SkPaint::kMiter_Join: {
+                const bool nearly180 = dot < 0 && SkScalarNearlyZero(1 + dot);
+                const SkScalar sinHalfAngle = SkScalarSqrt(SkScalarHalf(1 + dot));
+                if (!nearly180 && sinHalfAngle >= fInvMiterLimit) {
+                    SkVector mid;
+                    if (dot < 0) {
+                        mid.set(after.fY - before.fY, before.fX - after.fX);
+                    } else {
+                        mid = before + after;
+                    }
+                    mid.setLength(fRadius / sinHalfAngle);
+                    // The miter point replaces the end of the incoming segment.
+                    fBuilder->lineTo(pivot + mid);
+                    return;
+                }
+                [[fallthrough]];
+            }
+            case SkPaint::kBevel_Join:
+                fBuilder->lineTo(pivot + before);
+                fBuilder->lineTo(pivot + after);
+                return;
+            case SkPaint::kRound_Join: {
+                fBuilder->lineTo(pivot + before);
+                SkMatrix matrix = SkMatrix::Scale(fRadius, fRadius);
+                matrix.postTranslate(pivot.fX, pivot.fY);
+                SkConic conics[SkConic::kMaxConicsForArc];
+                const SkScalar invRadius = 1 / fRadius;
+                int count = SkConic::BuildUnitArc(before * invRadius, after * invRadius,
+                                                  kCW_SkRotationDirection, &matrix, conics);
+                for (int i = 0; i < count; ++i) {
+                    fBuilder->conicTo(conics[i].fPts[1], conics[i].fPts[2], conics[i].fW);
+                }
+                return;
+            }
+        }
+    }
+
+    // Caps the end of a side at pivot, going from pivot + normal to pivot - normal.
+    void cap(SkPoint pivot, SkVector normal) {
+        SkVector parallel;
+        SkPointPriv::RotateCW(normal, &parallel);
+        switch (fCap) {
+            case SkPaint::kButt_Cap:
+                fBuilder->lineTo(pivot - normal);
+                break;
+            case SkPaint::kRound_Cap: {
+                const SkPoint projectedCenter = pivot + parallel;
+                fBuilder->conicTo(projectedCenter + normal, projectedCenter, SK_ScalarRoot2Over2);
+                fBuilder->conicTo(projectedCenter - normal, pivot - normal, SK_ScalarRoot2Over2);
+                break;
+            }
+            case SkPaint::kSquare_Cap:
+                fBuilder->lineTo(pivot + normal + parallel);
+                fBuilder->lineTo(pivot - normal + parallel);
+                fBuilder->lineTo(pivot - normal);
+                break;
+        }
+    }
+
+    SkScalar       fRadius;
+    SkScalar       fInvMiterLimit;
+    SkPaint::Cap   fCap;
+    SkPaint::Join  fJoin;
+    SkPathBuilder* fBuilder;
+};
+
+class TriangleEmitter {
+public:
+    TriangleEmitter(SkScalar radius, SkPaint::Cap cap, SkPaint::Join join,
+                    SkScalar invMiterLimit, SkScalar resScale, SkTDArray<SkPoint>* tris)
+        : fRadius(radius)
+        , fInvMiterLimit(invMiterLimit)
+        , fCap(cap)
+        , fJoin(join)
+        , fTris(tris) {
+        // The largest angle a fan step can span while staying within kFanTolerance of the arc.
+        const SkScalar tol = std::min(kFanTolerance / resScale, radius);
+        fMaxFanStep = std::max(2 * std::acos(1 - tol / radius), SK_ScalarPI / 64);
+    }
+
+    void contour(const SkPoint pts[], const SkVector normals[], int segCount, bool closed) {
+        fTris->reserve(fTris->size() + 6 * segCount);
+        for (int k = 0; k < segCount; ++k) {
+            const SkVector n = normals[k];
+            const SkPoint a = pts[k] + n, b = pts[k] - n,
+                          c = pts[k + 1] + n, d = pts[k + 1] - n;
+            this->tri(a, b, c);
+            this->tri(b, d, c);
+        }
+        for (int k = closed ? 0 : 1; k < segCount; ++k) {
+            this->join(pts[k], normals[k == 0 ? segCount - 1 : k - 1], normals[k]);
+        }
+        if (!closed) {
+            this->cap(pts[segCount], normals[segCount - 1]);
+            this->cap(pts[0], -normals[0]);
+        }
+    }
+
+    void dot(SkPoint center) {
+        if (fCap == SkPaint::kRound_Cap) {
+            this->fan(center, {fRadius, 0}, 2 * SK_ScalarPI);
+        } else if (fCap == SkPaint::kSquare_Cap) {
+            const SkPoint a = center + SkVector{-fRadius, -fRadius},
+                          b = center + SkVector{ fRadius, -fRadius},
+                          c = center + SkVector{ fRadius,  fRadius},
+                          d = center + SkVector{-fRadius,  fRadius};
+            this->tri(a, b, c);
+            this->tri(a, c, d);
+        }
+    }
+
+private:
+    void tri(SkPoint a, SkPoint b, SkPoint c) {
+        SkPoint* p = fTris->append(3);
+        p[0] = a;
+        p[1] = b;
+        p[2] = c;
+    }
+
+    // Triangles from center, sweeping the radius vector 'from' through 'angle' radians.
+    void fan(SkPoint center, SkVector from, SkScalar angle) {
+        const int steps = std::max(1, (int)std::ceil(angle / fMaxFanStep));
+        const SkScalar c = std::cos(angle / steps), s = std::sin(angle / steps);
+        SkVector v = from;
+        for (int i = 0; i < steps; ++i) {
+            const SkVector next = {v.fX * c - v.fY * s, v.fX * s + v.fY * c};
+            this->tri(center, center + v, center + next);
+            v = next;
+        }
+    }
+
+    void join(SkPoint pivot, SkVector before, SkVector after) {
+        const SkScalar dot = SkPoint::DotProduct(before, after) / (fRadius * fRadius);
+        if (dot >= 0 && SkScalarNearlyZero(1 - dot)) {
+            return;
+        }
+        if (!is_clockwise(before, after)) {
+            // The outside of the turn is on the -normal side.
+            before = -before;
+            after = -after;
+        }
+        switch (fJoin) {
+            case SkPaint::kMiter_Join: {
+                const bool nearly180 = dot < 0 && SkScalarNearlyZero(1 + dot);
+                const SkScalar sinHalfAngle = SkScalarSqrt(SkScalarHalf(1 + dot));
+                if (!nearly180 && sinHalfAngle >= fInvMiterLimit) {
+                    SkVector mid = before + after;
+                    mid.setLength(fRadius / sinHalfAngle);
+                    this->tri(pivot, pivot + before, pivot + mid);
+                    this->tri(pivot, pivot + mid, pivot + after);
+                    return;
+                }
+                [[fallthrough]];
+            }
+            case SkPaint::kBevel_Join:
+                this->tri(pivot, pivot + before, pivot + after);
+                return;
+            case SkPaint::kRound_Join:
+                this->fan(pivot, before, std::acos(SkTPin(dot, -1.f, 1.f)));
+                return;
+        }
+    }
+
+    // Caps the segment end at pivot whose normal is 'normal'.
+    void cap(SkPoint pivot, SkVector normal) {
+        SkVector parallel;
+        SkPointPriv::RotateCW(normal, &parallel);
+        switch (fCap) {
+            case SkPaint::kButt_Cap:
+                break;
+            case SkPaint::kRound_Cap:
+                this->fan(pivot, normal, SK_ScalarPI);
+                break;
+            case SkPaint::kSquare_Cap:
+                this->tri(pivot + normal, pivot - normal, pivot + normal + parallel);
+                this->tri(pivot - normal, pivot - normal + parallel, pivot + normal + parallel);
+                break;
+        }
+    }
+
+    SkScalar            fRadius;
+    SkScalar            fInvMiterLimit;
+    SkScalar            fMaxFanStep;
+    SkPaint::Cap        fCap;
+    SkPaint::Join       fJoin;
+    SkTDArray<SkPoint>* fTris;
+};
+
+// Calls contourProc(pts, normals, segCount, closed) for every contour of the path with at least
+// one segment, and dotProc(pt) for contours whose lines all have zero length. Consecutive points
+// closer than SkStroke's tolerance are merged.
+template <typename ContourProc, typename DotProc>
+void for_each_contour(const SkPath& path, SkScalar radius, SkScalar resScale,
+                      ContourProc&& contourProc, DotProc&& dotProc) {
+    const SkScalar tol = SK_ScalarNearlyZero / resScale;
+    SkTDArray<SkPoint> pts;
+    SkTDArray<SkVector> normals;
+    bool hasLine = false;
+
+    auto finish = [&](bool closed) {
+        if (closed && pts.size() > 1 &&
+            SkPointPriv::EqualsWithinTolerance(pts.back(), pts[0], tol)) {
+            pts.pop_back();
+        }
+        if (pts.size() > 1) {
+            if (closed) {
+                pts.push_back(pts[0]);
+            }
+            const int segCount = pts.size() - 1;
+            normals.resize(segCount);
+            compute_normals(pts.begin(), segCount, radius, normals.begin());
+            contourProc(pts.begin(), normals.begin(), segCount, closed);
+        } else if (hasLine || (closed && !pts.empty())) {
+            dotProc(pts[0]);
+        }
+        pts.clear();
+        hasLine = false;
+    };
+
+    for (auto [verb, p, w] : SkPathPriv::Iterate(path)) {
+        switch (verb) {
+            case SkPathVerb::kMove:
+                finish(false);
+                pts.push_back(p[0]);
+                break;
+            case SkPathVerb::kLine:
+                hasLine = true;
+                if (!SkPointPriv::EqualsWithinTolerance(pts.back(), p[1], tol)) {
+                    pts.push_back(p[1]);
+                }
+                break;
+            case SkPathVerb::kClose:
+                finish(true);
+                break;
+            default:
+                SkDEBUGFAIL("SkPolylineStroker only handles lines");
+                break;
+        }
+    }
+    finish(false);
+}
+
+}  // namespace
+
+SkPolylineStroker::SkPolylineStroker(SkScalar width, SkPaint::Cap cap, SkPaint::Join join,
+                                     SkScalar miterLimit, SkScalar resScale)
+        : fRadius(SkScalarHalf(width))
+        , fInvMiterLimit(miterLimit > SK_Scalar1 ? SkScalarInvert(miterLimit) : 1)
+        , fResScale(resScale)
+        , fCap(cap)
+        , fJoin(join) {
+    // A miter limit of 1 or less makes every miter join a bevel, as in SkPathStroker.
+    if (fJoin == SkPaint::kMiter_Join && miterLimit <= SK_Scalar1) {
+        fJoin = SkPaint::kBevel_Join;
+    }
+}
+
+bool SkPolylineStroker::CanStroke(const SkPath& path) {
+    return path.getSegmentMasks() == SkPath::kLine_SegmentMask;
+}
+
+void SkPolylineStroker::strokePath(const SkPath& src, SkPath* dst) const {
+    SkASSERT(CanStroke(src));
+    SkPathBuilder builder;
+    if (fRadius > 0) {
+        PathEmitter emitter(fRadius, fCap, fJoin, fInvMiterLimit, &builder);
+        for_each_contour(src, fRadius, fResScale,
+                         [&](const SkPoint pts[], const SkVector normals[], int n, bool closed) {
+                             emitter.contour(pts, normals, n, closed);
+                         },
+                         [&](SkPoint pt) {
+                             if (fCap == SkPaint::kRound_Cap) {
+                                 builder.addCircle(pt.fX, pt.fY, fRadius);
+                             } else if (fCap == SkPaint::kSquare_Cap) {
+                                 builder.addRect(SkRect::MakeLTRB(pt.fX - fRadius,
+                                                                  pt.fY - fRadius,
+                                                                  pt.fX + fRadius,
+                                                                  pt.fY + fRadius));
+                             }
+                         });
+    }
+    *dst = builder.detach();
+}
+
+sk_sp<SkVertices> SkPolylineStroker::strokeVertices(const SkPath& src) const {
+    SkASSERT(CanStroke(src));
+    if (fRadius <= 0) {
+        return nullptr;
+    }
+    SkTDArray<SkPoint> tris;
+    TriangleEmitter emitter(fRadius, fCap, fJoin, fInvMiterLimit, fResScale, &tris);
+    for_each_contour(src, fRadius, fResScale,
+                     [&](const SkPoint pts[], const SkVector normals[], int n, bool closed) {
+                         emitter.contour(pts, normals, n, closed);
+                     },
+                     [&](SkPoint pt) { emitter.dot(pt); });
+    if (tris.empty()) {
+        return nullptr;
+    }
+    return SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode, tris.size(), tris.begin(),
+                                nullptr, nullptr);
+}
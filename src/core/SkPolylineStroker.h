@@ -0,0 +1,59 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPolylineStroker_DEFINED
+#define SkPolylineStroker_DEFINED
+
+#include "include/core/SkPaint.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkScalar.h"
+
+class SkPath;
+class SkVertices;
+
+/**
+ *  A stroker for paths made only of lines (e.g. long time series), which avoids the per-segment
+ *  overhead of the general SkPathStroker. Segment normals are computed up front for the whole
+ *  contour with SIMD, and each side of the stroke, along with its joins and caps, is then emitted
+ *  in a single pass.
+ *
+ *  The outline follows the same conventions as SkStroke (outer joins, inner joins through the
+ *  pivot, caps), so it is filled with the winding rule.
+ */
+class SkPolylineStroker {
+public:
+    SkPolylineStroker(SkScalar width, SkPaint::Cap, SkPaint::Join, SkScalar miterLimit,
+                      SkScalar resScale = 1);
+
+    // Line-only paths with at least this many points are worth routing through this stroker.
+    static constexpr int kMinPointCount = 256;
+
+    /** Returns true if every segment of the path is a line. */
+    static bool CanStroke(const SkPath&);
+
+    /**
+     *  Replaces dst with the stroke outline of src, which must satisfy CanStroke().
+     */
+    void strokePath(const SkPath& src, SkPath* dst) const;
+
+    /**
+     *  Returns the stroke of src as a triangle list, suitable for drawVertices(). The triangles
+     *  of neighboring segments, joins and caps overlap, so a translucent paint will blend the
+     *  overlaps twice; this is meant for opaque strokes or for coverage that is combined with a
+     *  max (e.g. when drawn into a mask). Returns nullptr if the stroke is empty.
+     */
+    sk_sp<SkVertices> strokeVertices(const SkPath& src) const;
+
+private:
+    SkScalar      fRadius;
+    SkScalar      fInvMiterLimit;
+    SkScalar      fResScale;
+    SkPaint::Cap  fCap;
+    SkPaint::Join fJoin;
+};
+
+#endif
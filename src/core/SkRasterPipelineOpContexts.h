@@ -12,7 +12,7 @@
 #include <cstddef>
 #include <cstdint>
 
-namespace SkSL { class TraceHook; }
+namespace SkSL { class ProfileHook; class TraceHook; }
 
 // The largest number of pixels we handle at a time. We have a separate value for the largest number
 // of pixels we handle in the highp pipeline. Many of the context structs in this file are only used
@@ -223,6 +223,18 @@ struct SkRasterPipeline_BinaryOpCtx {
     SkRPOffset src;
 };
 
+struct SkRasterPipeline_BinaryOpFromSlotsCtx {
+    SkRPOffset dst;
+    SkRPOffset left;   // equal to `dst` when the op is performed in-place
+    SkRPOffset right;
+};
+
+struct SkRasterPipeline_MadConstantCtx {
+    int32_t mulValue;
+    int32_t addValue;
+    SkRPOffset dst;
+};
+
 struct SkRasterPipeline_TernaryOpCtx {
     SkRPOffset dst;
     SkRPOffset delta;
@@ -302,6 +314,11 @@ struct SkRasterPipeline_TraceLineCtx {
     int lineNumber;
 };
 
+struct SkRasterPipeline_ProfileCtx {
+    SkSL::ProfileHook* profileHook;
+    int stageIndex;
+};
+
 struct SkRasterPipeline_TraceVarCtx {
     const int* traceMask;
     SkSL::TraceHook* traceHook;
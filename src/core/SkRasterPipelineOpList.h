@@ -104,15 +104,23 @@
     M(smoothstep_n_floats) M(dot_2_floats) M(dot_3_floats) M(dot_4_floats)                      \
     M(add_imm_float)                                                                            \
         M(add_n_floats)   M(add_float)    M(add_2_floats)   M(add_3_floats)   M(add_4_floats)   \
+    M(add_float_from_slot)        M(add_2_floats_from_slots)                                    \
+        M(add_3_floats_from_slots) M(add_4_floats_from_slots)                                   \
     M(add_imm_int)                                                                              \
         M(add_n_ints)     M(add_int)      M(add_2_ints)     M(add_3_ints)     M(add_4_ints)     \
     M(sub_n_floats)       M(sub_float)    M(sub_2_floats)   M(sub_3_floats)   M(sub_4_floats)   \
+    M(sub_float_from_slot)        M(sub_2_floats_from_slots)                                    \
+        M(sub_3_floats_from_slots) M(sub_4_floats_from_slots)                                   \
     M(sub_n_ints)         M(sub_int)      M(sub_2_ints)     M(sub_3_ints)     M(sub_4_ints)     \
     M(mul_imm_float)                                                                            \
         M(mul_n_floats)   M(mul_float)    M(mul_2_floats)   M(mul_3_floats)   M(mul_4_floats)   \
+    M(mul_float_from_slot)        M(mul_2_floats_from_slots)                                    \
+        M(mul_3_floats_from_slots) M(mul_4_floats_from_slots)                                   \
     M(mul_imm_int)                                                                              \
         M(mul_n_ints)     M(mul_int)      M(mul_2_ints)     M(mul_3_ints)     M(mul_4_ints)     \
     M(div_n_floats)       M(div_float)    M(div_2_floats)   M(div_3_floats)   M(div_4_floats)   \
+    M(div_float_from_slot)        M(div_2_floats_from_slots)                                    \
+        M(div_3_floats_from_slots) M(div_4_floats_from_slots)                                   \
     M(div_n_ints)         M(div_int)      M(div_2_ints)     M(div_3_ints)     M(div_4_ints)     \
     M(div_n_uints)        M(div_uint)     M(div_2_uints)    M(div_3_uints)    M(div_4_uints)    \
     M(max_imm_float)                                                                            \
@@ -146,7 +154,11 @@
         M(cmpne_n_floats) M(cmpne_float)  M(cmpne_2_floats) M(cmpne_3_floats) M(cmpne_4_floats) \
     M(cmpne_imm_int)                                                                            \
         M(cmpne_n_ints)   M(cmpne_int)    M(cmpne_2_ints)   M(cmpne_3_ints)   M(cmpne_4_ints)   \
-    M(trace_line)         M(trace_var)    M(trace_enter)    M(trace_exit)     M(trace_scope)
+    M(mad_imm_float)                                                                            \
+    M(add_n_floats_by_scalar) M(sub_n_floats_by_scalar)                                         \
+    M(mul_n_floats_by_scalar) M(div_n_floats_by_scalar)                                         \
+    M(trace_line)         M(trace_var)    M(trace_enter)    M(trace_exit)     M(trace_scope)   \
+    M(profile_stage)
 
 // `SK_RASTER_PIPELINE_OPS_HIGHP_ONLY` defines ops that are only available in highp; this subset
 // includes all of SkSL.
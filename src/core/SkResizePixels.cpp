@@ -0,0 +1,211 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkResizePixels.h"
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkImageInfoPriv.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+// For each dst pixel along one axis, the run of src pixels that contribute to it and their
+// normalized weights. Taps past the edges of src are folded onto the edge pixels.
+class WeightTable {
+public:
+    WeightTable(int srcSize, int dstSize, const SkResizeFilter& filter) {
+        const float scale = (float)dstSize / srcSize;
+        const float filterScale = std::max(1.f, 1 / scale);
+        const float support = filter.support() * filterScale;
+        fMaxTaps = (int)std::ceil(2 * support) + 1;
+
+        fFirst.push_back_n(dstSize);
+        fCount.push_back_n(dstSize);
+        fWeights.push_back_n(dstSize * fMaxTaps, 0.f);
+
+        skia_private::AutoSTArray<32, float> taps(fMaxTaps);
+        for (int d = 0; d < dstSize; ++d) {
+            // Pixel i is centered at i + 0.5 in both src and dst.
+            const float center = (d + 0.5f) / scale;
+            const int first = sk_float_floor2int(center - support - 0.5f) + 1;
+
+            float sum = 0;
+            for (int k = 0; k < fMaxTaps; ++k) {
+                taps[k] = filter((first + k + 0.5f - center) / filterScale);
+                sum += taps[k];
+            }
+
+            const int lo = std::clamp(first, 0, srcSize - 1),
+                      hi = std::clamp(first + fMaxTaps - 1, 0, srcSize - 1);
+            fFirst[d] = lo;
+            fCount[d] = hi - lo + 1;
+            float* weights = &fWeights[d * fMaxTaps];
+            for (int k = 0; k < fMaxTaps; ++k) {
+                weights[std::clamp(first + k, lo, hi) - lo] += sum != 0 ? taps[k] / sum : 0;
+            }
+        }
+    }
+
+    int first(int d) const { return fFirst[d]; }
+    int count(int d) const { return fCount[d]; }
+    const float* weights(int d) const { return &fWeights[d * fMaxTaps]; }
+
+    // No dst pixel reads more src pixels than this.
+    int maxTaps() const { return fMaxTaps; }
+
+private:
+    int                          fMaxTaps;
+    skia_private::TArray<int>    fFirst;
+    skia_private::TArray<int>    fCount;
+    skia_private::TArray<float>  fWeights;
+};
+
+// Keeps the filter's overshoot from producing invalid colors.
+skvx::float4 clamp_pixel(skvx::float4 px, bool premul) {
+    const float a = std::clamp(px[3], 0.f, 1.f);
+    return skvx::pin(px, skvx::float4(0), skvx::float4(premul ? a : 1.f, premul ? a : 1.f,
+                                                       premul ? a : 1.f, a));
+}
+
+}  // namespace
+
+float SkResizeFilter::operator()(float x) const {
+    x = std::abs(x);
+    if (fKind == Kind::kLanczos3) {
+        if (x < 1e-6f) {
+            return 1;
+        }
+        if (x >= 3) {
+            return 0;
+        }
+        const float px = SK_FloatPI * x;
+        return 3 * std::sin(px) * std::sin(px / 3) / (px * px);
+    }
+
+    // Mitchell-Netravali, as in SkCubicResampler.
+    const float B = fCubic.B, C = fCubic.C;
+    if (x < 1) {
+        return ((12 - 9*B - 6*C) * x*x*x + (-18 + 12*B + 6*C) * x*x + (6 - 2*B)) / 6;
+    }
+    if (x < 2) {
+        return ((-B - 6*C) * x*x*x + (6*B + 30*C) * x*x + (-12*B - 48*C) * x + (8*B + 24*C)) / 6;
+    }
+    return 0;
+}
+
+bool SkResizePixels(const SkPixmap& actualDst, const SkPixmap& actualSrc, SkResizeFilter filter,
+                    bool linearLight) {
+    SkPixmap src = actualSrc,
+             dst = actualDst;
+    if (src.width() <= 0 || src.height() <= 0 || dst.width() <= 0 || dst.height() <= 0 ||
+        !src.addr() || !dst.addr() || !SkImageInfoValidConversion(dst.info(), src.info())) {
+        return false;
+    }
+
+    // Like scalePixels(), filter unpremul pixels as is when both sides are unpremul, by treating
+    // them as premul.
+    bool premul = true;
+    if (src.alphaType() == kUnpremul_SkAlphaType && dst.alphaType() == kUnpremul_SkAlphaType) {
+        src.reset(src.info().makeAlphaType(kPremul_SkAlphaType), src.addr(), src.rowBytes());
+        dst.reset(dst.info().makeAlphaType(kPremul_SkAlphaType), dst.addr(), dst.rowBytes());
+        premul = false;
+    }
+
+    sk_sp<SkColorSpace> workingCS = src.refColorSpace();
+    if (linearLight && workingCS && !workingCS->gammaIsLinear()) {
+        workingCS = workingCS->makeLinearGamma();
+    }
+    const SkAlphaType workingAT = src.isOpaque() ? kOpaque_SkAlphaType : kPremul_SkAlphaType;
+    auto workingInfo = [&](int width, int height) {
+        return SkImageInfo::Make(width, height, kRGBA_F32_SkColorType, workingAT, workingCS);
+    };
+
+    const int srcW = src.width(), srcH = src.height(),
+              dstW = dst.width(), dstH = dst.height();
+    const WeightTable xWeights(srcW, dstW, filter),
+                      yWeights(srcH, dstH, filter);
+
+    // Each band of dst rows streams its src rows through a rolling window of horizontally filtered
+    // rows, as many as the vertical filter reads. Both first(y) and first(y) + count(y) only grow
+    // with y, so src row r always lives in window slot r % windowRows until it is no longer read.
+    const int windowRows = std::min(yWeights.maxTaps(), srcH);
+    const size_t srcStride = 4 * (size_t)srcW,
+                 midStride = 4 * (size_t)dstW;
+    const int rowPixels = SkToInt(std::min<int64_t>((int64_t)srcW * srcH / dstH + dstW,
+                                                    SK_MaxS32));
+    std::atomic<bool> ok{true};
+    SkTaskGroup::ForEachBand(dstH, rowPixels, [&](int first, int end) {
+        skia_private::AutoTMalloc<float> converted(srcStride * windowRows),
+                                         window(midStride * windowRows),
+                                         row(midStride);
+        int nextSrcRow = yWeights.first(first);
+        for (int y = first; y < end; ++y) {
+            // Convert and horizontally filter the src rows that this dst row reads for the first
+            // time, replacing the rows that no later dst row reads.
+            const int srcEnd = yWeights.first(y) + yWeights.count(y);
+            nextSrcRow = std::max(nextSrcRow, yWeights.first(y));
+            if (nextSrcRow < srcEnd) {
+                const int rowCount = srcEnd - nextSrcRow;
+                if (!src.readPixels(workingInfo(srcW, rowCount), converted.get(),
+                                    srcStride * sizeof(float), 0, nextSrcRow)) {
+                    ok.store(false, std::memory_order_relaxed);
+                    return;
+                }
+                for (int r = 0; r < rowCount; ++r) {
+                    const float* in = converted.get() + r * srcStride;
+                    float* out = window.get() + ((nextSrcRow + r) % windowRows) * midStride;
+                    for (int x = 0; x < dstW; ++x) {
+                        const float* px = in + 4 * xWeights.first(x);
+                        const float* w = xWeights.weights(x);
+                        skvx::float4 sum = 0;
+                        for (int k = 0; k < xWeights.count(x); ++k) {
+                            sum += w[k] * skvx::float4::Load(px + 4 * k);
+                        }
+                        sum.store(out + 4 * x);
+                    }
+                }
+                nextSrcRow = srcEnd;
+            }
+
+            // Filter the window's columns into dst.
+            const int srcFirst = yWeights.first(y);
+            const float* w = yWeights.weights(y);
+            const int count = yWeights.count(y);
+            for (int x = 0; x < dstW; ++x) {
+                skvx::float4 sum = 0;
+                for (int k = 0; k < count; ++k) {
+                    const float* in = window.get() + ((srcFirst + k) % windowRows) * midStride;
+                    sum += w[k] * skvx::float4::Load(in + 4 * x);
+                }
+                clamp_pixel(sum, premul).store(row.get() + 4 * x);
+            }
+            SkPixmap filtered(workingInfo(dstW, 1), row.get(), midStride * sizeof(float));
+            if (!filtered.readPixels(dst.info().makeWH(dstW, 1),
+                                     dst.writable_addr(0, y), dst.rowBytes())) {
+                ok.store(false, std::memory_order_relaxed);
+                return;
+            }
+        }
+    });
+    return ok.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkResizePixels_DEFINED
+#define SkResizePixels_DEFINED
+
+#include "include/core/SkSamplingOptions.h"
+
+class SkPixmap;
+
+/**
+ *  A separable filter for SkResizePixels(). When downscaling, the filter is stretched by the
+ *  inverse of the scale, so every src pixel contributes to the result.
+ */
+struct SkResizeFilter {
+    enum class Kind { kLanczos3, kCubic };
+
+    static constexpr SkResizeFilter Lanczos3() { return {Kind::kLanczos3, {0, 0}}; }
+    static constexpr SkResizeFilter Cubic(SkCubicResampler cubic) { return {Kind::kCubic, cubic}; }
+    static constexpr SkResizeFilter Mitchell() { return Cubic(SkCubicResampler::Mitchell()); }
+    static constexpr SkResizeFilter CatmullRom() { return Cubic(SkCubicResampler::CatmullRom()); }
+
+    // The radius of the filter, in src pixels, when not downscaling.
+    float support() const { return fKind == Kind::kLanczos3 ? 3 : 2; }
+
+    float operator()(float x) const;
+
+    Kind             fKind;
+    SkCubicResampler fCubic;
+};
+
+/**
+ *  Resizes all of src into dst, filtering rows and then columns with precomputed weight tables.
+ *  Pixels past the edges of src are clamped. Color and alpha conversions follow SkConvertPixels:
+ *  src is filtered as premultiplied floats in its own color space (made linear if linearLight is
+ *  true), and the result is converted to dst's color type and space. As with
+ *  SkPixmap::scalePixels(), if src and dst are both unpremul, the pixels are filtered without
+ *  being premultiplied.
+ *
+ *  Rows stream through a rolling window of horizontally filtered rows, so no intermediate image
+ *  is allocated. Large images are filtered in bands of rows with SkTaskGroup::ForEachBand().
+ *
+ *  Returns false if either pixmap is empty or the conversions are not possible.
+ */
+[[nodiscard]] bool SkResizePixels(const SkPixmap& dst, const SkPixmap& src, SkResizeFilter,
+                                  bool linearLight = false);
+
+#endif
@@ -75,6 +75,7 @@ bool SkRuntimeBlender::onAppendStages(const SkStageRec& rec) const {
                 /*alwaysCopyIntoAlloc=*/false,
                 rec.fDstCS,
                 rec.fAlloc);
+        program = fEffect->specializeRPProgram(program, &uniforms, rec.fAlloc);
         SkShaders::MatrixRec matrix(SkMatrix::I());
         matrix.markCTMApplied();
         RuntimeEffectRPCallbacks callbacks(rec, matrix, fChildren, fEffect->fSampleUsages);
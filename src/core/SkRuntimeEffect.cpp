@@ -13,26 +13,33 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkData.h"
+#include "include/core/SkMilestone.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkStream.h"
 #include "include/private/base/SkAlign.h"
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkMutex.h"
 #include "include/private/base/SkOnce.h"
 #include "include/private/base/SkTArray.h"
 #include "src/base/SkArenaAlloc.h"
 #include "src/base/SkEnumBitMask.h"
 #include "src/base/SkNoDestructor.h"
+#include "src/base/SkScopeExit.h"
 #include "src/core/SkBlenderBase.h"
 #include "src/core/SkChecksum.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
 #include "src/core/SkEffectPriv.h"
 #include "src/core/SkLRUCache.h"
+#include "src/core/SkMD5.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/core/SkRasterPipelineOpList.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRuntimeBlender.h"
 #include "src/core/SkRuntimeEffectPriv.h"
 #include "src/core/SkStreamPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 #include "src/effects/colorfilters/SkRuntimeColorFilter.h"
@@ -49,8 +56,13 @@
 #include "src/sksl/analysis/SkSLProgramUsage.h"
 #include "src/sksl/codegen/SkSLRasterPipelineBuilder.h"
 #include "src/sksl/codegen/SkSLRasterPipelineCodeGenerator.h"
+#include "src/sksl/ir/SkSLConstructorArray.h"
+#include "src/sksl/ir/SkSLConstructorCompound.h"
+#include "src/sksl/ir/SkSLExpression.h"
 #include "src/sksl/ir/SkSLFunctionDeclaration.h"
+#include "src/sksl/ir/SkSLFunctionDefinition.h"
 #include "src/sksl/ir/SkSLLayout.h"
+#include "src/sksl/ir/SkSLLiteral.h"
 #include "src/sksl/ir/SkSLModifierFlags.h"
 #include "src/sksl/ir/SkSLProgram.h"
 #include "src/sksl/ir/SkSLProgramElement.h"
@@ -59,8 +71,13 @@
 #include "src/sksl/ir/SkSLVarDeclarations.h"
 #include "src/sksl/ir/SkSLVariable.h"
 #include "src/sksl/tracing/SkSLDebugTracePriv.h"
+#include "src/sksl/transform/SkSLTransform.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <string>
 
 using namespace skia_private;
 
@@ -214,16 +231,74 @@ sk_sp<const SkData> SkRuntimeEffectPriv::TransformUniforms(
     return data ? data : originalData;
 }
 
+static std::atomic<SkRuntimeEffect::PersistentCache*> gPersistentCache{nullptr};
+
+void SkRuntimeEffect::SetPersistentCache(PersistentCache* cache) {
+    gPersistentCache.store(cache, std::memory_order_release);
+}
+
+// Identifies the build that serialized an RP program. A program refers to its ops by index, and
+// the ops available depend on the Skia version and on the compiler that built it, so a cached
+// program is only reused by the same build.
+static void write_build_identifier(SkMD5* hash) {
+    hash->write32(SK_MILESTONE);
+    hash->write32(kNumRasterPipelineHighpOps);
+    hash->write32(kNumRasterPipelineLowpOps);
+#if defined(__clang__)
+    hash->write("clang " __clang_version__, strlen("clang " __clang_version__));
+#elif defined(__GNUC__)
+    hash->write("gcc " __VERSION__, strlen("gcc " __VERSION__));
+#elif defined(_MSC_VER)
+    hash->write("msvc", 4);
+    hash->write32(_MSC_FULL_VER);
+#endif
+}
+
+// The RP program is determined by the source and by whether the inliner runs. The key also holds
+// the serialized-program version and the build, so programs from other versions of Skia, or from
+// other builds of it, are never looked up. Programs specialized on uniform values aren't made by
+// getRPProgram, and are never cached.
+static sk_sp<SkData> rp_program_cache_key(const SkSL::Program& program, bool optimize) {
+    SkMD5 hash;
+    write_build_identifier(&hash);
+    hash.write(program.fSource->data(), program.fSource->size());
+    hash.write32((int32_t)program.fConfig->fKind);
+    hash.write32(optimize);
+    SkMD5::Digest digest = hash.finish();
+
+    SkDynamicMemoryWStream key;
+    key.write("SkSL::RP", 8);
+    key.write32(SkSL::RP::Program::kSerializedVersion);
+    key.write(digest.data, sizeof(digest.data));
+    return key.detachAsData();
+}
+
 const SkSL::RP::Program* SkRuntimeEffect::getRPProgram(SkSL::DebugTracePriv* debugTrace) const {
     // Lazily compile the program the first time `getRPProgram` is called.
     // By using an SkOnce, we avoid thread hazards and behave in a conceptually const way, but we
     // can avoid the cost of invoking the RP code generator until it's actually needed.
     fCompileRPProgramOnce([&] {
+        // A persistent cache may already hold the program from an earlier process. Traced programs
+        // refer to their debug trace, so they are never cached.
+        const bool optimize = !(fFlags & kDisableOptimization_Flag);
+        PersistentCache* cache = gPersistentCache.load(std::memory_order_acquire);
+        sk_sp<SkData> cacheKey;
+        if (cache && !debugTrace && !kRPEnableLiveTrace) {
+            cacheKey = rp_program_cache_key(*fBaseProgram, optimize);
+            if (sk_sp<SkData> cached = cache->load(*cacheKey)) {
+                const_cast<SkRuntimeEffect*>(this)->fRPProgram =
+                        SkSL::RP::Program::Deserialize(*cached);
+                if (fRPProgram) {
+                    return;
+                }
+            }
+        }
+
         // We generally do not run the inliner when an SkRuntimeEffect program is initially created,
         // because the final compile to native shader code will do this. However, in SkRP, there's
         // no additional compilation occurring, so we need to manually inline here if we want the
         // performance boost of inlining.
-        if (!(fFlags & kDisableOptimization_Flag)) {
+        if (optimize) {
             SkSL::Compiler compiler;
             fBaseProgram->fConfig->fSettings.fInlineThreshold = SkSL::kDefaultInlineThreshold;
             compiler.runInliner(*fBaseProgram);
@@ -252,11 +327,126 @@ const SkSL::RP::Program* SkRuntimeEffect::getRPProgram(SkSL::DebugTracePriv* deb
                 SkDebugf("----- RP unsupported -----\n\n");
             }
         }
+
+        if (cacheKey && fRPProgram) {
+            if (sk_sp<SkData> data = fRPProgram->serialize()) {
+                cache->store(*cacheKey, *data);
+            }
+        }
     });
 
     return fRPProgram.get();
 }
 
+// The specialized RP programs of an effect, keyed by the bytes of the uniform values folded into
+// them. A set of values is only specialized once it has been drawn kDrawsBeforeSpecializing times,
+// so effects whose uniforms change on most draws don't pay for a compile on each of them. Sets
+// that couldn't be specialized are remembered, so they aren't tried again.
+struct SkRuntimeEffect::SpecializationCache {
+    static constexpr int kMaxUniformSets = 16;
+    static constexpr int kDrawsBeforeSpecializing = 4;
+
+    // Pipelines keep a ref, since they may run after the entry is evicted.
+    struct Variant : public SkNVRefCnt<Variant> {
+        std::unique_ptr<SkSL::RP::Program> fProgram;
+    };
+    struct Entry {
+        int fDraws = 0;
+        bool fFailed = false;
+        sk_sp<Variant> fVariant;
+    };
+
+    SkMutex fMutex;
+    SkLRUCache<std::string, Entry> fEntries SK_GUARDED_BY(fMutex){kMaxUniformSets};
+};
+
+// Returns the value of a uniform of the given type in 'data' as a constant expression, or null if
+// a value has no literal form (infinities and NaNs).
+static std::unique_ptr<SkSL::Expression> make_uniform_value(const SkSL::Context& context,
+                                                            SkSL::Position pos,
+                                                            const SkSL::Type& type,
+                                                            const float* data) {
+    if (type.isArray()) {
+        const SkSL::Type& elementType = type.componentType();
+        const size_t elementSlots = elementType.slotCount();
+        SkSL::ExpressionArray elements;
+        elements.reserve_exact(type.columns());
+        for (int i = 0; i < type.columns(); ++i) {
+            std::unique_ptr<SkSL::Expression> element =
+                    make_uniform_value(context, pos, elementType, data + i * elementSlots);
+            if (!element) {
+                return nullptr;
+            }
+            elements.push_back(std::move(element));
+        }
+        return SkSL::ConstructorArray::Make(context, pos, type, std::move(elements));
+    }
+
+    const bool isInt = type.componentType().isInteger();
+    double values[16];
+    SkASSERT(type.slotCount() <= std::size(values));
+    for (size_t i = 0; i < type.slotCount(); ++i) {
+        if (isInt) {
+            int32_t i32;
+            memcpy(&i32, data + i, sizeof(int32_t));
+            values[i] = i32;
+        } else if (SkIsFinite(data[i])) {
+            values[i] = data[i];
+        } else {
+            return nullptr;
+        }
+    }
+    if (type.isScalar()) {
+        return SkSL::Literal::Make(pos, values[0], &type);
+    }
+    return SkSL::ConstructorCompound::MakeFromConstants(context, pos, type, values);
+}
+
+const SkSL::RP::Program* SkRuntimeEffect::specializeRPProgram(const SkSL::RP::Program* program,
+                                                              SkSpan<const float>* uniforms,
+                                                              SkArenaAlloc* alloc) const {
+    if (!fSpecializations || uniforms->empty()) {
+        return program;
+    }
+
+    using Cache = SpecializationCache;
+    std::string key(reinterpret_cast<const char*>(uniforms->data()), uniforms->size_bytes());
+    sk_sp<Cache::Variant> variant;
+    {
+        SkAutoMutexExclusive lock(fSpecializations->fMutex);
+        Cache::Entry* entry = fSpecializations->fEntries.find(key);
+        if (!entry) {
+            entry = fSpecializations->fEntries.insert(key, {});
+        }
+        if (entry->fFailed || (!entry->fVariant &&
+                               ++entry->fDraws < Cache::kDrawsBeforeSpecializing)) {
+            return program;
+        }
+        variant = entry->fVariant;
+    }
+
+    if (!variant) {
+        std::unique_ptr<SkSL::RP::Program> specialized =
+                this->makeSpecializedRPProgram(uniforms->data());
+        Cache::Entry entry;
+        entry.fFailed = !specialized;
+        if (specialized) {
+            variant = sk_make_sp<Cache::Variant>();
+            variant->fProgram = std::move(specialized);
+            entry.fVariant = variant;
+        }
+        SkAutoMutexExclusive lock(fSpecializations->fMutex);
+        fSpecializations->fEntries.insert_or_update(key, std::move(entry));
+        if (!variant) {
+            return program;
+        }
+    }
+
+    alloc->make<sk_sp<Cache::Variant>>(variant);
+    *uniforms = {};
+    return variant->fProgram.get();
+}
+
 SkSpan<const float> SkRuntimeEffectPriv::UniformsAsSpan(
         SkSpan<const SkRuntimeEffect::Uniform> uniforms,
         sk_sp<const SkData> originalData,
@@ -512,6 +702,9 @@ SkRuntimeEffect::Result SkRuntimeEffect::MakeInternal(std::unique_ptr<SkSL::Prog
     if (options.forceUnoptimized) {
         flags |= kDisableOptimization_Flag;
     }
+    if (options.specializeUniforms) {
+        flags |= kSpecializeUniforms_Flag;
+    }
 
     // Find 'main', then locate the sample coords parameter. (It might not be present.)
     const SkSL::FunctionDeclaration* main = program->getFunction("main");
@@ -653,6 +846,62 @@ sk_sp<SkRuntimeEffect> SkRuntimeEffect::makeUnoptimizedClone() {
     return result.effect;
 }
 
+std::unique_ptr<SkSL::RP::Program> SkRuntimeEffect::makeSpecializedRPProgram(
+        const float* uniformData) const {
+    // The base program's IR is shared by every draw, so convert the source again into IR that can
+    // be rewritten, with the settings the effect was made with.
+    SkSL::Compiler compiler;
+    SkSL::ProgramSettings settings = fBaseProgram->fConfig->fSettings;
+    settings.fInlineThreshold = 0;
+    std::unique_ptr<SkSL::Program> program =
+            compiler.convertProgram(fBaseProgram->fConfig->fKind, *fBaseProgram->fSource, settings);
+    if (!program) {
+        return nullptr;
+    }
+
+    // Building and folding IR consults the program's settings, as it does during compilation.
+    program->fContext->fConfig = program->fConfig.get();
+    SK_AT_SCOPE_EXIT(program->fContext->fConfig = nullptr);
+
+    // Every uniform must be replaced, since the program is drawn without any uniform data.
+    SkSL::Transform::VariableValueMap values;
+    auto uniform = fUniforms.begin();
+    for (const SkSL::ProgramElement* elem : program->elements()) {
+        if (!elem->is<SkSL::GlobalVarDeclaration>()) {
+            continue;
+        }
+        const SkSL::Variable& var = *elem->as<SkSL::GlobalVarDeclaration>().varDeclaration().var();
+        if (!var.modifierFlags().isUniform() || var.type().isEffectChild()) {
+            continue;
+        }
+        SkASSERT(uniform != fUniforms.end() && uniform->name == var.name());
+        std::unique_ptr<SkSL::Expression> value =
+                make_uniform_value(*program->fContext, var.fPosition, var.type(),
+                                   uniformData + uniform->offset / sizeof(float));
+        if (!value) {
+            return nullptr;
+        }
+        values.set(&var, std::move(value));
+        ++uniform;
+    }
+    if (uniform != fUniforms.end()) {
+        return nullptr;
+    }
+    SkSL::Transform::ReplaceVariablesWithConstants(*program, values);
+
+    // As in getRPProgram, inline before generating code; the inlined bodies fold further.
+    if (!(fFlags & kDisableOptimization_Flag)) {
+        program->fConfig->fSettings.fInlineThreshold = SkSL::kDefaultInlineThreshold;
+        compiler.runInliner(*program);
+    }
+    const SkSL::FunctionDeclaration* main = program->getFunction("main");
+    if (!main || !main->definition()) {
+        return nullptr;
+    }
+    return MakeRasterPipelineProgram(*program, *main->definition(), /*debugTrace=*/nullptr,
+                                     /*writeTraceOps=*/false);
+}
+
 SkRuntimeEffect::Result SkRuntimeEffect::MakeForColorFilter(SkString sksl, const Options& options) {
     auto programKind = options.allowPrivateAccess ? SkSL::ProgramKind::kPrivateRuntimeColorFilter
                                                   : SkSL::ProgramKind::kRuntimeColorFilter;
@@ -677,6 +926,27 @@ SkRuntimeEffect::Result SkRuntimeEffect::MakeForBlender(SkString sksl, const Opt
     return result;
 }
 
+std::vector<SkRuntimeEffect::Result> SkRuntimeEffect::MakeBatch(
+        Result (*make)(SkString sksl, const Options&),
+        SkSpan<const SkString> sksl,
+        const Options& options,
+        SkExecutor* executor) {
+    std::vector<Result> results(sksl.size());
+    if (sksl.empty()) {
+        return results;
+    }
+
+    // Make sure the built-in modules are loaded before fanning out, so that every worker finds
+    // them already published instead of queueing up behind the first one to load them.
+    results[0] = make(sksl[0], options);
+    SkTaskGroup taskGroup(executor ? *executor : SkExecutor::GetDefault());
+    taskGroup.batch(SkToInt(sksl.size()) - 1, [&](int i) {
+        results[i + 1] = make(sksl[i + 1], options);
+    });
+    taskGroup.wait();
+    return results;
+}
+
 sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(
         SkRuntimeEffect::Result (*make)(SkString sksl, const SkRuntimeEffect::Options&),
         SkString sksl) {
@@ -750,18 +1020,24 @@ SkRuntimeEffect::SkRuntimeEffect(std::unique_ptr<SkSL::Program> baseProgram,
     SkASSERT(fBaseProgram);
     SkASSERT(fChildren.size() == fSampleUsages.size());
 
+    if (fFlags & kSpecializeUniforms_Flag) {
+        fSpecializations = std::make_unique<SpecializationCache>();
+    }
+
     // Everything from SkRuntimeEffect::Options which could influence the compiled result needs to
     // be accounted for in `fHash`. If you've added a new field to Options and caused the static-
     // assert below to trigger, please incorporate your field into `fHash` and update KnownOptions
     // to match the layout of Options.
     struct KnownOptions {
-        bool forceUnoptimized, allowPrivateAccess;
+        bool forceUnoptimized, specializeUniforms, allowPrivateAccess;
         uint32_t fStableKey;
         SkSL::Version maxVersionAllowed;
     };
     static_assert(sizeof(Options) == sizeof(KnownOptions));
     fHash = SkChecksum::Hash32(&options.forceUnoptimized,
                                sizeof(options.forceUnoptimized), fHash);
+    fHash = SkChecksum::Hash32(&options.specializeUniforms,
+                               sizeof(options.specializeUniforms), fHash);
     fHash = SkChecksum::Hash32(&options.allowPrivateAccess,
                                sizeof(options.allowPrivateAccess), fHash);
     fHash = SkChecksum::Hash32(&options.fStableKey,
@@ -912,6 +1188,17 @@ SkRuntimeEffect::TracedShader SkRuntimeEffect::MakeTraced(sk_sp<SkShader> shader
     return rtShader->makeTracedClone(traceCoord);
 }
 
+SkRuntimeEffect::ProfiledShader SkRuntimeEffect::MakeProfiled(sk_sp<SkShader> shader,
+                                                              int sampleInterval) {
+    SkRuntimeEffect* effect = as_SB(shader)->asRuntimeEffect();
+    if (!effect) {
+        return ProfiledShader{nullptr, nullptr};
+    }
+    // An SkShader with an attached SkRuntimeEffect must be an SkRuntimeShader.
+    SkRuntimeShader* rtShader = static_cast<SkRuntimeShader*>(shader.get());
+    return rtShader->makeProfiledClone(sampleInterval);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 std::optional<ChildType> SkRuntimeEffect::ChildPtr::type() const {
@@ -18,6 +18,7 @@
 #include "src/core/SkPathEnums.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkPointPriv.h"
+#include "src/core/SkPolylineStroker.h"
 #include "src/core/SkStrokerPriv.h"
 
 #include <algorithm>
@@ -1457,6 +1458,17 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
         }
     }
 
+    // Long line-only strokes (e.g. time series) are much cheaper with the dedicated stroker.
+    if (!fDoFill && src.countPoints() >= SkPolylineStroker::kMinPointCount &&
+        SkPolylineStroker::CanStroke(src)) {
+        SkPolylineStroker(fWidth, this->getCap(), this->getJoin(), fMiterLimit, fResScale)
+                .strokePath(src, dst);
+        if (src.isInverseFillType()) {
+            dst->toggleInverseFillType();
+        }
+        return;
+    }
+
     // We can always ignore centers for stroke and fill convex line-only paths
     // TODO: remove the line-only restriction
     bool ignoreCenter = fDoFill && (src.getSegmentMasks() == SkPath::kLine_SegmentMask) &&
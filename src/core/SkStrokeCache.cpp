@@ -0,0 +1,163 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkStrokeCache.h"
+
+#include "include/core/SkPath.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStrokeRec.h"
+#include "include/core/SkTypes.h"
+#include "include/private/SkIDChangeListener.h"
+#include "include/private/base/SkMutex.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkResourceCache.h"
+
+#include <atomic>
+#include <utility>
+
+namespace {
+
+// Paths with fewer points than this are cheaper to re-stroke than to look up.
+static constexpr int kMinCachedPointCount = 16;
+
+static unsigned gStrokeKeyNamespaceLabel;
+
+uint64_t make_shared_id(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('s', 't', 'r', 'k');
+    return (sharedID << 32) | pathGenID;
+}
+
+struct StrokeKey : public SkResourceCache::Key {
+public:
+    StrokeKey(const SkPath& path, const SkStrokeRec& rec, SkScalar resScale)
+        : fGenID(path.getGenerationID())
+        , fFillType(static_cast<uint32_t>(path.getFillType()))
+        , fWidth(rec.getWidth())
+        , fMiter(rec.getMiter())
+        , fResScale(resScale)
+        , fCapJoinStyle((rec.getCap() << 16) | (rec.getJoin() << 8) | rec.getStyle()) {
+        this->init(&gStrokeKeyNamespaceLabel, make_shared_id(fGenID),
+                   sizeof(fGenID) + sizeof(fFillType) + sizeof(fWidth) + sizeof(fMiter) +
+                   sizeof(fResScale) + sizeof(fCapJoinStyle));
+    }
+
+    uint32_t fGenID;
+    uint32_t fFillType;
+    SkScalar fWidth;
+    SkScalar fMiter;
+    SkScalar fResScale;
+    uint32_t fCapJoinStyle;
+};
+
+struct StrokeCacheRec : public SkResourceCache::Rec {
+    StrokeCacheRec(const StrokeKey& key, const SkPath& stroke, sk_sp<SkIDChangeListener> listener)
+        : fKey(key), fStroke(stroke), fListener(std::move(listener)) {}
+
+    ~StrokeCacheRec() override {
+        // Nothing left to invalidate once we're gone.
+        fListener->markShouldDeregister();
+    }
+
+    StrokeKey                 fKey;
+    SkPath                    fStroke;
+    sk_sp<SkIDChangeListener> fListener;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fStroke.approximateBytesUsed(); }
+    const char* getCategory() const override { return "stroke"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const StrokeCacheRec& rec = static_cast<const StrokeCacheRec&>(baseRec);
+        *static_cast<SkPath*>(contextData) = rec.fStroke;
+        return true;
+    }
+};
+
+// When the source path's SkPathRef changes or dies, purge every stroke made from it. This may be
+// called while another cache is locked (e.g. when a cached path is freed), so it only posts a
+// message that the stroke cache handles on its next access.
+class StrokeInvalidator : public SkIDChangeListener {
+public:
+    explicit StrokeInvalidator(uint32_t genID) : fGenID(genID) {}
+
+private:
+    void changed() override {
+        SkResourceCache::PostPurgeSharedID(make_shared_id(fGenID));
+    }
+
+    uint32_t fGenID;
+};
+
+SkMutex& stroke_cache_mutex() {
+    static SkMutex& mutex = *(new SkMutex);
+    return mutex;
+}
+
+SkResourceCache* stroke_cache() {
+    stroke_cache_mutex().assertHeld();
+    static SkResourceCache* gCache = new SkResourceCache(/*byteLimit=*/size_t(0));
+    return gCache;
+}
+
+// Mirrors the cache's byte limit, so CanCache() can skip disabled caches without the mutex.
+std::atomic<bool> gEnabled{false};
+
+std::atomic<int64_t> gHits{0};
+std::atomic<int64_t> gMisses{0};
+
+}  // namespace
+
+bool SkStrokeCache::CanCache(const SkPath& path) {
+    return gEnabled.load(std::memory_order_relaxed) &&
+           !path.isVolatile() && path.countPoints() >= kMinCachedPointCount;
+}
+
+bool SkStrokeCache::Find(const SkPath& src, const SkStrokeRec& rec, SkScalar resScale,
+                         SkPath* dst) {
+    StrokeKey key(src, rec, resScale);
+    bool found;
+    {
+        SkAutoMutexExclusive am(stroke_cache_mutex());
+        found = stroke_cache()->find(key, StrokeCacheRec::Visitor, dst);
+    }
+    (found ? gHits : gMisses).fetch_add(1, std::memory_order_relaxed);
+    return found;
+}
+
+void SkStrokeCache::Add(const SkPath& src, const SkStrokeRec& rec, SkScalar resScale,
+                        const SkPath& stroke) {
+    StrokeKey key(src, rec, resScale);
+    auto listener = sk_make_sp<StrokeInvalidator>(key.fGenID);
+    SkPathPriv::AddGenIDChangeListener(src, listener);
+
+    SkAutoMutexExclusive am(stroke_cache_mutex());
+    stroke_cache()->add(new StrokeCacheRec(key, stroke, std::move(listener)));
+}
+
+SkStrokeCache::Stats SkStrokeCache::GetStats() {
+    SkAutoMutexExclusive am(stroke_cache_mutex());
+    return {gHits.load(std::memory_order_relaxed),
+            gMisses.load(std::memory_order_relaxed),
+            stroke_cache()->getTotalBytesUsed(),
+            stroke_cache()->getTotalByteLimit()};
+}
+
+size_t SkStrokeCache::GetByteLimit() {
+    SkAutoMutexExclusive am(stroke_cache_mutex());
+    return stroke_cache()->getTotalByteLimit();
+}
+
+size_t SkStrokeCache::SetByteLimit(size_t newLimit) {
+    SkAutoMutexExclusive am(stroke_cache_mutex());
+    gEnabled.store(newLimit > 0, std::memory_order_relaxed);
+    return stroke_cache()->setTotalByteLimit(newLimit);
+}
+
+void SkStrokeCache::PurgeAll() {
+    SkAutoMutexExclusive am(stroke_cache_mutex());
+    stroke_cache()->purgeAll();
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "include/core/SkScalar.h"
+
+#include <cstddef>
+#include <cstdint>
+
+class SkPath;
+class SkStrokeRec;
+
+/**
+ *  Cache of stroked outlines, so a path that is drawn with the same stroke every frame is only
+ *  stroked once. Entries are keyed by the source path's generation ID, the stroke parameters,
+ *  and the exact resolution scale, and are dropped as soon as the source path's SkPathRef is
+ *  modified or destroyed. The cache is thread-safe and has its own memory budget, separate from
+ *  the global SkResourceCache budget.
+ *
+ *  The cache is off by default; clients opt in with SkGraphics::SetStrokeCacheByteLimit().
+ */
+class SkStrokeCache {
+public:
+    /**
+     *  Returns true if the cache is enabled and strokes of this path may be cached: the path must
+     *  not be volatile and must be complex enough that looking it up is cheaper than stroking it
+     *  again.
+     */
+    static bool CanCache(const SkPath&);
+
+    /**
+     *  On success, sets dst to the cached stroke of src and returns true. resScale overrides the
+     *  scale stored in the SkStrokeRec.
+     */
+    static bool Find(const SkPath& src, const SkStrokeRec&, SkScalar resScale, SkPath* dst);
+
+    /**
+     *  Adds the stroke of src (made with rec and resScale) to the cache.
+     */
+    static void Add(const SkPath& src, const SkStrokeRec&, SkScalar resScale,
+                    const SkPath& stroke);
+
+    struct Stats {
+        int64_t fHits;
+        int64_t fMisses;
+        size_t  fBytesUsed;
+        size_t  fByteLimit;
+    };
+    static Stats GetStats();
+
+    // A limit of zero disables the cache. Returns the previous limit.
+    static size_t GetByteLimit();
+    static size_t SetByteLimit(size_t newLimit);
+
+    static void PurgeAll();
+};
+
+#endif
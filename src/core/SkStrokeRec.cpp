@@ -9,6 +9,7 @@
 
 #include "src/core/SkPaintDefaults.h"
 #include "src/core/SkStroke.h"
+#include "src/core/SkStrokeCache.h"
 
 #include <algorithm>
 
@@ -109,18 +110,33 @@ bool SkStrokeRec::applyToPath(SkPath* dst, const SkPath& src) const {
         return false;
     }
 
+#ifdef SK_DEBUG
+    SkScalar resScale = gDebugStrokerErrorSet ? gDebugStrokerError : fResScale;
+#else
+    SkScalar resScale = fResScale;
+#endif
+
+    // When the client has enabled SkStrokeCache, strokes of paths that are drawn repeatedly
+    // (e.g. every frame) are cached.
+    const bool useCache = dst != &src && SkStrokeCache::CanCache(src);
+    if (useCache) {
+        if (SkStrokeCache::Find(src, *this, resScale, dst)) {
+            return true;
+        }
+    }
+
     SkStroke stroker;
     stroker.setCap((SkPaint::Cap)fCap);
     stroker.setJoin((SkPaint::Join)fJoin);
     stroker.setMiterLimit(fMiterLimit);
     stroker.setWidth(fWidth);
     stroker.setDoFill(fStrokeAndFill);
-#ifdef SK_DEBUG
-    stroker.setResScale(gDebugStrokerErrorSet ? gDebugStrokerError : fResScale);
-#else
-    stroker.setResScale(fResScale);
-#endif
+    stroker.setResScale(resScale);
     stroker.strokePath(src, dst);
+
+    if (useCache) {
+        SkStrokeCache::Add(src, *this, resScale, *dst);
+    }
     return true;
 }
 
@@ -149,8 +149,17 @@ public:
 
     // Hash tables will automatically resize themselves when set() and remove() are called, but
     // resize() can be called to manually grow capacity before a bulk insertion.
+    // find() masks hashes with fCapacity-1, so the capacity is rounded up to a power of two;
+    // any other size would leave most slots unreachable as probe starts and cluster entries.
     void resize(int capacity) {
         SkASSERT(capacity >= fCount);
+        if (capacity > 0 && (capacity & (capacity - 1))) {
+            int pow2 = 1;
+            while (pow2 < capacity) {
+                pow2 <<= 1;
+            }
+            capacity = pow2;
+        }
         int oldCapacity = fCapacity;
         SkDEBUGCODE(int oldCount = fCount);
 
@@ -566,6 +575,9 @@ public:
     // Is empty?
     bool empty() const { return fTable.count() == 0; }
 
+    // How many slots does the set contain?
+    int capacity() const { return fTable.capacity(); }
+
     // Approximately how many bytes of memory do we use beyond sizeof(*this)?
     size_t approxBytesUsed() const { return fTable.approxBytesUsed(); }
 
@@ -7,6 +7,7 @@
 #include "src/core/SkTaskGroup.h"
 
 #include "include/core/SkExecutor.h"
+#include "src/core/SkExecutorPriv.h"
 
 #include <type_traits>
 #include <utility>
@@ -32,6 +33,10 @@ void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
     }
 }
 
+bool SkTaskGroup::DefaultExecutorIsMultiThreaded() {
+    return SkExecutorHasDefault();
+}
+
 bool SkTaskGroup::done() const {
     return fPending.load(std::memory_order_acquire) == 0;
 }
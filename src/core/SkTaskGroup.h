@@ -12,6 +12,7 @@
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkNoncopyable.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <functional>
@@ -36,6 +37,30 @@ public:
     // Block until done().
     void wait();
 
+    // Returns true if a thread pool has been installed with SkExecutor::SetDefault(), so that
+    // tasks on the default executor may run concurrently. Otherwise they run inline when added,
+    // and splitting work into tasks only adds overhead.
+    static bool DefaultExecutorIsMultiThreaded();
+
+    // Calls fn(first, end) over consecutive bands that cover [0, count), e.g. the rows of an
+    // image, where each item is itemPixels pixels of work. When the default executor is
+    // multi-threaded, the bands run in parallel on it, and each band gets at least
+    // kMinPixelsPerBand pixels of work. Otherwise fn(0, count) runs on the calling thread.
+    template <typename Fn>
+    static void ForEachBand(int count, int itemPixels, Fn&& fn) {
+        const int64_t pixels = (int64_t)count * itemPixels;
+        const int bands = (int)std::min<int64_t>({pixels / kMinPixelsPerBand, count, kMaxBands});
+        if (bands <= 1 || !DefaultExecutorIsMultiThreaded()) {
+            fn(0, count);
+            return;
+        }
+        SkTaskGroup tasks;
+        tasks.batch(bands, [&](int band) {
+            fn((int)((int64_t)count * band / bands), (int)((int64_t)count * (band + 1) / bands));
+        });
+        tasks.wait();
+    }
+
     // A convenience for testing tools.
     // Creates and owns a thread pool, and passes it to SkExecutor::SetDefault().
     struct Enabler {
@@ -44,6 +69,9 @@ public:
     };
 
 private:
+    static constexpr int64_t kMinPixelsPerBand = 64 * 1024;
+    static constexpr int64_t kMaxBands = 32;
+
     std::atomic<int32_t> fPending;
     SkExecutor&          fExecutor;
 };
@@ -59,6 +59,7 @@ bool SkRuntimeColorFilter::appendStages(const SkStageRec& rec, bool) const {
                                                     /*alwaysCopyIntoAlloc=*/false,
                                                     rec.fDstCS,
                                                     rec.fAlloc);
+        program = fEffect->specializeRPProgram(program, &uniforms, rec.fAlloc);
         SkShaders::MatrixRec matrix(SkMatrix::I());
         matrix.markCTMApplied();
         RuntimeEffectRPCallbacks callbacks(rec, matrix, fChildren, fEffect->fSampleUsages);
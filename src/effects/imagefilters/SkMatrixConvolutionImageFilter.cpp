@@ -15,6 +15,7 @@
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
@@ -33,6 +34,7 @@
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkThreadAnnotations.h"
 #include "src/base/SkSafeMath.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkLRUCache.h"
@@ -40,8 +42,12 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkRuntimeEffectPriv.h"
+#include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <optional>
@@ -74,6 +80,9 @@ static_assert(kMediumKernelSize <= kMaxKernelSize, "Medium kernel size must be <
 SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
                               float* innerGain, float* innerBias);
 
+int decompose_kernel(const SkISize& kernelSize, const float* kernel, float gain,
+                     TArray<float>* rowFactors, TArray<float>* columnFactors);
+
 class SkMatrixConvolutionImageFilter final : public SkImageFilter_Base {
 public:
     SkMatrixConvolutionImageFilter(const SkISize& kernelSize, const SkScalar* kernel,
@@ -94,6 +103,8 @@ public:
 
         // Does nothing for small kernels, otherwise encodes kernel into an A8 image.
         fKernelBitmap = create_kernel_bitmap(kernelSize, kernel, &fInnerGain, &fInnerBias);
+        // Zero unless the kernel is cheaper to apply on raster as a sum of separable passes.
+        fRank = decompose_kernel(kernelSize, kernel, gain, &fRowFactors, &fColumnFactors);
     }
 
     SkRect computeFastBounds(const SkRect& bounds) const override;
@@ -139,6 +150,11 @@ private:
 
     sk_sp<SkShader> createShader(const skif::Context& ctx, sk_sp<SkShader> input) const;
 
+    // Returns the convolution of 'input' over the context's desired output, computed on the CPU as
+    // fRank separable passes, or nullopt if its pixels can't be read that way.
+    std::optional<skif::FilterResult> rasterSeparableConvolution(
+            const skif::Context& ctx, const skif::FilterResult& input) const;
+
     // Original kernel data, preserved for serialization even if it was encoded into fKernelBitmap
     TArray<float> fKernel;
 
@@ -157,6 +173,12 @@ private:
     SkBitmap fKernelBitmap;
     float fInnerBias;
     float fInnerGain;
+
+    // Also derived from fKernel: when fRank > 0, the kernel is the sum over i < fRank of the
+    // outer products of fColumnFactors[i*height, (i+1)*height) and fRowFactors[i*width, ...).
+    int fRank;
+    TArray<float> fRowFactors;
+    TArray<float> fColumnFactors;
 };
 
 // LayerSpace doesn't have a clean type to represent 4 separate edge deltas, but the result
@@ -235,6 +257,118 @@ SkBitmap create_kernel_bitmap(const SkISize& kernelSize, const float* kernel,
     return kernelBM;
 }
 
+// Decomposes the kernel into the fewest outer products of a column and a row that reproduce it to
+// within 1/4 of an 8-bit step (for inputs in [0, 1], after 'gain'), and returns that rank. The
+// factors come from a one-sided Jacobi SVD: rotating pairs of kernel columns until they are
+// orthogonal gives K*V = B, so K = sum(b_i * v_i^T), ordered here by the norm of b_i. Returns 0
+// when applying that many separable passes costs more taps than applying the kernel directly.
+int decompose_kernel(const SkISize& kernelSize, const float* kernel, float gain,
+                     TArray<float>* rowFactors, TArray<float>* columnFactors) {
+    const int w = kernelSize.fWidth;
+    const int h = kernelSize.fHeight;
+    if (w == 1 || h == 1) {
+        return 0; // Already a single pass, the shader does as well
+    }
+
+    // b is the kernel stored by columns, v starts as the identity; both are rotated together.
+    TArray<double> b(w * h), v(w * w);
+    for (int x = 0; x < w; ++x) {
+        for (int y = 0; y < h; ++y) {
+            b.push_back(kernel[y * w + x]);
+        }
+        for (int i = 0; i < w; ++i) {
+            v.push_back(i == x ? 1 : 0);
+        }
+    }
+    static constexpr int kMaxSweeps = 32;
+    static constexpr double kEpsilon = 1e-12;
+    for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+        bool rotated = false;
+        for (int p = 0; p < w - 1; ++p) {
+            for (int q = p + 1; q < w; ++q) {
+                double* bp = &b[p * h];
+                double* bq = &b[q * h];
+                double alpha = 0, beta = 0, gamma = 0;
+                for (int y = 0; y < h; ++y) {
+                    alpha += bp[y] * bp[y];
+                    beta  += bq[y] * bq[y];
+                    gamma += bp[y] * bq[y];
+                }
+                if (std::abs(gamma) <= kEpsilon * std::sqrt(alpha * beta)) {
+                    continue;
+                }
+                rotated = true;
+                const double zeta = (beta - alpha) / (2 * gamma);
+                const double t = std::copysign(1.0, zeta) /
+                                 (std::abs(zeta) + std::sqrt(1 + zeta * zeta));
+                const double c = 1 / std::sqrt(1 + t * t);
+                const double s = c * t;
+                auto rotate = [c, s](double* a0, double* a1, int n) {
+                    for (int i = 0; i < n; ++i) {
+                        const double x0 = a0[i], x1 = a1[i];
+                        a0[i] = c * x0 - s * x1;
+                        a1[i] = s * x0 + c * x1;
+                    }
+                };
+                rotate(bp, bq, h);
+                rotate(&v[p * w], &v[q * w], w);
+            }
+        }
+        if (!rotated) {
+            break;
+        }
+    }
+
+    int order[kMaxKernelSize];
+    TArray<double> norms(w);
+    for (int i = 0; i < w; ++i) {
+        double norm = 0;
+        for (int y = 0; y < h; ++y) {
+            norm += b[i * h + y] * b[i * h + y];
+        }
+        norms.push_back(norm);
+        order[i] = i;
+    }
+    std::sort(order, order + w, [&](int i0, int i1) { return norms[i0] > norms[i1]; });
+
+    // Accumulate outer products until the remaining error is below the tolerance. Gain scales the
+    // whole sum, so it scales the error too.
+    const double tolerance = 0.25 / 255 / std::max(std::abs(gain), 1e-6f);
+    TArray<double> residual(w * h);
+    for (int i = 0; i < w * h; ++i) {
+        residual.push_back(kernel[i]);
+    }
+    int rank = 0;
+    double error = tolerance + 1;
+    while (rank < w && error > tolerance) {
+        const double* bi = &b[order[rank] * h];
+        const double* vi = &v[order[rank] * w];
+        error = 0;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                residual[y * w + x] -= bi[y] * vi[x];
+                error += std::abs(residual[y * w + x]);
+            }
+        }
+        ++rank;
+    }
+    if (error > tolerance || rank * (w + h) > w * h) {
+        return 0;
+    }
+
+    rowFactors->reset(rank * w);
+    columnFactors->reset(rank * h);
+    for (int i = 0; i < rank; ++i) {
+        for (int x = 0; x < w; ++x) {
+            (*rowFactors)[i * w + x] = v[order[i] * w + x];
+        }
+        for (int y = 0; y < h; ++y) {
+            (*columnFactors)[i * h + y] = b[order[i] * h + y];
+        }
+    }
+    return rank;
+}
+
 } // anonymous namespace
 
 sk_sp<SkImageFilter> SkImageFilters::MatrixConvolution(const SkISize& kernelSize,
@@ -523,6 +657,134 @@ sk_sp<SkShader> SkMatrixConvolutionImageFilter::createShader(const skif::Context
     return builder.makeShader();
 }
 
+// On raster, a low-rank kernel is applied as fRank pairs of 1D passes whose results are summed.
+// Each pixel is a skvx::float4 so that all four channels are convolved at once. Output rows are
+// split into bands with SkTaskGroup::ForEachBand(), and each band is convolved in chunks of rows.
+// Each chunk runs the row passes over the input rows its column passes need, so chunks re-read
+// kernel height - 1 rows of their neighbors instead of sharing an intermediate image the size of
+// the output for each rank.
+static constexpr int kRowsPerConvolutionChunk = 64;
+
+std::optional<skif::FilterResult> SkMatrixConvolutionImageFilter::rasterSeparableConvolution(
+        const skif::Context& ctx, const skif::FilterResult& input) const {
+    SkASSERT(fRank > 0);
+    auto [srcImage, srcOrigin] = input.imageAndOffset(
+            ctx.withNewDesiredOutput(this->boundsSampledByKernel(ctx.desiredOutput())));
+    if (!srcImage) {
+        // Transparent black convolves to transparent black, unless the bias makes it visible.
+        if (fConvolveAlpha && fBias != 0.f) {
+            return std::nullopt;
+        }
+        return skif::FilterResult{};
+    }
+
+    // Any channel order works as long as alpha is last.
+    SkBitmap srcBM;
+    if (!SkSpecialImages::AsBitmap(srcImage.get(), &srcBM) ||
+        (srcBM.colorType() != kRGBA_8888_SkColorType &&
+         srcBM.colorType() != kBGRA_8888_SkColorType) ||
+        srcBM.alphaType() != kPremul_SkAlphaType) {
+        return std::nullopt;
+    }
+
+    const SkIRect srcBounds = SkIRect::MakeXYWH(srcOrigin.x(), srcOrigin.y(),
+                                                srcBM.width(), srcBM.height());
+    const SkIRect dstBounds = SkIRect(ctx.desiredOutput());
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(srcBM.info().makeDimensions(dstBounds.size()))) {
+        return std::nullopt;
+    }
+
+    const int kernelW = fKernelSize.width();
+    const int kernelH = fKernelSize.height();
+    const int dstW = dstBounds.width();
+    const int srcRowW = dstW + kernelW - 1;
+    const SkPixmap& src = srcBM.pixmap();
+    // Reads the pixel at layer coordinates (x, y) as floats, unpremultiplied when alpha is kept.
+    auto load = [&](int x, int y) {
+        if (!srcBounds.contains(x, y)) {
+            return skvx::float4(0.f);
+        }
+        auto c = skvx::cast<float>(skvx::byte4::Load(
+                src.addr32(x - srcBounds.left(), y - srcBounds.top()))) * (1 / 255.f);
+        if (!fConvolveAlpha) {
+            const float a = c[3];
+            c = a > 0 ? skvx::float4(c[0] / a, c[1] / a, c[2] / a, a) : skvx::float4(0.f);
+        }
+        return c;
+    };
+    // Adds k * src[i] to acc[i] for i in [0, n).
+    auto accumulate = [](skvx::float4* acc, const skvx::float4* src, float k, int n) {
+        for (int i = 0; i < n; ++i) {
+            acc[i] += k * src[i];
+        }
+    };
+
+    SkTaskGroup::ForEachBand(dstBounds.height(), dstW, [&](int first, int end) {
+        const int maxRowsH = std::min(kRowsPerConvolutionChunk, end - first) + kernelH - 1;
+        TArray<skvx::float4> srcRow(srcRowW);
+        srcRow.push_back_n(srcRowW);
+        TArray<skvx::float4> rows(fRank * maxRowsH * dstW);
+        rows.push_back_n(fRank * maxRowsH * dstW);
+        TArray<skvx::float4> sum(dstW);
+        sum.push_back_n(dstW);
+        const skvx::float4 bias(fBias / 255.f);
+
+        for (int chunk = first; chunk < end; chunk += kRowsPerConvolutionChunk) {
+            const int top = dstBounds.top() + chunk;
+            const int bottom = dstBounds.top() + std::min(chunk + kRowsPerConvolutionChunk, end);
+            const int rowsH = bottom - top + kernelH - 1;
+
+            // Row passes: rows[i][r] holds rank i's row factor applied to input row r.
+            std::fill(rows.begin(), rows.begin() + fRank * rowsH * dstW, skvx::float4(0.f));
+            for (int r = 0; r < rowsH; ++r) {
+                const int y = top - fKernelOffset.y() + r;
+                for (int x = 0; x < srcRowW; ++x) {
+                    srcRow[x] = load(dstBounds.left() - fKernelOffset.x() + x, y);
+                }
+                for (int i = 0; i < fRank; ++i) {
+                    skvx::float4* out = &rows[(i * rowsH + r) * dstW];
+                    for (int kx = 0; kx < kernelW; ++kx) {
+                        accumulate(out, &srcRow[kx], fRowFactors[i * kernelW + kx], dstW);
+                    }
+                }
+            }
+
+            // Column passes, summed over all ranks, then gain and bias as in the shader.
+            for (int y = top; y < bottom; ++y) {
+                std::fill(sum.begin(), sum.end(), skvx::float4(0.f));
+                for (int i = 0; i < fRank; ++i) {
+                    for (int ky = 0; ky < kernelH; ++ky) {
+                        accumulate(sum.data(), &rows[(i * rowsH + y - top + ky) * dstW],
+                                   fColumnFactors[i * kernelH + ky], dstW);
+                    }
+                }
+
+                uint32_t* dstRow = dst.getAddr32(0, y - dstBounds.top());
+                for (int x = 0; x < dstW; ++x) {
+                    skvx::float4 color = sum[x] * fGain + bias;
+                    float a;
+                    if (fConvolveAlpha) {
+                        a = std::clamp(color[3], 0.f, 1.f);
+                    } else {
+                        a = load(dstBounds.left() + x, y)[3];
+                        color *= a;
+                    }
+                    color = skvx::pin(color, skvx::float4(0.f), skvx::float4(a));
+                    color[3] = a;
+                    skvx::cast<uint8_t>(skvx::lrint(color * 255.f)).store(dstRow + x);
+                }
+            }
+        }
+    });
+
+    dst.setImmutable();
+    return skif::FilterResult{
+            SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()), dst,
+                                            srcImage->props()),
+            ctx.desiredOutput().topLeft()};
+}
+
 skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         const skif::Context& context) const {
     using ShaderFlags = skif::FilterResult::ShaderFlags;
@@ -544,6 +806,15 @@ skif::FilterResult SkMatrixConvolutionImageFilter::onFilterImage(
         }
     }
 
+    // When the backend's pixels are on the CPU, low-rank kernels are applied directly to them if
+    // they are in a format that allows it.
+    if (fRank > 0 && context.backend()->hasCPUPixels()) {
+        if (auto result = this->rasterSeparableConvolution(
+                    context.withNewDesiredOutput(outputBounds), childOutput)) {
+            return *result;
+        }
+    }
+
     skif::FilterResult::Builder builder{context};
     builder.add(childOutput,
                 this->boundsSampledByKernel(outputBounds),
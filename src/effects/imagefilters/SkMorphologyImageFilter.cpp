@@ -7,9 +7,13 @@
 
 #include "include/effects/SkImageFilters.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkImageFilter.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
@@ -17,15 +21,23 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkRuntimeEffect.h"
+#include "include/private/base/SkAlign.h"
 #include "include/private/base/SkSpan_impl.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkUtils.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkReadBuffer.h"
+#include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <utility>
 
@@ -222,6 +234,189 @@ skif::FilterResult morphology_pass(const skif::Context& ctx, const skif::FilterR
     return childOutput;
 }
 
+// On raster, the morphology passes are computed directly on the pixels with the van Herk/Gil-Werman
+// algorithm, which takes a constant number of min/max operations per pixel regardless of radius.
+// Lines are split into blocks of the kernel width (2R+1); the window around each pixel spans at
+// most two blocks, so it is the min/max of the suffix of one block and the prefix of the next.
+//
+// Each lane vector holds four 8888 pixels: for the X pass, the same column of four neighboring
+// rows, and for the Y pass, four neighboring pixels of the same row. Both passes split their
+// lines into bands that run on SkTaskGroup's default executor.
+using MorphLanes = skvx::Vec<16, uint8_t>;
+
+static constexpr int kMorphLanePixels = 4;
+
+template <MorphType kType>
+SK_ALWAYS_INLINE MorphLanes morph_op(const MorphLanes& a, const MorphLanes& b) {
+    return kType == MorphType::kDilate ? max(a, b) : min(a, b);
+}
+
+// Writes out[i] = op(in[i - radius], ..., in[i + radius]) for i in [0, n), where load(k) returns
+// in[k] for k in [-radius, n + radius). 'suffix' must hold n + 2 * radius lanes.
+template <MorphType kType, typename Load, typename Store>
+void morph_line(int n, int radius, Load&& load, Store&& store, MorphLanes* suffix) {
+    const int width = 2 * radius + 1;
+    const int len = n + 2 * radius;
+
+    // Suffix min/max of each block, walking backwards. The last block may be partial.
+    MorphLanes acc;
+    for (int e = len - 1, blockPos = (len - 1) % width; e >= 0; --e) {
+        MorphLanes v = load(e - radius);
+        acc = (e == len - 1 || blockPos == width - 1) ? v : morph_op<kType>(acc, v);
+        suffix[e] = acc;
+        if (--blockPos < 0) {
+            blockPos = width - 1;
+        }
+    }
+
+    // Prefix min/max of each block, combined with the suffix at the start of each window.
+    for (int e = 0, blockPos = 0; e < len; ++e) {
+        MorphLanes v = load(e - radius);
+        acc = blockPos == 0 ? v : morph_op<kType>(acc, v);
+        if (e >= width - 1) {
+            store(e - width + 1, morph_op<kType>(suffix[e - width + 1], acc));
+        }
+        if (++blockPos == width) {
+            blockPos = 0;
+        }
+    }
+}
+
+// Morphs 'src', whose pixels sit at 'srcBounds' and are transparent outside of it, into a new
+// bitmap covering 'dstBounds'.
+template <MorphType kType>
+SkBitmap cpu_morphology(const SkPixmap& src, SkIRect srcBounds, SkIRect dstBounds, SkISize radii) {
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(src.info().makeDimensions(dstBounds.size()))) {
+        return {};
+    }
+
+    // The X pass outputs the extra rows that the Y pass reads, into a buffer whose rows are padded
+    // to whole lanes so the Y pass never needs to check its loads.
+    const SkIRect xBounds = dstBounds.makeOutset(0, radii.height());
+    const int xStride = SkAlign4(xBounds.width());
+    static_assert(kMorphLanePixels == 4);
+    skia_private::AutoTMalloc<uint32_t> xPixels((size_t) xStride * xBounds.height());
+
+    const int xLineCount = (xBounds.height() + kMorphLanePixels - 1) / kMorphLanePixels;
+    const int xLinePixels = xBounds.width() * kMorphLanePixels;
+    SkTaskGroup::ForEachBand(xLineCount, xLinePixels, [&](int first, int end) {
+        skia_private::TArray<MorphLanes> suffix;
+        suffix.push_back_n(xBounds.width() + 2 * radii.width());
+        for (int line = first; line < end; ++line) {
+            // Four rows per line; rows outside of src (or past the end of xBounds) read as 0.
+            const uint32_t* srcRows[kMorphLanePixels];
+            uint32_t* dstRows[kMorphLanePixels];
+            for (int i = 0; i < kMorphLanePixels; ++i) {
+                const int y = xBounds.top() + line * kMorphLanePixels + i;
+                srcRows[i] = y >= srcBounds.top() && y < srcBounds.bottom()
+                        ? src.addr32(0, y - srcBounds.top()) : nullptr;
+                dstRows[i] = y < xBounds.bottom()
+                        ? xPixels.get() + (size_t) (y - xBounds.top()) * xStride : nullptr;
+            }
+            const int srcOffset = xBounds.left() - srcBounds.left();
+            morph_line<kType>(
+                    xBounds.width(), radii.width(),
+                    [&](int k) {
+                        const int x = srcOffset + k;
+                        if (x < 0 || x >= srcBounds.width()) {
+                            return MorphLanes(0);
+                        }
+                        skvx::Vec<4, uint32_t> px{srcRows[0] ? srcRows[0][x] : 0,
+                                                  srcRows[1] ? srcRows[1][x] : 0,
+                                                  srcRows[2] ? srcRows[2][x] : 0,
+                                                  srcRows[3] ? srcRows[3][x] : 0};
+                        return sk_bit_cast<MorphLanes>(px);
+                    },
+                    [&](int i, const MorphLanes& v) {
+                        auto px = sk_bit_cast<skvx::Vec<4, uint32_t>>(v);
+                        for (int r = 0; r < kMorphLanePixels; ++r) {
+                            if (dstRows[r]) {
+                                dstRows[r][i] = px[r];
+                            }
+                        }
+                    },
+                    suffix.data());
+        }
+    });
+
+    const int yLineCount = xStride / kMorphLanePixels;
+    const int yLinePixels = dstBounds.height() * kMorphLanePixels;
+    SkTaskGroup::ForEachBand(yLineCount, yLinePixels, [&](int first, int end) {
+        skia_private::TArray<MorphLanes> suffix;
+        suffix.push_back_n(dstBounds.height() + 2 * radii.height());
+        for (int line = first; line < end; ++line) {
+            // Four columns per line; the last line may have fewer valid columns in dst.
+            const int x = line * kMorphLanePixels;
+            const int columns = std::min(kMorphLanePixels, dstBounds.width() - x);
+            morph_line<kType>(
+                    dstBounds.height(), radii.height(),
+                    [&](int k) {
+                        // xBounds is dstBounds outset by the Y radius, so every row is available.
+                        const int y = k + radii.height();
+                        return MorphLanes::Load(xPixels.get() + (size_t) y * xStride + x);
+                    },
+                    [&](int i, const MorphLanes& v) {
+                        uint32_t px[kMorphLanePixels];
+                        v.store(px);
+                        memcpy(dst.getAddr32(x, i), px, columns * sizeof(uint32_t));
+                    },
+                    suffix.data());
+        }
+    });
+
+    return dst;
+}
+
+// The channels are 8-bit and independent, so min/max can work on any ordering of them.
+bool is_8888(SkColorType colorType) {
+    switch (colorType) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kSRGBA_8888_SkColorType:
+        case kRGB_888x_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Returns the morphology of 'input' over the context's desired output, computed directly on the
+// CPU, or nullopt if its pixels can't be read that way.
+std::optional<skif::FilterResult> raster_morphology(const skif::Context& ctx,
+                                                    const skif::FilterResult& input,
+                                                    MorphType type,
+                                                    skif::LayerSpace<SkISize> radii) {
+    // Resolve the input over everything the kernel reads, with transparent black beyond it.
+    skif::LayerSpace<SkIRect> requiredInput = ctx.desiredOutput();
+    requiredInput.outset(radii);
+    auto [srcImage, srcOrigin] = input.imageAndOffset(ctx.withNewDesiredOutput(requiredInput));
+    if (!srcImage) {
+        return skif::FilterResult{}; // Eroded or dilated transparent black is still transparent
+    }
+
+    SkBitmap srcBM;
+    if (!SkSpecialImages::AsBitmap(srcImage.get(), &srcBM) || !is_8888(srcBM.colorType())) {
+        return std::nullopt;
+    }
+
+    const SkIRect srcBounds = SkIRect::MakeXYWH(srcOrigin.x(), srcOrigin.y(),
+                                                srcBM.width(), srcBM.height());
+    const SkIRect dstBounds = SkIRect(ctx.desiredOutput());
+    const SkISize kernelRadii = SkISize(radii);
+    SkBitmap dst = type == MorphType::kDilate
+            ? cpu_morphology<MorphType::kDilate>(srcBM.pixmap(), srcBounds, dstBounds, kernelRadii)
+            : cpu_morphology<MorphType::kErode>(srcBM.pixmap(), srcBounds, dstBounds, kernelRadii);
+    if (dst.drawsNothing()) {
+        return skif::FilterResult{};
+    }
+    dst.setImmutable();
+    return skif::FilterResult{
+            SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(dst.dimensions()), dst,
+                                            srcImage->props()),
+            ctx.desiredOutput().topLeft()};
+}
+
 } // end namespace
 
 sk_sp<SkImageFilter> SkImageFilters::Dilate(SkScalar radiusX, SkScalar radiusY,
@@ -282,8 +477,17 @@ skif::FilterResult SkMorphologyImageFilter::onFilterImage(const skif::Context& c
         return {};
     }
 
-    // The X pass has to preserve the extra rows to later be consumed by the Y pass.
     skif::LayerSpace<SkISize> radii = this->radii(ctx.mapping());
+    // When the backend's pixels are on the CPU, both passes run directly on them if they are in a
+    // format that allows it.
+    if (ctx.backend()->hasCPUPixels()) {
+        if (auto result = raster_morphology(ctx.withNewDesiredOutput(maxOutput), childOutput,
+                                            fType, radii)) {
+            return *result;
+        }
+    }
+
+    // The X pass has to preserve the extra rows to later be consumed by the Y pass.
     skif::LayerSpace<SkIRect> maxOutputX = maxOutput;
     maxOutputX.outset(skif::LayerSpace<SkISize>({0, radii.height()}));
     childOutput = morphology_pass(ctx.withNewDesiredOutput(maxOutputX), childOutput, fType,
@@ -19,6 +19,7 @@
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSurface.h"
+#include "src/core/SkResizePixels.h"
 
 #include <cmath>
 #include <cstddef>
@@ -35,6 +36,39 @@ void SkRescaleAndReadPixels(SkBitmap bmp,
     int srcW = srcRect.width();
     int srcH = srcRect.height();
 
+    auto deliver = [&](std::unique_ptr<const char[]> data, size_t rowBytes) {
+        class Result : public SkImage::AsyncReadResult {
+        public:
+            Result(std::unique_ptr<const char[]> data, size_t rowBytes)
+                    : fData(std::move(data)), fRowBytes(rowBytes) {}
+            int count() const override { return 1; }
+            const void* data(int i) const override { return fData.get(); }
+            size_t rowBytes(int i) const override { return fRowBytes; }
+
+        private:
+            std::unique_ptr<const char[]> fData;
+            size_t fRowBytes;
+        };
+        callback(context, std::make_unique<Result>(std::move(data), rowBytes));
+    };
+
+    // Cubic rescales are done in one separable pass, with the filter widened when downscaling,
+    // rather than in repeated steps of at most 2x.
+    if (rescaleMode == SkImage::RescaleMode::kRepeatedCubic) {
+        SkPixmap srcPM;
+        size_t rowBytes = resultInfo.minRowBytes();
+        std::unique_ptr<char[]> data(new char[resultInfo.height() * rowBytes]);
+        if (bmp.pixmap().extractSubset(&srcPM, srcRect) &&
+            SkResizePixels(SkPixmap(resultInfo, data.get(), rowBytes), srcPM,
+                           SkResizeFilter::Mitchell(),
+                           rescaleGamma == SkImage::RescaleGamma::kLinear)) {
+            deliver(std::move(data), rowBytes);
+        } else {
+            callback(context, nullptr);
+        }
+        return;
+    }
+
     float sx = (float)resultInfo.width() / srcW;
     float sy = (float)resultInfo.height() / srcH;
     // How many bilerp/bicubic steps to do in X and Y. + means upscaling, - means downscaling.
@@ -147,19 +181,7 @@ void SkRescaleAndReadPixels(SkBitmap bmp,
     std::unique_ptr<char[]> data(new char[resultInfo.height() * rowBytes]);
     SkPixmap pm(resultInfo, data.get(), rowBytes);
     if (srcImage->readPixels(nullptr, pm, srcX, srcY)) {
-        class Result : public SkImage::AsyncReadResult {
-        public:
-            Result(std::unique_ptr<const char[]> data, size_t rowBytes)
-                    : fData(std::move(data)), fRowBytes(rowBytes) {}
-            int count() const override { return 1; }
-            const void* data(int i) const override { return fData.get(); }
-            size_t rowBytes(int i) const override { return fRowBytes; }
-
-        private:
-            std::unique_ptr<const char[]> fData;
-            size_t fRowBytes;
-        };
-        callback(context, std::make_unique<Result>(std::move(data), rowBytes));
+        deliver(std::move(data), rowBytes);
     } else {
         callback(context, nullptr);
     }
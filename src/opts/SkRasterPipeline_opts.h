@@ -4037,6 +4037,10 @@ STAGE_TAIL(trace_scope, SkRasterPipeline_TraceScopeCtx* ctx) {
     }
 }
 
+STAGE_TAIL(profile_stage, SkRasterPipeline_ProfileCtx* ctx) {
+    ctx->profileHook->stage(ctx->stageIndex);
+}
+
 STAGE_TAIL(trace_var, SkRasterPipeline_TraceVarCtx* ctx) {
     const I32* traceMask = (const I32*)ctx->traceMask;
     I32 mask = execution_mask() & *traceMask;
@@ -4554,6 +4558,35 @@ SI void apply_adjacent_binary_packed(SkRasterPipeline_BinaryOpCtx* packed, std::
     apply_adjacent_binary<T, ApplyFn>((T*)dst, (T*)src);
 }
 
+// These binary operations read their right-side input directly from a value slot, instead of from
+// the stack position adjacent to `dst`. This saves a copy of the right-side onto the stack. The
+// left-side input is usually `dst` itself, but can also be read from a separate slot.
+template <typename T, void (*ApplyFn)(T*, T*), int NumSlots>
+SI void apply_binary_from_slots(SkRasterPipeline_BinaryOpFromSlotsCtx* packed, std::byte* base) {
+    auto ctx = SkRPCtxUtils::Unpack(packed);
+    T* dst = (T*)(base + ctx.dst);
+    T* left = (T*)(base + ctx.left);
+    T* right = (T*)(base + ctx.right);
+    for (int index = 0; index < NumSlots; ++index) {
+        T value = left[index];
+        ApplyFn(&value, right + index);
+        dst[index] = value;
+    }
+}
+
+// Binary operations which combine every slot of `dst` with the single scalar in `src`. The scalar
+// sits directly after `dst`, in the position where a splatted copy would otherwise begin.
+template <typename T, void (*ApplyFn)(T*, T*)>
+SI void apply_binary_by_scalar(SkRasterPipeline_BinaryOpCtx* packed, std::byte* base) {
+    auto ctx = SkRPCtxUtils::Unpack(packed);
+    T* dst = (T*)(base + ctx.dst);
+    T* src = (T*)(base + ctx.src);
+    do {
+        ApplyFn(dst, src);
+        dst += 1;
+    } while (dst != src);
+}
+
 template <int N, typename V, typename S, void (*ApplyFn)(V*, V*)>
 SI void apply_binary_immediate(SkRasterPipeline_ConstantCtx* packed, std::byte* base) {
     auto ctx = SkRPCtxUtils::Unpack(packed);
@@ -4711,6 +4744,46 @@ DECLARE_BINARY_FLOAT(cmpne)  DECLARE_BINARY_INT(cmpne)
 DECLARE_N_WAY_BINARY_FLOAT(atan2)
 DECLARE_N_WAY_BINARY_FLOAT(pow)
 
+// The most common float ops can also take their right-side input directly from a value slot.
+#define DECLARE_BINARY_FLOAT_FROM_SLOTS(name)                                               \
+    STAGE_TAIL(name##_float_from_slot, SkRasterPipeline_BinaryOpFromSlotsCtx* packed) {     \
+        apply_binary_from_slots<F, &name##_fn, 1>(packed, base);                            \
+    }                                                                                       \
+    STAGE_TAIL(name##_2_floats_from_slots, SkRasterPipeline_BinaryOpFromSlotsCtx* packed) { \
+        apply_binary_from_slots<F, &name##_fn, 2>(packed, base);                            \
+    }                                                                                       \
+    STAGE_TAIL(name##_3_floats_from_slots, SkRasterPipeline_BinaryOpFromSlotsCtx* packed) { \
+        apply_binary_from_slots<F, &name##_fn, 3>(packed, base);                            \
+    }                                                                                       \
+    STAGE_TAIL(name##_4_floats_from_slots, SkRasterPipeline_BinaryOpFromSlotsCtx* packed) { \
+        apply_binary_from_slots<F, &name##_fn, 4>(packed, base);                            \
+    }
+
+DECLARE_BINARY_FLOAT_FROM_SLOTS(add)
+DECLARE_BINARY_FLOAT_FROM_SLOTS(sub)
+DECLARE_BINARY_FLOAT_FROM_SLOTS(mul)
+DECLARE_BINARY_FLOAT_FROM_SLOTS(div)
+
+// Fused ops combine a common sequence of ops into a single stage.
+#define DECLARE_BINARY_FLOAT_BY_SCALAR(name)                                      \
+    STAGE_TAIL(name##_n_floats_by_scalar, SkRasterPipeline_BinaryOpCtx* packed) { \
+        apply_binary_by_scalar<F, &name##_fn>(packed, base);                      \
+    }
+
+DECLARE_BINARY_FLOAT_BY_SCALAR(add)
+DECLARE_BINARY_FLOAT_BY_SCALAR(sub)
+DECLARE_BINARY_FLOAT_BY_SCALAR(mul)
+DECLARE_BINARY_FLOAT_BY_SCALAR(div)
+
+STAGE_TAIL(mad_imm_float, SkRasterPipeline_MadConstantCtx* packed) {
+    auto ctx = SkRPCtxUtils::Unpack(packed);
+    F* dst = (F*)(base + ctx.dst);
+    // The product is rounded before the add, as it is by `mul_imm_float` and `add_imm_float`, so
+    // fusing them never changes a result. (`mad` may compile to an FMA, which rounds only once.)
+    F product = *dst * sk_bit_cast<float>(ctx.mulValue);
+    *dst = product + sk_bit_cast<float>(ctx.addValue);
+}
+
 // Some ops have an optimized version when the right-side is an immediate value.
 #define DECLARE_IMM_BINARY_FLOAT(name)                                   \
     STAGE_TAIL(name##_imm_float, SkRasterPipeline_ConstantCtx* packed) { \
@@ -76,6 +76,17 @@ SkRuntimeEffect::TracedShader SkRuntimeShader::makeTracedClone(const SkIPoint& c
     return SkRuntimeEffect::TracedShader{std::move(debugShader), std::move(debugTrace)};
 }
 
+SkRuntimeEffect::ProfiledShader SkRuntimeShader::makeProfiledClone(int sampleInterval) {
+    // Unlike a debug trace, a profile measures the optimized program that normally runs.
+    auto profile = sk_make_sp<SkSL::ProfilePriv>(sampleInterval);
+    profile->setSource(fEffect->source());
+    auto profiledShader = sk_make_sp<SkRuntimeShader>(
+            fEffect, /*debugTrace=*/nullptr, this->uniformData(nullptr), SkSpan(fChildren));
+    profiledShader->fProfile = profile;
+
+    return SkRuntimeEffect::ProfiledShader{std::move(profiledShader), std::move(profile)};
+}
+
 bool SkRuntimeShader::appendStages(const SkStageRec& rec, const SkShaders::MatrixRec& mRec) const {
     if (!SkRuntimeEffectPriv::CanDraw(SkCapabilities::RasterBackend().get(), fEffect.get())) {
         // SkRP has support for many parts of #version 300 already, but for now, we restrict its
@@ -93,8 +104,13 @@ bool SkRuntimeShader::appendStages(const SkStageRec& rec, const SkShaders::Matri
                                                     /*alwaysCopyIntoAlloc=*/fUniformData == nullptr,
                                                     rec.fDstCS,
                                                     rec.fAlloc);
+        if (!fDebugTrace && !fProfile) {
+            // Traces and profiles refer to the unspecialized program.
+            program = fEffect->specializeRPProgram(program, &uniforms, rec.fAlloc);
+        }
         RuntimeEffectRPCallbacks callbacks(rec, *newMRec, fChildren, fEffect->fSampleUsages);
-        bool success = program->appendStages(rec.fPipeline, rec.fAlloc, &callbacks, uniforms);
+        bool success = program->appendStages(rec.fPipeline, rec.fAlloc, &callbacks, uniforms,
+                                             fProfile.get());
         return success;
     }
     return false;
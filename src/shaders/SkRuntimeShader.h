@@ -16,6 +16,7 @@
 #include "src/core/SkRuntimeEffectPriv.h"
 #include "src/shaders/SkShaderBase.h"
 #include "src/sksl/tracing/SkSLDebugTracePriv.h"
+#include "src/sksl/tracing/SkSLProfilePriv.h"
 
 #include <vector>
 
@@ -41,6 +42,8 @@ public:
 
     SkRuntimeEffect::TracedShader makeTracedClone(const SkIPoint& coord);
 
+    SkRuntimeEffect::ProfiledShader makeProfiledClone(int sampleInterval);
+
     bool isOpaque() const override { return fEffect->alwaysOpaque(); }
 
     ShaderType type() const override { return ShaderType::kRuntime; }
@@ -65,6 +68,7 @@ private:
 
     sk_sp<SkRuntimeEffect> fEffect;
     sk_sp<SkSL::DebugTracePriv> fDebugTrace;
+    sk_sp<SkSL::ProfilePriv> fProfile;
     sk_sp<const SkData> fUniformData;
     UniformsCallback fUniformsCallback;
     std::vector<SkRuntimeEffect::ChildPtr> fChildren;
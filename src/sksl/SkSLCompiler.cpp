@@ -54,34 +54,46 @@ public:
 };
 
 Compiler::Compiler() : fErrorReporter(this) {
-    auto moduleLoader = ModuleLoader::Get();
-    fContext = std::make_shared<Context>(moduleLoader.builtinTypes(), fErrorReporter);
+    fContext = std::make_shared<Context>(ModuleLoader::GetBuiltinTypes(), fErrorReporter);
 }
 
 Compiler::~Compiler() {}
 
-const Module* Compiler::moduleForProgramKind(ProgramKind kind) {
-    auto m = ModuleLoader::Get();
+static const Module* load_module_for_program_kind(ModuleLoader& m,
+                                                  Compiler* compiler,
+                                                  ProgramKind kind) {
     switch (kind) {
-        case ProgramKind::kFragment:              return m.loadFragmentModule(this);
-        case ProgramKind::kVertex:                return m.loadVertexModule(this);
-        case ProgramKind::kCompute:               return m.loadComputeModule(this);
-        case ProgramKind::kGraphiteFragment:      return m.loadGraphiteFragmentModule(this);
-        case ProgramKind::kGraphiteVertex:        return m.loadGraphiteVertexModule(this);
-        case ProgramKind::kGraphiteFragmentES2:   return m.loadGraphiteFragmentES2Module(this);
-        case ProgramKind::kGraphiteVertexES2:     return m.loadGraphiteVertexES2Module(this);
-        case ProgramKind::kPrivateRuntimeShader:  return m.loadPrivateRTShaderModule(this);
+        case ProgramKind::kFragment:              return m.loadFragmentModule(compiler);
+        case ProgramKind::kVertex:                return m.loadVertexModule(compiler);
+        case ProgramKind::kCompute:               return m.loadComputeModule(compiler);
+        case ProgramKind::kGraphiteFragment:      return m.loadGraphiteFragmentModule(compiler);
+        case ProgramKind::kGraphiteVertex:        return m.loadGraphiteVertexModule(compiler);
+        case ProgramKind::kGraphiteFragmentES2:   return m.loadGraphiteFragmentES2Module(compiler);
+        case ProgramKind::kGraphiteVertexES2:     return m.loadGraphiteVertexES2Module(compiler);
+        case ProgramKind::kPrivateRuntimeShader:  return m.loadPrivateRTShaderModule(compiler);
         case ProgramKind::kRuntimeColorFilter:
         case ProgramKind::kRuntimeShader:
         case ProgramKind::kRuntimeBlender:
         case ProgramKind::kPrivateRuntimeColorFilter:
         case ProgramKind::kPrivateRuntimeBlender:
         case ProgramKind::kMeshVertex:
-        case ProgramKind::kMeshFragment:          return m.loadPublicModule(this);
+        case ProgramKind::kMeshFragment:          return m.loadPublicModule(compiler);
     }
     SkUNREACHABLE;
 }
 
+const Module* Compiler::moduleForProgramKind(ProgramKind kind) {
+    // Loaded modules are immutable, so after the first compile of each kind, Compilers on any
+    // thread can share them without serializing on the ModuleLoader mutex.
+    if (const Module* module = ModuleLoader::FindPublishedModule(kind)) {
+        return module;
+    }
+    auto m = ModuleLoader::Get();
+    const Module* module = load_module_for_program_kind(m, this, kind);
+    m.publishModule(kind, module);
+    return module;
+}
+
 void Compiler::FinalizeSettings(ProgramSettings* settings, ProgramKind kind) {
     // Honor our optimization-override flags.
     switch (sOptimizer) {
@@ -772,6 +772,46 @@ static State get_transition(uint8_t transition, State state) {
     v *= 9;
     return (entry.values >> v) & 511;
 }
+static constexpr int8_t kLoopIndices[427] = {
+        -1, -1, -1, 0,  -1, -1, -1, -1, 1,  -1, 2,  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 3,  -1, -1, 4,  -1, 5,
+        -1, -1, 6,  -1, -1, -1, 7,  -1, -1, 8,  -1, -1, 9,  10, 11, -1, -1, 12, -1, -1, -1, -1, 13,
+        -1, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+static constexpr uint64_t kLoopChars[17][2] = {
+        {0x100002600ull, 0x0ull},
+        {0x3ff000000000000ull, 0x7fffffe87fffffeull},
+        {0x3ff000000000000ull, 0x7fffffe87fffffeull},
+        {0x3ff000000000000ull, 0x0ull},
+        {0x3ff000000000000ull, 0x0ull},
+        {0xfffffbffffffffffull, 0xffffffffffffffffull},
+        {0xfffffffffffffbffull, 0xffffffffffffffffull},
+        {0x3ff000000000000ull, 0x0ull},
+        {0x3ff000000000000ull, 0x0ull},
+        {0x3ff000000000000ull, 0x0ull},
+        {0xff000000000000ull, 0x0ull},
+        {0x3ff000000000000ull, 0x0ull},
+        {0x3ff000000000000ull, 0x0ull},
+        {0x3ff000000000000ull, 0x7e0000007eull},
+        {0x3ff000000000000ull, 0x0ull},
+        {0x3ff000000000000ull, 0x7fffffe87fffffeull},
+        {0x3ff000000000000ull, 0x7fffffe87fffffeull},
+};
 static const uint8_t kAccepts[427] = {
         255, 255, 89,  89, 92, 68,  73,  92,  43, 41, 41, 41, 41, 36,  41,  41, 41,  41,  37, 41,
         41,  41,  27,  58, 82, 63,  67,  87,  44, 45, 56, 80, 54, 52,  78,  51, 55,  53,  79, 50,
@@ -822,6 +862,18 @@ Token Lexer::next() {
         }
         state = newState;
         ++fOffset;
+
+        // Skip ahead over any characters which would leave us in the same state.
+        if (int loop = kLoopIndices[state]; loop >= 0) {
+            const uint64_t* chars = kLoopChars[loop];
+            while (fOffset < (int32_t)fText.length()) {
+                uint8_t ch = (uint8_t)fText[fOffset];
+                if (ch >= 128 || !((chars[ch >> 6] >> (ch & 63)) & 1)) {
+                    break;
+                }
+                ++fOffset;
+            }
+        }
     }
     Token::Kind kind = (Token::Kind)kAccepts[state];
     return Token(kind, startOffset, fOffset - startOffset);
@@ -22,6 +22,7 @@
 #include "src/sksl/ir/SkSLVariable.h"
 
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <utility>
 #include <vector>
@@ -171,11 +172,32 @@ struct ModuleLoader::Impl {
     std::unique_ptr<const Module> fPublicModule;            // [Shared] minus Private types +
                                                             //     Runtime effect intrinsics
     std::unique_ptr<const Module> fRuntimeShaderModule;     // [Public] + Runtime shader decls
+
+    // Once a program kind's module chain is fully loaded, it's published here so that Compilers
+    // can find it without taking fMutex. Writes happen under fMutex; reads need no lock.
+    static constexpr int kProgramKindCount = (int)ProgramKind::kMeshFragment + 1;
+    std::atomic<const Module*> fPublishedModules[kProgramKindCount] = {};
 };
 
-ModuleLoader ModuleLoader::Get() {
+ModuleLoader::Impl& ModuleLoader::GetImpl() {
     static SkNoDestructor<ModuleLoader::Impl> sModuleLoaderImpl;
-    return ModuleLoader(*sModuleLoaderImpl);
+    return *sModuleLoaderImpl;
+}
+
+ModuleLoader ModuleLoader::Get() {
+    return ModuleLoader(GetImpl());
+}
+
+const BuiltinTypes& ModuleLoader::GetBuiltinTypes() {
+    return GetImpl().fBuiltinTypes;
+}
+
+const Module* ModuleLoader::FindPublishedModule(ProgramKind kind) {
+    return GetImpl().fPublishedModules[(int)kind].load(std::memory_order_acquire);
+}
+
+void ModuleLoader::publishModule(ProgramKind kind, const Module* module) {
+    fModuleLoader.fPublishedModules[(int)kind].store(module, std::memory_order_release);
 }
 
 ModuleLoader::ModuleLoader(ModuleLoader::Impl& m) : fModuleLoader(m) {
@@ -187,6 +209,9 @@ ModuleLoader::~ModuleLoader() {
 }
 
 void ModuleLoader::unloadModules() {
+    for (std::atomic<const Module*>& published : fModuleLoader.fPublishedModules) {
+        published.store(nullptr, std::memory_order_relaxed);
+    }
     fModuleLoader.fSharedModule           = nullptr;
     fModuleLoader.fGPUModule              = nullptr;
     fModuleLoader.fVertexModule           = nullptr;
@@ -16,6 +16,7 @@ namespace SkSL {
 class Compiler;
 struct Module;
 class Type;
+enum class ProgramKind : int8_t;
 
 using BuiltinTypePtr = const std::unique_ptr<Type> BuiltinTypes::*;
 
@@ -24,6 +25,8 @@ private:
     struct Impl;
     Impl& fModuleLoader;
 
+    static Impl& GetImpl();
+
 public:
     ModuleLoader(ModuleLoader::Impl&);
     ~ModuleLoader();
@@ -37,6 +40,19 @@ public:
     const BuiltinTypes& builtinTypes();
     const Module* rootModule();
 
+    // Returns the built-in types without taking the ModuleLoader mutex. This is safe because the
+    // built-in types are immutable once the singleton exists.
+    static const BuiltinTypes& GetBuiltinTypes();
+
+    // Returns the module used to compile programs of `kind`, if one has already been published,
+    // without taking the ModuleLoader mutex. A published module is fully loaded and immutable, so
+    // any number of Compilers on different threads may share it. Returns null if the module has
+    // not been loaded yet; callers should then fall back to Get() and one of the load calls below.
+    static const Module* FindPublishedModule(ProgramKind kind);
+
+    // Makes a fully-loaded module visible to FindPublishedModule.
+    void publishModule(ProgramKind kind, const Module* module);
+
     // These modules are loaded on demand; once loaded, they are kept for the lifetime of the
     // process.
     const Module* loadSharedModule(SkSL::Compiler* compiler);
@@ -56,7 +72,8 @@ public:
     // `vec4` are added; SkSL private types like `sampler2D` are replaced with an invalid type.
     void addPublicTypeAliases(const SkSL::Module* module);
 
-    // This unloads every module. It's useful primarily for benchmarking purposes.
+    // This unloads every module. It's useful primarily for benchmarking purposes; it must not be
+    // called while another thread is compiling.
     void unloadModules();
 };
 
@@ -233,6 +233,14 @@ SymbolTable* Parser::symbolTable() {
     return fCompiler.symbolTable();
 }
 
+const SymbolTable::SymbolKey& Parser::symbolKey(Token token) {
+    if (token.fOffset != fSymbolKeyToken.fOffset || token.fLength != fSymbolKeyToken.fLength) {
+        fSymbolKeyToken = token;
+        fSymbolKey = SymbolTable::MakeSymbolKey(this->text(token));
+    }
+    return fSymbolKey;
+}
+
 Token Parser::nextRawToken() {
     Token token;
     if (fPushback.fKind != Token::Kind::TK_NONE) {
@@ -353,7 +361,7 @@ bool Parser::expectIdentifier(Token* result) {
     if (!this->expect(Token::Kind::TK_IDENTIFIER, "an identifier", result)) {
         return false;
     }
-    if (this->symbolTable()->isBuiltinType(this->text(*result))) {
+    if (this->symbolTable()->isBuiltinType(this->symbolKey(*result))) {
         this->error(*result, "expected an identifier, but found type '" +
                              std::string(this->text(*result)) + "'");
         this->fEncounteredFatalError = true;
@@ -366,7 +374,7 @@ bool Parser::checkIdentifier(Token* result) {
     if (!this->checkNext(Token::Kind::TK_IDENTIFIER, result)) {
         return false;
     }
-    if (this->symbolTable()->isBuiltinType(this->text(*result))) {
+    if (this->symbolTable()->isBuiltinType(this->symbolKey(*result))) {
         this->pushback(*result);
         return false;
     }
@@ -556,7 +564,7 @@ bool Parser::declaration() {
     Modifiers modifiers = this->modifiers();
     Token lookahead = this->peek();
     if (lookahead.fKind == Token::Kind::TK_IDENTIFIER &&
-        !this->symbolTable()->isType(this->text(lookahead))) {
+        !this->symbolTable()->isType(this->symbolKey(lookahead))) {
         // we have an identifier that's not a type, could be the start of an interface block
         return this->interfaceBlock(modifiers);
     }
@@ -883,7 +891,7 @@ std::unique_ptr<Statement> Parser::varDeclarationsOrExpressionStatement() {
     if (nextToken.fKind == Token::Kind::TK_HIGHP ||
         nextToken.fKind == Token::Kind::TK_MEDIUMP ||
         nextToken.fKind == Token::Kind::TK_LOWP ||
-        this->symbolTable()->isType(this->text(nextToken))) {
+        this->symbolTable()->isType(this->symbolKey(nextToken))) {
         // Statements that begin with a typename are most often variable declarations, but
         // occasionally the type is part of a constructor, and these are actually expression-
         // statements in disguise. First, attempt the common case: parse it as a vardecl.
@@ -1249,15 +1257,15 @@ std::unique_ptr<Statement> Parser::statement(bool bracesIntroduceNewScope) {
 
 const Type* Parser::findType(Position pos,
                              Modifiers* modifiers,
-                             std::string_view name) {
+                             const SymbolTable::SymbolKey& name) {
     const Context& context = fCompiler.context();
     const Symbol* symbol = this->symbolTable()->find(name);
     if (!symbol) {
-        this->error(pos, "no symbol named '" + std::string(name) + "'");
+        this->error(pos, "no symbol named '" + std::string(name.fName) + "'");
         return context.fTypes.fPoison.get();
     }
     if (!symbol->is<Type>()) {
-        this->error(pos, "symbol '" + std::string(name) + "' is not a type");
+        this->error(pos, "symbol '" + std::string(name.fName) + "' is not a type");
         return context.fTypes.fPoison.get();
     }
     const SkSL::Type* type = &symbol->as<Type>();
@@ -1280,11 +1288,11 @@ const Type* Parser::type(Modifiers* modifiers) {
     if (!this->expect(Token::Kind::TK_IDENTIFIER, "a type", &type)) {
         return nullptr;
     }
-    if (!this->symbolTable()->isType(this->text(type))) {
+    if (!this->symbolTable()->isType(this->symbolKey(type))) {
         this->error(type, "no type named '" + std::string(this->text(type)) + "'");
         return fCompiler.context().fTypes.fInvalid.get();
     }
-    const Type* result = this->findType(this->position(type), modifiers, this->text(type));
+    const Type* result = this->findType(this->position(type), modifiers, this->symbolKey(type));
     if (result->isInterfaceBlock()) {
         // SkSL puts interface blocks into the symbol table, but they aren't general-purpose types;
         // you can't use them to declare a variable type or a function return type.
@@ -2291,7 +2299,8 @@ std::unique_ptr<Expression> Parser::term() {
                 Position pos = this->position(t);
                 return this->expressionOrPoison(
                         pos,
-                        this->symbolTable()->instantiateSymbolRef(fCompiler.context(), text, pos));
+                        this->symbolTable()->instantiateSymbolRef(fCompiler.context(),
+                                                                  this->symbolKey(t), pos));
             }
             break;
         }
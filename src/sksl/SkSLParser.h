@@ -16,6 +16,7 @@
 #include "src/sksl/SkSLProgramSettings.h"
 #include "src/sksl/ir/SkSLLayout.h"
 #include "src/sksl/ir/SkSLModifiers.h"
+#include "src/sksl/ir/SkSLSymbolTable.h"
 
 #include <cstdint>
 #include <memory>
@@ -34,7 +35,6 @@ struct Program;
 class ProgramElement;
 enum class ProgramKind : int8_t;
 class Statement;
-class SymbolTable;
 class Type;
 class VarDeclaration;
 class Variable;
@@ -216,7 +216,7 @@ private:
 
     std::unique_ptr<Statement> statement(bool bracesIntroduceNewScope = true);
 
-    const Type* findType(Position pos, Modifiers* modifiers, std::string_view name);
+    const Type* findType(Position pos, Modifiers* modifiers, const SymbolTable::SymbolKey& name);
 
     const Type* type(Modifiers* modifiers);
 
@@ -316,6 +316,13 @@ private:
 
     SymbolTable* symbolTable();
 
+    /**
+     * Returns the symbol table key for an identifier token. The parser often looks up the same
+     * token several times (and sees it again after rewinding to a checkpoint), so the most recent
+     * key is kept and its hash is only computed once.
+     */
+    const SymbolTable::SymbolKey& symbolKey(Token token);
+
     Compiler& fCompiler;
     ProgramSettings fSettings;
     ErrorReporter* fErrorReporter;
@@ -328,6 +335,8 @@ private:
     // stack on pathological inputs
     int fDepth = 0;
     Token fPushback;
+    Token fSymbolKeyToken;
+    SymbolTable::SymbolKey fSymbolKey = {};
 };
 
 }  // namespace SkSL
@@ -62,6 +62,9 @@ struct ProgramSettings {
     bool fValidateSPIRV = true;
     // If true, any synthetic uniforms must use push constant syntax
     bool fUsePushConstants = false;
+    // If true, the Raster Pipeline code generator fuses common pairs of adjacent ops into a single
+    // stage. Benchmarks turn this off in order to measure its effect.
+    bool fFuseRasterPipelineOps = true;
     // TODO(skia:11209) - Replace this with a "promised" capabilities?
     // Sets a maximum SkSL version. Compilation will fail if the program uses features that aren't
     // allowed at the requested version. For instance, a valid program must have fully-unrollable
@@ -11,7 +11,9 @@
 
 #include <cerrno>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
+#include <iterator>
 #include <cstdlib>
 #include <locale>
 #include <memory>
@@ -55,7 +57,86 @@ std::string skstd::to_string(double value) {
     return to_string_impl<double, 17>(value);
 }
 
+// Parses literals with at most seven significant digits and a decimal exponent within ±10. Both the
+// digits and the power of ten are exact floats, so a single multiply or divide rounds correctly and
+// matches what a stream would produce. Returns false for anything else.
+static bool fast_stod(std::string_view s, float* value) {
+    static constexpr float kPowersOf10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                            1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    static constexpr int kMaxDigits = 7;
+    static constexpr int kMaxExponent = std::size(kPowersOf10) - 1;
+
+    uint32_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool sawDigit = false;
+    bool sawPoint = false;
+    size_t index = 0;
+    for (; index < s.size(); ++index) {
+        char c = s[index];
+        if (c == '.' && !sawPoint) {
+            sawPoint = true;
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            break;
+        }
+        sawDigit = true;
+        if (sawPoint) {
+            --exponent;
+        }
+        if (mantissa == 0 && c == '0') {
+            continue;  // Leading zeros aren't significant.
+        }
+        if (++digits > kMaxDigits) {
+            return false;
+        }
+        mantissa = mantissa * 10 + (c - '0');
+    }
+    if (!sawDigit) {
+        return false;
+    }
+    if (index < s.size()) {
+        if (s[index] != 'e' && s[index] != 'E') {
+            return false;
+        }
+        ++index;
+        bool negative = false;
+        if (index < s.size() && (s[index] == '+' || s[index] == '-')) {
+            negative = (s[index] == '-');
+            ++index;
+        }
+        if (index == s.size()) {
+            return false;
+        }
+        int explicitExponent = 0;
+        for (; index < s.size(); ++index) {
+            char c = s[index];
+            if (c < '0' || c > '9' || explicitExponent > 2 * kMaxExponent) {
+                return false;
+            }
+            explicitExponent = explicitExponent * 10 + (c - '0');
+        }
+        exponent += negative ? -explicitExponent : explicitExponent;
+    }
+    if (mantissa == 0) {
+        *value = 0.0f;
+        return true;
+    }
+    if (exponent < -kMaxExponent || exponent > kMaxExponent) {
+        return false;
+    }
+    *value = exponent < 0 ? (float)mantissa / kPowersOf10[-exponent]
+                          : (float)mantissa * kPowersOf10[exponent];
+    return true;
+}
+
 bool SkSL::stod(std::string_view s, SKSL_FLOAT* value) {
+    // Built-in modules contain hundreds of float literals, and constructing a stream for each one
+    // is a noticeable part of loading them.
+    if (fast_stod(s, value)) {
+        return true;
+    }
     std::string str(s.data(), s.size());
     std::stringstream buffer(str);
     buffer.imbue(std::locale::classic());
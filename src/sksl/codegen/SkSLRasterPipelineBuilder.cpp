@@ -7,10 +7,12 @@
 
 #include "src/sksl/codegen/SkSLRasterPipelineBuilder.h"
 
+#include "include/core/SkData.h"
 #include "include/core/SkStream.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkArenaAlloc.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkRasterPipelineContextUtils.h"
 #include "src/core/SkRasterPipelineOpContexts.h"
@@ -19,6 +21,7 @@
 #include "src/sksl/SkSLPosition.h"
 #include "src/sksl/SkSLString.h"
 #include "src/sksl/tracing/SkSLDebugTracePriv.h"
+#include "src/sksl/tracing/SkSLProfilePriv.h"
 #include "src/sksl/tracing/SkSLTraceHook.h"
 #include "src/utils/SkBitSet.h"
 
@@ -99,6 +102,30 @@ namespace SkSL::RP {
     case BuilderOp::cmpne_n_floats:     \
     case BuilderOp::cmpne_n_ints
 
+#define ALL_FROM_SLOTS_BINARY_OP_CASES       \
+         BuilderOp::add_float_from_slot:     \
+    case BuilderOp::add_2_floats_from_slots: \
+    case BuilderOp::add_3_floats_from_slots: \
+    case BuilderOp::add_4_floats_from_slots: \
+    case BuilderOp::sub_float_from_slot:     \
+    case BuilderOp::sub_2_floats_from_slots: \
+    case BuilderOp::sub_3_floats_from_slots: \
+    case BuilderOp::sub_4_floats_from_slots: \
+    case BuilderOp::mul_float_from_slot:     \
+    case BuilderOp::mul_2_floats_from_slots: \
+    case BuilderOp::mul_3_floats_from_slots: \
+    case BuilderOp::mul_4_floats_from_slots: \
+    case BuilderOp::div_float_from_slot:     \
+    case BuilderOp::div_2_floats_from_slots: \
+    case BuilderOp::div_3_floats_from_slots: \
+    case BuilderOp::div_4_floats_from_slots
+
+#define ALL_BY_SCALAR_BINARY_OP_CASES       \
+         BuilderOp::add_n_floats_by_scalar: \
+    case BuilderOp::sub_n_floats_by_scalar: \
+    case BuilderOp::mul_n_floats_by_scalar: \
+    case BuilderOp::div_n_floats_by_scalar
+
 #define ALL_IMMEDIATE_BINARY_OP_CASES    \
          BuilderOp::add_imm_float:       \
     case BuilderOp::add_imm_int:         \
@@ -182,10 +209,33 @@ static BuilderOp convert_n_way_op_to_immediate(BuilderOp op, int slots, int32_t*
     return op;
 }
 
+static BuilderOp convert_n_way_op_to_from_slots(BuilderOp op, int slots) {
+    // The from-slots ops only support one to four slots.
+    if (slots < 1 || slots > 4) {
+        return op;
+    }
+    BuilderOp fromSlotOp;
+    switch (op) {
+        case BuilderOp::add_n_floats: fromSlotOp = BuilderOp::add_float_from_slot; break;
+        case BuilderOp::sub_n_floats: fromSlotOp = BuilderOp::sub_float_from_slot; break;
+        case BuilderOp::mul_n_floats: fromSlotOp = BuilderOp::mul_float_from_slot; break;
+        case BuilderOp::div_n_floats: fromSlotOp = BuilderOp::div_float_from_slot; break;
+        default:                      return op;
+    }
+    // We rely on the exact ordering of SkRP ops here; the increasing-slot variations come directly
+    // after the single-slot op.
+    return (BuilderOp)((int)fromSlotOp + slots - 1);
+}
+
+static bool slot_ranges_overlap(SlotRange x, SlotRange y) {
+    return x.index < y.index + y.count &&
+           y.index < x.index + x.count;
+}
+
 void Builder::appendInstruction(BuilderOp op, SlotList slots,
                                 int immA, int immB, int immC, int immD) {
     fInstructions.push_back({op, slots.fSlotA, slots.fSlotB,
-                             immA, immB, immC, immD, fCurrentStackID});
+                             immA, immB, immC, immD, fCurrentStackID, fCurrentSourceOffset});
 }
 
 Instruction* Builder::lastInstruction(int fromBack) {
@@ -234,6 +284,19 @@ void Builder::binary_op(BuilderOp op, int32_t slots) {
                 return;
             }
         }
+        // If we just pushed value slots onto the stack...
+        if (lastInstruction->fOp == BuilderOp::push_slots &&
+            lastInstruction->fImmA >= slots) {
+            // ... and this op can read its right-side directly from value slots...
+            BuilderOp fromSlotsOp = convert_n_way_op_to_from_slots(op, slots);
+            if (fromSlotsOp != op) {
+                // ... discard the pushed slots, and read them from their original location.
+                Slot src = lastInstruction->fSlotA + lastInstruction->fImmA - slots;
+                this->discard_stack(slots);
+                this->appendInstruction(fromSlotsOp, {src}, slots);
+                return;
+            }
+        }
     }
 
     switch (op) {
@@ -337,6 +400,51 @@ bool Builder::simplifyImmediateUnmaskedOp() {
     return false;
 }
 
+bool Builder::simplifyFromSlotsUnmaskedOp() {
+    if (fInstructions.size() < 3) {
+        return false;
+    }
+
+    // If we detect a pattern of 'push, from-slots op, unmasked pop', then we can convert it into a
+    // from-slots op directly onto the value slots and take the stack entirely out of the equation.
+    Instruction* popInstruction  = this->lastInstruction(/*fromBack=*/0);
+    Instruction* opInstruction   = this->lastInstruction(/*fromBack=*/1);
+    Instruction* pushInstruction = this->lastInstruction(/*fromBack=*/2);
+
+    // If the last instruction is an unmasked pop...
+    if (popInstruction && opInstruction && pushInstruction &&
+        popInstruction->fOp == BuilderOp::copy_stack_to_slots_unmasked) {
+        // ... and the prior instruction was a from-slots op on the stack, with the same number of
+        // slots...
+        switch (opInstruction->fOp) {
+            case ALL_FROM_SLOTS_BINARY_OP_CASES: break;
+            default:                             return false;
+        }
+        if (opInstruction->fSlotB != NA || opInstruction->fImmA != popInstruction->fImmA) {
+            return false;
+        }
+        // ... and the prior instruction was `push_slots` of at least that many slots, onto the
+        // same slot range...
+        if (pushInstruction->fOp == BuilderOp::push_slots &&
+            pushInstruction->fImmA >= popInstruction->fImmA &&
+            pushInstruction->fSlotA + pushInstruction->fImmA ==
+            popInstruction->fSlotA + popInstruction->fImmA) {
+            // ... and the right-side either is the destination, or doesn't overlap it at all...
+            SlotRange dst{popInstruction->fSlotA, popInstruction->fImmA};
+            SlotRange src{opInstruction->fSlotA, opInstruction->fImmA};
+            if (dst.index == src.index || !slot_ranges_overlap(dst, src)) {
+                // ... we can shrink the push, eliminate the pop, and perform the op in-place.
+                pushInstruction->fImmA -= opInstruction->fImmA;
+                opInstruction->fSlotB = dst.index;
+                fInstructions.pop_back();
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 void Builder::discard_stack(int32_t count, int stackID) {
     // If we pushed something onto the stack and then immediately discarded part of it, we can
     // shrink or eliminate the push.
@@ -390,6 +498,13 @@ void Builder::discard_stack(int32_t count, int stackID) {
                     }
                 }
 
+                // Likewise, `push, from-slots op, pop` can operate directly on the value slots.
+                if (count == lastInstruction->fImmA) {
+                    if (this->simplifyFromSlotsUnmaskedOp()) {
+                        return;
+                    }
+                }
+
                 // A `copy_stack_to_slots_unmasked` op, followed immediately by a `discard_stack`
                 // op with an equal number of slots, is interpreted as an unmasked stack pop.
                 // We can simplify pops in a variety of ways. First, temporarily get rid of
@@ -896,11 +1011,6 @@ void Builder::copy_stack_to_slots_indirect(SlotRange fixedRange,
                             dynamicStackID);
 }
 
-static bool slot_ranges_overlap(SlotRange x, SlotRange y) {
-    return x.index < y.index + y.count &&
-           y.index < x.index + x.count;
-}
-
 void Builder::copy_constant(Slot slot, int constantValue) {
     // If the last instruction copied the same constant, just extend it.
     if (Instruction* lastInstr = this->lastInstruction()) {
@@ -1263,16 +1373,98 @@ void Builder::matrix_multiply(int leftColumns, int leftRows, int rightColumns, i
 std::unique_ptr<Program> Builder::finish(int numValueSlots,
                                          int numUniformSlots,
                                          int numImmutableSlots,
-                                         DebugTracePriv* debugTrace) {
+                                         DebugTracePriv* debugTrace,
+                                         bool fuseOps) {
     // Verify that calls to enableExecutionMaskWrites and disableExecutionMaskWrites are balanced.
     SkASSERT(fExecutionMaskWritesEnabled == 0);
 
     return std::make_unique<Program>(std::move(fInstructions), numValueSlots, numUniformSlots,
-                                     numImmutableSlots, fNumLabels, debugTrace);
+                                     numImmutableSlots, fNumLabels, debugTrace, fuseOps);
+}
+
+static BuilderOp convert_n_way_op_to_by_scalar(BuilderOp op) {
+    switch (op) {
+        case BuilderOp::add_n_floats: return BuilderOp::add_n_floats_by_scalar;
+        case BuilderOp::sub_n_floats: return BuilderOp::sub_n_floats_by_scalar;
+        case BuilderOp::mul_n_floats: return BuilderOp::mul_n_floats_by_scalar;
+        case BuilderOp::div_n_floats: return BuilderOp::div_n_floats_by_scalar;
+        default:                      return op;
+    }
+}
+
+static bool fuse_instructions(Instruction* first, Instruction* second) {
+    // On success, the fused instruction replaces `second`, and `first` is discarded if it no
+    // longer has any slots left. Both instructions must operate on the same stack.
+    if (first->fStackID != second->fStackID) {
+        return false;
+    }
+
+    switch (second->fOp) {
+        case ALL_FROM_SLOTS_BINARY_OP_CASES:
+            // `push_slots a, op $ += b` becomes `op $ = a + b`. The op pushes its own result, so
+            // the left-side never needs to be copied onto the stack.
+            if (first->fOp == BuilderOp::push_slots &&
+                first->fImmA >= second->fImmA &&
+                second->fSlotB == NA) {
+                second->fSlotB = first->fSlotA + first->fImmA - second->fImmA;
+                second->fImmB = 1;
+                first->fImmA -= second->fImmA;
+                return true;
+            }
+            return false;
+
+        case BuilderOp::add_n_floats:
+        case BuilderOp::sub_n_floats:
+        case BuilderOp::mul_n_floats:
+        case BuilderOp::div_n_floats:
+            // `swizzle $.xxx, op $ += $` becomes a single op which reads the scalar directly.
+            if (first->fOp >= BuilderOp::swizzle_2 &&
+                first->fOp <= BuilderOp::swizzle_4 &&
+                first->fImmA == 1 &&
+                first->fImmB == 0 &&
+                (int)first->fOp - (int)BuilderOp::swizzle_1 + 1 == second->fImmA) {
+                second->fOp = convert_n_way_op_to_by_scalar(second->fOp);
+                first->fImmA = 0;
+                return true;
+            }
+            return false;
+
+        case BuilderOp::add_imm_float:
+            // `mul_imm_float $ *= x, add_imm_float $ += y` becomes `mad_imm_float $ = $ * x + y`.
+            if (first->fOp == BuilderOp::mul_imm_float &&
+                first->fSlotA == second->fSlotA &&
+                first->fImmA == second->fImmA) {
+                second->fOp = BuilderOp::mad_imm_float;
+                second->fImmC = second->fImmB;
+                second->fImmB = first->fImmB;
+                first->fImmA = 0;
+                return true;
+            }
+            return false;
+
+        default:
+            return false;
+    }
 }
 
 void Program::optimize() {
-    // TODO(johnstiles): perform any last-minute cleanup of the instruction stream here
+    // Fuse common pairs of adjacent instructions into a single instruction. Labels are also
+    // instructions, so a branch can never land between a fused pair. Fused instructions never
+    // match a pattern again, so optimizing a deserialized program is harmless.
+    TArray<Instruction> fused;
+    fused.reserve_exact(fInstructions.size());
+    for (const Instruction& inst : fInstructions) {
+        fused.push_back(inst);
+        if (fused.size() >= 2) {
+            Instruction* first = &fused.fromBack(1);
+            Instruction* second = &fused.fromBack(0);
+            if (fuse_instructions(first, second) && first->fImmA == 0) {
+                *first = *second;
+                fused.pop_back();
+            }
+        }
+    }
+    fInstructions = std::move(fused);
 }
 
 static int stack_usage(const Instruction& inst) {
@@ -1320,6 +1512,12 @@ static int stack_usage(const Instruction& inst) {
         case ALL_MULTI_SLOT_TERNARY_OP_CASES:
             return 2 * -inst.fImmA;
 
+        case ALL_FROM_SLOTS_BINARY_OP_CASES:
+            return inst.fImmB ? inst.fImmA : 0;  // pushes its result if fused with a push_slots
+
+        case ALL_BY_SCALAR_BINARY_OP_CASES:
+            return -1;  // consumes the scalar
+
         case BuilderOp::swizzle_1:
             return 1 - inst.fImmA;  // consumes immA slots and emits a scalar
         case BuilderOp::swizzle_2:
@@ -1392,14 +1590,17 @@ Program::Program(TArray<Instruction> instrs,
                  int numUniformSlots,
                  int numImmutableSlots,
                  int numLabels,
-                 DebugTracePriv* debugTrace)
+                 DebugTracePriv* debugTrace,
+                 bool fuseOps)
         : fInstructions(std::move(instrs))
         , fNumValueSlots(numValueSlots)
         , fNumUniformSlots(numUniformSlots)
         , fNumImmutableSlots(numImmutableSlots)
         , fNumLabels(numLabels)
         , fDebugTrace(debugTrace) {
-    this->optimize();
+    if (fuseOps) {
+        this->optimize();
+    }
 
     fTempStackMaxDepths = this->tempStackMaxDepths();
 
@@ -1415,6 +1616,97 @@ Program::Program(TArray<Instruction> instrs,
 
 Program::~Program() = default;
 
+// The serialized format is a header, the instructions field by field, and a checksum of everything
+// before it. The op count in the header catches changes to the op lists that weren't accompanied
+// by a version bump.
+static constexpr uint32_t kSerializedMagic = SkSetFourByteTag('S', 'K', 'R', 'P');
+static constexpr int32_t kNumBuilderOps = (int)BuilderOp::unsupported;
+
+sk_sp<SkData> Program::serialize() const {
+    if (fDebugTrace) {
+        return nullptr;
+    }
+    SkDynamicMemoryWStream stream;
+    stream.write32(kSerializedMagic);
+    stream.write32(kSerializedVersion);
+    stream.write32(kNumBuilderOps);
+    stream.write32(fNumValueSlots);
+    stream.write32(fNumUniformSlots);
+    stream.write32(fNumImmutableSlots);
+    stream.write32(fNumLabels);
+    stream.write32(fInstructions.size());
+    for (const Instruction& inst : fInstructions) {
+        stream.write32((int32_t)inst.fOp);
+        stream.write32(inst.fSlotA);
+        stream.write32(inst.fSlotB);
+        stream.write32(inst.fImmA);
+        stream.write32(inst.fImmB);
+        stream.write32(inst.fImmC);
+        stream.write32(inst.fImmD);
+        stream.write32(inst.fStackID);
+        stream.write32(inst.fSourceOffset);
+    }
+    sk_sp<SkData> body = stream.detachAsData();
+    uint32_t checksum = SkChecksum::Hash32(body->data(), body->size());
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(body->size() + sizeof(checksum));
+    char* dst = static_cast<char*>(data->writable_data());
+    memcpy(dst, body->data(), body->size());
+    memcpy(dst + body->size(), &checksum, sizeof(checksum));
+    return data;
+}
+
+std::unique_ptr<Program> Program::Deserialize(const SkData& data) {
+    uint32_t checksum;
+    if (data.size() < sizeof(checksum)) {
+        return nullptr;
+    }
+    const size_t bodySize = data.size() - sizeof(checksum);
+    memcpy(&checksum, data.bytes() + bodySize, sizeof(checksum));
+    if (checksum != SkChecksum::Hash32(data.data(), bodySize)) {
+        return nullptr;
+    }
+
+    SkMemoryStream stream(data.data(), bodySize, /*copyData=*/false);
+    uint32_t magic, version;
+    int32_t numOps, numValueSlots, numUniformSlots, numImmutableSlots, numLabels, numInstructions;
+    if (!stream.readU32(&magic) || magic != kSerializedMagic ||
+        !stream.readU32(&version) || version != kSerializedVersion ||
+        !stream.readS32(&numOps) || numOps != kNumBuilderOps ||
+        !stream.readS32(&numValueSlots) || numValueSlots < 0 ||
+        !stream.readS32(&numUniformSlots) || numUniformSlots < 0 ||
+        !stream.readS32(&numImmutableSlots) || numImmutableSlots < 0 ||
+        !stream.readS32(&numLabels) || numLabels < 0 ||
+        !stream.readS32(&numInstructions) || numInstructions < 0 ||
+        (size_t)numInstructions * 9 * sizeof(int32_t) != stream.getLength() - stream.getPosition()) {
+        return nullptr;
+    }
+
+    TArray<Instruction> instrs;
+    instrs.reserve_exact(numInstructions);
+    for (int index = 0; index < numInstructions; ++index) {
+        int32_t op;
+        Instruction& inst = instrs.push_back();
+        if (!stream.readS32(&op) || op < 0 || op >= kNumBuilderOps ||
+            !stream.readS32(&inst.fSlotA) ||
+            !stream.readS32(&inst.fSlotB) ||
+            !stream.readS32(&inst.fImmA) ||
+            !stream.readS32(&inst.fImmB) ||
+            !stream.readS32(&inst.fImmC) ||
+            !stream.readS32(&inst.fImmD) ||
+            !stream.readS32(&inst.fStackID) || inst.fStackID < 0 ||
+            inst.fStackID > numInstructions ||
+            !stream.readS32(&inst.fSourceOffset)) {
+            return nullptr;
+        }
+        inst.fOp = (BuilderOp)op;
+    }
+
+    // The instructions were optimized before they were written; optimizing them again is harmless.
+    return std::make_unique<Program>(std::move(instrs), numValueSlots, numUniformSlots,
+                                     numImmutableSlots, numLabels, /*debugTrace=*/nullptr);
+}
+
 static bool immutable_data_is_splattable(int32_t* immutablePtr, int numSlots) {
     // If every value between `immutablePtr[0]` and `immutablePtr[numSlots]` is bit-identical, we
     // can use a splat.
@@ -1649,10 +1941,24 @@ Program::SlotData Program::allocateSlotData(SkArenaAlloc* alloc) const {
     return s;
 }
 
+#if !defined(SKSL_STANDALONE)
+static const char* program_op_name(ProgramOp op) {
+    switch (op) {
+        #define M(stage) case ProgramOp::stage: return #stage;
+        SKRP_EXTENDED_OPS(M)
+        #undef M
+
+        default:
+            return SkRasterPipeline::GetOpName((SkRasterPipelineOp)op);
+    }
+}
+#endif
+
 bool Program::appendStages(SkRasterPipeline* pipeline,
                            SkArenaAlloc* alloc,
                            RP::Callbacks* callbacks,
-                           SkSpan<const float> uniforms) const {
+                           SkSpan<const float> uniforms,
+                           ProfilePriv* profile) const {
 #if defined(SKSL_STANDALONE)
     return false;
 #else
@@ -1678,7 +1984,30 @@ bool Program::appendStages(SkRasterPipeline* pipeline,
 
     resetBasePointer();
 
+    // When profiling, register every stage (except labels, which don't run) with the profile, and
+    // report to the profile before each one runs.
+    int nextProfiledStage = 0;
+    auto appendProfileStage = [&](int stageIndex) {
+        auto* ctx = alloc->make<SkRasterPipeline_ProfileCtx>();
+        ctx->profileHook = profile;
+        ctx->stageIndex = stageIndex;
+        pipeline->append(SkRasterPipelineOp::profile_stage, ctx);
+    };
+    if (profile) {
+        TArray<ProfiledStage> profiledStages;
+        for (const Stage& stage : stages) {
+            if (stage.op != ProgramOp::label) {
+                profiledStages.push_back({program_op_name(stage.op), stage.sourceOffset});
+            }
+        }
+        nextProfiledStage = profile->addProgram(this, profiledStages);
+        appendProfileStage(ProfileHook::kBeginRun);
+    }
+
     for (const Stage& stage : stages) {
+        if (profile && stage.op != ProgramOp::label) {
+            appendProfileStage(nextProfiledStage++);
+        }
         switch (stage.op) {
             case ProgramOp::stack_rewind:
                 pipeline->appendStackRewind();
@@ -1757,6 +2086,10 @@ bool Program::appendStages(SkRasterPipeline* pipeline,
         }
     }
 
+    if (profile) {
+        appendProfileStage(ProfileHook::kEndRun);
+    }
+
     // Now that we have assembled the program and know the pipeline positions of each label and
     // branch, fix up every branch target.
     SkASSERT(branchContexts.size() == branchGoesToLabel.size());
@@ -1831,6 +2164,7 @@ void Program::makeStages(TArray<Stage>* pipeline,
             return ctx;
         };
         float*& tempStackPtr = tempStackMap[inst.fStackID];
+        int firstStageOfInstruction = pipeline->size();
 
         switch (inst.fOp) {
             case BuilderOp::label:
@@ -1939,6 +2273,40 @@ void Program::makeStages(TArray<Stage>* pipeline,
                                                       inst.fImmA);
                 break;
             }
+            case ALL_FROM_SLOTS_BINARY_OP_CASES: {
+                // The left-side is on the stack, unless it was folded into a value slot. When the
+                // op was fused with a push, the result is pushed onto the stack instead.
+                float* left = (inst.fSlotB == NA) ? tempStackPtr - (inst.fImmA * N)
+                                                  : SlotB();
+                float* dst = inst.fImmB ? tempStackPtr : left;
+                SkRasterPipeline_BinaryOpFromSlotsCtx ctx;
+                ctx.dst = OffsetFromBase(dst);
+                ctx.left = OffsetFromBase(left);
+                ctx.right = OffsetFromBase(SlotA());
+                pipeline->push_back({(ProgramOp)inst.fOp, SkRPCtxUtils::Pack(ctx, alloc)});
+                break;
+            }
+            case ALL_BY_SCALAR_BINARY_OP_CASES: {
+                float* src = tempStackPtr - (1 * N);
+                float* dst = src - (inst.fImmA * N);
+                SkRasterPipeline_BinaryOpCtx ctx;
+                ctx.dst = OffsetFromBase(dst);
+                ctx.src = OffsetFromBase(src);
+                pipeline->push_back({(ProgramOp)inst.fOp, SkRPCtxUtils::Pack(ctx, alloc)});
+                break;
+            }
+            case BuilderOp::mad_imm_float: {
+                float* dst = (inst.fSlotA == NA) ? tempStackPtr - (inst.fImmA * N)
+                                                 : SlotA();
+                SkRasterPipeline_MadConstantCtx ctx;
+                ctx.mulValue = inst.fImmB;
+                ctx.addValue = inst.fImmC;
+                for (int index = 0; index < inst.fImmA; ++index) {
+                    ctx.dst = OffsetFromBase(dst + (index * N));
+                    pipeline->push_back({ProgramOp::mad_imm_float, SkRPCtxUtils::Pack(ctx, alloc)});
+                }
+                break;
+            }
             case ALL_N_WAY_TERNARY_OP_CASES: {
                 float* src1 = tempStackPtr - (inst.fImmA * N);
                 float* src0 = tempStackPtr - (inst.fImmA * 2 * N);
@@ -2401,6 +2769,11 @@ void Program::makeStages(TArray<Stage>* pipeline,
                 break;
         }
 
+        // Attribute every stage generated by this instruction to its place in the source.
+        for (int index = firstStageOfInstruction; index < pipeline->size(); ++index) {
+            (*pipeline)[index].sourceOffset = inst.fSourceOffset;
+        }
+
         int stackUsage = stack_usage(inst);
         if (stackUsage != 0) {
             tempStackPtr += stackUsage * N;
@@ -2681,6 +3054,33 @@ public:
                 this->offsetCtx(ctx.src, numSlots)};
     }
 
+    // Interprets the context value as a BinaryOpFromSlots structure (numSlots is dictated by the op
+    // itself).
+    std::tuple<std::string, std::string, std::string> binaryOpFromSlotsCtx(const void* v,
+                                                                           int numSlots) const {
+        auto ctx = SkRPCtxUtils::Unpack((const SkRasterPipeline_BinaryOpFromSlotsCtx*)v);
+        return {this->offsetCtx(ctx.dst, numSlots),
+                this->offsetCtx(ctx.left, numSlots),
+                this->offsetCtx(ctx.right, numSlots)};
+    }
+
+    // Interprets the context value as a BinaryOp structure for an op which applies a scalar to
+    // every slot (numSlots is inferred from the distance between pointers).
+    std::tuple<std::string, std::string> byScalarCtx(const void* v) const {
+        auto ctx = SkRPCtxUtils::Unpack((const SkRasterPipeline_BinaryOpCtx*)v);
+        int numSlots = (ctx.src - ctx.dst) / (N * sizeof(float));
+        return {this->offsetCtx(ctx.dst, numSlots),
+                this->offsetCtx(ctx.src, 1)};
+    }
+
+    // Interprets the context value as a packed MadConstant structure.
+    std::tuple<std::string, std::string, std::string> madConstantCtx(const void* v) const {
+        auto ctx = SkRPCtxUtils::Unpack((const SkRasterPipeline_MadConstantCtx*)v);
+        return {this->offsetCtx(ctx.dst, 1),
+                this->imm(sk_bit_cast<float>(ctx.mulValue)),
+                this->imm(sk_bit_cast<float>(ctx.addValue))};
+    }
+
     // Interprets the context value as a BinaryOp structure for copy_n_uniforms (numSlots is
     // dictated by the op itself).
     std::tuple<std::string, std::string> copyUniformCtx(const void* v, int numSlots) const {
@@ -3124,6 +3524,35 @@ void Program::Dumper::dump(SkWStream* out, bool writeInstructionCount) {
                 std::tie(opArg1, opArg2) = this->binaryOpCtx(stage.ctx, 4);
                 break;
 
+            case POp::add_float_from_slot:    case POp::sub_float_from_slot:
+            case POp::mul_float_from_slot:    case POp::div_float_from_slot:
+                std::tie(opArg1, opArg2, opArg3) = this->binaryOpFromSlotsCtx(stage.ctx, 1);
+                break;
+
+            case POp::add_2_floats_from_slots: case POp::sub_2_floats_from_slots:
+            case POp::mul_2_floats_from_slots: case POp::div_2_floats_from_slots:
+                std::tie(opArg1, opArg2, opArg3) = this->binaryOpFromSlotsCtx(stage.ctx, 2);
+                break;
+
+            case POp::add_3_floats_from_slots: case POp::sub_3_floats_from_slots:
+            case POp::mul_3_floats_from_slots: case POp::div_3_floats_from_slots:
+                std::tie(opArg1, opArg2, opArg3) = this->binaryOpFromSlotsCtx(stage.ctx, 3);
+                break;
+
+            case POp::add_4_floats_from_slots: case POp::sub_4_floats_from_slots:
+            case POp::mul_4_floats_from_slots: case POp::div_4_floats_from_slots:
+                std::tie(opArg1, opArg2, opArg3) = this->binaryOpFromSlotsCtx(stage.ctx, 4);
+                break;
+
+            case POp::add_n_floats_by_scalar: case POp::sub_n_floats_by_scalar:
+            case POp::mul_n_floats_by_scalar: case POp::div_n_floats_by_scalar:
+                std::tie(opArg1, opArg2) = this->byScalarCtx(stage.ctx);
+                break;
+
+            case POp::mad_imm_float:
+                std::tie(opArg1, opArg2, opArg3) = this->madConstantCtx(stage.ctx);
+                break;
+
             case POp::copy_from_indirect_uniform_unmasked:
             case POp::copy_from_indirect_unmasked:
             case POp::copy_to_indirect_masked: {
@@ -3636,6 +4065,42 @@ void Program::Dumper::dump(SkWStream* out, bool writeInstructionCount) {
                 opText = opArg1 + " /= " + opArg2;
                 break;
 
+            case POp::add_float_from_slot:    case POp::add_2_floats_from_slots:
+            case POp::add_3_floats_from_slots: case POp::add_4_floats_from_slots:
+            case POp::add_n_floats_by_scalar:
+                opText = (opArg3.empty() || opArg1 == opArg2)
+                                 ? opArg1 + " += " + (opArg3.empty() ? opArg2 : opArg3)
+                                 : opArg1 + " = " + opArg2 + " + " + opArg3;
+                break;
+
+            case POp::sub_float_from_slot:    case POp::sub_2_floats_from_slots:
+            case POp::sub_3_floats_from_slots: case POp::sub_4_floats_from_slots:
+            case POp::sub_n_floats_by_scalar:
+                opText = (opArg3.empty() || opArg1 == opArg2)
+                                 ? opArg1 + " -= " + (opArg3.empty() ? opArg2 : opArg3)
+                                 : opArg1 + " = " + opArg2 + " - " + opArg3;
+                break;
+
+            case POp::mul_float_from_slot:    case POp::mul_2_floats_from_slots:
+            case POp::mul_3_floats_from_slots: case POp::mul_4_floats_from_slots:
+            case POp::mul_n_floats_by_scalar:
+                opText = (opArg3.empty() || opArg1 == opArg2)
+                                 ? opArg1 + " *= " + (opArg3.empty() ? opArg2 : opArg3)
+                                 : opArg1 + " = " + opArg2 + " * " + opArg3;
+                break;
+
+            case POp::div_float_from_slot:    case POp::div_2_floats_from_slots:
+            case POp::div_3_floats_from_slots: case POp::div_4_floats_from_slots:
+            case POp::div_n_floats_by_scalar:
+                opText = (opArg3.empty() || opArg1 == opArg2)
+                                 ? opArg1 + " /= " + (opArg3.empty() ? opArg2 : opArg3)
+                                 : opArg1 + " = " + opArg2 + " / " + opArg3;
+                break;
+
+            case POp::mad_imm_float:
+                opText = opArg1 + " = " + opArg1 + " * " + opArg2 + " + " + opArg3;
+                break;
+
             case POp::matrix_multiply_2:
             case POp::matrix_multiply_3:
             case POp::matrix_multiply_4:
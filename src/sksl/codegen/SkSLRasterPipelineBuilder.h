@@ -10,6 +10,7 @@
 
 #include "include/core/SkTypes.h"
 
+#include "include/core/SkRefCnt.h"
 #include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTArray.h"
@@ -21,6 +22,7 @@
 #include <memory>
 
 class SkArenaAlloc;
+class SkData;
 class SkRasterPipeline;
 class SkWStream;
 using SkRPOffset = uint32_t;
@@ -28,6 +30,7 @@ using SkRPOffset = uint32_t;
 namespace SkSL {
 
 class DebugTracePriv;
+class ProfilePriv;
 class TraceHook;
 
 namespace RP {
@@ -135,6 +138,7 @@ struct Instruction {
     int       fImmC = 0;
     int       fImmD = 0;
     int       fStackID = 0;
+    int       fSourceOffset = -1;  // where the statement which generated this is in the SkSL source
 };
 
 class Callbacks {
@@ -156,16 +160,38 @@ public:
             int numUniformSlots,
             int numImmutableSlots,
             int numLabels,
-            DebugTracePriv* debugTrace);
+            DebugTracePriv* debugTrace,
+            bool fuseOps = true);
     ~Program();
 
+    /**
+     * Appends the program to a raster pipeline. If a profile is passed, every stage is preceded by
+     * a `profile_stage` op which reports to it, so that the profile can attribute time to stages.
+     */
     bool appendStages(SkRasterPipeline* pipeline,
                       SkArenaAlloc* alloc,
                       Callbacks* callbacks,
-                      SkSpan<const float> uniforms) const;
+                      SkSpan<const float> uniforms,
+                      ProfilePriv* profile = nullptr) const;
 
     void dump(SkWStream* out, bool writeInstructionCount = false) const;
 
+    /**
+     * Writes the finished program as a versioned binary blob, so that it can be cached across
+     * processes. Returns null for programs with a debug trace, which can't be serialized.
+     */
+    sk_sp<SkData> serialize() const;
+
+    /**
+     * Recreates a program written by `serialize` without involving the SkSL compiler. Returns null
+     * if the data is corrupt or was written by a different version of the RP code generator. The
+     * instructions aren't otherwise validated, so the data must come from a trusted source.
+     */
+    static std::unique_ptr<Program> Deserialize(const SkData& data);
+
+    // Must be bumped whenever the serialized layout, or the meaning of an instruction, changes.
+    static constexpr uint32_t kSerializedVersion = 5;
+
     int numUniforms() const { return fNumUniformSlots; }
 
 private:
@@ -181,6 +207,7 @@ private:
     struct Stage {
         ProgramOp op;
         void*     ctx;
+        int       sourceOffset = -1;
     };
     void makeStages(skia_private::TArray<Stage>* pipeline,
                     SkArenaAlloc* alloc,
@@ -293,11 +320,12 @@ private:
 
 class Builder {
 public:
-    /** Finalizes and optimizes the program. */
+    /** Finalizes and optimizes the program. If `fuseOps` is false, adjacent ops aren't fused. */
     std::unique_ptr<Program> finish(int numValueSlots,
                                     int numUniformSlots,
                                     int numImmutableSlots,
-                                    DebugTracePriv* debugTrace = nullptr);
+                                    DebugTracePriv* debugTrace = nullptr,
+                                    bool fuseOps = true);
     /**
      * Peels off a label ID for use in the program. Set the label's position in the program with
      * the `label` instruction. Actually branch to the target with an instruction like
@@ -364,6 +392,16 @@ public:
         fCurrentStackID = stackID;
     }
 
+    // Sets the offset in the SkSL source that subsequent instructions are attributed to, so that
+    // profiles can map them back to a line.
+    void set_current_source_offset(int offset) {
+        fCurrentSourceOffset = offset;
+    }
+
+    int current_source_offset() const {
+        return fCurrentSourceOffset;
+    }
+
     // Inserts a label into the instruction stream.
     void label(int labelID);
 
@@ -742,11 +780,13 @@ private:
     Instruction* lastInstructionOnAnyStack(int fromBack = 0);
     void simplifyPopSlotsUnmasked(SlotRange* dst);
     bool simplifyImmediateUnmaskedOp();
+    bool simplifyFromSlotsUnmaskedOp();
 
     skia_private::TArray<Instruction> fInstructions;
     int fNumLabels = 0;
     int fExecutionMaskWritesEnabled = 0;
     int fCurrentStackID = 0;
+    int fCurrentSourceOffset = -1;
 };
 
 }  // namespace RP
@@ -24,6 +24,7 @@
 #include "src/sksl/SkSLIntrinsicList.h"
 #include "src/sksl/SkSLOperator.h"
 #include "src/sksl/SkSLPosition.h"
+#include "src/sksl/SkSLProgramSettings.h"
 #include "src/sksl/analysis/SkSLProgramUsage.h"
 #include "src/sksl/codegen/SkSLRasterPipelineBuilder.h"
 #include "src/sksl/ir/SkSLBinaryExpression.h"
@@ -380,7 +381,8 @@ public:
 
     /**
      * Emits a trace_line opcode. writeStatement does this, and statements that alter control flow
-     * may need to explicitly add additional traces.
+     * may need to explicitly add additional traces. The statement's position is also recorded on
+     * subsequent instructions, even when trace ops are not being written.
      */
     void emitTraceLine(Position pos);
 
@@ -1379,6 +1381,9 @@ std::optional<SlotRange> Generator::writeFunction(
         const IRNode& callSite,
         const FunctionDefinition& function,
         SkSpan<std::unique_ptr<Expression> const> arguments) {
+    // The function body is attributed to its own statements; remember the caller's for later.
+    int callerSourceOffset = fBuilder.current_source_offset();
+
     // Generate debug information and emit a trace-enter op.
     int funcIndex = -1;
     if (fDebugTrace) {
@@ -1503,6 +1508,7 @@ std::optional<SlotRange> Generator::writeFunction(
     if (fDebugTrace && fWriteTraceOps) {
         fBuilder.trace_exit(fTraceMask->stackID(), funcIndex);
     }
+    fBuilder.set_current_source_offset(callerSourceOffset);
 
     // Copy out-parameters and inout-parameters back to their homes.
     for (int index = 0; index < lvalues.size(); ++index) {
@@ -1533,16 +1539,21 @@ std::optional<SlotRange> Generator::writeFunction(
 }
 
 void Generator::emitTraceLine(Position pos) {
-    if (fDebugTrace && fWriteTraceOps && pos.valid() && fInsideCompoundStatement == 0) {
-        // Binary search within fLineOffets to convert the position into a line number.
-        SkASSERT(fLineOffsets.size() >= 2);
-        SkASSERT(fLineOffsets[0] == 0);
-        SkASSERT(fLineOffsets.back() == (int)fProgram.fSource->length());
-        int lineNumber = std::distance(
-                fLineOffsets.begin(),
-                std::upper_bound(fLineOffsets.begin(), fLineOffsets.end(), pos.startOffset()));
+    if (pos.valid() && fInsideCompoundStatement == 0) {
+        // Attribute the instructions for this statement to its position. Profiles convert it into
+        // a line when they are attached.
+        fBuilder.set_current_source_offset(pos.startOffset());
 
-        fBuilder.trace_line(fTraceMask->stackID(), lineNumber);
+        if (fDebugTrace && fWriteTraceOps) {
+            // Binary search within fLineOffets to convert the position into a line number.
+            SkASSERT(fLineOffsets.size() >= 2);
+            SkASSERT(fLineOffsets[0] == 0);
+            SkASSERT(fLineOffsets.back() == (int)fProgram.fSource->length());
+            int lineNumber = std::distance(
+                    fLineOffsets.begin(),
+                    std::upper_bound(fLineOffsets.begin(), fLineOffsets.end(), pos.startOffset()));
+            fBuilder.trace_line(fTraceMask->stackID(), lineNumber);
+        }
     }
 }
 
@@ -4062,7 +4073,8 @@ std::unique_ptr<RP::Program> Generator::finish() {
     return fBuilder.finish(fProgramSlots.slotCount(),
                            fUniformSlots.slotCount(),
                            fImmutableSlots.slotCount(),
-                           fDebugTrace);
+                           fDebugTrace,
+                           fProgram.fConfig->fSettings.fFuseRasterPipelineOps);
 }
 
 }  // namespace RP
@@ -165,6 +165,10 @@ bool Layout::checkPermittedLayout(const Context& context,
         permittedLayoutFlags &= ~LayoutFlag::kSet;
     }
 
+    // Nearly every layout we see is legal; only walk the flag names when we need an error.
+    if (!(layoutFlags & ~permittedLayoutFlags)) {
+        return success;
+    }
     for (const auto& lf : kLayoutFlags) {
         if (layoutFlags & lf.flag) {
             if (!(permittedLayoutFlags & lf.flag)) {
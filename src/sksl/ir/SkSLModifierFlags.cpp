@@ -118,6 +118,11 @@ bool ModifierFlags::checkPermittedFlags(const Context& context,
         { ModifierFlag::kPixelLocal,     "pixel_local" },
     };
 
+    // Nearly every declaration we see is legal; only walk the flag names when we need an error.
+    if (!(*this & ~permittedModifierFlags)) {
+        return true;
+    }
+
     bool success = true;
     ModifierFlags modifierFlags = *this;
     for (const auto& f : kModifierFlags) {
@@ -23,16 +23,16 @@ std::unique_ptr<SymbolTable> SymbolTable::insertNewParent() {
     return newTable;
 }
 
-bool SymbolTable::isType(std::string_view name) const {
-    const Symbol* symbol = this->find(name);
+bool SymbolTable::isType(const SymbolKey& key) const {
+    const Symbol* symbol = this->find(key);
     return symbol && symbol->is<Type>();
 }
 
-bool SymbolTable::isBuiltinType(std::string_view name) const {
+bool SymbolTable::isBuiltinType(const SymbolKey& key) const {
     if (!this->isBuiltin()) {
-        return fParent && fParent->isBuiltinType(name);
+        return fParent && fParent->isBuiltinType(key);
     }
-    return this->isType(name);
+    return this->isType(key);
 }
 
 const Symbol* SymbolTable::findBuiltinSymbol(std::string_view name) const {
@@ -194,10 +194,16 @@ const Type* SymbolTable::addArrayDimension(const Context& context,
 std::unique_ptr<Expression> SymbolTable::instantiateSymbolRef(const Context& context,
                                                               std::string_view name,
                                                               Position pos) {
-    if (const Symbol* symbol = this->find(name)) {
+    return this->instantiateSymbolRef(context, MakeSymbolKey(name), pos);
+}
+
+std::unique_ptr<Expression> SymbolTable::instantiateSymbolRef(const Context& context,
+                                                              const SymbolKey& key,
+                                                              Position pos) {
+    if (const Symbol* symbol = this->find(key)) {
         return symbol->instantiate(context, pos);
     }
-    context.fErrors->error(pos, "unknown identifier '" + std::string(name) + "'");
+    context.fErrors->error(pos, "unknown identifier '" + std::string(key.fName) + "'");
     return nullptr;
 }
 
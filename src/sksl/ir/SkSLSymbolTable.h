@@ -48,6 +48,25 @@ public:
      */
     std::unique_ptr<SymbolTable> insertNewParent();
 
+    /**
+     * A name paired with its hash. Making a key once and reusing it avoids rehashing a name that is
+     * looked up repeatedly, such as an identifier token which the parser checks several times.
+     */
+    struct SymbolKey {
+        std::string_view fName;
+        uint32_t         fHash;
+
+        bool operator==(const SymbolKey& that) const { return fName == that.fName; }
+        bool operator!=(const SymbolKey& that) const { return fName != that.fName; }
+        struct Hash {
+            uint32_t operator()(const SymbolKey& key) const { return key.fHash; }
+        };
+    };
+
+    static SymbolKey MakeSymbolKey(std::string_view name) {
+        return SymbolKey{name, SkChecksum::Hash32(name.data(), name.size())};
+    }
+
     /**
      * Looks up the requested symbol and returns a const pointer.
      */
@@ -55,6 +74,10 @@ public:
         return this->lookup(MakeSymbolKey(name));
     }
 
+    const Symbol* find(const SymbolKey& key) const {
+        return this->lookup(key);
+    }
+
     /**
      * Looks up the requested symbol, only searching the built-in symbol tables. Always const.
      */
@@ -76,6 +99,10 @@ public:
                                                      std::string_view name,
                                                      Position pos);
 
+    std::unique_ptr<Expression> instantiateSymbolRef(const Context& context,
+                                                     const SymbolKey& key,
+                                                     Position pos);
+
     /**
      * Assigns a new name to the passed-in symbol. The old name will continue to exist in the symbol
      * table and point to the symbol.
@@ -99,12 +126,20 @@ public:
     /**
      * Returns true if the name refers to a type (user or built-in) in the current symbol table.
      */
-    bool isType(std::string_view name) const;
+    bool isType(std::string_view name) const {
+        return this->isType(MakeSymbolKey(name));
+    }
+
+    bool isType(const SymbolKey& key) const;
 
     /**
      * Returns true if the name refers to a builtin type.
      */
-    bool isBuiltinType(std::string_view name) const;
+    bool isBuiltinType(std::string_view name) const {
+        return this->isBuiltinType(MakeSymbolKey(name));
+    }
+
+    bool isBuiltinType(const SymbolKey& key) const;
 
     /**
      * Adds a symbol to this symbol table, without conferring ownership. The caller is responsible
@@ -203,21 +238,6 @@ public:
     std::vector<std::unique_ptr<Symbol>> fOwnedSymbols;
 
 private:
-    struct SymbolKey {
-        std::string_view fName;
-        uint32_t         fHash;
-
-        bool operator==(const SymbolKey& that) const { return fName == that.fName; }
-        bool operator!=(const SymbolKey& that) const { return fName != that.fName; }
-        struct Hash {
-            uint32_t operator()(const SymbolKey& key) const { return key.fHash; }
-        };
-    };
-
-    static SymbolKey MakeSymbolKey(std::string_view name) {
-        return SymbolKey{name, SkChecksum::Hash32(name.data(), name.size())};
-    }
-
     Symbol* lookup(const SymbolKey& key) const;
     bool addWithoutOwnership(Symbol* symbol);
 
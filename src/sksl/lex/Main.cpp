@@ -16,6 +16,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -38,6 +40,13 @@ static constexpr const char HEADER[] =
     " ******************** This file was generated by sksllex. Do not edit. *******************\n"
     " *****************************************************************************************/\n";
 
+// Arbitrarily-chosen character which is greater than startChar, and should not appear in actual
+// input. Characters outside of the mapped range are treated as this character.
+static constexpr uint8_t kInvalidChar = 18;
+
+// The smallest run of characters that a state must loop on for the lexer to get a fast path for it.
+static constexpr int kMinLoopChars = 4;
+
 static void writeH(const DFA& dfa, const char* lexer, const char* token,
                    const std::vector<std::string>& tokens, const char* hPath) {
     std::ofstream out(hPath);
@@ -125,10 +134,8 @@ static void writeCPP(const DFA& dfa, const char* lexer, const char* token, const
         }
     }
 
-    // Arbitrarily-chosen character which is greater than startChar, and should not appear in actual
-    // input.
-    SkASSERT(startChar < 18);
-    out << "static constexpr uint8_t kInvalidChar = 18;";
+    SkASSERT(startChar < kInvalidChar);
+    out << "static constexpr uint8_t kInvalidChar = " << (int)kInvalidChar << ";";
     out << "static constexpr uint8_t kMappings[" << dfa.fCharMappings.size() - startChar << "] = {";
     for (size_t index = startChar; index < dfa.fCharMappings.size(); ++index) {
         out << std::to_string(dfa.fCharMappings[index]) << ", ";
@@ -137,6 +144,45 @@ static void writeCPP(const DFA& dfa, const char* lexer, const char* token, const
 
     WriteTransitionTable(out, dfa, states);
 
+    // Find the states which loop back to themselves on a run of characters, such as the body of an
+    // identifier or a stretch of whitespace. The lexer can skip over such a run with a bitmask test
+    // per character, instead of walking the transition table.
+    std::vector<int> loopIndices(states, -1);
+    std::vector<std::array<uint64_t, 2>> loopChars;
+    for (size_t state = 1; state < states; ++state) {
+        std::array<uint64_t, 2> chars = {};
+        int numChars = 0;
+        for (int ch = 0; ch < 128; ++ch) {
+            size_t c = (uint8_t)(ch - startChar);
+            if (c >= dfa.fCharMappings.size() - startChar) {
+                c = kInvalidChar;
+            }
+            size_t transition = dfa.fCharMappings[c + startChar];
+            if (transition < dfa.fTransitions.size() &&
+                state < dfa.fTransitions[transition].size() &&
+                dfa.fTransitions[transition][state] == (int)state) {
+                chars[ch >> 6] |= (uint64_t)1 << (ch & 63);
+                ++numChars;
+            }
+        }
+        if (numChars >= kMinLoopChars) {
+            loopIndices[state] = loopChars.size();
+            loopChars.push_back(chars);
+        }
+    }
+    SkASSERT(loopChars.size() <= 127);
+    out << "static constexpr int8_t kLoopIndices[" << states << "] = {";
+    for (int index : loopIndices) {
+        out << " " << index << ",";
+    }
+    out << "};\n";
+    out << "static constexpr uint64_t kLoopChars[" << std::max<size_t>(loopChars.size(), 1)
+        << "][2] = {";
+    for (const std::array<uint64_t, 2>& chars : loopChars) {
+        out << " {0x" << std::hex << chars[0] << "ull, 0x" << chars[1] << "ull}," << std::dec;
+    }
+    out << "};\n";
+
     out << "static const uint8_t kAccepts[" << states << "] = {";
     for (size_t i = 0; i < states; ++i) {
         if (i < dfa.fAccepts.size() && dfa.fAccepts[i] != INVALID) {
@@ -174,6 +220,18 @@ static void writeCPP(const DFA& dfa, const char* lexer, const char* token, const
         }
         state = newState;
         ++fOffset;
+
+        // Skip ahead over any characters which would leave us in the same state.
+        if (int loop = kLoopIndices[state]; loop >= 0) {
+            const uint64_t* chars = kLoopChars[loop];
+            while (fOffset < (int32_t)fText.length()) {
+                uint8_t ch = (uint8_t)fText[fOffset];
+                if (ch >= 128 || !((chars[ch >> 6] >> (ch & 63)) & 1)) {
+                    break;
+                }
+                ++fOffset;
+            }
+        }
     }
     Token::Kind kind = ()" << token << R"(::Kind) kAccepts[state];
     return )" << token << R"((kind, startOffset, fOffset - startOffset);
@@ -0,0 +1,318 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/sksl/tracing/SkSLProfilePriv.h"
+
+#include "include/core/SkStream.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkTime.h"
+#include "src/utils/SkJSONWriter.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#if defined(SK_CPU_X86)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+#endif
+
+static constexpr char kProfileVersion[] = "20241017";
+
+namespace SkSL {
+
+#if defined(SK_CPU_X86)
+static uint64_t read_ticks() {
+    return __rdtsc();
+}
+static constexpr bool kTicksAreNanos = false;
+#else
+static uint64_t read_ticks() {
+    return (uint64_t)SkTime::GetNSecs();
+}
+static constexpr bool kTicksAreNanos = true;
+#endif
+
+ProfilePriv::ProfilePriv(int sampleInterval) : fSampleInterval(std::max(sampleInterval, 1)) {
+    // Measure the cost of reading the timer, so that it can be left out of each stage's time.
+    fTimerOverhead = UINT64_MAX;
+    for (int index = 0; index < 16; ++index) {
+        uint64_t start = read_ticks();
+        fTimerOverhead = std::min(fTimerOverhead, read_ticks() - start);
+    }
+
+    // Work out how long a tick is by comparing it against the wall clock for a fraction of a
+    // millisecond.
+    fNanosPerTick = 1.0;
+    if (!kTicksAreNanos) {
+        double startNanos = SkTime::GetNSecs();
+        uint64_t startTicks = read_ticks();
+        double elapsedNanos;
+        do {
+            elapsedNanos = SkTime::GetNSecs() - startNanos;
+        } while (elapsedNanos < 200'000);
+        uint64_t elapsedTicks = read_ticks() - startTicks;
+        if (elapsedTicks > 0) {
+            fNanosPerTick = elapsedNanos / elapsedTicks;
+        }
+    }
+}
+
+void ProfilePriv::setSource(const std::string& source) {
+    fSource.clear();
+    std::stringstream stream{source};
+    while (stream.good()) {
+        fSource.push_back({});
+        std::getline(stream, fSource.back(), '\n');
+    }
+
+    // Programs only record where each stage's statement starts in the source, so that they don't
+    // pay for a line table unless they are profiled. Build the table here, the same way that the
+    // debug tracer does: the position of each newline, with a zero in front and the length last.
+    fLineOffsets.clear();
+    fLineOffsets.push_back(0);
+    for (size_t i = 0; i < source.length(); ++i) {
+        if (source[i] == '\n') {
+            fLineOffsets.push_back(i);
+        }
+    }
+    fLineOffsets.push_back(source.length());
+}
+
+int ProfilePriv::lineForSourceOffset(int sourceOffset) const {
+    if (sourceOffset < 0 || fLineOffsets.empty()) {
+        return 0;
+    }
+    return std::distance(fLineOffsets.begin(),
+                         std::upper_bound(fLineOffsets.begin(), fLineOffsets.end(), sourceOffset));
+}
+
+int ProfilePriv::addProgram(const void* programID, SkSpan<const ProfiledStage> stages) {
+    if (const ProgramStages* existing = fPrograms.find(programID)) {
+        if (existing->numStages == SkToInt(stages.size())) {
+            return existing->firstStage;
+        }
+    }
+    int firstStage = fStages.size();
+    for (const ProfiledStage& stage : stages) {
+        fStages.push_back({stage.op, this->lineForSourceOffset(stage.sourceOffset)});
+    }
+    fPrograms.set(programID, {firstStage, SkToInt(stages.size())});
+    return firstStage;
+}
+
+void ProfilePriv::stage(int stageIndex) {
+    if (stageIndex == kBeginRun) {
+        fSampling = (fRuns++ % fSampleInterval) == 0;
+        fSampledRuns += fSampling ? 1 : 0;
+        fCurrentStage = -1;
+        return;
+    }
+
+    // Charge the time since the previous profile_stage op to the stage which was running.
+    if (fSampling) {
+        uint64_t now = read_ticks();
+        if (fCurrentStage >= 0) {
+            uint64_t elapsed = now - fStageStartTicks;
+            fStages[fCurrentStage].sampledTicks += (elapsed > fTimerOverhead)
+                                                           ? elapsed - fTimerOverhead
+                                                           : 0;
+        }
+        fStageStartTicks = now;
+    }
+
+    if (stageIndex == kEndRun) {
+        fCurrentStage = -1;
+        return;
+    }
+    SkASSERT(stageIndex >= 0 && stageIndex < SkToInt(fStages.size()));
+    fStages[stageIndex].invocations++;
+    fCurrentStage = stageIndex;
+}
+
+double ProfilePriv::estimatedNanos(uint64_t ticks) const {
+    if (fSampledRuns == 0) {
+        return 0.0;
+    }
+    return ticks * fNanosPerTick * ((double)fRuns / fSampledRuns);
+}
+
+namespace {
+
+struct LineProfileInfo {
+    int line;
+    uint64_t invocations = 0;
+    uint64_t sampledTicks = 0;
+};
+
+}  // namespace
+
+// Totals the stages of each source line, in line order.
+static std::vector<LineProfileInfo> profile_lines(const std::vector<StageProfileInfo>& stages) {
+    std::map<int, LineProfileInfo> lines;
+    for (const StageProfileInfo& stage : stages) {
+        LineProfileInfo& info = lines.try_emplace(stage.line, LineProfileInfo{stage.line})
+                                     .first->second;
+        info.invocations = std::max(info.invocations, stage.invocations);
+        info.sampledTicks += stage.sampledTicks;
+    }
+    std::vector<LineProfileInfo> result;
+    for (const auto& [line, info] : lines) {
+        result.push_back(info);
+    }
+    return result;
+}
+
+static std::string line_text(const std::vector<std::string>& source, int line) {
+    if (line <= 0 || line > (int)source.size()) {
+        return "(unknown line)";
+    }
+    std::string_view text = source[line - 1];
+    size_t firstChar = text.find_first_not_of(" \t");
+    text.remove_prefix(std::min(firstChar, text.size()));
+    return "line " + std::to_string(line) + ": " + std::string(text);
+}
+
+void ProfilePriv::writeJSON(SkWStream* w) const {
+    SkJSONWriter json(w);
+
+    json.beginObject(); // root
+    json.appendNString("version", kProfileVersion);
+    json.appendS32("sampleInterval", fSampleInterval);
+    json.appendU64("runs", fRuns);
+    json.appendU64("sampledRuns", fSampledRuns);
+    json.appendDouble("nanosPerTick", fNanosPerTick);
+    json.beginArray("source");
+
+    for (const std::string& line : fSource) {
+        json.appendString(line);
+    }
+
+    json.endArray(); // source
+    json.beginArray("stages");
+
+    for (const StageProfileInfo& stage : fStages) {
+        json.beginObject();
+        json.appendCString("op", stage.op);
+        json.appendS32("line", stage.line);
+        json.appendU64("invocations", stage.invocations);
+        json.appendU64("ticks", stage.sampledTicks);
+        json.endObject();
+    }
+
+    json.endArray(); // stages
+    json.endObject(); // root
+    json.flush();
+}
+
+void ProfilePriv::writePerfettoTrace(SkWStream* w) const {
+    // The profile holds totals rather than a timeline, so each line is laid out as a single slice
+    // whose duration is the line's estimated total time. Its stages are nested slices inside it.
+    SkJSONWriter json(w);
+
+    json.beginObject(); // root
+    json.appendNString("displayTimeUnit", "ns");
+    json.beginArray("traceEvents");
+
+    auto writeSlice = [&](const std::string& name, double startMicros, double durationMicros,
+                          uint64_t invocations) {
+        json.beginObject();
+        json.appendString("name", name);
+        json.appendNString("cat", "sksl");
+        json.appendNString("ph", "X");
+        json.appendS32("pid", 1);
+        json.appendS32("tid", 1);
+        json.appendDouble("ts", startMicros);
+        json.appendDouble("dur", durationMicros);
+        json.beginObject("args");
+        json.appendU64("invocations", invocations);
+        json.endObject();
+        json.endObject();
+    };
+
+    double lineStart = 0.0;
+    for (const LineProfileInfo& line : profile_lines(fStages)) {
+        double lineDuration = this->estimatedNanos(line.sampledTicks) * 1e-3;
+        writeSlice(line_text(fSource, line.line), lineStart, lineDuration, line.invocations);
+
+        double stageStart = lineStart;
+        for (const StageProfileInfo& stage : fStages) {
+            if (stage.line == line.line && stage.invocations > 0) {
+                double stageDuration = this->estimatedNanos(stage.sampledTicks) * 1e-3;
+                writeSlice(stage.op, stageStart, stageDuration, stage.invocations);
+                stageStart += stageDuration;
+            }
+        }
+        lineStart += lineDuration;
+    }
+
+    json.endArray(); // traceEvents
+    json.endObject(); // root
+    json.flush();
+}
+
+void ProfilePriv::dump(SkWStream* o) const {
+    uint64_t totalTicks = 0;
+    for (const StageProfileInfo& stage : fStages) {
+        totalTicks += stage.sampledTicks;
+    }
+
+    o->writeBigDecAsText(fRuns);
+    o->writeText(" runs, ");
+    o->writeBigDecAsText(fSampledRuns);
+    o->writeText(" timed; estimated total ");
+    o->writeScalarAsText(this->estimatedNanos(totalTicks) * 1e-6);
+    o->writeText(" ms\n");
+
+    auto writePercent = [&](uint64_t ticks) {
+        std::string percent = std::to_string(totalTicks ? 100.0 * ticks / totalTicks : 0.0);
+        percent.resize(percent.find('.') + 2);
+        o->writeText(std::string(7 - std::min<size_t>(percent.size(), 7), ' ').c_str());
+        o->writeText(percent.c_str());
+        o->writeText("%  ");
+    };
+
+    // List the lines, hottest first.
+    std::vector<LineProfileInfo> lines = profile_lines(fStages);
+    std::stable_sort(lines.begin(), lines.end(), [](const auto& a, const auto& b) {
+        return a.sampledTicks > b.sampledTicks;
+    });
+    o->writeText("\nHottest lines:\n");
+    for (const LineProfileInfo& line : lines) {
+        writePercent(line.sampledTicks);
+        o->writeText(line_text(fSource, line.line).c_str());
+        o->newline();
+    }
+
+    // List the individual stages, hottest first.
+    std::vector<const StageProfileInfo*> stages;
+    for (const StageProfileInfo& stage : fStages) {
+        stages.push_back(&stage);
+    }
+    std::stable_sort(stages.begin(), stages.end(), [](const auto* a, const auto* b) {
+        return a->sampledTicks > b->sampledTicks;
+    });
+    o->writeText("\nHottest stages:\n");
+    for (const StageProfileInfo* stage : stages) {
+        writePercent(stage->sampledTicks);
+        o->writeText(stage->op);
+        o->writeText(" (line ");
+        o->writeDecAsText(stage->line);
+        o->writeText(", ");
+        o->writeBigDecAsText(stage->invocations);
+        o->writeText(" calls)\n");
+    }
+}
+
+}  // namespace SkSL
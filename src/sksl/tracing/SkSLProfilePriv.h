@@ -0,0 +1,108 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSLPROFILEPRIV
+#define SKSLPROFILEPRIV
+
+#include "include/core/SkSpan.h"
+#include "include/sksl/SkSLProfile.h"
+#include "src/core/SkTHash.h"
+#include "src/sksl/tracing/SkSLTraceHook.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class SkWStream;
+
+namespace SkSL {
+
+/** Describes one stage of an instrumented raster pipeline program. */
+struct ProfiledStage {
+    /** The name of the stage's op. This must be a string literal (or otherwise outlive the profile). */
+    const char* op;
+    /** Where the statement which generated this stage starts in the SkSL source, or -1. */
+    int sourceOffset;
+};
+
+struct StageProfileInfo {
+    const char* op;
+    int line;
+    /** How many times the stage ran. Every run is counted. */
+    uint64_t invocations = 0;
+    /** Time spent inside the stage, in ticks, measured on sampled runs only. */
+    uint64_t sampledTicks = 0;
+};
+
+/**
+ * Collects per-stage invocation counts and timings from raster pipeline programs that were
+ * appended with a profile. A profile is not thread-safe; draw with it from one thread at a time.
+ */
+class ProfilePriv : public Profile, public ProfileHook {
+public:
+    /**
+     * Times one out of every `sampleInterval` runs of a program. Ticks are CPU cycles where a
+     * cycle counter is available, and nanoseconds otherwise.
+     */
+    explicit ProfilePriv(int sampleInterval = 1);
+
+    /**
+     * Attaches the SkSL source, so that stages can be mapped to lines and shown alongside them.
+     * This must be called before programs are added.
+     */
+    void setSource(const std::string& source);
+
+    /**
+     * Registers the stages of a program and returns the index of its first stage. Appending the
+     * same program again (e.g. on each draw) reuses the stages it registered the first time.
+     */
+    int addProgram(const void* programID, SkSpan<const ProfiledStage> stages);
+
+    /** Called by the `profile_stage` op before each stage runs. */
+    void stage(int stageIndex) override;
+
+    void writeJSON(SkWStream* w) const override;
+    void writePerfettoTrace(SkWStream* w) const override;
+    void dump(SkWStream* o) const override;
+
+    /** The estimated time represented by `ticks` sampled ticks, across all runs. */
+    double estimatedNanos(uint64_t ticks) const;
+
+    std::vector<StageProfileInfo> fStages;
+
+    /** The SkSL code, split line-by-line. */
+    std::vector<std::string> fSource;
+
+    /** The number of program runs, and how many of those were timed. */
+    uint64_t fRuns = 0;
+    uint64_t fSampledRuns = 0;
+
+private:
+    struct ProgramStages {
+        int firstStage;
+        int numStages;
+    };
+    skia_private::THashMap<const void*, ProgramStages> fPrograms;
+
+    /** Returns the line containing `sourceOffset`, or zero if it isn't known. */
+    int lineForSourceOffset(int sourceOffset) const;
+
+    /** The position of each newline in the source, plus a zero at the start and the length. */
+    std::vector<int> fLineOffsets;
+
+    int fSampleInterval;
+    double fNanosPerTick;
+    uint64_t fTimerOverhead;
+
+    bool fSampling = false;
+    int fCurrentStage = -1;
+    uint64_t fStageStartTicks = 0;
+};
+
+}  // namespace SkSL
+
+#endif
@@ -26,6 +26,16 @@ public:
     virtual void scope(int delta) = 0;
 };
 
+class ProfileHook {
+public:
+    // Passed in place of a stage index to mark the start and end of a program's execution.
+    static constexpr int kBeginRun = -1;
+    static constexpr int kEndRun = -2;
+
+    virtual ~ProfileHook() = default;
+    virtual void stage(int stageIndex) = 0;
+};
+
 class Tracer : public TraceHook {
 public:
     static std::unique_ptr<Tracer> Make(std::vector<TraceInfo>* traceInfo);
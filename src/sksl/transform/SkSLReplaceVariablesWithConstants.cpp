@@ -0,0 +1,196 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkTypes.h"
+#include "src/core/SkTHash.h"
+#include "src/sksl/SkSLAnalysis.h"
+#include "src/sksl/SkSLConstantFolder.h"
+#include "src/sksl/SkSLContext.h"
+#include "src/sksl/analysis/SkSLProgramUsage.h"
+#include "src/sksl/ir/SkSLBinaryExpression.h"
+#include "src/sksl/ir/SkSLConstructorCompoundCast.h"
+#include "src/sksl/ir/SkSLConstructorScalarCast.h"
+#include "src/sksl/ir/SkSLExpression.h"
+#include "src/sksl/ir/SkSLFunctionCall.h"
+#include "src/sksl/ir/SkSLFunctionDeclaration.h"
+#include "src/sksl/ir/SkSLFunctionDefinition.h"
+#include "src/sksl/ir/SkSLIRNode.h"
+#include "src/sksl/ir/SkSLIfStatement.h"
+#include "src/sksl/ir/SkSLIndexExpression.h"
+#include "src/sksl/ir/SkSLPrefixExpression.h"
+#include "src/sksl/ir/SkSLProgram.h"
+#include "src/sksl/ir/SkSLProgramElement.h"
+#include "src/sksl/ir/SkSLStatement.h"
+#include "src/sksl/ir/SkSLSwizzle.h"
+#include "src/sksl/ir/SkSLTernaryExpression.h"
+#include "src/sksl/ir/SkSLVarDeclarations.h"
+#include "src/sksl/ir/SkSLVariableReference.h"
+#include "src/sksl/transform/SkSLProgramWriter.h"
+#include "src/sksl/transform/SkSLTransform.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace SkSL {
+
+void Transform::ReplaceVariablesWithConstants(Program& program, const VariableValueMap& values) {
+    class ConstantReplacer : public ProgramWriter {
+    public:
+        ConstantReplacer(const Context& context, ProgramUsage* usage,
+                         const VariableValueMap& values)
+                : fContext(context), fUsage(usage), fValues(values) {}
+
+        using ProgramWriter::visitProgramElement;
+
+        bool visitExpressionPtr(std::unique_ptr<Expression>& expr) override {
+            if (expr->is<VariableReference>()) {
+                const Variable* var = expr->as<VariableReference>().variable();
+                if (const std::unique_ptr<Expression>* value = fValues.find(var)) {
+                    this->replace(expr, (*value)->clone(expr->fPosition));
+                }
+                return false;
+            }
+            // Fold the expression once its operands have been replaced.
+            INHERITED::visitExpressionPtr(expr);
+            if (std::unique_ptr<Expression> folded = this->fold(*expr)) {
+                this->replace(expr, std::move(folded));
+            }
+            return false;
+        }
+
+        bool visitStatementPtr(std::unique_ptr<Statement>& stmt) override {
+            INHERITED::visitStatementPtr(stmt);
+            if (stmt->is<IfStatement>() && stmt->as<IfStatement>().test()->isBoolLiteral()) {
+                // Keep only the branch that is taken.
+                IfStatement& ifStmt = stmt->as<IfStatement>();
+                fUsage->remove(stmt.get());
+                stmt = IfStatement::Make(fContext, ifStmt.fPosition,
+                                         std::move(ifStmt.test()),
+                                         std::move(ifStmt.ifTrue()),
+                                         std::move(ifStmt.ifFalse()));
+                fUsage->add(stmt.get());
+            }
+            return false;
+        }
+
+    private:
+        void replace(std::unique_ptr<Expression>& expr, std::unique_ptr<Expression> replacement) {
+            fUsage->remove(expr.get());
+            expr = std::move(replacement);
+            fUsage->add(expr.get());
+        }
+
+        static bool is_constant(const std::unique_ptr<Expression>& expr) {
+            return expr && Analysis::IsCompileTimeConstant(*expr);
+        }
+
+        // Returns a simpler replacement for expr, which is built the same way as the compiler
+        // would have built it from constant operands, or null.
+        std::unique_ptr<Expression> fold(const Expression& expr) {
+            const Position pos = expr.fPosition;
+            switch (expr.kind()) {
+                case Expression::Kind::kBinary: {
+                    const BinaryExpression& b = expr.as<BinaryExpression>();
+                    return ConstantFolder::Simplify(fContext, pos, *b.left(), b.getOperator(),
+                                                    *b.right(), b.type());
+                }
+                case Expression::Kind::kPrefix: {
+                    const PrefixExpression& p = expr.as<PrefixExpression>();
+                    return is_constant(p.operand()) ? PrefixExpression::Make(fContext, pos,
+                                                                            p.getOperator(),
+                                                                            p.operand()->clone())
+                                                    : nullptr;
+                }
+                case Expression::Kind::kTernary: {
+                    const TernaryExpression& t = expr.as<TernaryExpression>();
+                    return t.test()->isBoolLiteral()
+                                   ? TernaryExpression::Make(fContext, pos, t.test()->clone(),
+                                                             t.ifTrue()->clone(),
+                                                             t.ifFalse()->clone())
+                                   : nullptr;
+                }
+                case Expression::Kind::kSwizzle: {
+                    const Swizzle& s = expr.as<Swizzle>();
+                    return is_constant(s.base()) ? Swizzle::Make(fContext, pos, s.base()->clone(),
+                                                                 s.components())
+                                                 : nullptr;
+                }
+                case Expression::Kind::kIndex: {
+                    const IndexExpression& i = expr.as<IndexExpression>();
+                    return is_constant(i.base()) && is_constant(i.index())
+                                   ? IndexExpression::Make(fContext, pos, i.base()->clone(),
+                                                           i.index()->clone())
+                                   : nullptr;
+                }
+                case Expression::Kind::kConstructorScalarCast:
+                case Expression::Kind::kConstructorCompoundCast: {
+                    const std::unique_ptr<Expression>& arg =
+                            expr.asAnyConstructor().argumentSpan().front();
+                    if (!is_constant(arg)) {
+                        return nullptr;
+                    }
+                    return expr.is<ConstructorScalarCast>()
+                                   ? ConstructorScalarCast::Make(fContext, pos, expr.type(),
+                                                                 arg->clone())
+                                   : ConstructorCompoundCast::Make(fContext, pos, expr.type(),
+                                                                   arg->clone());
+                }
+                case Expression::Kind::kFunctionCall: {
+                    const FunctionCall& call = expr.as<FunctionCall>();
+                    if (!call.function().isIntrinsic() ||
+                        !std::all_of(call.arguments().begin(), call.arguments().end(),
+                                     is_constant)) {
+                        return nullptr;
+                    }
+                    ExpressionArray args;
+                    args.reserve_exact(call.arguments().size());
+                    for (const std::unique_ptr<Expression>& arg : call.arguments()) {
+                        args.push_back(arg->clone());
+                    }
+                    std::unique_ptr<Expression> result = FunctionCall::Make(
+                            fContext, pos, &call.type(), call.function(), std::move(args));
+                    return result->is<FunctionCall>() ? nullptr : std::move(result);
+                }
+                default:
+                    return nullptr;
+            }
+        }
+
+        const Context& fContext;
+        ProgramUsage* fUsage;
+        const VariableValueMap& fValues;
+
+        using INHERITED = ProgramWriter;
+    };
+
+    ConstantReplacer replacer{*program.fContext, program.fUsage.get(), values};
+    for (std::unique_ptr<ProgramElement>& pe : program.fOwnedElements) {
+        if (pe->is<FunctionDefinition>()) {
+            replacer.visitProgramElement(*pe);
+        }
+    }
+
+    // The replaced global variables are no longer referenced; remove their declarations.
+    auto isReplaced = [&](const std::unique_ptr<ProgramElement>& pe) {
+        if (!pe->is<GlobalVarDeclaration>()) {
+            return false;
+        }
+        const VarDeclaration& decl = pe->as<GlobalVarDeclaration>().varDeclaration();
+        if (!values.find(decl.var())) {
+            return false;
+        }
+        program.fUsage->remove(&decl);
+        return true;
+    };
+    program.fOwnedElements.erase(std::remove_if(program.fOwnedElements.begin(),
+                                                program.fOwnedElements.end(),
+                                                isReplaced),
+                                 program.fOwnedElements.end());
+}
+
+}  // namespace SkSL
@@ -9,6 +9,7 @@
 #define SKSL_TRANSFORM
 
 #include "include/core/SkSpan.h"
+#include "src/core/SkTHash.h"
 #include "src/sksl/ir/SkSLModifierFlags.h"
 
 #include <memory>
@@ -110,6 +111,14 @@ void RenamePrivateSymbols(Context& context, Module& module, ProgramUsage* usage,
 /** Replaces constant variables in a program with their equivalent values. */
 void ReplaceConstVarsWithLiterals(Module& module, ProgramUsage* usage);
 
+/**
+ * Replaces every reference to a variable in `values` with a copy of its compile-time constant
+ * value, and refolds the expressions and `if` statements that become constant as a result. The
+ * declarations of replaced global variables (such as uniforms) are removed from the program.
+ */
+using VariableValueMap = skia_private::THashMap<const Variable*, std::unique_ptr<Expression>>;
+void ReplaceVariablesWithConstants(Program& program, const VariableValueMap& values);
+
 /**
  * Looks for variables inside of the top-level of a switch body, such as:
  *
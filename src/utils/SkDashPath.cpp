@@ -7,6 +7,7 @@
 
 #include "src/utils/SkDashPathPriv.h"
 
+#include "include/core/SkContourMeasure.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathEffect.h"
@@ -18,8 +19,10 @@
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkAlign.h"
 #include "include/private/base/SkFloatingPoint.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTo.h"
 #include "src/core/SkPathEnums.h"
+#include "src/core/SkPathMeasurePriv.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkPointPriv.h"
 
@@ -101,6 +104,16 @@ static void outset_for_stroke(SkRect* rect, const SkStrokeRec& rec) {
     rect->outset(radius, radius);
 }
 
+// Like outset_for_stroke(), but also covers the corners of square caps on diagonal dashes, which
+// reach sqrt(2) times the stroke radius away from the path.
+static void outset_for_curve_stroke(SkRect* rect, const SkStrokeRec& rec) {
+    outset_for_stroke(rect, rec);
+    if (SkPaint::kSquare_Cap == rec.getCap()) {
+        SkScalar extra = SkScalarHalf(rec.getWidth()) * (SK_ScalarSqrt2 - 1);
+        rect->outset(extra, extra);
+    }
+}
+
 // If line is zero-length, bump out the end by a tiny amount
 // to draw endcaps. The bump factor is sized so that
 // SkPoint::Distance() computes a non-zero length.
@@ -379,17 +392,44 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         srcPtr = &cullPathStorage;
     }
 
+    // cull_path() only handles lines and rects. For anything else, only dash the parts of each
+    // contour whose lines and curves come near the cull rect. This
+    // must look at the stroke before SpecialLineRec takes it over.
+    const bool cullSegments = cullRect && srcPtr == &src;
+    SkRect cullBounds;
+    if (cullSegments) {
+        cullBounds = *cullRect;
+        outset_for_curve_stroke(&cullBounds, *rec);
+    }
+
     SpecialLineRec lineRec;
     bool specialLine = (StrokeRecApplication::kAllow == strokeRecApplication) &&
                        lineRec.init(*srcPtr, dst, rec, count >> 1, intervalLength);
 
     SkPathMeasure   meas(*srcPtr, false, rec->getResScale());
 
+    skia_private::TArray<SkPathMeasurePriv::Span> visibleSpans;
+    // The dashes of the current contour, added to dst all at once.
+    skia_private::TArray<SkPathMeasurePriv::Span> dashes;
+
     do {
         bool        skipFirstSegment = meas.isClosed();
         bool        addedSegment = false;
         SkScalar    length = meas.getLength();
         int         index = initialDashIndex;
+        const SkContourMeasure* contour = meas.currentMeasure();
+
+        SkScalar dashedLength = length;
+        if (cullSegments) {
+            visibleSpans.clear();
+            dashedLength = 0;
+            if (contour) {
+                SkPathMeasurePriv::VisibleSpans(*contour, cullBounds, &visibleSpans);
+                for (const SkPathMeasurePriv::Span& span : visibleSpans) {
+                    dashedLength += span.fStop - span.fStart;
+                }
+            }
+        }
 
         // Since the path length / dash length ratio may be arbitrarily large, we can exert
         // significant memory pressure while attempting to build the filtered path. To avoid this,
@@ -399,7 +439,7 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         // 90 million dash segments and crashing the memory allocator. A limit of 1 million
         // segments seems reasonable: at 2 verbs per segment * 9 bytes per verb, this caps the
         // maximum dash memory overhead at roughly 17MB per path.
-        dashCount += length * (count >> 1) / intervalLength;
+        dashCount += dashedLength * (count >> 1) / intervalLength;
         if (dashCount > kMaxDashCount) {
             dst->reset();
             return false;
@@ -409,11 +449,34 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         // (for extreme path_length/dash_length ratios). See test_infinite_dash() unittest.
         double  distance = 0;
         double  dlen = initialDashLength;
+        int     spanIndex = 0;
+        dashes.clear();
 
         while (distance < length) {
             SkASSERT(dlen >= 0);
             addedSegment = false;
-            if (is_even(index) && !skipFirstSegment) {
+            bool visible = true;
+            if (cullSegments) {
+                while (spanIndex < visibleSpans.size() &&
+                       visibleSpans[spanIndex].fStop < distance) {
+                    ++spanIndex;
+                }
+                if (spanIndex == visibleSpans.size()) {
+                    break;  // nothing else in this contour is visible
+                }
+                double spanStart = visibleSpans[spanIndex].fStart;
+                if (distance + dlen < spanStart) {
+                    // Jump over whole cycles of intervals, which keeps index and dlen in phase.
+                    double cycles = std::floor((spanStart - distance - dlen) / intervalLength);
+                    if (cycles > 0) {
+                        distance += cycles * intervalLength;
+                        // The skipped first segment is still added below, if need be.
+                        skipFirstSegment = false;
+                    }
+                    visible = distance + dlen >= spanStart;
+                }
+            }
+            if (is_even(index) && !skipFirstSegment && visible) {
                 addedSegment = true;
                 ++segCount;
 
@@ -422,9 +485,8 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
                                        SkDoubleToScalar(distance + dlen),
                                        dst);
                 } else {
-                    meas.getSegment(SkDoubleToScalar(distance),
-                                    SkDoubleToScalar(distance + dlen),
-                                    dst, true);
+                    dashes.push_back({SkDoubleToScalar(distance),
+                                      SkDoubleToScalar(distance + dlen)});
                 }
             }
             distance += dlen;
@@ -443,6 +505,10 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
             dlen = intervals[index];
         }
 
+        if (contour) {
+            SkPathMeasurePriv::GetSegments(*contour, dashes, dst);
+        }
+
         // extend if we ended on a segment and we need to join up with the (skipped) initial segment
         if (meas.isClosed() && is_even(initialDashIndex) &&
             initialDashLength >= 0) {
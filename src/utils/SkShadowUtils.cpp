@@ -18,6 +18,7 @@
 #include "include/core/SkPath.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkPoint3.h"
+#include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkVertices.h"
@@ -34,6 +35,7 @@
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkVerticesPriv.h"
+#include "src/utils/SkShadowUtilsPriv.h"
 
 #if !defined(SK_ENABLE_OPTIMIZE_SIZE)
 #include "src/utils/SkShadowTessellator.h"
@@ -45,6 +47,8 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstring>
 #include <functional>
 #include <memory>
@@ -53,8 +57,6 @@
 
 using namespace skia_private;
 
-class SkRRect;
-
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #if !defined(SK_ENABLE_OPTIMIZE_SIZE)
@@ -64,6 +66,50 @@ uint64_t resource_cache_shared_id() {
     return 0x2020776f64616873llu;  // 'shadow  '
 }
 
+std::atomic<int64_t> gTessellationCacheHits{0};
+std::atomic<int64_t> gTessellationCacheMisses{0};
+
+// Matrices with nearly the same scale and skew share a tessellation. It is made for the matrix of
+// their bucket and mapped onto the actual matrix when drawn, so the shape is exact and only the
+// widths of the blurred edges are off, by about 1% at most.
+constexpr float kScaleBucketsPerOctave = 32;
+constexpr float kEntryStepsPerScale = 128;
+
+/**
+ * Snaps the scale and skew of a matrix without perspective to its bucket. Returns the bucket's
+ * matrix, with ctm's translation, and the scale and skew that maps from the bucket to ctm.
+ */
+bool bucket_matrix(const SkMatrix& ctm, SkMatrix* bucket, SkMatrix* correction) {
+    SkASSERT(!ctm.hasPerspective());
+    const SkScalar entries[4] = {ctm.getScaleX(), ctm.getSkewX(), ctm.getSkewY(), ctm.getScaleY()};
+    SkScalar scale = 0;
+    for (SkScalar entry : entries) {
+        scale = std::max(scale, SkScalarAbs(entry));
+    }
+    if (!(scale > 0) || !SkIsFinite(scale)) {
+        return false;
+    }
+    SkScalar bucketScale =
+            std::exp2(std::round(std::log2(scale) * kScaleBucketsPerOctave) /
+                      kScaleBucketsPerOctave);
+    auto snap = [&](SkScalar entry) {
+        return std::round(entry / scale * kEntryStepsPerScale) / kEntryStepsPerScale * bucketScale;
+    };
+
+    SkMatrix linear = SkMatrix::MakeAll(snap(entries[0]), snap(entries[1]), 0,
+                                        snap(entries[2]), snap(entries[3]), 0,
+                                        0, 0, 1);
+    SkMatrix inverse;
+    if (!linear.invert(&inverse)) {
+        return false;
+    }
+    *correction = SkMatrix::MakeAll(entries[0], entries[1], 0, entries[2], entries[3], 0, 0, 0, 1);
+    correction->preConcat(inverse);
+    *bucket = linear;
+    bucket->postTranslate(ctm.getTranslateX(), ctm.getTranslateY());
+    return true;
+}
+
 /** Factory for an ambient shadow mesh with particular shadow properties. */
 struct AmbientVerticesFactory {
     SkScalar fOccluderHeight = SK_ScalarNaN;  // NaN so that isCompatible will fail until init'ed.
@@ -78,6 +124,10 @@ struct AmbientVerticesFactory {
         return true;
     }
 
+    // Whether makeVertices() ignores the translation, so the mesh can be shared by every matrix
+    // in the same bucket.
+    bool usesCanonicalMatrix(const SkMatrix& ctm) const { return !ctm.hasPerspective(); }
+
     sk_sp<SkVertices> makeVertices(const SkPath& path, const SkMatrix& ctm,
                                    SkVector* translate) const {
         SkPoint3 zParams = SkPoint3::Make(0, 0, fOccluderHeight);
@@ -143,6 +193,12 @@ struct SpotVerticesFactory {
         SK_ABORT("Uninitialized occluder type?");
     }
 
+    bool usesCanonicalMatrix(const SkMatrix& ctm) const {
+        // These are the cases where makeVertices() ignores the translation.
+        return !ctm.hasPerspective() && (fOccluderType == OccluderType::kPointTransparent ||
+                                         fOccluderType == OccluderType::kPointOpaqueNoUmbra);
+    }
+
     sk_sp<SkVertices> makeVertices(const SkPath& path, const SkMatrix& ctm,
                                    SkVector* translate) const {
         bool transparent = fOccluderType == OccluderType::kPointTransparent ||
@@ -351,29 +407,81 @@ public:
 #if defined(SK_GANESH)
             , fShapeForKey(*path, GrStyle::SimpleFill())
 #endif
-    {}
+    {
+        this->canonicalizeRRect();
+    }
 
     const SkPath& path() const { return *fPath; }
     const SkMatrix& viewMatrix() const { return *fViewMatrix; }
-#if defined(SK_GANESH)
+
     /** Negative means the vertices should not be cached for this path. */
-    int keyBytes() const { return fShapeForKey.unstyledKeySize() * sizeof(uint32_t); }
+    int keyBytes() const {
+        if (fIsCanonicalRRect) {
+            return SkRRect::kSizeInMemory + sizeof(uint32_t);
+        }
+#if defined(SK_GANESH)
+        return fShapeForKey.unstyledKeySize() * sizeof(uint32_t);
+#else
+        return fPath->isVolatile() ? -1 : 2 * sizeof(uint32_t);
+#endif
+    }
     void writeKey(void* key) const {
+        if (fIsCanonicalRRect) {
+            fRRect.writeToMemory(key);
+            uint32_t shape = (fIsOval << 16) | ((int)fDir << 8) | fStart;
+            memcpy(SkTAddOffset<void>(key, SkRRect::kSizeInMemory), &shape, sizeof(shape));
+            return;
+        }
+#if defined(SK_GANESH)
         fShapeForKey.writeUnstyledKey(reinterpret_cast<uint32_t*>(key));
-    }
-    bool isRRect(SkRRect* rrect) { return fShapeForKey.asRRect(rrect, nullptr, nullptr, nullptr); }
 #else
-    int keyBytes() const { return -1; }
-    void writeKey(void* key) const { SK_ABORT("Should never be called"); }
-    bool isRRect(SkRRect* rrect) { return false; }
+        uint32_t* key32 = reinterpret_cast<uint32_t*>(key);
+        key32[0] = fPath->getGenerationID();
+        key32[1] = static_cast<uint32_t>(fPath->getFillType());
 #endif
+    }
+    /** Whether the key depends on the path's generation ID (rather than its geometry). */
+    bool keyNeedsInvalidation() const { return !fIsCanonicalRRect; }
 
 private:
+    // Round rects and ovals are keyed by their geometry with their top-left corner moved to the
+    // origin, and the offset is folded into the view matrix. Every copy of the same shape then
+    // shares one tessellation, wherever it is drawn.
+    void canonicalizeRRect() {
+        if (fPath->isInverseFillType()) {
+            return;
+        }
+        SkRect oval;
+        if (SkPathPriv::IsOval(*fPath, &oval, &fDir, &fStart)) {
+            fRRect.setOval(oval);
+            fIsOval = true;
+        } else if (!SkPathPriv::IsRRect(*fPath, &fRRect, &fDir, &fStart)) {
+            return;
+        }
+
+        const SkPoint origin = {fRRect.rect().fLeft, fRRect.rect().fTop};
+        fRRect.offset(-origin.fX, -origin.fY);
+        fCanonicalPath = fIsOval ? SkPath::Oval(fRRect.rect(), fDir, fStart)
+                                 : SkPath::RRect(fRRect, fDir, fStart);
+        fCanonicalMatrix = SkMatrix::Concat(*fViewMatrix,
+                                            SkMatrix::Translate(origin.fX, origin.fY));
+        fPath = &fCanonicalPath;
+        fViewMatrix = &fCanonicalMatrix;
+        fIsCanonicalRRect = true;
+    }
+
     const SkPath* fPath;
     const SkMatrix* fViewMatrix;
 #if defined(SK_GANESH)
     GrStyledShape fShapeForKey;
 #endif
+    bool fIsCanonicalRRect = false;
+    bool fIsOval = false;
+    SkRRect fRRect;
+    SkPathDirection fDir = SkPathDirection::kCW;
+    unsigned fStart = 0;
+    SkPath fCanonicalPath;
+    SkMatrix fCanonicalMatrix;
 };
 
 // This creates a domain of keys in SkResourceCache used by this file.
@@ -411,8 +519,18 @@ private:
 template <typename FACTORY>
 bool draw_shadow(const FACTORY& factory,
                  std::function<void(const SkVertices*, SkBlendMode, const SkPaint&,
-                 SkScalar tx, SkScalar ty, bool)> drawProc, ShadowedPath& path, SkColor color) {
-    FindContext<FACTORY> context(&path.viewMatrix(), &factory);
+                 const SkMatrix& transform, bool)> drawProc, ShadowedPath& path, SkColor color) {
+    // Tessellate for the matrix's bucket when the mesh doesn't depend on the translation, and
+    // map the mesh onto the real matrix when drawing it.
+    SkMatrix tessMatrix = path.viewMatrix();
+    SkMatrix correction = SkMatrix::I();
+    if (factory.usesCanonicalMatrix(tessMatrix)) {
+        SkMatrix bucket;
+        if (bucket_matrix(path.viewMatrix(), &bucket, &correction)) {
+            tessMatrix = bucket;
+        }
+    }
+    FindContext<FACTORY> context(&tessMatrix, &factory);
 
     SkResourceCache::Key* key = nullptr;
     AutoSTArray<32 * 4, uint8_t> keyStorage;
@@ -427,6 +545,10 @@ bool draw_shadow(const FACTORY& factory,
 
     sk_sp<SkVertices> vertices;
     bool foundInCache = SkToBool(context.fVertices);
+    if (key) {
+        (foundInCache ? gTessellationCacheHits : gTessellationCacheMisses)
+                .fetch_add(1, std::memory_order_relaxed);
+    }
     if (foundInCache) {
         vertices = std::move(context.fVertices);
     } else {
@@ -439,17 +561,18 @@ bool draw_shadow(const FACTORY& factory,
             } else {
                 tessellations.reset(new CachedTessellations());
             }
-            vertices = tessellations->add(path.path(), factory, path.viewMatrix(),
-                                          &context.fTranslate);
+            vertices = tessellations->add(path.path(), factory, tessMatrix, &context.fTranslate);
             if (!vertices) {
                 return false;
             }
             auto rec = new CachedTessellationsRec(*key, std::move(tessellations));
-            SkPathPriv::AddGenIDChangeListener(path.path(), sk_make_sp<ShadowInvalidator>(*key));
+            if (path.keyNeedsInvalidation()) {
+                SkPathPriv::AddGenIDChangeListener(path.path(),
+                                                   sk_make_sp<ShadowInvalidator>(*key));
+            }
             SkResourceCache::Add(rec);
         } else {
-            vertices = factory.makeVertices(path.path(), path.viewMatrix(),
-                                            &context.fTranslate);
+            vertices = factory.makeVertices(path.path(), tessMatrix, &context.fTranslate);
             if (!vertices) {
                 return false;
             }
@@ -464,7 +587,8 @@ bool draw_shadow(const FACTORY& factory,
                                                                 SkColorFilterPriv::MakeGaussian()));
 
     drawProc(vertices.get(), SkBlendMode::kModulate, paint,
-             context.fTranslate.fX, context.fTranslate.fY, path.viewMatrix().hasPerspective());
+             SkMatrix::Concat(SkMatrix::Translate(context.fTranslate), correction),
+             path.viewMatrix().hasPerspective());
 
     return true;
 }
@@ -600,15 +724,14 @@ void SkDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
 
 #if !defined(SK_ENABLE_OPTIMIZE_SIZE)
     auto drawVertsProc = [this](const SkVertices* vertices, SkBlendMode mode, const SkPaint& paint,
-                                SkScalar tx, SkScalar ty, bool hasPerspective) {
+                                const SkMatrix& transform, bool hasPerspective) {
         if (vertices->priv().vertexCount()) {
             // For perspective shadows we've already computed the shadow in world space,
             // and we can't translate it without changing it. Otherwise we concat the
-            // change in translation from the cached version.
+            // change in translation (and the bucket's scale correction) from the cached version.
             SkAutoDeviceTransformRestore adr(
                     this,
-                    hasPerspective ? SkMatrix::I()
-                                   : this->localToDevice() * SkMatrix::Translate(tx, ty));
+                    hasPerspective ? SkMatrix::I() : this->localToDevice() * transform);
             // The vertex colors for a tesselated shadow polygon are always either opaque black
             // or transparent and their real contribution to the final blended color is via
             // their alpha. We can skip expensive per-vertex color conversion for this.
@@ -660,14 +783,15 @@ void SkDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
         }
 
         if (!success && !useBlur) {
+            const SkMatrix& shadowMatrix = shadowedPath.viewMatrix();
             AmbientVerticesFactory factory;
             factory.fOccluderHeight = zPlaneParams.fZ;
             factory.fTransparent = transparent;
-            if (viewMatrix.hasPerspective()) {
+            if (shadowMatrix.hasPerspective()) {
                 factory.fOffset.set(0, 0);
             } else {
-                factory.fOffset.fX = viewMatrix.getTranslateX();
-                factory.fOffset.fY = viewMatrix.getTranslateY();
+                factory.fOffset.fX = shadowMatrix.getTranslateX();
+                factory.fOffset.fY = shadowMatrix.getTranslateY();
             }
 
             success = draw_shadow(factory, drawVertsProc, shadowedPath, rec.fAmbientColor);
@@ -753,14 +877,19 @@ void SkDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
         }
 
         if (!success && !useBlur) {
+            // The cache may have moved the path to a canonical place, with the view matrix
+            // adjusted to match.
+            const SkPath& shadowPath = shadowedPath.path();
+            const SkMatrix& shadowMatrix = shadowedPath.viewMatrix();
             SpotVerticesFactory factory;
             factory.fOccluderHeight = zPlaneParams.fZ;
             factory.fDevLightPos = devLightPos;
             factory.fLightRadius = lightRadius;
 
-            SkPoint center = SkPoint::Make(path.getBounds().centerX(), path.getBounds().centerY());
+            SkPoint center = SkPoint::Make(shadowPath.getBounds().centerX(),
+                                           shadowPath.getBounds().centerY());
             factory.fLocalCenter = center;
-            viewMatrix.mapPoints(&center, 1);
+            shadowMatrix.mapPoints(&center, 1);
             SkScalar radius, scale;
             if (SkToBool(rec.fFlags & kDirectionalLight_ShadowFlag)) {
                 SkDrawShadowMetrics::GetDirectionalParams(zPlaneParams.fZ, devLightPos.fX,
@@ -774,7 +903,7 @@ void SkDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
             }
 
             SkRect devBounds;
-            viewMatrix.mapRect(&devBounds, path.getBounds());
+            shadowMatrix.mapRect(&devBounds, shadowPath.getBounds());
             if (transparent ||
                 SkTAbs(factory.fOffset.fX) > 0.5f*devBounds.width() ||
                 SkTAbs(factory.fOffset.fY) > 0.5f*devBounds.height()) {
@@ -791,14 +920,14 @@ void SkDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
             } else if (factory.fOffset.length()*scale + scale < radius) {
                 // if we don't translate more than the blur distance, can assume umbra is covered
                 factory.fOccluderType = SpotVerticesFactory::OccluderType::kPointOpaqueNoUmbra;
-            } else if (path.isConvex()) {
+            } else if (shadowPath.isConvex()) {
                 factory.fOccluderType = SpotVerticesFactory::OccluderType::kPointOpaquePartialUmbra;
             } else {
                 factory.fOccluderType = SpotVerticesFactory::OccluderType::kPointTransparent;
             }
             // need to add this after we classify the shadow
-            factory.fOffset.fX += viewMatrix.getTranslateX();
-            factory.fOffset.fY += viewMatrix.getTranslateY();
+            factory.fOffset.fX += shadowMatrix.getTranslateX();
+            factory.fOffset.fY += shadowMatrix.getTranslateY();
 
             SkColor color = rec.fSpotColor;
 #ifdef DEBUG_SHADOW_CHECKS
@@ -843,3 +972,14 @@ void SkDevice::drawShadow(const SkPath& path, const SkDrawShadowRec& rec) {
         }
     }
 }
+
+#if !defined(SK_ENABLE_OPTIMIZE_SIZE)
+SkShadowUtilsPriv::TessellationCacheStats SkShadowUtilsPriv::GetTessellationCacheStats() {
+    return {gTessellationCacheHits.load(std::memory_order_relaxed),
+            gTessellationCacheMisses.load(std::memory_order_relaxed)};
+}
+#else
+SkShadowUtilsPriv::TessellationCacheStats SkShadowUtilsPriv::GetTessellationCacheStats() {
+    return {0, 0};
+}
+#endif
@@ -0,0 +1,29 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkShadowUtilsPriv_DEFINED
+#define SkShadowUtilsPriv_DEFINED
+
+#include <cstdint>
+
+namespace SkShadowUtilsPriv {
+
+/**
+ *  Counts of how often SkDevice::drawShadow found a cached tessellation in SkResourceCache.
+ *  Shadows that are never cached (volatile paths, tilted z-planes, blurred fallbacks) are not
+ *  counted.
+ */
+struct TessellationCacheStats {
+    int64_t fHits;
+    int64_t fMisses;
+};
+
+TessellationCacheStats GetTessellationCacheStats();
+
+}  // namespace SkShadowUtilsPriv
+
+#endif  // SkShadowUtilsPriv_DEFINED
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTileMode.h"
+#include "src/base/SkRandom.h"
+#include "src/core/SkBlurEngine.h"
+#include "src/core/SkSpecialImage.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+static sk_sp<SkSpecialImage> make_source(SkColorType colorType, const SkBitmap& content) {
+    SkBitmap bm;
+    bm.allocPixels(content.info().makeColorType(colorType));
+    SkAssertResult(content.readPixels(bm.pixmap()));
+    bm.setImmutable();
+    return SkSpecialImages::MakeFromRaster(SkIRect::MakeSize(bm.dimensions()), bm, SkSurfaceProps());
+}
+
+static SkBitmap blur(SkSize sigma, const SkBitmap& content, SkColorType colorType,
+                     const SkIRect& dstRect) {
+    const SkBlurEngine* engine = SkBlurEngine::GetRasterBlurEngine();
+    const SkBlurEngine::Algorithm* algorithm = engine->findAlgorithm(sigma, colorType);
+    if (!algorithm) {
+        return {};
+    }
+    sk_sp<SkSpecialImage> src = make_source(colorType, content);
+    sk_sp<SkSpecialImage> result = algorithm->blur(sigma, src, SkIRect::MakeSize(src->dimensions()),
+                                                   SkTileMode::kDecal, dstRect);
+    SkBitmap bm;
+    if (!result || !SkSpecialImages::AsBitmap(result.get(), &bm)) {
+        return {};
+    }
+    // Compare everything as 8888.
+    SkBitmap n32;
+    n32.allocPixels(bm.info().makeColorType(kN32_SkColorType));
+    SkAssertResult(bm.readPixels(n32.pixmap()));
+    return n32;
+}
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    SkASSERT(a.dimensions() == b.dimensions());
+    int maxDiff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            SkColor ca = a.getColor(x, y), cb = b.getColor(x, y);
+            for (int shift : {0, 8, 16, 24}) {
+                maxDiff = std::max(maxDiff, std::abs(int((ca >> shift) & 0xFF) -
+                                                     int((cb >> shift) & 0xFF)));
+            }
+        }
+    }
+    return maxDiff;
+}
+
+static SkBitmap make_content() {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::MakeN32Premul(64, 48));
+    bm.eraseColor(SK_ColorTRANSPARENT);
+    SkRandom rand;
+    for (int i = 0; i < 12; ++i) {
+        SkIRect r = SkIRect::MakeXYWH(rand.nextULessThan(56), rand.nextULessThan(40),
+                                      1 + rand.nextULessThan(8), 1 + rand.nextULessThan(8));
+        bm.erase(rand.nextU() | 0xFF000000, r);
+    }
+    return bm;
+}
+
+DEF_TEST(RasterBlurEngine_SupportedColorTypes, r) {
+    const SkBlurEngine* engine = SkBlurEngine::GetRasterBlurEngine();
+    REPORTER_ASSERT(r, engine->findAlgorithm({4, 4}, kRGBA_8888_SkColorType));
+    REPORTER_ASSERT(r, engine->findAlgorithm({4, 4}, kBGRA_8888_SkColorType));
+    REPORTER_ASSERT(r, engine->findAlgorithm({4, 4}, kRGBA_F16_SkColorType));
+    REPORTER_ASSERT(r, !engine->findAlgorithm({4, 4}, kAlpha_8_SkColorType));
+}
+
+// The F16 passes run the same box filters as the 8888 passes, in float.
+DEF_TEST(RasterBlurEngine_F16Matches8888, r) {
+    const SkBitmap content = make_content();
+    for (SkSize sigma : {SkSize{3, 3}, SkSize{8, 0.f}, SkSize{0.f, 5.5f}, SkSize{20, 60}}) {
+        SkIRect dstRect = SkIRect::MakeSize(content.dimensions())
+                                  .makeOutset(SkScalarCeilToInt(3 * sigma.width()),
+                                              SkScalarCeilToInt(3 * sigma.height()));
+        SkBitmap expected = blur(sigma, content, kN32_SkColorType, dstRect);
+        SkBitmap actual = blur(sigma, content, kRGBA_F16_SkColorType, dstRect);
+        if (expected.drawsNothing() || actual.drawsNothing()) {
+            ERRORF(r, "sigma (%g, %g): blur failed", sigma.width(), sigma.height());
+            continue;
+        }
+        REPORTER_ASSERT(r, expected.dimensions() == dstRect.size());
+        int diff = max_diff(expected, actual);
+        REPORTER_ASSERT(r, diff <= 2, "sigma (%g, %g): max diff %d",
+                        sigma.width(), sigma.height(), diff);
+    }
+}
+
+// Sigmas too small to blur just copy the source.
+DEF_TEST(RasterBlurEngine_Identity, r) {
+    const SkBitmap content = make_content();
+    SkBitmap result = blur({0.5f, 0.5f}, content, kN32_SkColorType,
+                           SkIRect::MakeSize(content.dimensions()));
+    REPORTER_ASSERT(r, max_diff(content, result) == 0);
+}
+
+// Large sigmas are blurred at a lower resolution, which should still spread the same amount of
+// coverage evenly around the source.
+DEF_TEST(RasterBlurEngine_LargeSigma, r) {
+    SkBitmap content;
+    content.allocPixels(SkImageInfo::MakeN32Premul(64, 64));
+    content.eraseColor(SK_ColorWHITE);
+
+    const float sigma = 70;
+    const int radius = SkScalarCeilToInt(3 * sigma);
+    const SkIRect dstRect = SkIRect::MakeSize(content.dimensions()).makeOutset(radius, radius);
+    for (SkColorType ct : {kN32_SkColorType, kRGBA_F16_SkColorType}) {
+        SkBitmap result = blur({sigma, sigma}, content, ct, dstRect);
+        if (result.drawsNothing()) {
+            ERRORF(r, "color type %d: blur failed", ct);
+            continue;
+        }
+
+        double total = 0;
+        for (int y = 0; y < result.height(); ++y) {
+            for (int x = 0; x < result.width(); ++x) {
+                total += SkColorGetA(result.getColor(x, y));
+            }
+        }
+        const double expected = 255.0 * 64 * 64;
+        REPORTER_ASSERT(r, std::abs(total - expected) < 0.05 * expected,
+                        "total alpha %g, expected %g", total, expected);
+
+        // The peak should be at the center of the source, and the blur should be symmetric.
+        const int cx = radius + 32, cy = radius + 32;
+        SkColor center = result.getColor(cx, cy);
+        REPORTER_ASSERT(r, SkColorGetA(center) > 0);
+        for (int d : {60, 150}) {
+            int left = SkColorGetA(result.getColor(cx - d, cy));
+            int right = SkColorGetA(result.getColor(cx + d - 1, cy));
+            int top = SkColorGetA(result.getColor(cx, cy - d));
+            REPORTER_ASSERT(r, left <= (int)SkColorGetA(center));
+            REPORTER_ASSERT(r, std::abs(left - right) <= 1 && std::abs(left - top) <= 1,
+                            "d %d: %d %d %d", d, left, right, top);
+        }
+    }
+}
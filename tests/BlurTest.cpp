@@ -33,8 +33,11 @@
 #include "include/private/base/SkTPin.h"
 #include "src/base/SkFloatBits.h"
 #include "src/base/SkMathPriv.h"
+#include "src/base/SkTLazy.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkCachedData.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkMaskCache.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/effects/SkEmbossMaskFilter.h"
 #include "src/gpu/ganesh/GrBlurUtils.h"
@@ -44,9 +47,11 @@
 
 #include <math.h>
 #include <string.h>
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <initializer_list>
 
 struct GrContextOptions;
@@ -358,6 +363,120 @@ DEF_TEST(BlurSigmaRange, reporter) {
     }
 }
 
+// Large sigmas are blurred at a lower resolution and interpolated back up, which should be about
+// as close to a Gaussian as blurring at full resolution.
+DEF_TEST(BlurLargeSigma, reporter) {
+    static const int kSize = 100;
+
+    // A divet keeps this off the rect and convex path special cases.
+    SkPoint polyPts[] = {
+        { 0.3f, 0.3f },
+        { 100.3f, 0.3f },
+        { 100.3f, 100.3f },
+        { 0.3f, 100.3f },
+        { 2.3f, 50.3f }
+    };
+    SkPath polyPath;
+    polyPath.addPoly(polyPts, std::size(polyPts), true);
+
+    for (SkScalar sigma : {12.0f, 16.0f, 40.0f, 100.0f}) {
+        int generalCaseResult[kSize];
+        int groundTruthResult[kSize];
+        cpu_blur_path(polyPath, sigma, generalCaseResult, kSize);
+        ground_truth_2d(100, 100, sigma, groundTruthResult, kSize);
+
+        REPORTER_ASSERT(reporter, match(generalCaseResult, groundTruthResult, kSize, 6),
+                        "sigma %g", sigma);
+    }
+}
+
+// Several rows are blurred at once, and the rows left over one at a time, so the blur of a
+// pattern that is symmetric about the diagonal should be too.
+DEF_TEST(BlurMaskSymmetric, reporter) {
+    static const int kSize = 37;
+
+    SkMaskBuilder src(SkMaskBuilder::AllocImage(kSize * kSize), SkIRect::MakeWH(kSize, kSize),
+                      kSize, SkMask::kA8_Format);
+    SkAutoMaskFreeImage srcImage(src.image());
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            src.image()[y * kSize + x] = ((x * y) % 7 < 3) ? 255 : (x + y) * 3;
+        }
+    }
+
+    for (SkScalar sigma : {3.0f, 10.0f, 30.0f}) {
+        SkMaskBuilder dst;
+        REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&dst, src, sigma, kNormal_SkBlurStyle));
+        SkAutoMaskFreeImage dstImage(dst.image());
+        REPORTER_ASSERT(reporter, dst.fBounds.width() == dst.fBounds.height());
+
+        int maxDiff = 0;
+        for (int y = 0; y < dst.fBounds.height(); ++y) {
+            for (int x = 0; x < y; ++x) {
+                const int a = dst.fImage[y * dst.fRowBytes + x],
+                          b = dst.fImage[x * dst.fRowBytes + y];
+                maxDiff = std::max(maxDiff, std::abs(a - b));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 1, "sigma %g: diff %d", sigma, maxDiff);
+    }
+}
+
+// Blurred convex paths are cached by shape, and drawn from the cache at any integer translation.
+DEF_TEST(BlurConvexPathCache, reporter) {
+    const SkPath triangle = SkPath::Polygon({{20.5f, 10.25f}, {70, 30}, {30, 60.75f}},
+                                            /*isClosed=*/true);
+    SkPaint paint;
+    paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 4));
+
+    auto draw = [&](SkVector offset, const SkIRect& clip) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeA8(200, 100));
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        canvas.clipIRect(clip);
+        SkPath path;
+        triangle.offset(offset.x(), offset.y(), &path);
+        canvas.drawPath(path, paint);
+        return bitmap;
+    };
+
+    const SkIRect everywhere = SkIRect::MakeWH(200, 100);
+    SkBitmap first = draw({0, 0}, everywhere);
+
+    SkPath translated;
+    triangle.offset(3, 5, &translated);
+    SkTLazy<SkMask> mask;
+    SkCachedData* data = SkMaskCache::FindAndRef(4, kNormal_SkBlurStyle, translated, &mask);
+    REPORTER_ASSERT(reporter, data);
+    if (data) {
+        data->unref();
+    }
+
+    // Drawing the triangle elsewhere uses the cached mask.
+    SkBitmap moved = draw({100, 20}, everywhere);
+    for (int y = 0; y < 80; ++y) {
+        for (int x = 0; x < 100; ++x) {
+            if (*moved.getAddr8(x + 100, y + 20) != *first.getAddr8(x, y)) {
+                ERRORF(reporter, "(%d, %d): %d, moved %d", x, y, *first.getAddr8(x, y),
+                       *moved.getAddr8(x + 100, y + 20));
+                return;
+            }
+        }
+    }
+
+    // A path that isn't entirely within the clip is blurred without the cache.
+    const SkPath clipped = SkPath::Polygon({{10, 40.5f}, {90, 50}, {25, 95}}, /*isClosed=*/true);
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeA8(200, 100));
+    SkCanvas canvas(bitmap);
+    canvas.clipIRect(SkIRect::MakeWH(50, 100));
+    canvas.drawPath(clipped, paint);
+    mask.reset();
+    REPORTER_ASSERT(reporter,
+                    !SkMaskCache::FindAndRef(4, kNormal_SkBlurStyle, clipped, &mask));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 DEF_TEST(BlurAsABlur, reporter) {
@@ -0,0 +1,236 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorTransform.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
+#include "include/encode/SkICC.h"
+#include "modules/skcms/skcms.h"
+#include "src/base/SkRandom.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+// The pixels are opaque: readPixels() lets out-of-gamut premul colors exceed alpha, where
+// skcms clamps them to it.
+static SkBitmap make_noise(int width, int height, sk_sp<SkColorSpace> cs) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(width, height, kRGBA_8888_SkColorType, kPremul_SkAlphaType,
+                                     std::move(cs)));
+    SkRandom rand;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            *bm.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU() | 0xFF000000);
+        }
+    }
+    return bm;
+}
+
+// Returns the largest difference between any bytes of the two pixmaps, which have the same info.
+// (Comparing unpremultiplied colors would magnify rounding in nearly transparent pixels.)
+static int max_diff(const SkPixmap& a, const SkPixmap& b) {
+    int diff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        const uint8_t* rowA = static_cast<const uint8_t*>(a.addr(0, y));
+        const uint8_t* rowB = static_cast<const uint8_t*>(b.addr(0, y));
+        for (size_t i = 0; i < a.info().minRowBytes(); ++i) {
+            diff = std::max(diff, std::abs((int)rowA[i] - (int)rowB[i]));
+        }
+    }
+    return diff;
+}
+
+static float mean_diff(const SkPixmap& a, const SkPixmap& b) {
+    int64_t sum = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        const uint8_t* rowA = static_cast<const uint8_t*>(a.addr(0, y));
+        const uint8_t* rowB = static_cast<const uint8_t*>(b.addr(0, y));
+        for (size_t i = 0; i < a.info().minRowBytes(); ++i) {
+            sum += std::abs((int)rowA[i] - (int)rowB[i]);
+        }
+    }
+    return (float)sum / (a.height() * a.info().minRowBytes());
+}
+
+// Converts src with both the exact and baked transforms, and checks that they stay within the
+// three 8-bit steps that baked transforms are allowed (trivially, if the baked transform refused to
+// bake). Baked transforms look up opaque 8-bit pixels directly rather than unpacking them first,
+// which must give the same result.
+static void check_baked(skiatest::Reporter* reporter, const char* name, const SkPixmap& src,
+                        sk_sp<SkColorTransform> exact, sk_sp<SkColorTransform> baked) {
+    REPORTER_ASSERT(reporter, exact && !exact->isBaked());
+    REPORTER_ASSERT(reporter, baked);
+
+    SkBitmap viaExact, viaBaked;
+    viaExact.allocPixels(src.info().makeColorSpace(nullptr));
+    viaBaked.allocPixels(viaExact.info());
+    REPORTER_ASSERT(reporter, exact->apply(viaExact.pixmap(), src));
+    REPORTER_ASSERT(reporter, baked->apply(viaBaked.pixmap(), src));
+
+    const int maxDiff = max_diff(viaExact.pixmap(), viaBaked.pixmap());
+    const float meanDiff = mean_diff(viaExact.pixmap(), viaBaked.pixmap());
+    REPORTER_ASSERT(reporter, maxDiff <= 3, "%s: max diff %d", name, maxDiff);
+    REPORTER_ASSERT(reporter, meanDiff <= 0.25f, "%s: mean diff %g", name, meanDiff);
+
+    if (src.alphaType() == kPremul_SkAlphaType) {
+        SkBitmap viaBytes;
+        viaBytes.allocPixels(viaExact.info());
+        SkPixmap opaque(src.info().makeAlphaType(kOpaque_SkAlphaType), src.addr(), src.rowBytes());
+        REPORTER_ASSERT(reporter, baked->apply(viaBytes.pixmap(), opaque));
+        REPORTER_ASSERT(reporter, max_diff(viaBytes.pixmap(), viaBaked.pixmap()) == 0, "%s", name);
+    }
+}
+
+// apply() agrees with converting the pixels with readPixels(), whether or not the image is
+// large enough to be split into bands.
+DEF_TEST(ColorTransform_MatchesReadPixels, reporter) {
+    sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                                   SkNamedGamut::kDisplayP3);
+    sk_sp<SkColorTransform> transform = SkColorTransform::Make(p3, nullptr);
+    REPORTER_ASSERT(reporter, transform);
+
+    for (SkISize size : {SkISize{37, 23}, SkISize{600, 500}}) {
+        SkBitmap src = make_noise(size.width(), size.height(), p3);
+
+        SkBitmap expected, actual;
+        expected.allocPixels(src.info().makeColorSpace(SkColorSpace::MakeSRGB()));
+        actual.allocPixels(expected.info());
+        REPORTER_ASSERT(reporter, src.readPixels(expected.pixmap()));
+        REPORTER_ASSERT(reporter, transform->apply(actual.pixmap(), src.pixmap()));
+
+        const int diff = max_diff(actual.pixmap(), expected.pixmap());
+        REPORTER_ASSERT(reporter, diff <= 1, "diff %d", diff);
+    }
+}
+
+DEF_TEST(ColorTransform_Subsets, reporter) {
+    sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                                   SkNamedGamut::kDisplayP3);
+    sk_sp<SkColorTransform> transform = SkColorTransform::Make(p3, nullptr);
+    SkBitmap src = make_noise(700, 400, p3);
+
+    // Rows that aren't contiguous are converted one at a time, into a different color type.
+    SkPixmap srcSubset;
+    SkAssertResult(src.pixmap().extractSubset(&srcSubset, SkIRect::MakeLTRB(5, 3, 650, 390)));
+    SkBitmap dst;
+    dst.allocPixels(srcSubset.info().makeColorType(kBGRA_8888_SkColorType)
+                                    .makeColorSpace(SkColorSpace::MakeSRGB()),
+                    srcSubset.info().minRowBytes() + 64);
+    REPORTER_ASSERT(reporter, transform->apply(dst.pixmap(), srcSubset));
+
+    SkBitmap expected;
+    expected.allocPixels(dst.info());
+    REPORTER_ASSERT(reporter, srcSubset.readPixels(expected.pixmap()));
+    const int diff = max_diff(dst.pixmap(), expected.pixmap());
+    REPORTER_ASSERT(reporter, diff <= 1, "diff %d", diff);
+
+    // Mismatched sizes and unsupported color types are rejected.
+    REPORTER_ASSERT(reporter, !transform->apply(dst.pixmap(), src.pixmap()));
+    SkBitmap alpha;
+    alpha.allocPixels(srcSubset.info().makeColorType(kAlpha_8_SkColorType));
+    REPORTER_ASSERT(reporter, !transform->apply(alpha.pixmap(), srcSubset));
+}
+
+DEF_TEST(ColorTransform_Cached, reporter) {
+    SkColorTransform::PurgeCache();
+
+    sk_sp<SkColorSpace> p3 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                                   SkNamedGamut::kDisplayP3);
+    sk_sp<SkColorTransform> a = SkColorTransform::Make(p3, nullptr),
+                            b = SkColorTransform::Make(SkColorSpace::MakeRGB(
+                                    SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3), nullptr);
+    REPORTER_ASSERT(reporter, a && a == b);
+    REPORTER_ASSERT(reporter, a != SkColorTransform::Make(p3, p3));
+
+    sk_sp<SkData> icc = SkWriteICCProfile(SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3);
+    sk_sp<SkColorTransform> fromICC = SkColorTransform::MakeFromICC(icc, nullptr);
+    REPORTER_ASSERT(reporter, fromICC);
+    REPORTER_ASSERT(reporter, fromICC == SkColorTransform::MakeFromICC(
+                                                 SkData::MakeWithCopy(icc->data(), icc->size()),
+                                                 nullptr));
+
+    // Transforms are matched on the profile's bytes, not just their hash; even bytes that skcms
+    // ignores (here, the header's creation date) make a separate transform.
+    sk_sp<SkData> redated = SkData::MakeWithCopy(icc->data(), icc->size());
+    static_cast<uint8_t*>(redated->writable_data())[24] ^= 1;
+    REPORTER_ASSERT(reporter, fromICC != SkColorTransform::MakeFromICC(redated, nullptr));
+
+    // The transform from the ICC bytes matches the one from the color space.
+    SkBitmap src = make_noise(64, 64, p3), viaICC, viaColorSpace;
+    viaICC.allocPixels(src.info());
+    viaColorSpace.allocPixels(src.info());
+    REPORTER_ASSERT(reporter, fromICC->apply(viaICC.pixmap(), src.pixmap()));
+    REPORTER_ASSERT(reporter, a->apply(viaColorSpace.pixmap(), src.pixmap()));
+    REPORTER_ASSERT(reporter, max_diff(viaICC.pixmap(), viaColorSpace.pixmap()) <= 1);
+
+    const char garbage[] = "not an ICC profile";
+    REPORTER_ASSERT(reporter, !SkColorTransform::MakeFromICC(
+                                      SkData::MakeWithCopy(garbage, sizeof(garbage)), nullptr));
+}
+
+DEF_TEST(ColorTransform_Baked, reporter) {
+    SkBitmap src = make_noise(300, 200, nullptr);
+
+    // A matrix/TRC profile, which is cheaper to convert exactly so is never baked, and two A2B
+    // profiles with tone-mapping CLUTs.
+    sk_sp<SkData> p3 = SkWriteICCProfile(SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3),
+                  hlg = SkWriteICCProfile(SkNamedTransferFn::kHLG, SkNamedGamut::kRec2020),
+                  pq = SkWriteICCProfile(SkNamedTransferFn::kPQ, SkNamedGamut::kRec2020);
+    for (auto [name, icc, expectBaked] : {std::make_tuple("p3", p3, false),
+                                          std::make_tuple("hlg", hlg, true),
+                                          std::make_tuple("pq", pq, true)}) {
+        sk_sp<SkColorTransform> exact = SkColorTransform::MakeFromICC(icc, nullptr),
+                                baked = SkColorTransform::MakeFromICC(
+                                        icc, nullptr, SkColorTransform::Mode::kBaked);
+        REPORTER_ASSERT(reporter, exact != baked);
+        REPORTER_ASSERT(reporter, baked->isBaked() == expectBaked, "%s", name);
+        check_baked(reporter, name, src.pixmap(), exact, baked);
+    }
+}
+
+DEF_TEST(ColorTransform_BakedCMYK, reporter) {
+    std::unique_ptr<SkCodec> codec =
+            SkCodec::MakeFromData(GetResourceAsData("images/mandrill_cmyk.jpg"));
+    if (!codec || !codec->getICCProfile()) {
+        return;
+    }
+    const skcms_ICCProfile* profile = codec->getICCProfile();
+    REPORTER_ASSERT(reporter, profile->data_color_space == skcms_Signature_CMYK);
+    sk_sp<SkData> icc = SkData::MakeWithCopy(profile->buffer, profile->size);
+
+    // The four channels of each pixel are C, M, Y and K, which skcms never unpremultiplies.
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::Make(300, 200, kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+    SkRandom rand;
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *src.getAddr32(x, y) = rand.nextU();
+        }
+    }
+    sk_sp<SkColorTransform> baked =
+            SkColorTransform::MakeFromICC(icc, nullptr, SkColorTransform::Mode::kBaked);
+    REPORTER_ASSERT(reporter, baked && baked->isBaked());
+    check_baked(reporter, "cmyk", src.pixmap(), SkColorTransform::MakeFromICC(icc, nullptr), baked);
+}
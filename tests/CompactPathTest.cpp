@@ -0,0 +1,216 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkData.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkScalar.h"
+#include "src/base/SkRandom.h"
+#include "src/core/SkCompactPath.h"
+#include "tests/Test.h"
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+static SkPath make_outline(SkRandom* rand, int contours) {
+    SkPath path;
+    SkPoint pt = {1000, 2000};
+    auto step = [&]() {
+        pt += {rand->nextRangeF(-3, 3), rand->nextRangeF(-3, 3)};
+        return pt;
+    };
+    for (int c = 0; c < contours; ++c) {
+        path.moveTo(step());
+        for (int i = 0; i < 50; ++i) {
+            switch (rand->nextULessThan(4)) {
+                case 0: path.lineTo(step()); break;
+                case 1: path.quadTo(step(), step()); break;
+                case 2: path.conicTo(step(), step(), rand->nextRangeF(0.25f, 2)); break;
+                case 3: path.cubicTo(step(), step(), step()); break;
+            }
+        }
+        if (c & 1) {
+            path.close();
+        }
+    }
+    path.setFillType(SkPathFillType::kEvenOdd);
+    return path;
+}
+
+// The number of points RawIter::next() fills in for the verb.
+static int iter_point_count(SkPath::Verb verb) {
+    switch (verb) {
+        case SkPath::kMove_Verb:  return 1;
+        case SkPath::kLine_Verb:  return 2;
+        case SkPath::kQuad_Verb:  return 3;
+        case SkPath::kConic_Verb: return 3;
+        case SkPath::kCubic_Verb: return 4;
+        default:                  return 0;
+    }
+}
+
+static void check_matches(skiatest::Reporter* r, const SkPath& path, const SkCompactPath& compact) {
+    REPORTER_ASSERT(r, compact.countVerbs() == path.countVerbs());
+    REPORTER_ASSERT(r, compact.countPoints() == path.countPoints());
+    REPORTER_ASSERT(r, compact.getFillType() == path.getFillType());
+
+    const SkScalar tolerance = compact.quantum() * 0.5f + SK_ScalarNearlyZero * 100;
+    SkPath::RawIter expected(path);
+    SkCompactPath::RawIter actual(compact);
+    SkPoint want[4], got[4];
+    for (;;) {
+        SkPath::Verb verb = expected.next(want);
+        REPORTER_ASSERT(r, actual.next(got) == verb);
+        if (verb == SkPath::kDone_Verb) {
+            break;
+        }
+        for (int i = 0; i < iter_point_count(verb); ++i) {
+            REPORTER_ASSERT(r, SkScalarAbs(want[i].fX - got[i].fX) <= tolerance &&
+                               SkScalarAbs(want[i].fY - got[i].fY) <= tolerance);
+        }
+        if (verb == SkPath::kConic_Verb) {
+            REPORTER_ASSERT(r, expected.conicWeight() == actual.conicWeight());
+        }
+    }
+
+    // Decoding to a path gives the same points as the iterator.
+    SkPath decoded = compact.toPath();
+    REPORTER_ASSERT(r, decoded.countVerbs() == path.countVerbs());
+    REPORTER_ASSERT(r, decoded.getFillType() == path.getFillType());
+    REPORTER_ASSERT(r, decoded.getBounds() == compact.getBounds());
+    std::vector<SkPoint> points;
+    SkCompactPath::RawIter again(compact);
+    for (SkPath::Verb verb; (verb = again.next(got)) != SkPath::kDone_Verb;) {
+        // Every verb but kMove repeats the previous point first.
+        for (int i = verb == SkPath::kMove_Verb ? 0 : 1; i < iter_point_count(verb); ++i) {
+            points.push_back(got[i]);
+        }
+    }
+    REPORTER_ASSERT(r, (int)points.size() == decoded.countPoints());
+    for (int i = 0; i < decoded.countPoints(); ++i) {
+        REPORTER_ASSERT(r, decoded.getPoint(i) == points[i]);
+    }
+}
+
+DEF_TEST(CompactPath, r) {
+    SkRandom rand;
+    SkPath path = make_outline(&rand, 8);
+
+    std::optional<SkCompactPath> compact = SkCompactPath::Make(path);
+    REPORTER_ASSERT(r, compact);
+    check_matches(r, path, *compact);
+
+    // Small steps between neighboring points fit in a few bytes each.
+    size_t pointBytes = path.countPoints() * sizeof(SkPoint);
+    REPORTER_ASSERT(r, compact->serialize()->size() < pointBytes / 2);
+
+    // A coarser grid is smaller still.
+    std::optional<SkCompactPath> coarse = SkCompactPath::Make(path, 1);
+    REPORTER_ASSERT(r, coarse);
+    check_matches(r, path, *coarse);
+    REPORTER_ASSERT(r, coarse->serialize()->size() < compact->serialize()->size());
+
+    // Paths that can't be encoded.
+    REPORTER_ASSERT(r, !SkCompactPath::Make(path, 0));
+    REPORTER_ASSERT(r, !SkCompactPath::Make(path, SK_ScalarNaN));
+    REPORTER_ASSERT(r, !SkCompactPath::Make(SkPath().lineTo(SK_ScalarInfinity, 0)));
+    REPORTER_ASSERT(r, !SkCompactPath::Make(SkPath().lineTo(1e9f, 0), 1.0f / 64));
+
+    // Empty paths.
+    SkCompactPath empty;
+    REPORTER_ASSERT(r, empty.isEmpty());
+    REPORTER_ASSERT(r, empty.toPath().isEmpty());
+    check_matches(r, SkPath(), *SkCompactPath::Make(SkPath()));
+}
+
+DEF_TEST(CompactPath_Serialization, r) {
+    SkRandom rand;
+    SkPath path = make_outline(&rand, 3);
+    SkCompactPath compact = *SkCompactPath::Make(path);
+
+    size_t size = compact.writeToMemory(nullptr);
+    REPORTER_ASSERT(r, size % 4 == 0);
+    std::vector<uint8_t> storage(size + 8);
+    REPORTER_ASSERT(r, compact.writeToMemory(storage.data()) == size);
+
+    size_t bytesRead = 0;
+    std::optional<SkCompactPath> readBack =
+            SkCompactPath::MakeFromMemory(storage.data(), storage.size(), &bytesRead);
+    REPORTER_ASSERT(r, readBack);
+    REPORTER_ASSERT(r, bytesRead == size);
+    REPORTER_ASSERT(r, readBack->toPath() == compact.toPath());
+
+    // SkPath reads the compact form too.
+    SkPath asPath;
+    REPORTER_ASSERT(r, asPath.readFromMemory(storage.data(), storage.size()) == size);
+    REPORTER_ASSERT(r, asPath == compact.toPath());
+
+    // Truncated or corrupted data is rejected.
+    REPORTER_ASSERT(r, !SkCompactPath::MakeFromMemory(storage.data(), size - 4));
+    REPORTER_ASSERT(r, SkPath().readFromMemory(storage.data(), size - 4) == 0);
+    for (size_t i = 0; i < size; i += 7) {
+        std::vector<uint8_t> corrupt(storage.begin(), storage.begin() + size);
+        corrupt[i] ^= 0xA5;
+        if (auto bad = SkCompactPath::MakeFromMemory(corrupt.data(), corrupt.size())) {
+            // Whatever was accepted must still decode safely.
+            bad->toPath();
+        }
+    }
+}
+
+// Writes value as a five byte varint, the longest form that readers accept.
+static void write_long_varint(uint32_t value, uint8_t* dst) {
+    for (int i = 0; i < 5; ++i) {
+        dst[i] = (value & 0x7F) | (i < 4 ? 0x80 : 0);
+        value >>= 7;
+    }
+}
+
+DEF_TEST(CompactPath_UntrustedData, r) {
+    // The encoded data starts with a 40 byte header, followed by the conic weights, the verbs and
+    // the points.
+    static constexpr size_t kHeaderSize = 40;
+
+    // Conic weights must be finite and positive.
+    SkPath conic;
+    conic.moveTo(0, 0);
+    conic.conicTo(10, 0, 10, 10, 0.5f);
+    SkCompactPath compactConic = *SkCompactPath::Make(conic);
+    std::vector<uint8_t> storage(compactConic.writeToMemory(nullptr));
+    compactConic.writeToMemory(storage.data());
+    REPORTER_ASSERT(r, SkCompactPath::MakeFromMemory(storage.data(), storage.size()));
+    for (SkScalar weight : {-1.0f, 0.0f, SK_ScalarNaN, SK_ScalarInfinity}) {
+        std::vector<uint8_t> bad = storage;
+        memcpy(bad.data() + kHeaderSize, &weight, sizeof(weight));
+        REPORTER_ASSERT(r, !SkCompactPath::MakeFromMemory(bad.data(), bad.size()));
+        REPORTER_ASSERT(r, SkPath().readFromMemory(bad.data(), bad.size()) == 0);
+    }
+
+    // Points at opposite corners of a large grid take five bytes per coordinate.
+    SkPath lines;
+    lines.moveTo(1e9f, 1e9f);
+    lines.lineTo(0, 0);
+    lines.lineTo(1e9f, 1e9f);
+    SkCompactPath compactLines = *SkCompactPath::Make(lines, 1);
+    storage.resize(compactLines.writeToMemory(nullptr));
+    compactLines.writeToMemory(storage.data());
+    REPORTER_ASSERT(r, SkCompactPath::MakeFromMemory(storage.data(), storage.size()));
+
+    // Deltas that would overflow a 32-bit sum are rejected: step to the edge of the grid, then
+    // step by the largest positive delta.
+    uint8_t* points = storage.data() + kHeaderSize + lines.countVerbs();
+    write_long_varint(1u << 31, points);         // +2^30
+    write_long_varint(1u << 31, points + 5);
+    write_long_varint(0xFFFFFFFE, points + 10);  // +2^31 - 1
+    write_long_varint(0xFFFFFFFE, points + 15);
+    REPORTER_ASSERT(r, !SkCompactPath::MakeFromMemory(storage.data(), storage.size()));
+    REPORTER_ASSERT(r, SkPath().readFromMemory(storage.data(), storage.size()) == 0);
+}
@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -145,3 +147,84 @@ DEF_TEST(DashCrazy_crbug_875494, r) {
     skpathutils::FillPathWithPaint(path, paint, &path2, &cull);
 }
 
+
+static SkBitmap draw_culled(const SkPath& path, const SkRect& cull) {
+    SkBitmap bm;
+    bm.allocN32Pixels(SkScalarCeilToInt(cull.width()), SkScalarCeilToInt(cull.height()));
+    bm.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bm);
+    canvas.translate(-cull.fLeft, -cull.fTop);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas.drawPath(path, paint);
+    return bm;
+}
+
+// Dashes of curves far outside the cull rect should be skipped, without changing what is drawn
+// inside it.
+DEF_TEST(DashPath_CullCurves, r) {
+    SkPath route;
+    route.moveTo(0, 0);
+    for (int i = 0; i < 2000; ++i) {
+        SkScalar x = i * 50.0f;
+        switch (i % 3) {
+            case 0:
+                route.quadTo(x + 25, i % 2 ? 40 : -40, x + 50, 0);
+                break;
+            case 1:
+                route.cubicTo(x + 10, 30, x + 40, -30, x + 50, 0);
+                break;
+            case 2:
+                route.conicTo(x + 25, i % 2 ? 40 : -40, x + 50, 0, 0.7f);
+                break;
+        }
+    }
+
+    const SkScalar intervals[] = {10, 5};
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    paint.setPathEffect(SkDashPathEffect::Make(intervals, std::size(intervals), 2));
+
+    for (SkPaint::Cap cap : {SkPaint::kButt_Cap, SkPaint::kSquare_Cap}) {
+        paint.setStrokeCap(cap);
+        const SkRect cull = SkRect::MakeXYWH(40000.5f, -50, 100, 100);
+
+        SkPath full, culled;
+        skpathutils::FillPathWithPaint(route, paint, &full);
+        skpathutils::FillPathWithPaint(route, paint, &culled, &cull);
+        REPORTER_ASSERT(r, culled.countVerbs() * 100 < full.countVerbs());
+
+        SkBitmap expected = draw_culled(full, cull);
+        SkBitmap actual = draw_culled(culled, cull);
+        int mismatches = 0;
+        for (int y = 0; y < expected.height(); ++y) {
+            for (int x = 0; x < expected.width(); ++x) {
+                mismatches += expected.getColor(x, y) != actual.getColor(x, y);
+            }
+        }
+        REPORTER_ASSERT(r, mismatches == 0, "cap %d: %d pixels differ", cap, mismatches);
+    }
+}
+
+// A curve with far too many dashes to dash in full can still be dashed where it is visible.
+DEF_TEST(DashPath_CullHugeCurve, r) {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.cubicTo(3e6f, 1e6f, 7e6f, -1e6f, 1e7f, 0);
+
+    const SkScalar intervals[] = {1, 1};
+    sk_sp<SkPathEffect> dash = SkDashPathEffect::Make(intervals, std::size(intervals), 0);
+    const SkRect cull = SkRect::MakeXYWH(0, -50, 100, 100);
+
+    SkPath dst;
+    SkStrokeRec rec(SkStrokeRec::kHairline_InitStyle);
+    REPORTER_ASSERT(r, !dash->filterPath(&dst, path, &rec, nullptr));
+
+    dst.reset();
+    rec = SkStrokeRec(SkStrokeRec::kHairline_InitStyle);
+    REPORTER_ASSERT(r, dash->filterPath(&dst, path, &rec, &cull));
+    REPORTER_ASSERT(r, !dst.isEmpty());
+    REPORTER_ASSERT(r, dst.getBounds().intersects(cull));
+    REPORTER_ASSERT(r, dst.getBounds().fRight < 1e6f);
+}
@@ -231,6 +231,20 @@ DEF_TEST(HashSetCtorOneElem, r) {
     REPORTER_ASSERT(r, !set.contains("three"));
 }
 
+DEF_TEST(HashSetCtorCapacityIsPow2, r) {
+    // Lookups mask the hash with capacity-1, so the initializer list constructor must round its
+    // capacity up to a power of two: 10 * 5/3 = 16 slots, 12 * 5/3 = 20 -> 32 slots.
+    THashSet<int> ten{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    REPORTER_ASSERT(r, ten.capacity() == 16);
+
+    THashSet<int> twelve{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    REPORTER_ASSERT(r, twelve.capacity() == 32);
+    for (int i = 0; i < 12; i++) {
+        REPORTER_ASSERT(r, twelve.contains(i));
+    }
+    REPORTER_ASSERT(r, !twelve.contains(12));
+}
+
 template <typename T>
 static void test_hash_set(skiatest::Reporter* r) {
     THashSet<T> set;
@@ -21,6 +21,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTraceMemoryDump.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/gpu/GrBackendSurface.h"
@@ -43,10 +44,14 @@
 #include "tests/Test.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
 #include <tuple>
 #include <utility>
 
 class GrRecordingContext;
+class SkDiscardableMemory;
 struct GrContextOptions;
 
 static const int kSmallerSize = 10;
@@ -184,6 +189,93 @@ static void test_explicit_purging(skiatest::Reporter* reporter,
     REPORTER_ASSERT(reporter, !cache->get(key2, &foundImage));
 }
 
+// Test that entries which are cheaper to recompute per byte are purged first
+static void test_cost_aware_purge(skiatest::Reporter* reporter,
+                                  const sk_sp<SkSpecialImage>& image) {
+    SkASSERT(image->getSize());
+    const size_t kCacheSize = 2 * image->getSize() + 10;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    SkIRect clip = SkIRect::MakeWH(100, 100);
+    SkImageFilterCacheKey key1(0, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey key2(1, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey key3(2, SkMatrix::I(), clip, image->uniqueID(), image->subset());
+
+    SkIPoint offset = SkIPoint::Make(3, 4);
+    auto filter = make_filter();
+    cache->set(key1, filter.get(), skif::FilterResult(image, skif::LayerSpace<SkIPoint>(offset)),
+               /*recomputeNanos=*/1000000);
+    cache->set(key2, filter.get(), skif::FilterResult(image, skif::LayerSpace<SkIPoint>(offset)),
+               /*recomputeNanos=*/10);
+
+    // key2 is the most recently used, but key1 is much more expensive to recompute
+    skif::FilterResult foundImage;
+    REPORTER_ASSERT(reporter, cache->get(key2, &foundImage));
+    cache->set(key3, filter.get(), skif::FilterResult(image, skif::LayerSpace<SkIPoint>(offset)),
+               /*recomputeNanos=*/10);
+
+    REPORTER_ASSERT(reporter, cache->get(key1, &foundImage));
+    REPORTER_ASSERT(reporter, !cache->get(key2, &foundImage));
+    REPORTER_ASSERT(reporter, cache->get(key3, &foundImage));
+}
+
+class StatsTraceMemoryDump : public SkTraceMemoryDump {
+public:
+    void dumpNumericValue(const char* dumpName, const char* valueName, const char* units,
+                          uint64_t value) override {
+        fValues[std::string(dumpName) + ":" + valueName] = value;
+    }
+    void setMemoryBacking(const char*, const char*, const char*) override {}
+    void setDiscardableMemoryBacking(const char*, const SkDiscardableMemory&) override {}
+    LevelOfDetail getRequestedDetails() const override {
+        return SkTraceMemoryDump::kObjectsBreakdowns_LevelOfDetail;
+    }
+
+    std::map<std::string, uint64_t> fValues;
+};
+
+// Test the per-filter stats and their memory dump
+static void test_filter_stats(skiatest::Reporter* reporter, const sk_sp<SkSpecialImage>& image) {
+    static const size_t kCacheSize = 1000000;
+    sk_sp<SkImageFilterCache> cache(SkImageFilterCache::Create(kCacheSize));
+
+    SkIRect clip1 = SkIRect::MakeWH(100, 100);
+    SkIRect clip2 = SkIRect::MakeWH(200, 200);
+    SkImageFilterCacheKey key1(7, SkMatrix::I(), clip1, image->uniqueID(), image->subset());
+    SkImageFilterCacheKey key2(7, SkMatrix::I(), clip2, image->uniqueID(), image->subset());
+
+    SkIPoint offset = SkIPoint::Make(3, 4);
+    auto filter = make_filter();
+    skif::FilterResult foundImage;
+    REPORTER_ASSERT(reporter, !cache->get(key1, &foundImage));
+    cache->set(key1, filter.get(), skif::FilterResult(image, skif::LayerSpace<SkIPoint>(offset)),
+               /*recomputeNanos=*/300);
+    cache->set(key2, filter.get(), skif::FilterResult(image, skif::LayerSpace<SkIPoint>(offset)),
+               /*recomputeNanos=*/200);
+    REPORTER_ASSERT(reporter, cache->get(key1, &foundImage));
+    REPORTER_ASSERT(reporter, cache->get(key2, &foundImage));
+    REPORTER_ASSERT(reporter, cache->get(key2, &foundImage));
+
+    SkImageFilterCache::FilterStats stats = cache->getFilterStats(7);
+    REPORTER_ASSERT(reporter, stats.fHits == 3);
+    REPORTER_ASSERT(reporter, stats.fMisses == 1);
+    REPORTER_ASSERT(reporter, stats.fBytes == 2 * image->getSize());
+    REPORTER_ASSERT(reporter, stats.fRecomputeNanos == 500);
+
+    StatsTraceMemoryDump dump;
+    cache->dumpMemoryStatistics(&dump);
+    REPORTER_ASSERT(reporter,
+                    dump.fValues[std::string("skia/sk_image_filter_cache:size")] ==
+                    2 * image->getSize());
+    REPORTER_ASSERT(reporter,
+                    dump.fValues[std::string("skia/sk_image_filter_cache/filter_7:hits")] == 3);
+    REPORTER_ASSERT(reporter,
+                    dump.fValues[std::string("skia/sk_image_filter_cache/filter_7:misses")] == 1);
+
+    cache->purge();
+    REPORTER_ASSERT(reporter, cache->getFilterStats(7).fBytes == 0);
+}
+
 DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     SkBitmap srcBM = create_bm();
 
@@ -200,6 +292,8 @@ DEF_TEST(ImageFilterCache_RasterBacked, reporter) {
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_cost_aware_purge(reporter, fullImg);
+    test_filter_stats(reporter, fullImg);
 }
 
 
@@ -229,6 +323,8 @@ static void test_image_backed(skiatest::Reporter* reporter,
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_cost_aware_purge(reporter, fullImg);
+    test_filter_stats(reporter, fullImg);
 }
 
 DEF_TEST(ImageFilterCache_ImageBackedRaster, reporter) {
@@ -328,6 +424,8 @@ DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(ImageFilterCache_GPUBacked,
     test_dont_find_if_diff_key(reporter, fullImg, subsetImg);
     test_internal_purge(reporter, fullImg);
     test_explicit_purging(reporter, fullImg, subsetImg);
+    test_cost_aware_purge(reporter, fullImg);
+    test_filter_stats(reporter, fullImg);
 }
 
 DEF_SERIAL_TEST(PurgeImageFilterCache, r) {
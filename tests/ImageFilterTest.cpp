@@ -12,6 +12,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkFlattenable.h"
@@ -44,6 +45,7 @@
 #include "include/gpu/GrTypes.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTo.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkBitmapDevice.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkImageFilterTypes.h"
@@ -79,7 +81,9 @@
 #endif
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <utility>
 #include <limits>
@@ -703,6 +707,73 @@ DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(MorphologyFilterRadiusWithMirrorCTM_Gpu,
     test_morphology_radius_with_mirror_ctm(reporter, ctxInfo.directContext());
 }
 
+DEF_TEST(MorphologyFilterMatchesBruteForce, reporter) {
+    // Premultiplied random pixels, with some fully transparent ones.
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(53, 37);
+    SkRandom random;
+    for (int y = 0; y < srcBM.height(); ++y) {
+        for (int x = 0; x < srcBM.width(); ++x) {
+            uint32_t a = random.nextBool() ? random.nextULessThan(256) : 0;
+            *srcBM.getAddr32(x, y) = SkPackARGB32(a, random.nextULessThan(a + 1),
+                                                  random.nextULessThan(a + 1),
+                                                  random.nextULessThan(a + 1));
+        }
+    }
+    srcBM.setImmutable();
+    sk_sp<SkImage> src = srcBM.asImage();
+
+    const SkISize kRadii[] = {{0, 3}, {5, 0}, {1, 1}, {7, 2}, {40, 25}};
+    for (bool dilate : {false, true}) {
+        for (SkISize radii : kRadii) {
+            sk_sp<SkImageFilter> filter =
+                    dilate ? SkImageFilters::Dilate(radii.width(), radii.height(), nullptr)
+                           : SkImageFilters::Erode(radii.width(), radii.height(), nullptr);
+
+            const SkIRect clip = srcBM.bounds().makeOutset(10, 10);
+            SkIRect outSubset;
+            SkIPoint offset;
+            sk_sp<SkImage> result = SkImages::MakeWithFilter(src, filter.get(), srcBM.bounds(),
+                                                             clip, &outSubset, &offset);
+            SkBitmap resultBM;
+            if (result) {
+                REPORTER_ASSERT(reporter, result->asLegacyBitmap(&resultBM));
+            }
+
+            int errors = 0;
+            for (int y = clip.top(); y < clip.bottom(); ++y) {
+                for (int x = clip.left(); x < clip.right(); ++x) {
+                    // Per-channel min or max over the kernel, transparent outside of src.
+                    uint32_t expected = dilate ? 0 : 0xFFFFFFFF;
+                    for (int ky = y - radii.height(); ky <= y + radii.height(); ++ky) {
+                        for (int kx = x - radii.width(); kx <= x + radii.width(); ++kx) {
+                            uint32_t px = srcBM.bounds().contains(kx, ky)
+                                                  ? *srcBM.getAddr32(kx, ky) : 0;
+                            uint32_t merged = 0;
+                            for (int shift = 0; shift < 32; shift += 8) {
+                                uint32_t a = (expected >> shift) & 0xFF,
+                                         b = (px >> shift) & 0xFF;
+                                merged |= (dilate ? std::max(a, b) : std::min(a, b)) << shift;
+                            }
+                            expected = merged;
+                        }
+                    }
+
+                    const int rx = x - offset.x() + outSubset.left(),
+                              ry = y - offset.y() + outSubset.top();
+                    const uint32_t actual = result && outSubset.contains(rx, ry)
+                                                    ? *resultBM.getAddr32(rx, ry) : 0;
+                    if (actual != expected) {
+                        ++errors;
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, errors == 0, "%s (%d, %d): %d mismatched pixels",
+                            dilate ? "dilate" : "erode", radii.width(), radii.height(), errors);
+        }
+    }
+}
+
 static void test_zero_blur_sigma(skiatest::Reporter* reporter, GrDirectContext* dContext) {
     // Check that SkBlurImageFilter with a zero sigma and a non-zero srcOffset works correctly.
     SkIRect cropRect = SkIRect::MakeXYWH(5, 0, 5, 10);
@@ -1264,6 +1335,120 @@ DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(ImageFilterMatrixConvolutionBigKernel_Gpu
     test_big_kernel(reporter, ctxInfo.directContext());
 }
 
+DEF_TEST(ImageFilterMatrixConvolutionLowRank, reporter) {
+    // Premultiplied random pixels, with some fully transparent ones.
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(53, 37);
+    SkRandom random;
+    for (int y = 0; y < srcBM.height(); ++y) {
+        for (int x = 0; x < srcBM.width(); ++x) {
+            uint32_t a = random.nextBool() ? random.nextULessThan(256) : 0;
+            *srcBM.getAddr32(x, y) = SkPackARGB32(a, random.nextULessThan(a + 1),
+                                                  random.nextULessThan(a + 1),
+                                                  random.nextULessThan(a + 1));
+        }
+    }
+    srcBM.setImmutable();
+    sk_sp<SkImage> src = srcBM.asImage();
+
+    struct Kernel {
+        SkISize fSize;
+        SkIPoint fOffset;
+        float fGain, fBias;
+        bool fConvolveAlpha;
+        TArray<float> fValues;
+    };
+    Kernel kernels[] = {
+        // Sobel, rank 1
+        {{3, 3}, {1, 1}, 1.f, 0.f, false, TArray<float>{-1, 0, 1, -2, 0, 2, -1, 0, 1}},
+        // Sharpen as in MatrixConvolutionBench, rank 2
+        {{9, 9}, {4, 4}, 0.3f, 100.f, true, {}},
+        // Gaussian, rank 1
+        {{15, 15}, {3, 10}, 1.f, 0.f, true, {}},
+        // Random, full rank, so it is applied by the shader
+        {{3, 3}, {2, 0}, 0.5f, 10.f, false, {}},
+    };
+    kernels[1].fValues.push_back_n(81, 1.f);
+    kernels[1].fValues[40] = -79.f;
+    for (int y = 0; y < 15; ++y) {
+        for (int x = 0; x < 15; ++x) {
+            kernels[2].fValues.push_back(std::exp(-((x - 7) * (x - 7) + (y - 7) * (y - 7)) / 18.f) /
+                                         (2 * SK_FloatPI * 9.f));
+        }
+    }
+    for (int i = 0; i < 9; ++i) {
+        kernels[3].fValues.push_back(random.nextRangeF(-1.f, 1.f));
+    }
+
+    for (const Kernel& k : kernels) {
+        sk_sp<SkImageFilter> filter = SkImageFilters::MatrixConvolution(
+                k.fSize, k.fValues.data(), k.fGain, k.fBias, k.fOffset, SkTileMode::kDecal,
+                k.fConvolveAlpha, nullptr);
+
+        const SkIRect clip = srcBM.bounds().makeOutset(10, 10);
+        SkIRect outSubset;
+        SkIPoint offset;
+        sk_sp<SkImage> result = SkImages::MakeWithFilter(src, filter.get(), srcBM.bounds(),
+                                                         clip, &outSubset, &offset);
+        SkBitmap resultBM;
+        if (result) {
+            REPORTER_ASSERT(reporter, result->asLegacyBitmap(&resultBM));
+        }
+
+        // Reads srcBM as floats, unpremultiplied when alpha is kept, and transparent outside.
+        auto load = [&](int x, int y, int channel) -> float {
+            if (!srcBM.bounds().contains(x, y)) {
+                return 0.f;
+            }
+            const SkPMColor c = *srcBM.getAddr32(x, y);
+            const float a = SkGetPackedA32(c) / 255.f;
+            const uint32_t channels[4] = {SkGetPackedR32(c), SkGetPackedG32(c),
+                                          SkGetPackedB32(c), SkGetPackedA32(c)};
+            const float v = channels[channel] / 255.f;
+            return k.fConvolveAlpha || channel == 3 ? v : (a > 0 ? v / a : 0.f);
+        };
+
+        int errors = 0;
+        for (int y = clip.top(); y < clip.bottom(); ++y) {
+            for (int x = clip.left(); x < clip.right(); ++x) {
+                float color[4];
+                for (int c = 0; c < 4; ++c) {
+                    float sum = 0;
+                    for (int ky = 0; ky < k.fSize.height(); ++ky) {
+                        for (int kx = 0; kx < k.fSize.width(); ++kx) {
+                            sum += k.fValues[ky * k.fSize.width() + kx] *
+                                   load(x + kx - k.fOffset.x(), y + ky - k.fOffset.y(), c);
+                        }
+                    }
+                    color[c] = sum * k.fGain + k.fBias / 255.f;
+                }
+                const float a = k.fConvolveAlpha ? SkTPin(color[3], 0.f, 1.f) : load(x, y, 3);
+                int expected[4];
+                for (int c = 0; c < 3; ++c) {
+                    const float v = k.fConvolveAlpha ? color[c] : color[c] * a;
+                    expected[c] = (int) std::lrint(SkTPin(v, 0.f, a) * 255);
+                }
+                expected[3] = (int) std::lrint(a * 255);
+
+                const int rx = x - offset.x() + outSubset.left(),
+                          ry = y - offset.y() + outSubset.top();
+                const SkPMColor actual = result && outSubset.contains(rx, ry)
+                                                 ? *resultBM.getAddr32(rx, ry) : 0;
+                const int actualChannels[4] = {SkGetPackedR32(actual), SkGetPackedG32(actual),
+                                               SkGetPackedB32(actual), SkGetPackedA32(actual)};
+                for (int c = 0; c < 4; ++c) {
+                    if (std::abs(actualChannels[c] - expected[c]) > 1) {
+                        ++errors;
+                        break;
+                    }
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, errors == 0, "%dx%d kernel: %d mismatched pixels",
+                        k.fSize.width(), k.fSize.height(), errors);
+    }
+}
+
 DEF_TEST(ImageFilterCropRect, reporter) {
     test_cropRects(reporter, nullptr);
 }
@@ -2327,3 +2512,80 @@ DEF_TEST(DropShadowImageFilter_Huge, reporter) {
     surf->getCanvas()->saveLayer(nullptr, &paint);
     surf->getCanvas()->restore();
 }
+
+DEF_TEST(ImageFilterTiledMatchesUntiled, reporter) {
+    // Large enough that the raster backend splits the output into tiles, when the default executor
+    // is multi-threaded (as it is in DM).
+    static constexpr int kWidth = 1300;
+    static constexpr int kHeight = 700;
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kWidth, kHeight);
+    sk_sp<SkSurface> contentSurface = SkSurfaces::Raster(info);
+    SkCanvas* contentCanvas = contentSurface->getCanvas();
+    SkPaint paint;
+    const SkPoint gradientPts[] = {{0, 0}, {kWidth, kHeight}};
+    const SkColor gradientColors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+    paint.setShader(SkGradientShader::MakeLinear(gradientPts, gradientColors, nullptr, 3,
+                                                 SkTileMode::kClamp));
+    contentCanvas->drawPaint(paint);
+    paint.setShader(nullptr);
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 40; ++i) {
+        paint.setColor(i % 2 ? SK_ColorWHITE : SK_ColorBLACK);
+        contentCanvas->drawCircle(37.f * i, 17.f * i, 30, paint);
+    }
+    sk_sp<SkImage> content = contentSurface->makeImageSnapshot();
+
+    sk_sp<SkImageFilter> filters[] = {
+        // blur -> displacement -> lighting, so each tile requires a margin of input around it.
+        SkImageFilters::DistantLitDiffuse(
+                SkPoint3::Make(1, 1, 1), SK_ColorWHITE, /*surfaceScale=*/2, /*kd=*/1,
+                SkImageFilters::DisplacementMap(SkColorChannel::kR, SkColorChannel::kG,
+                                                /*scale=*/20,
+                                                SkImageFilters::Blur(6, 6, nullptr), nullptr)),
+        // Sigmas above 32 are blurred at a lower resolution, which must not show the tile seams.
+        SkImageFilters::Blur(33, 33, nullptr),
+        SkImageFilters::Blur(40, 40, nullptr),
+        SkImageFilters::Offset(5, 5, SkImageFilters::DropShadow(10, 10, 40, 40, SK_ColorBLACK,
+                                                                nullptr)),
+    };
+    for (const sk_sp<SkImageFilter>& filter : filters) {
+        // The canvas evaluates the filter in tiles when it can run them in parallel.
+        sk_sp<SkSurface> tiled = SkSurfaces::Raster(info);
+        SkPaint filterPaint;
+        filterPaint.setImageFilter(filter);
+        tiled->getCanvas()->drawImage(content, 0, 0, SkSamplingOptions(), &filterPaint);
+
+        // SkImages::MakeWithFilter() evaluates the whole output at once.
+        SkIRect outSubset;
+        SkIPoint offset;
+        sk_sp<SkImage> untiledImage = SkImages::MakeWithFilter(content, filter.get(), info.bounds(),
+                                                               info.bounds(), &outSubset, &offset);
+        REPORTER_ASSERT(reporter, untiledImage);
+        sk_sp<SkSurface> untiled = SkSurfaces::Raster(info);
+        untiled->getCanvas()->drawImageRect(untiledImage, SkRect::Make(outSubset),
+                                            SkRect::Make(outSubset.makeOffset(offset -
+                                                                              outSubset.topLeft())),
+                                            SkSamplingOptions(), nullptr,
+                                            SkCanvas::kStrict_SrcRectConstraint);
+
+        SkBitmap tiledPixels, untiledPixels;
+        tiledPixels.allocPixels(info);
+        untiledPixels.allocPixels(info);
+        tiled->readPixels(tiledPixels, 0, 0);
+        untiled->readPixels(untiledPixels, 0, 0);
+
+        int maxDiff = 0;
+        for (int y = 0; y < kHeight; ++y) {
+            for (int x = 0; x < kWidth; ++x) {
+                SkColor a = tiledPixels.getColor(x, y);
+                SkColor b = untiledPixels.getColor(x, y);
+                for (int shift = 0; shift < 32; shift += 8) {
+                    maxDiff = std::max(maxDiff, std::abs(int((a >> shift) & 0xFF) -
+                                                         int((b >> shift) & 0xFF)));
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 1, "max difference %d", maxDiff);
+    }
+}
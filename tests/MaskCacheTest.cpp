@@ -6,9 +6,12 @@
  */
 
 #include "include/core/SkBlurTypes.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPoint.h"
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkScalar.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "src/base/SkTLazy.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkMask.h"
@@ -16,7 +19,9 @@
 #include "src/core/SkResourceCache.h"
 #include "tests/Test.h"
 
+#include <cmath>
 #include <cstring>
+#include <iterator>
 
 enum LockedState {
     kUnlocked,
@@ -108,3 +113,61 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(ConvexPathMaskCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkScalar sigma = 0.8f;
+    SkPath path = SkPath::Polygon({{10.5f, 20}, {60, 25}, {40.25f, 70}}, /*isClosed=*/true);
+    SkBlurStyle style = kNormal_SkBlurStyle;
+    SkTLazy<SkMask> lazyMask;
+    REPORTER_ASSERT(reporter, SkMaskCache::CanCacheConvexPath(path));
+
+    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, path, &lazyMask, &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+    REPORTER_ASSERT(reporter, !lazyMask.isValid());
+
+    size_t size = 256;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    SkMask mask(nullptr, SkIRect::MakeXYWH(0, 0, 100, 100), 100, SkMask::kBW_Format);
+    SkMaskCache::Add(sigma, style, path, mask, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    // The same shape at another integer translation finds the same entry; at a fractional
+    // translation, it does not.
+    SkPath translated;
+    path.offset(7, -3, &translated);
+    lazyMask.reset();
+    data = SkMaskCache::FindAndRef(sigma, style, translated, &lazyMask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, data->size() == size);
+    REPORTER_ASSERT(reporter, data->data() == static_cast<const void*>(lazyMask->fImage));
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    path.offset(0.5f, 0, &translated);
+    SkTLazy<SkMask> otherMask;
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, translated, &otherMask,
+                                                       &cache));
+
+    cache.purgeAll();
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+
+    // Concave paths and paths with too many points aren't cached.
+    SkPath concave = SkPath::Polygon({{0, 0}, {10, 5}, {20, 0}, {10, 20}}, /*isClosed=*/true);
+    REPORTER_ASSERT(reporter, !SkMaskCache::CanCacheConvexPath(concave));
+    REPORTER_ASSERT(reporter, SkMaskCache::CanCacheConvexPath(SkPath::Circle(50, 50, 40)));
+
+    SkPoint points[SkMaskCache::kMaxConvexPathPoints + 1];
+    for (int i = 0; i < (int)std::size(points); ++i) {
+        const float angle = 2 * SK_FloatPI * i / std::size(points);
+        points[i] = {50 + 40 * std::cos(angle), 50 + 40 * std::sin(angle)};
+    }
+    SkPath polygon = SkPath::Polygon(points, (int)std::size(points), /*isClosed=*/true);
+    REPORTER_ASSERT(reporter, polygon.isConvex());
+    REPORTER_ASSERT(reporter, !SkMaskCache::CanCacheConvexPath(polygon));
+}
@@ -21,12 +21,16 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkTo.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkMipmapBuilder.h"
 #include "tests/Test.h"
 #include "tools/DecodeUtils.h"
 
+#include <cstdint>
+#include <cstring>
+
 static void make_bitmap(SkBitmap* bm, int width, int height) {
     bm->allocN32Pixels(width, height);
     bm->eraseColor(SK_ColorWHITE);
@@ -235,6 +239,74 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+static void fill_random(SkBitmap* bm, SkRandom* rand) {
+    for (int y = 0; y < bm->height(); ++y) {
+        uint8_t* row = static_cast<uint8_t*>(bm->getAddr(0, y));
+        for (size_t i = 0; i < bm->info().minRowBytes(); ++i) {
+            row[i] = SkToU8(rand->nextU());
+        }
+    }
+}
+
+// The first level of an even-sized image is a 2x2 box filter of the base, truncated per channel.
+DEF_TEST(MipMap_BoxFilterBytes, reporter) {
+    SkRandom rand;
+    for (SkColorType ct : {kRGBA_8888_SkColorType, kR8G8_unorm_SkColorType,
+                           kAlpha_8_SkColorType}) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::Make(74, 6, ct, kPremul_SkAlphaType));
+        fill_random(&bm, &rand);
+
+        sk_sp<SkMipmap> mipmap(SkMipmap::Build(bm, nullptr));
+        SkMipmap::Level level;
+        REPORTER_ASSERT(reporter, mipmap && mipmap->getLevel(0, &level));
+        const SkPixmap& dst = level.fPixmap;
+        const int bpp = bm.bytesPerPixel();
+        for (int y = 0; y < dst.height(); ++y) {
+            const uint8_t* src0 = static_cast<const uint8_t*>(bm.getAddr(0, 2 * y));
+            const uint8_t* src1 = static_cast<const uint8_t*>(bm.getAddr(0, 2 * y + 1));
+            const uint8_t* d = static_cast<const uint8_t*>(dst.addr(0, y));
+            for (int i = 0; i < dst.width() * bpp; ++i) {
+                const int x = i / bpp * 2 * bpp + i % bpp;
+                const int expected = (src0[x] + src0[x + bpp] + src1[x] + src1[x + bpp]) >> 2;
+                if (d[i] != expected) {
+                    ERRORF(reporter, "ct %d, (%d, %d) byte %d: got %d, expected %d",
+                           ct, i / bpp, y, i % bpp, d[i], expected);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(MipMap_Lazy, reporter) {
+    SkRandom rand;
+    for (SkISize size : {SkISize{300, 200}, SkISize{301, 199}, SkISize{1, 77}}) {
+        SkBitmap bm;
+        bm.allocN32Pixels(size.width(), size.height());
+        fill_random(&bm, &rand);
+
+        sk_sp<SkMipmap> eager(SkMipmap::Build(bm, nullptr));
+        sk_sp<SkMipmap> lazy(SkMipmap::BuildLazy(bm, nullptr));
+        REPORTER_ASSERT(reporter, eager && lazy);
+        REPORTER_ASSERT(reporter, eager->countLevels() == lazy->countLevels());
+
+        // Ask for a level in the middle first, then the rest.
+        const int count = lazy->countLevels();
+        for (int i : {count / 2, 0, count - 1}) {
+            SkMipmap::Level expected, actual;
+            REPORTER_ASSERT(reporter, eager->getLevel(i, &expected));
+            REPORTER_ASSERT(reporter, lazy->getLevel(i, &actual));
+            REPORTER_ASSERT(reporter, expected.fPixmap.dimensions() == actual.fPixmap.dimensions());
+            for (int y = 0; y < actual.fPixmap.height(); ++y) {
+                REPORTER_ASSERT(reporter, 0 == memcmp(expected.fPixmap.addr(0, y),
+                                                      actual.fPixmap.addr(0, y),
+                                                      actual.fPixmap.info().minRowBytes()));
+            }
+        }
+    }
+}
+
 static void fill_in_mips(SkMipmapBuilder* builder, sk_sp<SkImage> img) {
     int count = builder->countLevels();
     for (int i = 0; i < count; ++i) {
@@ -603,6 +603,105 @@ cmpne_2_floats                 $0..1 = notEqual($0..1, $2..3)
 )");
 }
 
+DEF_TEST(RasterPipelineBuilderBinaryFloatOpsFromSlots, r) {
+    using BuilderOp = SkSL::RP::BuilderOp;
+
+    SkSL::RP::Builder builder;
+    // v0..1 *= v4..5 should be performed directly on the value slots.
+    builder.push_slots(two_slots_at(0));
+    builder.push_slots(two_slots_at(4));
+    builder.binary_op(BuilderOp::mul_n_floats, 2);
+    builder.copy_stack_to_slots_unmasked(two_slots_at(0));
+    builder.discard_stack(2);
+    // The right-side of these ops should be read directly from the value slots. Pushing the
+    // left-side is folded into the op as well.
+    builder.push_slots(three_slots_at(0));
+    builder.push_slots(three_slots_at(3));
+    builder.binary_op(BuilderOp::add_n_floats, 3);
+    builder.push_slots(one_slot_at(9));
+    builder.binary_op(BuilderOp::sub_n_floats, 1);
+    // The right-side overlaps the destination, so this op cannot be performed in place.
+    builder.push_slots(two_slots_at(7));
+    builder.push_slots(two_slots_at(6));
+    builder.binary_op(BuilderOp::div_n_floats, 2);
+    builder.copy_stack_to_slots_unmasked(two_slots_at(7));
+    builder.discard_stack(2);
+    // Five-slot ops have no from-slots equivalent.
+    builder.push_slots(five_slots_at(0));
+    builder.push_slots(five_slots_at(5));
+    builder.binary_op(BuilderOp::add_n_floats, 5);
+    builder.copy_stack_to_slots(five_slots_at(0));
+    builder.discard_stack(8);
+    std::unique_ptr<SkSL::RP::Program> program = builder.finish(/*numValueSlots=*/10,
+                                                                /*numUniformSlots=*/0,
+                                                                /*numImmutableSlots=*/0);
+    check(r, *program,
+R"(mul_2_floats_from_slots        v0..1 *= v4..5
+add_3_floats_from_slots        $0..2 = v0..2 + v3..5
+sub_float_from_slot            $2 -= v9
+div_2_floats_from_slots        $3..4 = v7..8 / v6..7
+copy_2_slots_unmasked          v7..8 = $3..4
+copy_4_slots_unmasked          $3..6 = v0..3
+copy_4_slots_unmasked          $7..10 = v4..7
+copy_2_slots_unmasked          $11..12 = v8..9
+add_n_floats                   $3..7 += $8..12
+copy_4_slots_unmasked          v0..3 = $3..6
+copy_slot_unmasked             v4 = $7
+)");
+}
+
+DEF_TEST(RasterPipelineBuilderFusedOps, r) {
+    using BuilderOp = SkSL::RP::BuilderOp;
+
+    SkSL::RP::Builder builder;
+    // Pushing the left-side and then applying a from-slots op should fuse into a single op.
+    builder.push_slots(four_slots_at(0));
+    builder.push_slots(two_slots_at(4));
+    builder.binary_op(BuilderOp::add_n_floats, 2);
+    // Splatting a scalar and then applying an n-way op should read the scalar directly.
+    builder.push_slots(one_slot_at(6));
+    builder.swizzle(/*consumedSlots=*/1, {0, 0, 0, 0});
+    builder.binary_op(BuilderOp::mul_n_floats, 4);
+    // Multiplying and then adding an immediate value should fuse into a multiply-add.
+    builder.push_constant_f(2.0f);
+    builder.binary_op(BuilderOp::mul_n_floats, 1);
+    builder.push_constant_f(-1.0f);
+    builder.binary_op(BuilderOp::add_n_floats, 1);
+    builder.discard_stack(4);
+    std::unique_ptr<SkSL::RP::Program> program = builder.finish(/*numValueSlots=*/7,
+                                                                /*numUniformSlots=*/0,
+                                                                /*numImmutableSlots=*/0);
+    check(r, *program,
+R"(copy_2_slots_unmasked          $0..1 = v0..1
+add_2_floats_from_slots        $2..3 = v2..3 + v4..5
+copy_slot_unmasked             $4 = v6
+mul_n_floats_by_scalar         $0..3 *= $4
+mad_imm_float                  $3 = $3 * 0x40000000 (2.0) + 0xBF800000 (-1.0)
+)");
+
+    // The same ops are left alone when fusion is turned off.
+    SkSL::RP::Builder unfusedBuilder;
+    unfusedBuilder.push_slots(four_slots_at(0));
+    unfusedBuilder.push_slots(two_slots_at(4));
+    unfusedBuilder.binary_op(BuilderOp::add_n_floats, 2);
+    unfusedBuilder.push_constant_f(2.0f);
+    unfusedBuilder.binary_op(BuilderOp::mul_n_floats, 1);
+    unfusedBuilder.push_constant_f(-1.0f);
+    unfusedBuilder.binary_op(BuilderOp::add_n_floats, 1);
+    unfusedBuilder.discard_stack(4);
+    program = unfusedBuilder.finish(/*numValueSlots=*/7,
+                                    /*numUniformSlots=*/0,
+                                    /*numImmutableSlots=*/0,
+                                    /*debugTrace=*/nullptr,
+                                    /*fuseOps=*/false);
+    check(r, *program,
+R"(copy_4_slots_unmasked          $0..3 = v0..3
+add_2_floats_from_slots        $2..3 += v4..5
+mul_imm_float                  $3 *= 0x40000000 (2.0)
+add_imm_float                  $3 += 0xBF800000 (-1.0)
+)");
+}
+
 DEF_TEST(RasterPipelineBuilderBinaryIntOps, r) {
     using BuilderOp = SkSL::RP::BuilderOp;
 
@@ -881,3 +980,50 @@ trace_exit                     TraceExit(FunctionC) when $0 is true
         }
     }
 }
+
+DEF_TEST(RasterPipelineBuilderSerialize, r) {
+    // Create a nonsense program that uses the stack, uniforms and immutable data.
+    SkSL::RP::Builder builder;
+    builder.store_immutable_value_i(0, 0x3F800000);
+    builder.push_uniform(two_slots_at(0));
+    builder.push_immutable(one_slot_at(0));
+    builder.push_constant_f(2.5f);
+    builder.binary_op(SkSL::RP::BuilderOp::add_n_floats, 1);
+    builder.pop_slots(three_slots_at(1));
+    builder.push_slots(four_slots_at(0));
+    builder.pop_slots(four_slots_at(4));
+    std::unique_ptr<SkSL::RP::Program> program = builder.finish(/*numValueSlots=*/10,
+                                                                /*numUniformSlots=*/2,
+                                                                /*numImmutableSlots=*/1);
+    sk_sp<SkData> data = program->serialize();
+    REPORTER_ASSERT(r, data);
+
+    // A reloaded program is indistinguishable from the original.
+    std::unique_ptr<SkSL::RP::Program> reloaded = SkSL::RP::Program::Deserialize(*data);
+    REPORTER_ASSERT(r, reloaded);
+    REPORTER_ASSERT(r, reloaded->numUniforms() == program->numUniforms());
+    sk_sp<SkData> expected = get_program_dump(*program);
+    check(r, *reloaded, as_string_view(expected));
+
+    // Truncated or damaged data is rejected.
+    for (size_t size : {size_t(0), size_t(3), data->size() / 2, data->size() - 1}) {
+        REPORTER_ASSERT(r, !SkSL::RP::Program::Deserialize(*SkData::MakeSubset(data.get(), 0,
+                                                                               size)));
+    }
+    for (size_t offset = 0; offset < data->size(); offset += 7) {
+        sk_sp<SkData> damaged = SkData::MakeWithCopy(data->data(), data->size());
+        static_cast<uint8_t*>(damaged->writable_data())[offset] ^= 0x10;
+        REPORTER_ASSERT(r, !SkSL::RP::Program::Deserialize(*damaged), "offset %zu", offset);
+    }
+
+    // Programs that write to a debug trace can't be serialized.
+    SkSL::RP::Builder tracedBuilder;
+    tracedBuilder.push_constant_i(-1);
+    tracedBuilder.discard_stack(1);
+    SkSL::DebugTracePriv trace;
+    std::unique_ptr<SkSL::RP::Program> traced = tracedBuilder.finish(/*numValueSlots=*/0,
+                                                                     /*numUniformSlots=*/0,
+                                                                     /*numImmutableSlots=*/0,
+                                                                     &trace);
+    REPORTER_ASSERT(r, !traced->serialize());
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkSurface.h"
+#include "src/base/SkRandom.h"
+#include "src/core/SkResizePixels.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <initializer_list>
+#include <utility>
+
+static SkBitmap make_stripes(int width, int height, SkColor a, SkColor b,
+                             sk_sp<SkColorSpace> cs = nullptr) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(width, height, kRGBA_8888_SkColorType, kPremul_SkAlphaType,
+                                     std::move(cs)));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            *bm.getAddr32(x, y) = SkPreMultiplyColor(((x + y) & 1) ? a : b);
+        }
+    }
+    return bm;
+}
+
+static int color_diff(SkColor a, SkColor b) {
+    return std::max({std::abs((int)SkColorGetA(a) - (int)SkColorGetA(b)),
+                     std::abs((int)SkColorGetR(a) - (int)SkColorGetR(b)),
+                     std::abs((int)SkColorGetG(a) - (int)SkColorGetG(b)),
+                     std::abs((int)SkColorGetB(a) - (int)SkColorGetB(b))});
+}
+
+// Returns the largest difference between any channel of the pixels and the expected color.
+static int max_diff(const SkPixmap& pm, SkColor expected) {
+    int diff = 0;
+    for (int y = 0; y < pm.height(); ++y) {
+        for (int x = 0; x < pm.width(); ++x) {
+            diff = std::max(diff, color_diff(pm.getColor(x, y), expected));
+        }
+    }
+    return diff;
+}
+
+DEF_TEST(ResizePixels_PreservesSolidColor, reporter) {
+    const SkColor color = SkColorSetARGB(255, 10, 200, 77);
+    SkBitmap src = make_stripes(37, 23, color, color);
+
+    for (SkResizeFilter filter : {SkResizeFilter::Lanczos3(),
+                                  SkResizeFilter::Mitchell(),
+                                  SkResizeFilter::CatmullRom()}) {
+        for (SkISize size : {SkISize{5, 3}, SkISize{37, 50}, SkISize{100, 7}}) {
+            SkBitmap dst;
+            dst.allocPixels(src.info().makeDimensions(size));
+            REPORTER_ASSERT(reporter, SkResizePixels(dst.pixmap(), src.pixmap(), filter));
+            REPORTER_ASSERT(reporter, max_diff(dst.pixmap(), color) <= 1);
+        }
+    }
+}
+
+// When downscaling, the filter is widened to cover every src pixel, so a checkerboard averages
+// out to gray instead of aliasing.
+DEF_TEST(ResizePixels_DownscaleDoesNotAlias, reporter) {
+    SkBitmap src = make_stripes(400, 300, SK_ColorBLACK, SK_ColorWHITE);
+
+    for (SkResizeFilter filter : {SkResizeFilter::Lanczos3(), SkResizeFilter::Mitchell()}) {
+        SkBitmap dst;
+        dst.allocPixels(src.info().makeWH(57, 43));
+        REPORTER_ASSERT(reporter, SkResizePixels(dst.pixmap(), src.pixmap(), filter));
+        const int diff = max_diff(dst.pixmap(), SkColorSetARGB(255, 128, 128, 128));
+        REPORTER_ASSERT(reporter, diff <= 8, "diff %d", diff);
+    }
+}
+
+DEF_TEST(ResizePixels_LinearLight, reporter) {
+    SkBitmap src = make_stripes(64, 64, SK_ColorBLACK, SK_ColorWHITE, SkColorSpace::MakeSRGB());
+    SkBitmap dst;
+    dst.allocPixels(src.info().makeWH(16, 16));
+    // Clamping at the edges makes the border pixels lean towards the edge pixels of src.
+    SkPixmap interior;
+    SkAssertResult(dst.pixmap().extractSubset(&interior, SkIRect::MakeLTRB(2, 2, 14, 14)));
+
+    // Averaging black and white in linear light gives 0.5, which is 188 in sRGB.
+    REPORTER_ASSERT(reporter, SkResizePixels(dst.pixmap(), src.pixmap(),
+                                             SkResizeFilter::Mitchell(), /*linearLight=*/true));
+    REPORTER_ASSERT(reporter, max_diff(interior, SkColorSetARGB(255, 188, 188, 188)) <= 1);
+
+    REPORTER_ASSERT(reporter, SkResizePixels(dst.pixmap(), src.pixmap(),
+                                             SkResizeFilter::Mitchell(), /*linearLight=*/false));
+    REPORTER_ASSERT(reporter, max_diff(interior, SkColorSetARGB(255, 128, 128, 128)) <= 1);
+}
+
+// When upscaling, the separable filter computes the same thing as sampling with the cubic.
+DEF_TEST(ResizePixels_UpscaleMatchesCubicSampling, reporter) {
+    SkBitmap src;
+    src.allocN32Pixels(20, 13);
+    SkRandom rand;
+    for (int y = 0; y < src.height(); ++y) {
+        for (int x = 0; x < src.width(); ++x) {
+            *src.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU() | 0xFF000000);
+        }
+    }
+
+    const SkSamplingOptions sampling(SkCubicResampler::CatmullRom());
+    const SkImageInfo dstInfo = src.info().makeWH(63, 40);
+    SkBitmap resized;
+    resized.allocPixels(dstInfo);
+    REPORTER_ASSERT(reporter, src.pixmap().scalePixels(resized.pixmap(), sampling));
+
+    sk_sp<SkSurface> surface = SkSurfaces::Raster(dstInfo);
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    surface->getCanvas()->drawImageRect(src.asImage(), SkRect::Make(dstInfo.bounds()), sampling,
+                                        &paint);
+    SkBitmap drawn;
+    drawn.allocPixels(dstInfo);
+    REPORTER_ASSERT(reporter, surface->readPixels(drawn, 0, 0));
+
+    for (int y = 0; y < dstInfo.height(); ++y) {
+        for (int x = 0; x < dstInfo.width(); ++x) {
+            const SkColor expected = drawn.getColor(x, y);
+            const int diff = color_diff(resized.getColor(x, y), expected);
+            if (diff > 1) {
+                ERRORF(reporter, "(%d, %d): %08x vs %08x", x, y, resized.getColor(x, y), expected);
+                return;
+            }
+        }
+    }
+}
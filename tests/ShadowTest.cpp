@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPoint.h"
@@ -21,8 +23,12 @@
 #include "src/core/SkDrawShadowInfo.h"
 #include "src/core/SkVerticesPriv.h"
 #include "src/utils/SkShadowTessellator.h"
+#include "src/utils/SkShadowUtilsPriv.h"
 #include "tests/Test.h"
 
+#include <algorithm>
+#include <cstdlib>
+
 #if !defined(SK_ENABLE_OPTIMIZE_SIZE)
 
 enum ExpectVerts {
@@ -219,4 +225,53 @@ DEF_TEST(ShadowBounds, reporter) {
     check_bounds(reporter, path);
 }
 
+static SkBitmap draw_card_shadow(const SkPath& card, const SkMatrix& ctm) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(200, 200);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.concat(ctm);
+    SkShadowUtils::DrawShadow(&canvas, card, {0, 0, 8}, {100, 0, 600}, 800,
+                              0x40000000, 0x60000000, SkShadowFlags::kGeometricOnly_ShadowFlag);
+    return bitmap;
+}
+
+DEF_TEST(ShadowTessellationCache, reporter) {
+    // Cards that differ only in position, drawn with slightly different scales, share a mesh.
+    auto make_card = [](SkScalar x, SkScalar y) {
+        return SkPath::RRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(x, y, 60, 40), 4, 4));
+    };
+    SkShadowUtilsPriv::TessellationCacheStats before =
+            SkShadowUtilsPriv::GetTessellationCacheStats();
+    draw_card_shadow(make_card(40, 50), SkMatrix::Scale(1.0f, 1.0f));
+    SkShadowUtilsPriv::TessellationCacheStats afterFirst =
+            SkShadowUtilsPriv::GetTessellationCacheStats();
+    REPORTER_ASSERT(reporter, afterFirst.fMisses > before.fMisses);
+
+    SkPath card = make_card(70.5f, 90.25f);
+    SkMatrix ctm = SkMatrix::Scale(1.001f, 1.001f);
+    SkBitmap cached = draw_card_shadow(card, ctm);
+    // Other tests may use the cache concurrently, so only check that the hits moved.
+    SkShadowUtilsPriv::TessellationCacheStats afterSecond =
+            SkShadowUtilsPriv::GetTessellationCacheStats();
+    REPORTER_ASSERT(reporter, afterSecond.fHits > afterFirst.fHits);
+
+    // A volatile path is never cached, so it is tessellated for exactly this matrix. The
+    // shared mesh is mapped onto the same shape, so it only differs in the falloff.
+    SkPath uncachedCard = card;
+    uncachedCard.setIsVolatile(true);
+    SkBitmap uncached = draw_card_shadow(uncachedCard, ctm);
+    int maxDiff = 0;
+    for (int y = 0; y < cached.height(); ++y) {
+        for (int x = 0; x < cached.width(); ++x) {
+            SkColor a = cached.getColor(x, y), b = uncached.getColor(x, y);
+            maxDiff = std::max({maxDiff,
+                                std::abs((int)SkColorGetR(a) - (int)SkColorGetR(b)),
+                                std::abs((int)SkColorGetG(a) - (int)SkColorGetG(b)),
+                                std::abs((int)SkColorGetB(a) - (int)SkColorGetB(b))});
+        }
+    }
+    REPORTER_ASSERT(reporter, maxDiff <= 2, "max diff %d", maxDiff);
+}
+
 #endif // !defined(SK_ENABLE_OPTIMIZE_SIZE)
@@ -1783,6 +1783,221 @@ DEF_TEST(SkRasterPipeline_FloatArithmeticWithHardcodedSlots, r) {
     }
 }
 
+DEF_TEST(SkRasterPipeline_FloatArithmeticFromSlots, r) {
+    // Allocate space for 5 dest slots, a gap, and 5 source slots.
+    alignas(64) float slots[11 * SkRasterPipeline_kMaxStride_highp];
+    const int dstIndex = 0, srcIndex = 6;
+    const int N = SkOpts::raster_pipeline_highp_stride;
+
+    struct ArithmeticOp {
+        SkRasterPipelineOp stage;
+        int numSlotsAffected;
+        std::function<float(float, float)> verify;
+    };
+
+    static const ArithmeticOp kArithmeticOps[] = {
+        {SkRasterPipelineOp::add_float_from_slot,     1, [](float a, float b) { return a + b; }},
+        {SkRasterPipelineOp::sub_float_from_slot,     1, [](float a, float b) { return a - b; }},
+        {SkRasterPipelineOp::mul_float_from_slot,     1, [](float a, float b) { return a * b; }},
+        {SkRasterPipelineOp::div_float_from_slot,     1, [](float a, float b) { return a / b; }},
+
+        {SkRasterPipelineOp::add_2_floats_from_slots, 2, [](float a, float b) { return a + b; }},
+        {SkRasterPipelineOp::sub_2_floats_from_slots, 2, [](float a, float b) { return a - b; }},
+        {SkRasterPipelineOp::mul_2_floats_from_slots, 2, [](float a, float b) { return a * b; }},
+        {SkRasterPipelineOp::div_2_floats_from_slots, 2, [](float a, float b) { return a / b; }},
+
+        {SkRasterPipelineOp::add_3_floats_from_slots, 3, [](float a, float b) { return a + b; }},
+        {SkRasterPipelineOp::sub_3_floats_from_slots, 3, [](float a, float b) { return a - b; }},
+        {SkRasterPipelineOp::mul_3_floats_from_slots, 3, [](float a, float b) { return a * b; }},
+        {SkRasterPipelineOp::div_3_floats_from_slots, 3, [](float a, float b) { return a / b; }},
+
+        {SkRasterPipelineOp::add_4_floats_from_slots, 4, [](float a, float b) { return a + b; }},
+        {SkRasterPipelineOp::sub_4_floats_from_slots, 4, [](float a, float b) { return a - b; }},
+        {SkRasterPipelineOp::mul_4_floats_from_slots, 4, [](float a, float b) { return a * b; }},
+        {SkRasterPipelineOp::div_4_floats_from_slots, 4, [](float a, float b) { return a / b; }},
+    };
+
+    for (const ArithmeticOp& op : kArithmeticOps) {
+        // Initialize the slot values to 1,2,3...
+        std::iota(&slots[0], &slots[11 * N], 1.0f);
+
+        // Run the arithmetic op over our data. The sources are not adjacent to the destination.
+        SkArenaAlloc alloc(/*firstHeapAllocation=*/256);
+        SkRasterPipeline p(&alloc);
+        SkRasterPipeline_BinaryOpFromSlotsCtx ctx;
+        ctx.dst = N * dstIndex * sizeof(float);
+        ctx.left = ctx.dst;
+        ctx.right = N * srcIndex * sizeof(float);
+        p.append(SkRasterPipelineOp::set_base_pointer, &slots[0]);
+        p.append(op.stage, SkRPCtxUtils::Pack(ctx, &alloc));
+        p.run(0,0,1,1);
+
+        // Verify that the affected slots now equal (1,2,3...) op (the source slot values).
+        float leftValue = 1.0f;
+        float rightValue = float(srcIndex * N) + 1.0f;
+        float* destPtr = &slots[N * dstIndex];
+        for (int checkSlot = 0; checkSlot < 5; ++checkSlot) {
+            for (int checkLane = 0; checkLane < N; ++checkLane) {
+                if (checkSlot < op.numSlotsAffected) {
+                    REPORTER_ASSERT(r, *destPtr == op.verify(leftValue, rightValue));
+                } else {
+                    REPORTER_ASSERT(r, *destPtr == leftValue);
+                }
+
+                ++destPtr;
+                leftValue += 1.0f;
+                rightValue += 1.0f;
+            }
+        }
+
+        // Verify that the source slots are untouched.
+        float* srcPtr = &slots[N * srcIndex];
+        for (int index = 0; index < 5 * N; ++index) {
+            REPORTER_ASSERT(r, srcPtr[index] == float(srcIndex * N + index) + 1.0f);
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_FloatArithmeticFromSlotsToSeparateDest, r) {
+    // Allocate space for 4 dest slots, 4 left-side slots, and 4 right-side slots.
+    alignas(64) float slots[12 * SkRasterPipeline_kMaxStride_highp];
+    const int dstIndex = 0, leftIndex = 4, rightIndex = 8;
+    const int N = SkOpts::raster_pipeline_highp_stride;
+
+    struct ArithmeticOp {
+        SkRasterPipelineOp stage;
+        int numSlotsAffected;
+        std::function<float(float, float)> verify;
+    };
+
+    static const ArithmeticOp kArithmeticOps[] = {
+        {SkRasterPipelineOp::add_float_from_slot,     1, [](float a, float b) { return a + b; }},
+        {SkRasterPipelineOp::sub_2_floats_from_slots, 2, [](float a, float b) { return a - b; }},
+        {SkRasterPipelineOp::mul_3_floats_from_slots, 3, [](float a, float b) { return a * b; }},
+        {SkRasterPipelineOp::div_4_floats_from_slots, 4, [](float a, float b) { return a / b; }},
+    };
+
+    for (const ArithmeticOp& op : kArithmeticOps) {
+        // Initialize the slot values to 1,2,3...
+        std::iota(&slots[0], &slots[12 * N], 1.0f);
+
+        // Run the arithmetic op over our data, writing the result to a third range of slots.
+        SkArenaAlloc alloc(/*firstHeapAllocation=*/256);
+        SkRasterPipeline p(&alloc);
+        SkRasterPipeline_BinaryOpFromSlotsCtx ctx;
+        ctx.dst = N * dstIndex * sizeof(float);
+        ctx.left = N * leftIndex * sizeof(float);
+        ctx.right = N * rightIndex * sizeof(float);
+        p.append(SkRasterPipelineOp::set_base_pointer, &slots[0]);
+        p.append(op.stage, SkRPCtxUtils::Pack(ctx, &alloc));
+        p.run(0,0,1,1);
+
+        // Verify that the affected slots now equal (left slot values) op (right slot values).
+        for (int index = 0; index < 4 * N; ++index) {
+            float original = float(dstIndex * N + index) + 1.0f;
+            float left = float(leftIndex * N + index) + 1.0f;
+            float right = float(rightIndex * N + index) + 1.0f;
+            float expected = (index < op.numSlotsAffected * N) ? op.verify(left, right) : original;
+            REPORTER_ASSERT(r, slots[dstIndex * N + index] == expected);
+        }
+
+        // Verify that the left- and right-side slots are untouched.
+        for (int index = leftIndex * N; index < 12 * N; ++index) {
+            REPORTER_ASSERT(r, slots[index] == float(index) + 1.0f);
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_FloatArithmeticByScalar, r) {
+    // Allocate space for 5 dest slots, followed by a scalar.
+    alignas(64) float slots[6 * SkRasterPipeline_kMaxStride_highp];
+    const int N = SkOpts::raster_pipeline_highp_stride;
+
+    struct ArithmeticOp {
+        SkRasterPipelineOp stage;
+        std::function<float(float, float)> verify;
+    };
+
+    static const ArithmeticOp kArithmeticOps[] = {
+        {SkRasterPipelineOp::add_n_floats_by_scalar, [](float a, float b) { return a + b; }},
+        {SkRasterPipelineOp::sub_n_floats_by_scalar, [](float a, float b) { return a - b; }},
+        {SkRasterPipelineOp::mul_n_floats_by_scalar, [](float a, float b) { return a * b; }},
+        {SkRasterPipelineOp::div_n_floats_by_scalar, [](float a, float b) { return a / b; }},
+    };
+
+    for (const ArithmeticOp& op : kArithmeticOps) {
+        for (int numSlotsAffected = 1; numSlotsAffected <= 5; ++numSlotsAffected) {
+            // Initialize the slot values to 1,2,3...
+            std::iota(&slots[0], &slots[6 * N], 1.0f);
+
+            // Apply the scalar (which lives directly after the affected slots) to every slot.
+            SkArenaAlloc alloc(/*firstHeapAllocation=*/256);
+            SkRasterPipeline p(&alloc);
+            SkRasterPipeline_BinaryOpCtx ctx;
+            ctx.dst = 0;
+            ctx.src = N * numSlotsAffected * sizeof(float);
+            p.append(SkRasterPipelineOp::set_base_pointer, &slots[0]);
+            p.append(op.stage, SkRPCtxUtils::Pack(ctx, &alloc));
+            p.run(0,0,1,1);
+
+            // Verify that the affected slots now equal (1,2,3...) op (the scalar in that lane).
+            for (int index = 0; index < 6 * N; ++index) {
+                float original = float(index) + 1.0f;
+                float scalar = float(numSlotsAffected * N + (index % N)) + 1.0f;
+                float expected = (index < numSlotsAffected * N) ? op.verify(original, scalar)
+                                                                : original;
+                REPORTER_ASSERT(r, slots[index] == expected);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_MadImmFloat, r) {
+    alignas(64) float fused[SkRasterPipeline_kMaxStride_highp];
+    alignas(64) float unfused[SkRasterPipeline_kMaxStride_highp];
+    const int N = SkOpts::raster_pipeline_highp_stride;
+
+    // `mad_imm_float` must match `mul_imm_float` followed by `add_imm_float`, even when an FMA
+    // would not: (1 + 2^-12)^2 rounds to 1 + 2^-11, so subtracting that gives exactly zero.
+    const float x = 1.0f + 0x1p-12f;
+    const float kValues[][2] = {{2.5f, -4.0f}, {x, -(1.0f + 0x1p-11f)}, {-0.1f, 0.3f}};
+    for (const auto& [mul, add] : kValues) {
+        for (int index = 0; index < N; ++index) {
+            fused[index] = unfused[index] = x * (float)(index + 1);
+        }
+
+        SkArenaAlloc alloc(/*firstHeapAllocation=*/256);
+        SkRasterPipeline p(&alloc);
+        SkRasterPipeline_MadConstantCtx madCtx;
+        madCtx.mulValue = sk_bit_cast<int32_t>(mul);
+        madCtx.addValue = sk_bit_cast<int32_t>(add);
+        madCtx.dst = 0;
+        p.append(SkRasterPipelineOp::set_base_pointer, &fused[0]);
+        p.append(SkRasterPipelineOp::mad_imm_float, SkRPCtxUtils::Pack(madCtx, &alloc));
+        p.run(0,0,1,1);
+
+        SkRasterPipeline q(&alloc);
+        SkRasterPipeline_ConstantCtx mulCtx, addCtx;
+        mulCtx.value = sk_bit_cast<int32_t>(mul);
+        mulCtx.dst = 0;
+        addCtx.value = sk_bit_cast<int32_t>(add);
+        addCtx.dst = 0;
+        q.append(SkRasterPipelineOp::set_base_pointer, &unfused[0]);
+        q.append(SkRasterPipelineOp::mul_imm_float, SkRPCtxUtils::Pack(mulCtx, &alloc));
+        q.append(SkRasterPipelineOp::add_imm_float, SkRPCtxUtils::Pack(addCtx, &alloc));
+        q.run(0,0,1,1);
+
+        for (int index = 0; index < N; ++index) {
+            REPORTER_ASSERT(r, sk_bit_cast<uint32_t>(fused[index]) ==
+                               sk_bit_cast<uint32_t>(unfused[index]),
+                            "lane %d: %a != %a", index, fused[index], unfused[index]);
+        }
+        if (mul == x) {
+            REPORTER_ASSERT(r, fused[0] == 0.0f, "%a", fused[0]);
+        }
+    }
+}
+
 static int divide_unsigned(int a, int b) { return int(uint32_t(a) / uint32_t(b)); }
 static int min_unsigned   (int a, int b) { return uint32_t(a) < uint32_t(b) ? a : b; }
 static int max_unsigned   (int a, int b) { return uint32_t(a) > uint32_t(b) ? a : b; }
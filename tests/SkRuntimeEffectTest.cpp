@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkAlphaType.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkBlender.h"
 #include "include/core/SkCanvas.h"
@@ -14,6 +15,7 @@
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
@@ -52,17 +54,24 @@
 #include "src/gpu/ganesh/SurfaceFillContext.h"
 #include "src/gpu/ganesh/effects/GrSkSLFP.h"
 #include "src/sksl/SkSLString.h"
+#include "src/utils/SkJSON.h"
 #include "tests/CtsEnforcement.h"
 #include "tests/Test.h"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <initializer_list>
+#include <limits>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
+#include <vector>
 
 using namespace skia_private;
 
@@ -1645,3 +1654,296 @@ DEF_GANESH_TEST_FOR_RENDERING_CONTEXTS(GrSkSLFP_UniformArray,
         }
     }
 }
+
+DEF_TEST(SkRuntimeEffectSpecializeUniforms, r) {
+    // Effects drawn with specializeUniforms should match the same effect drawn normally, whether or
+    // not their uniforms can be folded into the program.
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(16, 16);
+    auto draw = [&](sk_sp<SkShader> shader, SkBitmap* bitmap) {
+        bitmap->allocPixels(info);
+        SkCanvas canvas(*bitmap);
+        SkPaint paint;
+        paint.setShader(std::move(shader));
+        canvas.drawPaint(paint);
+    };
+    auto test = [&](const char* sksl, const std::vector<float>& values) {
+        SkRuntimeEffect::Options options;
+        auto [plain, err] = SkRuntimeEffect::MakeForShader(SkString(sksl), options);
+        REPORTER_ASSERT(r, plain, "%s", err.c_str());
+        options.specializeUniforms = true;
+        auto [specializing, err2] = SkRuntimeEffect::MakeForShader(SkString(sksl), options);
+        REPORTER_ASSERT(r, specializing, "%s", err2.c_str());
+        REPORTER_ASSERT(r, plain->uniformSize() == values.size() * sizeof(float));
+
+        // A set of values is specialized once it has been drawn a few times, so drawing more often
+        // covers the generic program, compiling the variant, and reusing it.
+        for (int pass = 0; pass < 6; ++pass) {
+            SkBitmap expected, actual;
+            sk_sp<SkData> uniforms = SkData::MakeWithCopy(values.data(), plain->uniformSize());
+            draw(plain->makeShader(uniforms, /*children=*/{}), &expected);
+            draw(specializing->makeShader(uniforms, /*children=*/{}), &actual);
+            for (int y = 0; y < info.height(); ++y) {
+                for (int x = 0; x < info.width(); ++x) {
+                    REPORTER_ASSERT(r, expected.getColor(x, y) == actual.getColor(x, y),
+                                    "%s\n(%d, %d): %08x != %08x", sksl, x, y,
+                                    expected.getColor(x, y), actual.getColor(x, y));
+                }
+            }
+        }
+    };
+
+    static constexpr char kLoop[] = R"(
+        uniform int count;
+        uniform half4 colors[3];
+        uniform float2x2 m;
+        half4 main(float2 p) {
+            p = m * p;
+            half4 c = half4(0);
+            for (int i = 0; i < 3; ++i) {
+                if (i >= count) { break; }
+                c += colors[i] * half(fract(p.x / float(i + 2)));
+            }
+            return c;
+        }
+    )";
+    // Draw more distinct values than there are cached variants.
+    for (int count = 0; count <= 3; ++count) {
+        for (float scale : {0.25f, 1.0f, 3.5f}) {
+            std::vector<float> values = {0,
+                                         1, 0, 0, 1,   0, 0.5f, 0, 0.5f,   0.1f, 0.2f, 0.3f, 0.4f,
+                                         scale, 0.5f, -0.25f, scale};
+            memcpy(values.data(), &count, sizeof(count));
+            test(kLoop, values);
+        }
+    }
+
+    // Values with no literal form fall back to the unspecialized program.
+    test("uniform float4 c; half4 main(float2 p) { return c.x == c.x ? half4(c) : half4(1); }",
+         {std::numeric_limits<float>::quiet_NaN(), 0.5f, 0.25f, 1});
+
+    // Uniforms are replaced in the IR, however they are declared, and the branches and intrinsic
+    // calls that depend on them are folded.
+    test("uniform half a, b; half4 main(float2 p) { return half4(a, b, 0, 1); }",
+         {0.5f, 0.75f});
+    test("uniform half a; // alpha\nhalf4 main(float2 p) { return half4(a); }",
+         {0.375f});
+    static constexpr char kBranches[] = R"(
+        uniform int mode;
+        uniform float2 scale;
+        half4 main(float2 p) {
+            if (mode == 1) { return half4(half(max(scale.x, scale.y)), 0, 0, 1); }
+            else if (mode == 2) { return half4(0, half(fract(p.x * scale.y)), 0, 1); }
+            return mode > 2 ? half4(1) : half4(0, 0, half(-scale.x), 1);
+        }
+    )";
+    for (int mode = 0; mode <= 3; ++mode) {
+        std::vector<float> values = {0, -0.5f, 0.25f};
+        memcpy(values.data(), &mode, sizeof(mode));
+        test(kBranches, values);
+    }
+}
+
+DEF_SERIAL_TEST(SkRuntimeEffectPersistentCache, r) {
+    // Stands in for a cache that outlives the process. This test is serial because the cache is
+    // process-wide, and other tests draw runtime effects.
+    struct MemoryCache final : public SkRuntimeEffect::PersistentCache {
+        sk_sp<SkData> load(const SkData& key) override {
+            ++fLoads;
+            for (const auto& [storedKey, data] : fEntries) {
+                if (storedKey->equals(&key)) {
+                    ++fHits;
+                    return data;
+                }
+            }
+            return nullptr;
+        }
+        void store(const SkData& key, const SkData& data) override {
+            fEntries.push_back({SkData::MakeWithCopy(key.data(), key.size()),
+                                SkData::MakeWithCopy(data.data(), data.size())});
+        }
+        std::vector<std::pair<sk_sp<SkData>, sk_sp<SkData>>> fEntries;
+        int fLoads = 0;
+        int fHits = 0;
+    };
+
+    static constexpr char kSource[] = R"(
+        uniform half4 color;
+        half4 main(float2 p) {
+            half4 c = color;
+            for (int i = 0; i < 4; ++i) { c.r += half(fract(p.x * 0.1 * float(i))) / 4; }
+            return c;
+        }
+    )";
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(8, 8);
+    auto draw = [&](SkBitmap* bitmap) {
+        // Each draw compiles a new effect, as a new process would.
+        auto [effect, err] = SkRuntimeEffect::MakeForShader(SkString(kSource));
+        REPORTER_ASSERT(r, effect, "%s", err.c_str());
+        const SkColor4f color = {0.25f, 0.5f, 0.75f, 1.0f};
+        bitmap->allocPixels(info);
+        SkCanvas canvas(*bitmap);
+        SkPaint paint;
+        paint.setShader(effect->makeShader(SkData::MakeWithCopy(&color, sizeof(color)), {}));
+        canvas.drawPaint(paint);
+    };
+
+    MemoryCache cache;
+    SkRuntimeEffect::SetPersistentCache(&cache);
+    SkBitmap compiled, loaded;
+    draw(&compiled);
+    REPORTER_ASSERT(r, cache.fLoads == 1 && cache.fHits == 0 && cache.fEntries.size() == 1);
+    draw(&loaded);
+    REPORTER_ASSERT(r, cache.fLoads == 2 && cache.fHits == 1 && cache.fEntries.size() == 1);
+
+    // Programs specialized on uniform values are built from the cached program, but are never
+    // stored themselves.
+    SkRuntimeEffect::Options options;
+    options.specializeUniforms = true;
+    auto [specializing, err] = SkRuntimeEffect::MakeForShader(SkString(kSource), options);
+    REPORTER_ASSERT(r, specializing, "%s", err.c_str());
+    const SkColor4f color = {0.25f, 0.5f, 0.75f, 1.0f};
+    for (int i = 0; i < 8; ++i) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setShader(specializing->makeShader(SkData::MakeWithCopy(&color, sizeof(color)), {}));
+        canvas.drawPaint(paint);
+    }
+    REPORTER_ASSERT(r, cache.fLoads == 3 && cache.fHits == 2 && cache.fEntries.size() == 1);
+    SkRuntimeEffect::SetPersistentCache(nullptr);
+
+    for (int y = 0; y < info.height(); ++y) {
+        for (int x = 0; x < info.width(); ++x) {
+            REPORTER_ASSERT(r, compiled.getColor(x, y) == loaded.getColor(x, y));
+        }
+    }
+}
+
+DEF_TEST(SkRuntimeEffectMakeBatch, r) {
+    // Compile a batch of shaders on a thread pool, including one with an error, and check that
+    // every result lands in its input's slot.
+    constexpr int kCount = 24;
+    constexpr int kBroken = 13;
+    std::vector<SkString> sources;
+    for (int i = 0; i < kCount; ++i) {
+        sources.push_back(i == kBroken
+                ? SkString("half4 main(float2 xy) { return undefinedColor; }")
+                : SkStringPrintf("half4 main(float2 xy) { return half4(%d.0 / 255.0); }", i));
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    std::vector<SkRuntimeEffect::Result> results = SkRuntimeEffect::MakeBatch(
+            SkRuntimeEffect::MakeForShader, sources, SkRuntimeEffect::Options{}, executor.get());
+    REPORTER_ASSERT(r, results.size() == kCount);
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(1, 1);
+    for (int i = 0; i < kCount; ++i) {
+        const SkRuntimeEffect::Result& result = results[i];
+        if (i == kBroken) {
+            REPORTER_ASSERT(r, !result.effect);
+            REPORTER_ASSERT(r, result.errorText.contains("undefinedColor"),
+                            "%s", result.errorText.c_str());
+            continue;
+        }
+        REPORTER_ASSERT(r, result.effect, "%s", result.errorText.c_str());
+        if (!result.effect) {
+            continue;
+        }
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setShader(result.effect->makeShader(/*uniforms=*/nullptr, /*children=*/{}));
+        canvas.drawPaint(paint);
+        REPORTER_ASSERT(r, SkColorGetA(bitmap.getColor(0, 0)) == (unsigned)i,
+                        "%d: %08x", i, bitmap.getColor(0, 0));
+    }
+}
+
+DEF_TEST(SkRuntimeEffectProfile, r) {
+    static constexpr char kSource[] = R"(
+        uniform half4 color;
+        half4 main(float2 p) {
+            half4 c = color;
+            for (int i = 0; i < 4; ++i) {
+                c.r += half(fract(p.x * 0.1 * float(i))) / 4;
+            }
+            return c;
+        }
+    )";
+    auto [effect, err] = SkRuntimeEffect::MakeForShader(SkString(kSource));
+    REPORTER_ASSERT(r, effect, "%s", err.c_str());
+    const SkColor4f color = {0.25f, 0.5f, 0.75f, 1.0f};
+    sk_sp<SkShader> shader = effect->makeShader(SkData::MakeWithCopy(&color, sizeof(color)), {});
+
+    // A profiled shader should draw the same pixels as the original.
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(16, 16);
+    auto draw = [&](sk_sp<SkShader> drawShader, SkBitmap* bitmap) {
+        bitmap->allocPixels(info);
+        SkCanvas canvas(*bitmap);
+        SkPaint paint;
+        paint.setShader(std::move(drawShader));
+        canvas.drawPaint(paint);
+    };
+    SkRuntimeEffect::ProfiledShader profiled = SkRuntimeEffect::MakeProfiled(shader,
+                                                                             /*sampleInterval=*/2);
+    REPORTER_ASSERT(r, profiled.shader && profiled.profile);
+    SkBitmap expected, actual;
+    draw(shader, &expected);
+    draw(profiled.shader, &actual);
+    for (int y = 0; y < info.height(); ++y) {
+        for (int x = 0; x < info.width(); ++x) {
+            REPORTER_ASSERT(r, expected.getColor(x, y) == actual.getColor(x, y));
+        }
+    }
+
+    SkDynamicMemoryWStream jsonStream;
+    profiled.profile->writeJSON(&jsonStream);
+    sk_sp<SkData> json = jsonStream.detachAsData();
+    skjson::DOM dom(static_cast<const char*>(json->data()), json->size());
+    const skjson::ObjectValue* root = dom.root();
+    REPORTER_ASSERT(r, root);
+    if (!root) {
+        return;
+    }
+    const skjson::NumberValue* runs = (*root)["runs"];
+    const skjson::NumberValue* sampledRuns = (*root)["sampledRuns"];
+    const skjson::ArrayValue* source = (*root)["source"];
+    const skjson::ArrayValue* stages = (*root)["stages"];
+    REPORTER_ASSERT(r, runs && sampledRuns && source && stages);
+    if (!runs || !sampledRuns || !source || !stages) {
+        return;
+    }
+    REPORTER_ASSERT(r, **runs > 0);
+    REPORTER_ASSERT(r, **sampledRuns == std::ceil(**runs / 2));
+
+    // Every run passes through the loop body four times.
+    int loopLine = 0;
+    for (size_t index = 0; index < source->size(); ++index) {
+        const skjson::StringValue* text = (*source)[index];
+        if (text && text->str().find("c.r +=") != std::string_view::npos) {
+            loopLine = index + 1;
+        }
+    }
+    REPORTER_ASSERT(r, loopLine > 0);
+    double loopInvocations = 0;
+    for (const skjson::ObjectValue* stage : *stages) {
+        const skjson::NumberValue* line = (*stage)["line"];
+        const skjson::NumberValue* invocations = (*stage)["invocations"];
+        if (line && invocations && **line == loopLine) {
+            loopInvocations = std::max(loopInvocations, **invocations);
+        }
+    }
+    REPORTER_ASSERT(r, loopInvocations >= 4 * **runs, "%g", loopInvocations);
+
+    SkDynamicMemoryWStream dumpStream, traceStream;
+    profiled.profile->dump(&dumpStream);
+    profiled.profile->writePerfettoTrace(&traceStream);
+    sk_sp<SkData> dump = dumpStream.detachAsData();
+    sk_sp<SkData> trace = traceStream.detachAsData();
+    REPORTER_ASSERT(r, std::string_view(static_cast<const char*>(dump->data()), dump->size())
+                               .find("c.r +=") != std::string_view::npos);
+    skjson::DOM traceDom(static_cast<const char*>(trace->data()), trace->size());
+    REPORTER_ASSERT(r, traceDom.root()["traceEvents"].is<skjson::ArrayValue>());
+}
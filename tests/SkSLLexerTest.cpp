@@ -0,0 +1,83 @@
+/*
+ * Copyright 2024 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/sksl/SkSLLexer.h"
+#include "tests/Test.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using Kind = SkSL::Token::Kind;
+
+struct ExpectedToken {
+    Kind kind;
+    std::string_view text;
+};
+
+static void test_lexer(skiatest::Reporter* r,
+                       std::string_view src,
+                       const std::vector<ExpectedToken>& expected) {
+    SkSL::Lexer lexer;
+    lexer.start(src);
+    for (const ExpectedToken& expectedToken : expected) {
+        SkSL::Token token = lexer.next();
+        std::string_view text = src.substr(token.fOffset, token.fLength);
+        REPORTER_ASSERT(r, token.fKind == expectedToken.kind && text == expectedToken.text,
+                        "expected '%.*s' (%d), got '%.*s' (%d)",
+                        (int)expectedToken.text.size(), expectedToken.text.data(),
+                        (int)expectedToken.kind, (int)text.size(), text.data(), (int)token.fKind);
+    }
+    REPORTER_ASSERT(r, lexer.next().fKind == Kind::TK_END_OF_FILE);
+}
+
+DEF_TEST(SkSLLexerRuns, r) {
+    // Identifiers which begin like keywords, and long runs of identifier characters.
+    test_lexer(r, "format whiles while_ in inout inouts sk_FragColor_0123456789",
+               {{Kind::TK_IDENTIFIER, "format"},       {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_IDENTIFIER, "whiles"},       {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_IDENTIFIER, "while_"},       {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_IN, "in"},                   {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_INOUT, "inout"},             {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_IDENTIFIER, "inouts"},       {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_IDENTIFIER, "sk_FragColor_0123456789"}});
+
+    // Private identifiers, directives, and reserved names.
+    test_lexer(r, "$pure $pureness #version gl_Position samplerCube",
+               {{Kind::TK_PURE, "$pure"},                   {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_PRIVATE_IDENTIFIER, "$pureness"}, {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_DIRECTIVE, "#version"},           {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_RESERVED, "gl_Position"},         {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_RESERVED, "samplerCube"}});
+
+    // Runs of whitespace and comments.
+    test_lexer(r, "a \t\r\n  \n\tb// comment * / */\n/* block * comment / ** */c",
+               {{Kind::TK_IDENTIFIER, "a"},
+                {Kind::TK_WHITESPACE, " \t\r\n  \n\t"},
+                {Kind::TK_IDENTIFIER, "b"},
+                {Kind::TK_LINE_COMMENT, "// comment * / */"},
+                {Kind::TK_WHITESPACE, "\n"},
+                {Kind::TK_BLOCK_COMMENT, "/* block * comment / ** */"},
+                {Kind::TK_IDENTIFIER, "c"}});
+
+    // Numbers.
+    test_lexer(r, "1234567 0x1234abcdU 1.2345e-10 0777 089",
+               {{Kind::TK_INT_LITERAL, "1234567"},      {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_INT_LITERAL, "0x1234abcdU"},  {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_FLOAT_LITERAL, "1.2345e-10"}, {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_INT_LITERAL, "0777"},         {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_BAD_OCTAL, "089"}});
+
+    // Characters outside of ASCII end a run, and are not part of any token.
+    test_lexer(r, "abc\xC3\xA9 // \xC3\xA9\n",
+               {{Kind::TK_IDENTIFIER, "abc"},
+                {Kind::TK_INVALID, "\xC3"},
+                {Kind::TK_INVALID, "\xA9"},
+                {Kind::TK_WHITESPACE, " "},
+                {Kind::TK_LINE_COMMENT, "// \xC3\xA9"},
+                {Kind::TK_WHITESPACE, "\n"}});
+}
@@ -5,6 +5,10 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathUtils.h"
@@ -12,8 +16,13 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkStrokeRec.h"
+#include "include/core/SkVertices.h"
 #include "src/base/SkFloatBits.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkPathPriv.h"
+#include "src/core/SkPolylineStroker.h"
+#include "src/core/SkStroke.h"
+#include "src/core/SkStrokeCache.h"
 #include "tests/Test.h"
 
 #include <array>
@@ -192,3 +201,178 @@ DEF_TEST(Stroke, reporter) {
     test_strokerec_equality(reporter);
     test_big_stroke(reporter);
 }
+
+DEF_TEST(StrokeCache, reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 1; i < 100; ++i) {
+        path.lineTo(i * 10, (i % 7) * 13);
+    }
+    // The cache is off unless the client opts in.
+    size_t oldLimit = SkGraphics::SetStrokeCacheByteLimit(0);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::CanCache(path));
+    SkGraphics::SetStrokeCacheByteLimit(1024 * 1024);
+    REPORTER_ASSERT(reporter, SkStrokeCache::CanCache(path));
+
+    SkStrokeRec rec(SkStrokeRec::kFill_InitStyle);
+    rec.setStrokeStyle(3);
+    rec.setStrokeParams(SkPaint::kRound_Cap, SkPaint::kMiter_Join, 4);
+    rec.setResScale(1.1f);
+
+    // Other tests may use the cache concurrently, so only check that the counters move.
+    SkPath first, second;
+    SkStrokeCache::Stats before = SkStrokeCache::GetStats();
+    REPORTER_ASSERT(reporter, rec.applyToPath(&first, path));
+    REPORTER_ASSERT(reporter, rec.applyToPath(&second, path));
+    SkStrokeCache::Stats after = SkStrokeCache::GetStats();
+    REPORTER_ASSERT(reporter, after.fHits > before.fHits);
+    REPORTER_ASSERT(reporter, after.fMisses > before.fMisses);
+    REPORTER_ASSERT(reporter, first == second);
+
+    // A cached stroke matches the uncached one exactly, and other scales get their own entry.
+    SkPath uncached;
+    SkStroke stroker;
+    stroker.setCap(SkPaint::kRound_Cap);
+    stroker.setJoin(SkPaint::kMiter_Join);
+    stroker.setMiterLimit(4);
+    stroker.setWidth(3);
+    stroker.setResScale(1.1f);
+    stroker.strokePath(path, &uncached);
+    REPORTER_ASSERT(reporter, second == uncached);
+    rec.setResScale(1.12f);
+    SkPath rescaled;
+    REPORTER_ASSERT(reporter, rec.applyToPath(&rescaled, path));
+    stroker.setResScale(1.12f);
+    stroker.strokePath(path, &uncached);
+    REPORTER_ASSERT(reporter, rescaled == uncached);
+
+    // Purging every cache also drops the cached strokes.
+    REPORTER_ASSERT(reporter, SkStrokeCache::GetStats().fBytesUsed > 0);
+    SkGraphics::PurgeAllCaches();
+    REPORTER_ASSERT(reporter, SkStrokeCache::GetStats().fBytesUsed == 0);
+
+    // Editing the path must not return the stale stroke.
+    path.lineTo(2000, 2000);
+    SkPath edited;
+    REPORTER_ASSERT(reporter, rec.applyToPath(&edited, path));
+    REPORTER_ASSERT(reporter, edited != first);
+
+    // Volatile paths are never cached.
+    path.setIsVolatile(true);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::CanCache(path));
+
+    SkGraphics::SetStrokeCacheByteLimit(oldLimit);
+}
+
+static SkPath make_polyline(int pointCount, bool close) {
+    SkRandom rand;
+    SkPath path;
+    path.moveTo(20, 120);
+    for (int i = 1; i < pointCount; ++i) {
+        SkScalar x = 20 + 216.0f * i / pointCount;
+        // Sharp spikes exercise the miter limit, repeated points the degenerate segments.
+        SkScalar y = i % 9 == 0 ? 20 : 60 + rand.nextUScalar1() * 120;
+        path.lineTo(x, y);
+        if (i % 13 == 0) {
+            path.lineTo(x, y);
+        }
+    }
+    if (close) {
+        path.lineTo(128, 236);
+        path.close();
+    }
+    return path;
+}
+
+template <typename DrawFn>
+static SkBitmap rasterize(DrawFn&& draw) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeA8(256, 256));
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bitmap);
+    draw(&canvas);
+    return bitmap;
+}
+
+// Returns the fraction of pixels whose coverage differs by more than tolerance.
+static float coverage_mismatch(const SkBitmap& a, const SkBitmap& b, int tolerance) {
+    int mismatches = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            if (std::abs(*a.getAddr8(x, y) - *b.getAddr8(x, y)) > tolerance) {
+                ++mismatches;
+            }
+        }
+    }
+    return (float)mismatches / (a.width() * a.height());
+}
+
+DEF_TEST(PolylineStroker, reporter) {
+    REPORTER_ASSERT(reporter, !SkPolylineStroker::CanStroke(SkPath().quadTo(1, 1, 2, 0)));
+
+    SkPaint fill;
+    fill.setAntiAlias(true);
+
+    for (bool close : {false, true}) {
+        // Short enough that SkStroke still uses the general stroker.
+        SkPath path = make_polyline(100, close);
+        REPORTER_ASSERT(reporter, SkPolylineStroker::CanStroke(path));
+        REPORTER_ASSERT(reporter, path.countPoints() < SkPolylineStroker::kMinPointCount);
+
+        for (SkPaint::Cap cap : {SkPaint::kButt_Cap, SkPaint::kRound_Cap, SkPaint::kSquare_Cap}) {
+            for (SkPaint::Join join :
+                 {SkPaint::kMiter_Join, SkPaint::kRound_Join, SkPaint::kBevel_Join}) {
+                SkStroke stroke;
+                stroke.setWidth(5);
+                stroke.setCap(cap);
+                stroke.setJoin(join);
+                stroke.setMiterLimit(4);
+                SkPath expected, actual;
+                stroke.strokePath(path, &expected);
+                SkPolylineStroker(5, cap, join, 4).strokePath(path, &actual);
+
+                SkBitmap want = rasterize([&](SkCanvas* c) { c->drawPath(expected, fill); });
+                SkBitmap got = rasterize([&](SkCanvas* c) { c->drawPath(actual, fill); });
+                // Round joins and caps are approximated differently; the rest should match.
+                float mismatch = coverage_mismatch(want, got, 8);
+                REPORTER_ASSERT(reporter, mismatch < 0.001f,
+                                "cap %d join %d close %d: %g", cap, join, close, mismatch);
+            }
+        }
+    }
+
+    // Long line-only paths go through the polyline stroker from SkStroke.
+    SkPath longPath = make_polyline(SkPolylineStroker::kMinPointCount + 10, false);
+    SkStroke stroke;
+    stroke.setWidth(3);
+    SkPath viaStroke, direct;
+    stroke.strokePath(longPath, &viaStroke);
+    SkPolylineStroker(3, stroke.getCap(), stroke.getJoin(), 4).strokePath(longPath, &direct);
+    REPORTER_ASSERT(reporter, viaStroke == direct);
+
+    // The triangles never cover more than the outline. They can cover a little less: at sharp
+    // turns the outline's inner join also fills some of the notch between the two segments.
+    SkPolylineStroker stroker(5, SkPaint::kRound_Cap, SkPaint::kRound_Join, 4);
+    SkPath outline;
+    stroker.strokePath(longPath, &outline);
+    sk_sp<SkVertices> vertices = stroker.strokeVertices(longPath);
+    REPORTER_ASSERT(reporter, vertices);
+    SkPaint opaque;
+    SkBitmap want = rasterize([&](SkCanvas* c) { c->drawPath(outline, opaque); });
+    SkBitmap got = rasterize([&](SkCanvas* c) {
+        c->drawVertices(vertices, SkBlendMode::kSrcOver, opaque);
+    });
+    int outlineOnly = 0, trianglesOnly = 0, both = 0;
+    for (int y = 0; y < want.height(); ++y) {
+        for (int x = 0; x < want.width(); ++x) {
+            bool inOutline = *want.getAddr8(x, y), inTriangles = *got.getAddr8(x, y);
+            outlineOnly += inOutline && !inTriangles;
+            trianglesOnly += inTriangles && !inOutline;
+            both += inOutline && inTriangles;
+        }
+    }
+    REPORTER_ASSERT(reporter, trianglesOnly == 0);
+    REPORTER_ASSERT(reporter, outlineOnly < both / 50, "%d of %d", outlineOnly, both);
+
+    REPORTER_ASSERT(reporter, !stroker.strokeVertices(SkPath()));
+}
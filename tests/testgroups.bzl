@@ -4,6 +4,7 @@ CODEC_TESTS = [
     "SerializationTest.cpp",
     "SwizzlerTest.cpp",
     "ICCTest.cpp",
+    "ColorTransformTest.cpp",
     "InvalidIndexedPngTest.cpp",
     "BadIcoTest.cpp",
     "SerialProcsTest.cpp",
@@ -22,6 +23,7 @@ CORE_TESTS = [
     "BitmapGetColorTest.cpp",
     "BitmapTest.cpp",
     "BlitMaskClip.cpp",
+    "BlurEngineTest.cpp",
     "CachedDecodingPixelRefTest.cpp",
     "CanvasTest.cpp",
     "ChecksumTest.cpp",
@@ -31,6 +33,7 @@ CORE_TESTS = [
     "ColorMatrixTest.cpp",
     "ColorPrivTest.cpp",
     "ColorTest.cpp",
+    "CompactPathTest.cpp",
     "CtsEnforcement.cpp",
     "CubicMapTest.cpp",
     "DashPathEffectTest.cpp",
@@ -103,6 +106,7 @@ CORE_TESTS = [
     "RectTest.cpp",
     "RefCntTest.cpp",
     "RegionTest.cpp",
+    "ResizePixelsTest.cpp",
     "SRGBTest.cpp",
     "SafeMathTest.cpp",
     "ScalarTest.cpp",
@@ -124,6 +128,7 @@ CORE_TESTS = [
     "SkMallocTest.cpp",
     "SkPathRangeIterTest.cpp",
     "SkSLErrorTest.cpp",
+    "SkSLLexerTest.cpp",
     "SkSLMemoryLayoutTest.cpp",
     "SkSLTypeTest.cpp",
     "SkSharedMutexTest.cpp",